@@ -41,9 +41,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 // GPSTK
 #include "Exception.hpp"
@@ -113,6 +118,7 @@ private:
       help = verbose = brief = nohead = notab = gpstime = sorttime = vistab
          = dogaps = doms = ycode = quiet = false;
       debug = -1;
+      nthreads = 1;
       dt = -1.0;
       vres = 0;
    }  // end Configuration::SetDefaults()
@@ -127,13 +133,14 @@ public:
       // start command line input
    bool help, verbose, brief, nohead, notab, gpstime, sorttime, dogaps, doms,
       vistab, ycode, quiet;
-   int debug, vres;
+   int debug, vres, nthreads;
    double dt;
    string cfgfile, userfmt;
 
    vector<string> InputObsFiles; // RINEX obs file names
    string Obspath;               // paths
    string LogFile;               // output log file (optional)
+   string JSONFile;              // output summary file (optional)
 
       // times derived from --start and --stop
    string defaultstartStr,startStr;
@@ -144,13 +151,9 @@ public:
 
       // end of command line input
 
-   vector<int> gapcount;               // for counting gaps
    string msg;
-   static const string calfmt,gpsfmt,longfmt;
-   ofstream logstrm;
-
-      // for milliseconds
-   msecHandler msh;
+   static const string calfmt,gpsfmt,longfmt,jsonfmt;
+   ofstream logstrm, jsonstrm;
 
 }; // end class Configuration
 
@@ -160,6 +163,7 @@ const string Configuration::PrgmName = string("RinSum");
 const string Configuration::calfmt = string("%04Y/%02m/%02d %02H:%02M:%02S");
 const string Configuration::gpsfmt = string("%4F %w %10.3g %P");
 const string Configuration::longfmt = calfmt + " = " + gpsfmt;
+const string Configuration::jsonfmt = string("%04Y-%02m-%02dT%02H:%02M:%06.3f");
 
 //-----------------------------------------------------------------------------
 // struct used to store SAT/Obs table
@@ -199,10 +203,127 @@ public:
    { return d1.begin < d2.begin; }
 };
 
+//-----------------------------------------------------------------------------
+// summary of one satellite in one file, for the JSON output
+struct SatSummary
+{
+   RinexSatID sat;
+   string begin, end;
+   map<string,int> nobs;               // number of data per obs type
+};
+
+// Summary of one file. The report is the text output, kept here only when
+// several files are summarized at once, so that it can be output in order.
+struct FileSummary
+{
+   FileSummary() : iret(0), done(false), failed(false), version(0.0), dt(0.0),
+      span(0.0), nepochs(0), npossible(0), ncommentblocks(0), nooo(0),
+      ngaps(-1) {}
+
+   string filename;
+   int iret;                     // 0 ok, or could not: 1 open file, 2 read header,
+                                 // 3 read data, 4 valid header, 5 find data
+   bool done;                    // summary is complete
+   bool failed;                  // the worker threw fatal, to be rethrown
+   Exception fatal;
+   string report;                // output, when buffered
+
+   double version;
+   string marker, first, last;
+   double dt, span;
+   int nepochs, npossible, ncommentblocks, nooo, ngaps;
+   vector<SatSummary> sats;
+   map<string, map<string,long> > counts;    // number of data per system,obs
+};
+
+// Totals over many files. Each worker thread keeps its own, and they are
+// merged when all files are done.
+struct ArchiveSummary
+{
+   ArchiveSummary() : nfiles(0), nok(0), nepochs(0) {}
+
+      // add one file
+   void add(const FileSummary& S);
+      // add the totals of another archive summary
+   void merge(const ArchiveSummary& A);
+
+   int nfiles, nok;
+   long nepochs;
+   string first, last;
+   set<RinexSatID> sats;
+   map<string, map<string,long> > counts;
+};
+
+//-----------------------------------------------------------------------------
+// LOG for the summary of one file; like LOG, but writes to a given stream,
+// which is a buffer when files are summarized in parallel.
+class FileLOG
+{
+public:
+   FileLOG(ostream& s) : strm(s) {}
+   ~FileLOG() { strm << os.str() << endl; }
+   ostringstream& Put(void) { return os; }
+private:
+   ostream& strm;
+   ostringstream os;
+};
+
+#define FLOG(level) \
+   if(level <= LOGlevel) FileLOG(rpt).Put()
+
+//-----------------------------------------------------------------------------
+// Source of the data records of one file, read after the header. When
+// threaded, a second thread reads the file and keeps a bounded queue of
+// records ahead of the caller, so parsing overlaps the counting.
+class ObsReader
+{
+public:
+   ObsReader(Rinex3ObsStream& s, bool threaded);
+   ~ObsReader() { finish(); }
+
+      // stop reading; call before closing the stream
+   void finish(void);
+
+      // get the next record. Return 1 for a record, 0 at end of file, -1 if
+      // the stream failed (what is the message, data is the partial record),
+      // or -2 for any other exception (what is the message).
+   int next(Rinex3ObsData& data, string& what);
+
+private:
+   struct Record
+   {
+      Rinex3ObsData data;
+      int status;
+      string what;
+   };
+
+      // read one record from the stream
+   int read(Rinex3ObsData& data, string& what);
+
+   Rinex3ObsStream& strm;
+   bool threaded;
+
+#ifndef _WIN32
+   static void *run(void *arg);
+
+   static const size_t queueSize = 64;
+   deque<Record> queue;
+   bool stop;
+   pthread_t thread;
+   pthread_mutex_t mutex;
+   pthread_cond_t notEmpty, notFull;
+#endif
+};
+
 //-----------------------------------------------------------------------------
 // prototypes
 int Initialize(string& errors) throw(Exception);
 int ProcessFiles(void) throw(Exception);
+int SummarizeFile(size_t nfile, FileSummary& S, ostream& rpt, bool threaded)
+   throw(Exception);
+#ifndef _WIN32
+int SummarizeParallel(ArchiveSummary& archive) throw(Exception);
+#endif
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -299,10 +420,6 @@ int Initialize(string& errors) throw(Exception)
             LOG(ERROR) << C.msg;
       }
 
-         // initialize millisecond handler
-      if(C.doms)
-         C.msh.setDT(C.dt);
-
          // -------- save errors and output
          //errors = oss.str();
          //stripTrailing(errors,'\n');
@@ -479,9 +596,13 @@ string Configuration::BuildCommandLine(void) throw()
             "Print graphical visibility, resolution <n> [n~20 @ 30s; req's --gaps]");
    opts.Add(0, "vtab", "", false, false, &vistab, "",
             "Print tabular visibility [req's --gaps and --vis]");
+   opts.Add(0, "json", "fn", false, false, &JSONFile, "",
+            "Also write the summaries to file <fn>, one JSON object per line");
 
    opts.Add(0, "ycode", "", false, false, &ycode, "# Other:",
             "Assume v2.11 P mean Y");
+   opts.Add(0, "threads", "n", false, false, &nthreads, "",
+            "Summarize <n> files at a time, each read on its own thread");
    opts.Add(0, "verbose", "", false, false, &verbose, "",
             "Print extra output information");
    opts.Add(0, "debug", "", false, false, &debug, "",
@@ -589,6 +710,14 @@ int Configuration::ExtraProcessing(string& errors, string& extras) throw()
    if (!quiet)
       LOG(INFO) << Title;
 
+      // open the summary file
+   if(!JSONFile.empty())
+   {
+      jsonstrm.open(JSONFile.c_str(), ios::out);
+      if(!jsonstrm.is_open())
+         oss << "Error : Failed to open JSON file " << JSONFile << endl;
+   }
+
       // check consistency of exSat and onlySat; note you CAN have --only R --ex R10,R07
    if(exSats.size() > 0 && onlySats.size() > 0)
    {
@@ -613,6 +742,11 @@ int Configuration::ExtraProcessing(string& errors, string& extras) throw()
    {
       ossx << "Warning - Option --dt, must have dt positive\n";
       dt = -1.0;
+   }
+   if(nthreads < 1)
+   {
+      ossx << "Warning - Option --threads, must have n positive\n";
+      nthreads = 1;
    }
       // milli requires dt
    if(doms && dt == -1.0)
@@ -650,19 +784,453 @@ int Configuration::ExtraProcessing(string& errors, string& extras) throw()
 
 } // end Configuration::ExtraProcessing(string& errors) throw()
 
+//-----------------------------------------------------------------------------
+ObsReader::ObsReader(Rinex3ObsStream& s, bool thr) : strm(s), threaded(thr)
+{
+#ifdef _WIN32
+   threaded = false;
+#else
+   if(!threaded)
+      return;
+   stop = false;
+   pthread_mutex_init(&mutex, NULL);
+   pthread_cond_init(&notEmpty, NULL);
+   pthread_cond_init(&notFull, NULL);
+   if(pthread_create(&thread, NULL, run, this) != 0)
+   {
+         // read in this thread instead
+      pthread_cond_destroy(&notFull);
+      pthread_cond_destroy(&notEmpty);
+      pthread_mutex_destroy(&mutex);
+      threaded = false;
+   }
+#endif
+}
+
+void ObsReader::finish(void)
+{
+#ifndef _WIN32
+   if(!threaded)
+      return;
+   threaded = false;
+   pthread_mutex_lock(&mutex);
+   stop = true;
+   pthread_cond_signal(&notFull);
+   pthread_mutex_unlock(&mutex);
+   pthread_join(thread, NULL);
+   pthread_cond_destroy(&notFull);
+   pthread_cond_destroy(&notEmpty);
+   pthread_mutex_destroy(&mutex);
+#endif
+}
+
+int ObsReader::next(Rinex3ObsData& data, string& what)
+{
+#ifndef _WIN32
+   if(threaded)
+   {
+      pthread_mutex_lock(&mutex);
+      while(queue.empty())
+         pthread_cond_wait(&notEmpty, &mutex);
+      Record& rec(queue.front());
+      int status(rec.status);
+      data = rec.data;
+      what = rec.what;
+      queue.pop_front();
+      pthread_cond_signal(&notFull);
+      pthread_mutex_unlock(&mutex);
+      return status;
+   }
+#endif
+   return read(data, what);
+}
+
+int ObsReader::read(Rinex3ObsData& data, string& what)
+{
+   try
+   {
+      strm >> data;
+   }
+   catch(Exception& e)
+   {
+      what = e.getText(0);
+      return -1;
+   }
+   catch(std::exception& e)
+   {
+      what = string("Std excep: ") + e.what();
+      return -2;
+   }
+   catch(...)
+   {
+      what = string("Unknown exception while reading RINEX data.");
+      return -2;
+   }
+
+      // normal EOF
+   if(!strm.good() || strm.eof())
+      return 0;
+   return 1;
+}
+
+#ifndef _WIN32
+void *ObsReader::run(void *arg)
+{
+   ObsReader& R(*static_cast<ObsReader *>(arg));
+   Record rec;
+   bool quit;
+   do
+   {
+      rec.what.clear();
+      rec.status = R.read(rec.data, rec.what);
+
+      pthread_mutex_lock(&R.mutex);
+      while(!R.stop && R.queue.size() >= queueSize)
+         pthread_cond_wait(&R.notFull, &R.mutex);
+      if(!R.stop)
+      {
+         R.queue.push_back(rec);
+         pthread_cond_signal(&R.notEmpty);
+      }
+      quit = R.stop;
+      pthread_mutex_unlock(&R.mutex);
+   } while(rec.status == 1 && !quit);
+
+   return NULL;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+void ArchiveSummary::add(const FileSummary& S)
+{
+   nfiles++;
+   if(S.iret == 0)
+      nok++;
+   if(S.nepochs <= 0)
+      return;
+
+   nepochs += S.nepochs;
+   if(first.empty() || S.first < first) first = S.first;
+   if(last.empty() || S.last > last) last = S.last;
+   for(size_t i=0; i<S.sats.size(); i++)
+      sats.insert(S.sats[i].sat);
+
+   map<string, map<string,long> >::const_iterator sit;
+   map<string,long>::const_iterator oit;
+   for(sit=S.counts.begin(); sit != S.counts.end(); ++sit)
+      for(oit=sit->second.begin(); oit != sit->second.end(); ++oit)
+         counts[sit->first][oit->first] += oit->second;
+}
+
+void ArchiveSummary::merge(const ArchiveSummary& A)
+{
+   nfiles += A.nfiles;
+   nok += A.nok;
+   nepochs += A.nepochs;
+   if(!A.first.empty() && (first.empty() || A.first < first)) first = A.first;
+   if(!A.last.empty() && (last.empty() || A.last > last)) last = A.last;
+   sats.insert(A.sats.begin(), A.sats.end());
+
+   map<string, map<string,long> >::const_iterator sit;
+   map<string,long>::const_iterator oit;
+   for(sit=A.counts.begin(); sit != A.counts.end(); ++sit)
+      for(oit=sit->second.begin(); oit != sit->second.end(); ++oit)
+         counts[sit->first][oit->first] += oit->second;
+}
+
+//-----------------------------------------------------------------------------
+// JSON output, one object per line: one per file, then one for the archive
+string jsonString(const string& str)
+{
+   string q("\"");
+   for(size_t i=0; i<str.size(); i++)
+   {
+      if(str[i] == '"' || str[i] == '\\')
+         q += '\\';
+      q += (static_cast<unsigned char>(str[i]) < 0x20 ? ' ' : str[i]);
+   }
+   return q + "\"";
+}
+
+template <class T>
+void WriteJSONCounts(ostream& os, const map<string,T>& counts)
+{
+   typename map<string,T>::const_iterator it;
+   os << "{";
+   for(it=counts.begin(); it != counts.end(); ++it)
+      os << (it == counts.begin() ? "" : ",") << jsonString(it->first)
+         << ":" << it->second;
+   os << "}";
+}
+
+void WriteJSONCounts(ostream& os, const map<string, map<string,long> >& counts)
+{
+   map<string, map<string,long> >::const_iterator it;
+   os << "{";
+   for(it=counts.begin(); it != counts.end(); ++it)
+   {
+      os << (it == counts.begin() ? "" : ",") << jsonString(it->first) << ":";
+      WriteJSONCounts(os, it->second);
+   }
+   os << "}";
+}
+
+void WriteJSON(ostream& os, const FileSummary& S)
+{
+   static const char *status[] = { "ok", "open failed", "header failed",
+      "read failed", "invalid header", "no data" };
+
+   os << "{\"file\":" << jsonString(S.filename)
+      << ",\"status\":" << jsonString(status[S.iret]);
+   if(S.iret != 1 && S.iret != 2)
+      os << ",\"version\":" << fixed << setprecision(2) << S.version
+         << ",\"marker\":" << jsonString(S.marker);
+   if(S.nepochs > 0)
+   {
+      os << ",\"first\":" << jsonString(S.first)
+         << ",\"last\":" << jsonString(S.last)
+         << ",\"interval\":" << setprecision(3) << S.dt
+         << ",\"span\":" << S.span
+         << ",\"epochs\":" << S.nepochs
+         << ",\"possible\":" << S.npossible
+         << ",\"commentBlocks\":" << S.ncommentblocks
+         << ",\"outOfOrderBlocks\":" << S.nooo;
+      if(S.ngaps >= 0)
+         os << ",\"gaps\":" << S.ngaps;
+      os << ",\"counts\":";
+      WriteJSONCounts(os, S.counts);
+      os << ",\"sats\":{";
+      for(size_t i=0; i<S.sats.size(); i++)
+      {
+         const SatSummary& sat(S.sats[i]);
+         os << (i == 0 ? "" : ",") << jsonString(asString(sat.sat))
+            << ":{\"begin\":" << jsonString(sat.begin)
+            << ",\"end\":" << jsonString(sat.end) << ",\"nobs\":";
+         WriteJSONCounts(os, sat.nobs);
+         os << "}";
+      }
+      os << "}";
+   }
+   os << "}" << endl;
+}
+
+void WriteJSON(ostream& os, const ArchiveSummary& A)
+{
+   os << "{\"archive\":{\"files\":" << A.nfiles
+      << ",\"ok\":" << A.nok
+      << ",\"epochs\":" << A.nepochs;
+   if(A.nepochs > 0)
+      os << ",\"first\":" << jsonString(A.first)
+         << ",\"last\":" << jsonString(A.last);
+   os << ",\"sats\":[";
+   set<RinexSatID>::const_iterator it;
+   for(it=A.sats.begin(); it != A.sats.end(); ++it)
+      os << (it == A.sats.begin() ? "" : ",") << jsonString(asString(*it));
+   os << "],\"counts\":";
+   WriteJSONCounts(os, A.counts);
+   os << "}}" << endl;
+}
+
 //-----------------------------------------------------------------------------
 // Return 0 ok, >0 number of files successfully read, <0 fatal error
 int ProcessFiles(void) throw(Exception)
+{
+   try
+   {
+      Configuration& C(Configuration::Instance());
+      int nfiles(0);
+      ArchiveSummary archive;
+
+#ifndef _WIN32
+      if(C.nthreads > 1 && C.InputObsFiles.size() > 0)
+         nfiles = SummarizeParallel(archive);
+      else
+#endif
+      for(size_t nfile=0; nfile<C.InputObsFiles.size(); nfile++)
+      {
+         FileSummary S;
+         SummarizeFile(nfile, S, LOGstrm, false);
+         archive.add(S);
+         if(C.jsonstrm.is_open())
+            WriteJSON(C.jsonstrm, S);
+         if(S.iret == 0)
+            nfiles++;
+      }
+
+      if(C.jsonstrm.is_open())
+         WriteJSON(C.jsonstrm, archive);
+
+      return nfiles;
+   }
+   catch(Exception& e)
+   {
+      GPSTK_RETHROW(e);
+   }
+}  // end ProcessFiles()
+
+#ifndef _WIN32
+//-----------------------------------------------------------------------------
+// Files summarized in parallel: the worker threads take the files in order,
+// no more than window ahead of the output, which is in input order.
+struct FilePool
+{
+   vector<FileSummary> summaries;
+   size_t next;                  // next file to start
+   size_t nout;                  // number of files output
+   size_t window;
+   bool abort;
+   pthread_mutex_t mutex;
+   pthread_cond_t changed;       // a file is done, or output
+};
+
+struct FileWorker
+{
+   FilePool *pool;
+   ArchiveSummary archive;       // this thread's files
+   pthread_t thread;
+};
+
+void *SummarizeFiles(void *arg)
+{
+   FileWorker& W(*static_cast<FileWorker *>(arg));
+   FilePool& P(*W.pool);
+
+   pthread_mutex_lock(&P.mutex);
+   while(1)
+   {
+      while(!P.abort && P.next < P.summaries.size()
+            && P.next >= P.nout + P.window)
+         pthread_cond_wait(&P.changed, &P.mutex);
+      if(P.abort || P.next >= P.summaries.size())
+         break;
+      size_t nfile(P.next++);
+      FileSummary& S(P.summaries[nfile]);
+      pthread_mutex_unlock(&P.mutex);
+
+      ostringstream rpt;
+      try
+      {
+         SummarizeFile(nfile, S, rpt, true);
+         W.archive.add(S);
+      }
+      catch(Exception& e)
+      {
+         S.fatal = e;
+         S.failed = true;
+      }
+      catch(std::exception& e)
+      {
+         S.fatal = Exception(string("Std excep: ") + e.what());
+         S.failed = true;
+      }
+      S.report = rpt.str();
+
+      pthread_mutex_lock(&P.mutex);
+      S.done = true;
+      pthread_cond_broadcast(&P.changed);
+   }
+   pthread_mutex_unlock(&P.mutex);
+
+   return NULL;
+}
+
+// Summarize the files on C.nthreads threads, and output them in order.
+// Return the number of files successfully read.
+int SummarizeParallel(ArchiveSummary& archive) throw(Exception)
+{
+   Configuration& C(Configuration::Instance());
+   size_t i, nfile;
+   int nfiles(0);
+   bool failed(false);
+   Exception fatal;
+
+   FilePool P;
+   P.summaries = vector<FileSummary>(C.InputObsFiles.size());
+   P.next = P.nout = 0;
+   P.window = 4*C.nthreads;
+   P.abort = false;
+   pthread_mutex_init(&P.mutex, NULL);
+   pthread_cond_init(&P.changed, NULL);
+
+   vector<FileWorker> workers(min(size_t(C.nthreads), P.summaries.size()));
+   for(i=0; i<workers.size(); i++)
+   {
+      workers[i].pool = &P;
+      if(pthread_create(&workers[i].thread, NULL, SummarizeFiles, &workers[i]))
+         break;
+   }
+   workers.resize(i);
+   if(workers.empty())
+   {
+      pthread_cond_destroy(&P.changed);
+      pthread_mutex_destroy(&P.mutex);
+      Exception e("Unable to start threads");
+      GPSTK_THROW(e);
+   }
+
+   for(nfile=0; nfile<P.summaries.size(); nfile++)
+   {
+      FileSummary& S(P.summaries[nfile]);
+      pthread_mutex_lock(&P.mutex);
+      while(!S.done)
+         pthread_cond_wait(&P.changed, &P.mutex);
+      pthread_mutex_unlock(&P.mutex);
+
+      LOGstrm << S.report << flush;
+      if(S.failed)
+      {
+         fatal = S.fatal;
+         failed = true;
+         break;
+      }
+      if(C.jsonstrm.is_open())
+         WriteJSON(C.jsonstrm, S);
+      if(S.iret == 0)
+         nfiles++;
+
+         // done with it
+      S = FileSummary();
+      pthread_mutex_lock(&P.mutex);
+      P.nout++;
+      pthread_cond_broadcast(&P.changed);
+      pthread_mutex_unlock(&P.mutex);
+   }
+
+   pthread_mutex_lock(&P.mutex);
+   P.abort = true;
+   pthread_cond_broadcast(&P.changed);
+   pthread_mutex_unlock(&P.mutex);
+   for(i=0; i<workers.size(); i++)
+   {
+      pthread_join(workers[i].thread, NULL);
+      archive.merge(workers[i].archive);
+   }
+   pthread_cond_destroy(&P.changed);
+   pthread_mutex_destroy(&P.mutex);
+
+   if(failed)
+   {
+      GPSTK_RETHROW(fatal);
+   }
+
+   return nfiles;
+}  // end SummarizeParallel()
+#endif
+
+//-----------------------------------------------------------------------------
+// Summarize one file: write the report to rpt and fill in S. If threaded, the
+// file is read on a thread of its own. Return S.iret
+int SummarizeFile(size_t nfile, FileSummary& S, ostream& rpt, bool threaded)
+   throw(Exception)
 {
    try
    {
       Configuration& C(Configuration::Instance());
       int iret,ii,k;
-      size_t i,j,nfile,nfiles;
-      string tag;
+      size_t i,j;
+      string tag, what;
       CommonTime lastObsTime, prevObsTime, firstObsTime;
       RinexSatID sat;
-      Rinex3ObsStream ostrm;
       ostringstream oss;
          // estimate time step
       const size_t ndtmax=15;
@@ -672,1021 +1240,1041 @@ int ProcessFiles(void) throw(Exception)
       bool cacheon;
       vector<CommonTime> cachetime;
       vector<vector<Rinex3ObsData> > cache;
-
-      for(nfiles=0,nfile=0; nfile<C.InputObsFiles.size(); nfile++)
+      vector<int> gapcount;               // for counting gaps
+      msecHandler msh;                    // for milliseconds
+      Rinex3ObsStream istrm;
+      Rinex3ObsHeader Rhead, Rheadout;
+      Rinex3ObsData Rdata;
+
+         // If command line specified P1/P2 are to be considered
+         // as Y-code, set the Rinex3ObsHeader flag to indicate such.
+      if (C.ycode)
       {
-         Rinex3ObsStream istrm;
-         Rinex3ObsHeader Rhead, Rheadout;
-         Rinex3ObsData Rdata;
+         Rhead.PisY = true;
+         Rheadout.PisY = true;
+      }
+   
+      cacheon = false;
 
-            // If command line specified P1/P2 are to be considered
-            // as Y-code, set the Rinex3ObsHeader flag to indicate such.
-         if (C.ycode)
-         {
-            Rhead.PisY = true;
-            Rheadout.PisY = true;
-         }
-      
-         cacheon = false;
-         cache.clear();
-         cachetime.clear();
+      string filename(C.InputObsFiles[nfile]);
+      S.filename = filename;
 
-         string filename(C.InputObsFiles[nfile]);
+      // iret is set to 0 ok, or could not: 1 open file, 2 read header, 3 read data,
+      // 4 valid header, 5 find data
+      iret = 0;
+      for(i=0; i<ndtmax; i++)
+         ndt[i] = -1;
 
-         // iret is set to 0 ok, or could not: 1 open file, 2 read header, 3 read data
-         iret = 0;
-         for(i=0; i<ndtmax; i++)
-            ndt[i] = -1;
+         // open the file ------------------------------------------------
+      istrm.open(filename.c_str(),ios::in);
+      if(!istrm.is_open())
+      {
+         FLOG(WARNING) << "Warning : could not open file " << filename;
+         S.iret = iret = 1;
+         return iret;
+      }
+      istrm.exceptions(ios::failbit);
 
-            // open the file ------------------------------------------------
-         istrm.open(filename.c_str(),ios::in);
-         if(!istrm.is_open())
-         {
-            LOG(WARNING) << "Warning : could not open file " << filename;
-            iret = 1;
-            continue;
-         }
-         istrm.exceptions(ios::failbit);
+      // get file size - on windows its different b/c of CRs
+      //char ch;
+      //istrm.seekg(0,ios::end);
+      //streampos filesize(istrm.tellg());
+      //istrm.seekg(0,ios::beg);
+
+         // output file name
+      if(C.quiet)
+      {
+         std::string choppedFN(filename);
+         choppedFN.erase(0,1+filename.find_last_of("/\\"));
+         FLOG(INFO) << "+++++++++++++ " << C.PrgmName
+                    << " summary of Rinex obs file " << choppedFN
+                    << " +++++++++++++";
+      }
+      else if(!C.brief)
+      {
+         FLOG(INFO) << "+++++++++++++ " << C.PrgmName
+                    << " summary of Rinex obs file " << filename
+                    << " +++++++++++++";
+      }
+
+         // read the header ----------------------------------------------
+      try
+      {
+         istrm >> Rhead;
+      }
+      catch(Exception& e)
+      {
+         FLOG(WARNING) << "Warning : Failed to read header: " << e.what()
+                       << "\n Header dump follows.";
+         Rhead.dump(rpt);
+         istrm.close();
+         S.iret = iret = 2;
+         return iret;
+      }
+      if(Rhead.lastObs.getTimeSystem() != Rhead.firstObs.getTimeSystem())
+         Rhead.lastObs.setTimeSystem(Rhead.firstObs.getTimeSystem());
+      S.version = Rhead.version;
+      S.marker = Rhead.markerName;
 
-         // get file size - on windows its different b/c of CRs
-         //char ch;
-         //istrm.seekg(0,ios::end);
-         //streampos filesize(istrm.tellg());
-         //istrm.seekg(0,ios::beg);
+         // output file name and header
+      if(C.brief)
+      {
+         if(nfile > 0)
+            FLOG(INFO) << "";
+         FLOG(INFO) << "File name: " << filename
+                    << " (RINEX ver. " << Rhead.version << ")";
+         FLOG(INFO) << "Marker name: " << Rhead.markerName;
+         FLOG(INFO) << "Antenna type: " << Rhead.antType;
+         FLOG(INFO) << "Position (XYZ,m) : " << fixed << setprecision(4)
+                    << Rhead.antennaPosition << ".";
+         FLOG(INFO) << "Antenna offset (UEN,m) : " << fixed << setprecision(4)
+                    << Rhead.antennaDeltaHEN << ".";
+      }
+      else if(!C.nohead)
+      {
+         FLOG(DEBUG) << "RINEX header:";
+         Rhead.dump(rpt);
+      }
 
-            // output file name
+      if(!Rhead.isValid())
+      {
+         FLOG(INFO) << "Abort: header is invalid.";
          if(C.quiet)
          {
             std::string choppedFN(filename);
             choppedFN.erase(0,1+filename.find_last_of("/\\"));
-            LOG(INFO) << "+++++++++++++ " << C.PrgmName
-                      << " summary of Rinex obs file " << choppedFN
-                      << " +++++++++++++";
+            FLOG(INFO) << "\n+++++++++++++ End of RinSum summary of "
+                       << choppedFN << " +++++++++++++";
          }
          else if(!C.brief)
          {
-            LOG(INFO) << "+++++++++++++ " << C.PrgmName
-                      << " summary of Rinex obs file " << filename
-                      << " +++++++++++++";
+            FLOG(INFO) << "\n+++++++++++++ End of RinSum summary of "
+                       << filename << " +++++++++++++";
          }
+         S.iret = iret = 4;
+         return iret;
+      }
 
-            // read the header ----------------------------------------------
-         try
+         // initialize counting -------------------------------------------
+      int nepochs(0), ncommentblocks(0), nmaxobs(0);
+      vector<TableData> table;            // table of counts per sat,obs
+      map<char, vector<int> > totals;     // totals per system,obs
+
+      prevObsTime = CommonTime::BEGINNING_OF_TIME;
+      firstObsTime = CommonTime::BEGINNING_OF_TIME;
+
+         // initialize for all systems in the header
+      map<std::string,vector<RinexObsID> >::const_iterator sit;   // used below often
+      for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+      {
+            // Initialize the vectors contained in the map
+         totals[(sit->first)[0]] = vector<int>((sit->second).size());
+
+         FLOG(DEBUG) << "GNSS " << (sit->first) << " is present with "
+                     << (sit->second).size() << " observations...";
+
+            // find the max size of obs list
+         if(int((sit->second).size()) > nmaxobs)
+            nmaxobs = (sit->second).size();
+      }
+
+         // initialize millisecond handler with obstypes and wavelengths
+      vector<string> msots;
+      if(C.doms)
+      {
+         vector<double> waves;
+            // get obs types from header
+         for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
          {
-            istrm >> Rhead;
+               // get the system
+            RinexSatID rsid;
+            rsid.fromString(sit->first);
+            SatID sid(rsid);
+               // TD support only GPS currently
+            if(rsid.systemChar() != 'G') continue;
+               // excluded satellites/systems
+            if(find(C.exSats.begin(), C.exSats.end(), rsid) != C.exSats.end())
+               continue;
+               // get the obstypes, prepend the system character
+            for(i=0; i<sit->second.size(); i++)
+            {
+               tag = sit->second[i].asString();       // 3-char obs type
+               if(tag[0] == 'C' || tag[0] == 'L')
+               {
+                     // code and phase only
+                  msots.push_back(string(1,rsid.systemChar())+tag);
+                     // get wavelength ... NB TD Glonass frequency channel not supported
+                  if(tag[0] == 'L')
+                  {
+                     ii = asInt(string(1,tag[1]));
+                     waves.push_back(getWavelength(sid, ii));
+                  }
+                  else 
+                     waves.push_back(0.0);
+               }
+            }
          }
-         catch(Exception& e)
+
+         msh.setDT(C.dt);
+         msh.setObstypes(msots,waves);
+         FLOG(DEBUG) << "Initialize millisecond handler with obs type, wavelength:";
+         for(i=0; i<msots.size(); i++) FLOG(DEBUG) << " " << msots[i]
+                                                   << fixed << setprecision(6) << " " << waves[i];
+      }
+
+      if(pLOGstrm == &cout && !C.brief)
+         FLOG(INFO) << "\nReading the observation data...";
+
+         // loop over epochs ---------------------------------------------
+      ObsReader reader(istrm, threaded);
+      while(1)
+      {
+         int rc(reader.next(Rdata, what));
+         if(rc == -1)
          {
-            LOG(WARNING) << "Warning : Failed to read header: " << e.what()
-                         << "\n Header dump follows.";
-            Rhead.dump(LOGstrm);
-            istrm.close();
-            iret = 2;
-            continue;
+            FLOG(WARNING) << " Warning : Failed to read obs data (Exception "
+                          << what << "); dump follows.";
+            Rdata.dump(rpt,Rhead);
+            iret = 3;
+            break;
          }
-         if(Rhead.lastObs.getTimeSystem() != Rhead.firstObs.getTimeSystem())
-            Rhead.lastObs.setTimeSystem(Rhead.firstObs.getTimeSystem());
-
-            // output file name and header
-         if(C.brief)
+         else if(rc < 0)
          {
-            if(nfile > 0)
-               LOG(INFO) << "";
-            LOG(INFO) << "File name: " << filename
-                      << " (RINEX ver. " << Rhead.version << ")";
-            LOG(INFO) << "Marker name: " << Rhead.markerName;
-            LOG(INFO) << "Antenna type: " << Rhead.antType;
-            LOG(INFO) << "Position (XYZ,m) : " << fixed << setprecision(4)
-                      << Rhead.antennaPosition << ".";
-            LOG(INFO) << "Antenna offset (UEN,m) : " << fixed << setprecision(4)
-                      << Rhead.antennaDeltaHEN << ".";
+            Exception ge(what);
+            GPSTK_THROW(ge);
          }
-         else if(!C.nohead)
+
+            // normal EOF
+         if(rc == 0)
          {
-            LOG(DEBUG) << "RINEX header:";
-            Rhead.dump(LOGstrm);
+            iret = 0;
+            break;
          }
 
-         if(!Rhead.isValid())
+            // stay within time limits
+         if(Rdata.time < C.beginTime)
          {
-            LOG(INFO) << "Abort: header is invalid.";
-            if(C.quiet)
-            {
-               std::string choppedFN(filename);
-               choppedFN.erase(0,1+filename.find_last_of("/\\"));
-               LOG(INFO) << "\n+++++++++++++ End of RinSum summary of "
-                         << choppedFN << " +++++++++++++";
-            }
-            else if(!C.brief)
-            {
-               LOG(INFO) << "\n+++++++++++++ End of RinSum summary of "
-                         << filename << " +++++++++++++";
-            }
+            FLOG(DEBUG) << " RINEX data timetag " << printTime(C.beginTime,C.longfmt)
+                        << " is before begin time.";
             continue;
          }
+         if(Rdata.time > C.endTime)
+         {
+            FLOG(DEBUG) << " RINEX data timetag " << printTime(C.endTime,C.longfmt)
+                        << " is after end time.";
+            break;
+         }
 
-            // initialize counting -------------------------------------------
-         int nepochs(0), ncommentblocks(0), nmaxobs(0);
-         vector<TableData> table;            // table of counts per sat,obs
-         map<char, vector<int> > totals;     // totals per system,obs
-
-         prevObsTime = CommonTime::BEGINNING_OF_TIME;
-         firstObsTime = CommonTime::BEGINNING_OF_TIME;
-
-            // initialize for all systems in the header
-         map<std::string,vector<RinexObsID> >::const_iterator sit;   // used below often
-         for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+            // fix time systems
+         if(nepochs == 0 &&
+            Rdata.time.getTimeSystem() != Rhead.lastObs.getTimeSystem())
+         {
+            Rhead.lastObs.setTimeSystem(Rdata.time.getTimeSystem());
+            Rhead.firstObs.setTimeSystem(Rdata.time.getTimeSystem());
+         }
+         lastObsTime = Rdata.time;
+         lastObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
+         firstObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
+         prevObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
+         if(firstObsTime == CommonTime::BEGINNING_OF_TIME)
+            firstObsTime = lastObsTime;
+
+            //FLOG(INFO) << "";
+         FLOG(DEBUG) << " Read RINEX data: flag " << Rdata.epochFlag
+                     << ", timetag " << printTime(Rdata.time,C.longfmt);
+
+            // if aux header data, either output or skip
+         if(Rdata.epochFlag > 1)
          {
-               // Initialize the vectors contained in the map
-            totals[(sit->first)[0]] = vector<int>((sit->second).size());
+            if(C.debug > -1)
+               for(j=0; j<Rdata.auxHeader.commentList.size(); j++)
+                  FLOG(DEBUG) << "Comment: " << Rdata.auxHeader.commentList[j];
+            ncommentblocks++;
+            continue;
+         }
 
-            LOG(DEBUG) << "GNSS " << (sit->first) << " is present with "
-                       << (sit->second).size() << " observations...";
+            // debug: dump the RINEX data object
+         if(C.debug > -1)
+            Rdata.dump(rpt,Rhead);
 
-               // find the max size of obs list
-            if(int((sit->second).size()) > nmaxobs)
-               nmaxobs = (sit->second).size();
-         }
+            // count this epoch
+         nepochs++;
 
-            // initialize millisecond handler with obstypes and wavelengths
-         vector<string> msots;
-         if(C.doms)
+            // check for data out of time order
+            // use < 1.e-3 not < 0 b/c inline header info (epochFlag > 1) excluded
+         if(prevObsTime != CommonTime::BEGINNING_OF_TIME
+            && Rdata.time-prevObsTime < 1.e-3)
          {
-            vector<double> waves;
-               // get obs types from header
-            for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+               // save it
+            if(!cacheon)
             {
-                  // get the system
-               RinexSatID rsid;
-               rsid.fromString(sit->first);
-               SatID sid(rsid);
-                  // TD support only GPS currently
-               if(rsid.systemChar() != 'G') continue;
-                  // excluded satellites/systems
-               if(find(C.exSats.begin(), C.exSats.end(), rsid) != C.exSats.end())
-                  continue;
-                  // get the obstypes, prepend the system character
-               for(i=0; i<sit->second.size(); i++)
-               {
-                  tag = sit->second[i].asString();       // 3-char obs type
-                  if(tag[0] == 'C' || tag[0] == 'L')
-                  {
-                        // code and phase only
-                     msots.push_back(string(1,rsid.systemChar())+tag);
-                        // get wavelength ... NB TD Glonass frequency channel not supported
-                     if(tag[0] == 'L')
-                     {
-                        ii = asInt(string(1,tag[1]));
-                        waves.push_back(getWavelength(sid, ii));
-                     }
-                     else 
-                        waves.push_back(0.0);
-                  }
-               }
+                  // new block
+               cachetime.push_back(prevObsTime);
+               cacheon = true;
+               vector<Rinex3ObsData> v;
+               cache.push_back(v);
             }
-
-            C.msh.setObstypes(msots,waves);
-            LOG(DEBUG) << "Initialize millisecond handler with obs type, wavelength:";
-            for(i=0; i<msots.size(); i++) LOG(DEBUG) << " " << msots[i]
-                                                     << fixed << setprecision(6) << " " << waves[i];
+            cache[cache.size()-1].push_back(Rdata);
+            continue;
          }
+         cacheon = false;
 
-         if(pLOGstrm == &cout && !C.brief)
-            LOG(INFO) << "\nReading the observation data...";
-
-            // loop over epochs ---------------------------------------------
-         while(1)
+            // look for gaps in the timetags
+         int ncount;
+         if(C.dt > 0.0)
          {
-            try
+            ncount = int(0.5+(lastObsTime-firstObsTime)/C.dt);
+               // update gap count
+            if(gapcount.size() == 0)
             {
-               istrm >> Rdata;
+                  // create the list
+               gapcount.push_back(ncount);   // start time
+               gapcount.push_back(ncount-1); // end time
             }
-            catch(Exception& e)
-            {
-               LOG(WARNING) << " Warning : Failed to read obs data (Exception "
-                            << e.getText(0) << "); dump follows.";
-               Rdata.dump(LOGstrm,Rhead);
-               istrm.close();
-               iret = 3;
-               break;
-            }
-            catch(std::exception& e)
-            {
-               Exception ge(string("Std excep: ") + e.what());
-               GPSTK_THROW(ge);
-            }
-            catch(...)
+            i = gapcount.size() - 1;
+            if(ncount == gapcount[i] + 1)    // no gap
+               gapcount[i] = ncount;
+            else
             {
-               Exception ue("Unknown exception while reading RINEX data.");
-               GPSTK_THROW(ue);
+                  // found a gap
+               gapcount.push_back(ncount);   // start time
+               gapcount.push_back(ncount);   // end time
             }
 
-               // normal EOF
-            if(!istrm.good() || istrm.eof())
-            {
-               iret = 0;
-               break;
-            }
+               // TD test after 50 epochs - wrong dt is disasterous
+         }
 
-               // stay within time limits
-            if(Rdata.time < C.beginTime)
-            {
-               LOG(DEBUG) << " RINEX data timetag " << printTime(C.beginTime,C.longfmt)
-                          << " is before begin time.";
-               continue;
-            }
-            if(Rdata.time > C.endTime)
-            {
-               LOG(DEBUG) << " RINEX data timetag " << printTime(C.endTime,C.longfmt)
-                          << " is after end time.";
-               break;
-            }
+            // loop over satellites -------------------------------------
+         Rinex3ObsData::DataMap::const_iterator it;
+         for(it=Rdata.obs.begin(); it != Rdata.obs.end(); ++it)
+         {
+            const RinexSatID& sat(it->first);
 
-               // fix time systems
-            if(nepochs == 0 &&
-               Rdata.time.getTimeSystem() != Rhead.lastObs.getTimeSystem())
-            {
-               Rhead.lastObs.setTimeSystem(Rdata.time.getTimeSystem());
-               Rhead.firstObs.setTimeSystem(Rdata.time.getTimeSystem());
-            }
-            lastObsTime = Rdata.time;
-            lastObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            firstObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            prevObsTime.setTimeSystem(Rhead.lastObs.getTimeSystem());
-            if(firstObsTime == CommonTime::BEGINNING_OF_TIME)
-               firstObsTime = lastObsTime;
-
-               //LOG(INFO) << "";
-            LOG(DEBUG) << " Read RINEX data: flag " << Rdata.epochFlag
-                       << ", timetag " << printTime(Rdata.time,C.longfmt);
-
-               // if aux header data, either output or skip
-            if(Rdata.epochFlag > 1)
-            {
-               if(C.debug > -1)
-                  for(j=0; j<Rdata.auxHeader.commentList.size(); j++)
-                     LOG(DEBUG) << "Comment: " << Rdata.auxHeader.commentList[j];
-               ncommentblocks++;
+               // is sat included?
+            if(C.onlySats.size() > 0 &&
+               find(C.onlySats.begin(), C.onlySats.end(), sat) == C.onlySats.end()
+               && find(C.onlySats.begin(), C.onlySats.end(),
+                       RinexSatID(-1,sat.system)) == C.onlySats.end())
                continue;
-            }
 
-               // debug: dump the RINEX data object
-            if(C.debug > -1)
-               Rdata.dump(LOGstrm,Rhead);
+               // is sat excluded?
+            if(find(C.exSats.begin(), C.exSats.end(), sat) != C.exSats.end())
+               continue;
+               // check for all sats of this system
+            else if(find(C.exSats.begin(), C.exSats.end(),
+                         RinexSatID(-1,sat.system)) != C.exSats.end())
+               continue;
 
-               // count this epoch
-            nepochs++;
+            const vector<RinexDatum>& vecData(it->second);
 
-               // check for data out of time order
-               // use < 1.e-3 not < 0 b/c inline header info (epochFlag > 1) excluded
-            if(prevObsTime != CommonTime::BEGINNING_OF_TIME
-               && Rdata.time-prevObsTime < 1.e-3)
+               // find this sat in the table; add it if necessary
+            vector<TableData>::iterator ptab;
+            ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
+            if(ptab == table.end())
             {
-                  // save it
-               if(!cacheon)
+                  // add it
+               table.push_back(TableData(sat,nmaxobs));
+               ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
+               ptab->begin = lastObsTime;
+               if(C.dt > 0.0)
                {
-                     // new block
-                  cachetime.push_back(prevObsTime);
-                  cacheon = true;
-                  vector<Rinex3ObsData> v;
-                  cache.push_back(v);
+                  ptab->gapcount.push_back(ncount);      // start time
+                  ptab->gapcount.push_back(ncount-1);    // end time
                }
-               cache[cache.size()-1].push_back(Rdata);
-               continue;
             }
-            cacheon = false;
 
-               // look for gaps in the timetags
-            int ncount;
+               // update list of gap times
             if(C.dt > 0.0)
             {
-               ncount = int(0.5+(lastObsTime-firstObsTime)/C.dt);
-                  // update gap count
-               if(C.gapcount.size() == 0)
-               {
-                     // create the list
-                  C.gapcount.push_back(ncount);   // start time
-                  C.gapcount.push_back(ncount-1); // end time
-               }
-               i = C.gapcount.size() - 1;
-               if(ncount == C.gapcount[i] + 1)    // no gap
-                  C.gapcount[i] = ncount;
+               i = ptab->gapcount.size() - 1;         // index of curr end time
+               if(ncount == ptab->gapcount[i] + 1)    // no gap
+                  ptab->gapcount[i] = ncount;
                else
                {
                      // found a gap
-                  C.gapcount.push_back(ncount);   // start time
-                  C.gapcount.push_back(ncount);   // end time
+                  ptab->gapcount.push_back(ncount);   // start time
+                  ptab->gapcount.push_back(ncount);   // end time
                }
-
-                  // TD test after 50 epochs - wrong dt is disasterous
             }
 
-               // loop over satellites -------------------------------------
-            Rinex3ObsData::DataMap::const_iterator it;
-            for(it=Rdata.obs.begin(); it != Rdata.obs.end(); ++it)
+               // set the end time for this satellite to the current epoch
+            ptab->end = lastObsTime;
+            if(C.debug > -1)
             {
-               const RinexSatID& sat(it->first);
-
-                  // is sat included?
-               if(C.onlySats.size() > 0 &&
-                  find(C.onlySats.begin(), C.onlySats.end(), sat) == C.onlySats.end()
-                  && find(C.onlySats.begin(), C.onlySats.end(),
-                          RinexSatID(-1,sat.system)) == C.onlySats.end())
-                  continue;
+               oss.str("");
+               oss << "Sat " << setw(2) << sat;
+            }
 
-                  // is sat excluded?
-               if(find(C.exSats.begin(), C.exSats.end(), sat) != C.exSats.end())
-                  continue;
-                  // check for all sats of this system
-               else if(find(C.exSats.begin(), C.exSats.end(),
-                            RinexSatID(-1,sat.system)) != C.exSats.end())
-                  continue;
+               // first, find the current system...
+            char sysCode = sat.systemChar();
+            string sysStr(string(1,sysCode));
 
-               const vector<RinexDatum>& vecData(it->second);
+               // update Obs data totals
+            for(size_t index=0; index != vecData.size(); index++)
+            {
+               if(C.debug > -1)
+                  oss << " (" << index << ")";
 
-                  // find this sat in the table; add it if necessary
-               vector<TableData>::iterator ptab;
-               ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
-               if(ptab == table.end())
+                  // if this observation is not zero, update it's total count
+               if(vecData[index].data != 0)
                {
-                     // add it
-                  table.push_back(TableData(sat,nmaxobs));
-                  ptab = find(table.begin(),table.end(),TableData(sat,nmaxobs));
-                  ptab->begin = lastObsTime;
-                  if(C.dt > 0.0)
-                  {
-                     ptab->gapcount.push_back(ncount);      // start time
-                     ptab->gapcount.push_back(ncount-1);    // end time
-                  }
+                  (ptab->nobs)[index]++;                 // per obs
+                  if(totals[sysCode].size() == 0)
+                     totals[sysCode] = vector<int>(vecData.size());
+                  totals[sysCode][index]++;              // per system
                }
 
-                  // update list of gap times
-               if(C.dt > 0.0)
+                  // if looking for milliseconds, update handler
+               if(C.doms && vecData[index].data != 0)
                {
-                  i = ptab->gapcount.size() - 1;         // index of curr end time
-                  if(ncount == ptab->gapcount[i] + 1)    // no gap
-                     ptab->gapcount[i] = ncount;
-                  else
+                  tag = sysStr + Rhead.mapObsTypes[sysStr][index].asString();
+                  if(vectorindex(msots,tag) != -1)
                   {
-                        // found a gap
-                     ptab->gapcount.push_back(ncount);   // start time
-                     ptab->gapcount.push_back(ncount);   // end time
+                     msh.add(lastObsTime, sat, tag, vecData[index].data);
                   }
                }
 
-                  // set the end time for this satellite to the current epoch
-               ptab->end = lastObsTime;
                if(C.debug > -1)
-               {
-                  oss.str("");
-                  oss << "Sat " << setw(2) << sat;
-               }
+                  oss << fixed << setprecision(3)
+                      << " " << asString(Rhead.mapObsTypes[sysStr][index])
+                      << " " << setw(13) << vecData[index].data
+                      << " " << vecData[index].lli
+                      << " " << vecData[index].ssi;
 
-                  // first, find the current system...
-               char sysCode = sat.systemChar();
-               string sysStr(string(1,sysCode));
+            } // end loop over observations
 
-                  // update Obs data totals
-               for(size_t index=0; index != vecData.size(); index++)
-               {
-                  if(C.debug > -1)
-                     oss << " (" << index << ")";
+            if(C.debug > -1)
+               FLOG(DEBUG) << oss.str();
+
+         }  // end loop over satellites
 
-                     // if this observation is not zero, update it's total count
-                  if(vecData[index].data != 0)
+         if(prevObsTime != CommonTime::BEGINNING_OF_TIME)
+         {
+            dt = lastObsTime-prevObsTime;
+            if(dt > 0.0)
+            {
+               for(i=0; i<ndtmax; i++)
+               {
+                  if(ndt[i] <= 0)
                   {
-                     (ptab->nobs)[index]++;                 // per obs
-                     if(totals[sysCode].size() == 0)
-                        totals[sysCode] = vector<int>(vecData.size());
-                     totals[sysCode][index]++;              // per system
+                     bestdt[i]=dt;
+                     ndt[i]=1;
+                     break;
                   }
-
-                     // if looking for milliseconds, update handler
-                  if(C.doms && vecData[index].data != 0)
+                  if(fabs(dt-bestdt[i]) < 0.0001)
                   {
-                     tag = sysStr + Rhead.mapObsTypes[sysStr][index].asString();
-                     if(vectorindex(msots,tag) != -1)
-                     {
-                        C.msh.add(lastObsTime, sat, tag, vecData[index].data);
-                     }
+                     ndt[i]++;
+                     break;
                   }
-
-                  if(C.debug > -1)
-                     oss << fixed << setprecision(3)
-                         << " " << asString(Rhead.mapObsTypes[sysStr][index])
-                         << " " << setw(13) << vecData[index].data
-                         << " " << vecData[index].lli
-                         << " " << vecData[index].ssi;
-
-               } // end loop over observations
-
-               if(C.debug > -1)
-                  LOG(DEBUG) << oss.str();
-
-            }  // end loop over satellites
-
-            if(prevObsTime != CommonTime::BEGINNING_OF_TIME)
-            {
-               dt = lastObsTime-prevObsTime;
-               if(dt > 0.0)
-               {
-                  for(i=0; i<ndtmax; i++)
+                  if(i == ndtmax-1)
                   {
-                     if(ndt[i] <= 0)
+                     k = 0;
+                     int nleast = ndt[k];
+                     for(j=1; j<ndtmax; j++)
                      {
-                        bestdt[i]=dt;
-                        ndt[i]=1;
-                        break;
-                     }
-                     if(fabs(dt-bestdt[i]) < 0.0001)
-                     {
-                        ndt[i]++;
-                        break;
-                     }
-                     if(i == ndtmax-1)
-                     {
-                        k = 0;
-                        int nleast = ndt[k];
-                        for(j=1; j<ndtmax; j++)
+                        if(ndt[j] <= nleast)
                         {
-                           if(ndt[j] <= nleast)
-                           {
-                              k = j;
-                              nleast = ndt[j];
-                           }
+                           k = j;
+                           nleast = ndt[j];
                         }
-                        ndt[k] = 1;
-                        bestdt[k] = dt;
                      }
+                     ndt[k] = 1;
+                     bestdt[k] = dt;
                   }
                }
-               else if(dt == 0)
-               {
-                  LOG(WARNING) << "Warning - repeated time tag at "
-                               << printTime(lastObsTime,C.longfmt);
-               }
-               else
-               {
-                  LOG(WARNING) << "Warning - time tags out of order: "
-                               << printTime(prevObsTime,C.longfmt) << " > "
-                               << printTime(lastObsTime,C.longfmt);
-                     //<< " " << scientific << setprecision(4) << dt;
-               }
             }
-            prevObsTime = lastObsTime;
-
-         }  // end while loop over epochs
+            else if(dt == 0)
+            {
+               FLOG(WARNING) << "Warning - repeated time tag at "
+                             << printTime(lastObsTime,C.longfmt);
+            }
+            else
+            {
+               FLOG(WARNING) << "Warning - time tags out of order: "
+                             << printTime(prevObsTime,C.longfmt) << " > "
+                             << printTime(lastObsTime,C.longfmt);
+                  //<< " " << scientific << setprecision(4) << dt;
+            }
+         }
+         prevObsTime = lastObsTime;
 
-         istrm.close();
+      }  // end while loop over epochs
 
-            // check that we found some data
-         if(nepochs <= 0)
-         {
-            LOG(INFO) << "File " << filename
-                      << " : no data found. Are time limits wrong?";
-            continue;
-         }
+      reader.finish();
+      istrm.close();
 
-            // Compute interval -------------------------------------------------
-         for(i=1,j=0; i < ndtmax; i++)
-         {
-            if(ndt[i] > ndt[j])
-               j = i;
-            dt = bestdt[j];
-         }
+         // check that we found some data
+      if(nepochs <= 0)
+      {
+         FLOG(INFO) << "File " << filename
+                    << " : no data found. Are time limits wrong?";
+         if(iret == 0)
+            iret = 5;
+         S.iret = iret;
+         return iret;
+      }
 
-            // Summary info -----------------------------------------------------
-         LOG(INFO) << "Computed interval " << fixed << setw(5) << setprecision(2)
-                   << dt << " seconds.";
-         LOG(INFO) << "Computed first epoch: " << printTime(firstObsTime,C.longfmt);
-         LOG(INFO) << "Computed last  epoch: " << printTime(lastObsTime,C.longfmt);
-      
-            // compute time span of dataset in days/hours/minutes/seconds
-         oss.str("");
-         oss << "Computed time span: ";
-         double secs = lastObsTime - firstObsTime;
-         int remainder = int(secs);
-         CivilTime delta(firstObsTime);
-         delta.day    = remainder / 86400; remainder %= 86400;
-         delta.hour   = remainder / 3600;  remainder %= 3600;
-         delta.minute = remainder / 60;    remainder %= 60;
-         delta.second = remainder;
-         if(delta.day > 0)
-            oss << delta.day << "d ";
-
-         LOG(INFO) << oss.str() << delta.hour << "h " << delta.minute << "m "
-                   << delta.second << "s = " << secs << " seconds.";
-
-         //LOG(INFO) << "Computed file size: " << filesize << " bytes.";
-
-            // Reusing secs, as it is equivalent to the original expression
-            // i = 1+int(0.5+(lastObsTime-firstObsTime)/dt);
-         i = 1+int(0.5 + secs / dt);
-
-         LOG(INFO) << "There were " << nepochs << " epochs ("
-                   << fixed << setprecision(2) << double(nepochs*100)/i
-                   << "% of " << i << " possible epochs in this timespan) and "
-                   << ncommentblocks << " inline header blocks.";
-
-            // Sort table
-         if(C.sorttime)
-            sort(table.begin(),table.end(),TableBegLessThan());
-         else
-            sort(table.begin(),table.end(),TableSATLessThan());
+         // Compute interval -------------------------------------------------
+      for(i=1,j=0; i < ndtmax; i++)
+      {
+         if(ndt[i] > ndt[j])
+            j = i;
+         dt = bestdt[j];
+      }
 
-            // output table
-            // header
-         vector<TableData>::iterator tabIt;
-         if(table.size() > 0)
-            table.begin()->sat.setfill('0');
+         // Summary info -----------------------------------------------------
+      FLOG(INFO) << "Computed interval " << fixed << setw(5) << setprecision(2)
+                 << dt << " seconds.";
+      FLOG(INFO) << "Computed first epoch: " << printTime(firstObsTime,C.longfmt);
+      FLOG(INFO) << "Computed last  epoch: " << printTime(lastObsTime,C.longfmt);
+   
+         // compute time span of dataset in days/hours/minutes/seconds
+      oss.str("");
+      oss << "Computed time span: ";
+      double secs = lastObsTime - firstObsTime;
+      int remainder = int(secs);
+      CivilTime delta(firstObsTime);
+      delta.day    = remainder / 86400; remainder %= 86400;
+      delta.hour   = remainder / 3600;  remainder %= 3600;
+      delta.minute = remainder / 60;    remainder %= 60;
+      delta.second = remainder;
+      if(delta.day > 0)
+         oss << delta.day << "d ";
+
+      FLOG(INFO) << oss.str() << delta.hour << "h " << delta.minute << "m "
+                 << delta.second << "s = " << secs << " seconds.";
+
+      //FLOG(INFO) << "Computed file size: " << filesize << " bytes.";
+
+         // Reusing secs, as it is equivalent to the original expression
+         // i = 1+int(0.5+(lastObsTime-firstObsTime)/dt);
+      i = 1+int(0.5 + secs / dt);
+
+      FLOG(INFO) << "There were " << nepochs << " epochs ("
+                 << fixed << setprecision(2) << double(nepochs*100)/i
+                 << "% of " << i << " possible epochs in this timespan) and "
+                 << ncommentblocks << " inline header blocks.";
+
+         // Sort table
+      if(C.sorttime)
+         sort(table.begin(),table.end(),TableBegLessThan());
+      else
+         sort(table.begin(),table.end(),TableSATLessThan());
+
+         // output table
+         // header
+      vector<TableData>::iterator tabIt;
+      if(table.size() > 0)
+         table.begin()->sat.setfill('0');
+
+         // fill in the summary
+      S.first = printTime(firstObsTime,C.jsonfmt);
+      S.last = printTime(lastObsTime,C.jsonfmt);
+      S.dt = dt;
+      S.span = secs;
+      S.nepochs = nepochs;
+      S.npossible = i;
+      S.ncommentblocks = ncommentblocks;
+      S.nooo = cache.size();
+      if(C.dt > 0.0)
+         S.ngaps = (gapcount.size()-2)/2;
+      for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+      {
+         const vector<int>& vec(totals[(sit->first)[0]]);
+         for(k=0; k<vec.size() && k<(sit->second).size(); k++)
+            if(vec[k] > 0)
+               S.counts[sit->first][(sit->second)[k].asString()] = vec[k];
+      }
+      for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+      {
+         SatSummary satsum;
+         satsum.sat = tabIt->sat;
+         satsum.begin = printTime(tabIt->begin,C.jsonfmt);
+         satsum.end = printTime(tabIt->end,C.jsonfmt);
+         sit = Rhead.mapObsTypes.find(string(1,(tabIt->sat).systemChar()));
+         if(sit != Rhead.mapObsTypes.end())
+            for(k=0; k<(sit->second).size(); k++)
+               if(tabIt->nobs[k] > 0)
+                  satsum.nobs[(sit->second)[k].asString()] = tabIt->nobs[k];
+         S.sats.push_back(satsum);
+      }
 
-         if(!C.brief && !C.notab)
+      if(!C.brief && !C.notab)
+      {
+            // non-brief output ------------
+         FLOG(INFO) << "\n      Summary of data available in this file: "
+                    << "(Spans are based on times and interval)";
+         string fmt(C.gpstime ? C.gpsfmt : C.calfmt);
+         j = 0;
+         for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
          {
-               // non-brief output ------------
-            LOG(INFO) << "\n      Summary of data available in this file: "
-                      << "(Spans are based on times and interval)";
-            string fmt(C.gpstime ? C.gpsfmt : C.calfmt);
-            j = 0;
-            for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
-            {
-               RinexSatID sat(sit->first);
-
-               map<char, vector<int> >::const_iterator totalsIter;
-                  // compute grand total first
-               totalsIter = totals.find((sit->first)[0]);
-               const vector<int>& vec = totalsIter->second;
-               for(i=0,k=0; k<vec.size(); k++) i += vec[k];
-               if(i == 0)
-                  continue;
+            RinexSatID sat(sit->first);
 
-                  // print the table
-               if(++j > 1)
-                  LOG(INFO) << "";
-               LOG(INFO) << "System " << sit->first <<" = "<< sat.systemString() << ":";
-               oss.str("");
-               oss << " Sat\\OT:";
+            map<char, vector<int> >::const_iterator totalsIter;
+               // compute grand total first
+            totalsIter = totals.find((sit->first)[0]);
+            const vector<int>& vec = totalsIter->second;
+            for(i=0,k=0; k<vec.size(); k++) i += vec[k];
+            if(i == 0)
+               continue;
 
-                  // print line of RINEX 3 codes
-               for(k=0; k < (sit->second).size(); k++)
-                     //oss << setw(k==0?4:7) << asString((sit->second)[k]);
-                  oss << setw(k==0?4:7) << (sit->second)[k].asString();
-               LOG(INFO) << oss.str() << "   Span             Begin time - End time";
+               // print the table
+            if(++j > 1)
+               FLOG(INFO) << "";
+            FLOG(INFO) << "System " << sit->first <<" = "<< sat.systemString() << ":";
+            oss.str("");
+            oss << " Sat\\OT:";
 
-                  // print the table
-               for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+               // print line of RINEX 3 codes
+            for(k=0; k < (sit->second).size(); k++)
+                  //oss << setw(k==0?4:7) << asString((sit->second)[k]);
+               oss << setw(k==0?4:7) << (sit->second)[k].asString();
+            FLOG(INFO) << oss.str() << "   Span             Begin time - End time";
+
+               // print the table
+            for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+            {
+               std::string sysChar;
+               sysChar += (tabIt->sat).systemChar();
+               if((sit->first) == sysChar)
                {
-                  std::string sysChar;
-                  sysChar += (tabIt->sat).systemChar();
-                  if((sit->first) == sysChar)
-                  {
-                     oss.str("");
-                     oss << " " << tabIt->sat << " ";
-                     size_t obsSize = (Rhead.mapObsTypes.find(sysChar)->second).size();
-                     for(k = 0; k < obsSize; k++)
-                        oss << setw(7) << tabIt->nobs[k];
+                  oss.str("");
+                  oss << " " << tabIt->sat << " ";
+                  size_t obsSize = (Rhead.mapObsTypes.find(sysChar)->second).size();
+                  for(k = 0; k < obsSize; k++)
+                     oss << setw(7) << tabIt->nobs[k];
 
-                     oss << setw(7) << 1+int(0.5+(tabIt->end-tabIt->begin)/dt);
+                  oss << setw(7) << 1+int(0.5+(tabIt->end-tabIt->begin)/dt);
 
-                     LOG(INFO) << oss.str() << "  " << printTime(tabIt->begin,fmt)
-                               << " - " << printTime(tabIt->end,fmt);
-                  }
+                  FLOG(INFO) << oss.str() << "  " << printTime(tabIt->begin,fmt)
+                             << " - " << printTime(tabIt->end,fmt);
                }
-
-               oss.str("");
-               oss << "TOTAL";
-               for(k=0; k<vec.size(); k++) oss << setw(7) << vec[k];
-               LOG(INFO) << oss.str();
             }
-            LOG(INFO) << "";
+
+            oss.str("");
+            oss << "TOTAL";
+            for(k=0; k<vec.size(); k++) oss << setw(7) << vec[k];
+            FLOG(INFO) << oss.str();
          }
-         else
+         FLOG(INFO) << "";
+      }
+      else
+      {
+            // brief output ---------------
+            // output satellites
+         oss.str(""); oss << "SATs(" << table.size() << "):";
+         i = 0;
+         for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
          {
-               // brief output ---------------
-               // output satellites
-            oss.str(""); oss << "SATs(" << table.size() << "):";
-            i = 0;
-            for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+            oss << " " << tabIt->sat;
+            if((++i % 20) == 0)
             {
-               oss << " " << tabIt->sat;
-               if((++i % 20) == 0)
-               {
-                  LOG(INFO) << oss.str();
-                  oss.str(""); i=0;
-                  oss << "SATs ...:";
-               }
+               FLOG(INFO) << oss.str();
+               oss.str(""); i=0;
+               oss << "SATs ...:";
             }
-            LOG(INFO) << oss.str();
+         }
+         FLOG(INFO) << oss.str();
 
-               // output obs types
-            sit = Rhead.mapObsTypes.begin();
-            for( ; sit != Rhead.mapObsTypes.end(); ++sit)
-            {
-               string sysCode = (sit->first);
-               vector<RinexObsID>& vec = Rhead.mapObsTypes[sysCode];
+            // output obs types
+         sit = Rhead.mapObsTypes.begin();
+         for( ; sit != Rhead.mapObsTypes.end(); ++sit)
+         {
+            string sysCode = (sit->first);
+            vector<RinexObsID>& vec = Rhead.mapObsTypes[sysCode];
 
-                  // is this system found in the list of sats?
-               map<char, vector<int> >::const_iterator totalsIter;
-               totalsIter = totals.find(sysCode[0]);
-               const vector<int>& vectot = totalsIter->second;
-               for(i=0,k=0; k<vectot.size(); k++) i += vectot[k];
-               if(i == 0)
-                  continue;    // no, skip it
+               // is this system found in the list of sats?
+            map<char, vector<int> >::const_iterator totalsIter;
+            totalsIter = totals.find(sysCode[0]);
+            const vector<int>& vectot = totalsIter->second;
+            for(i=0,k=0; k<vectot.size(); k++) i += vectot[k];
+            if(i == 0)
+               continue;    // no, skip it
 
-               oss.str("");
-               oss << "System " << RinexSatID(sysCode).systemString3()
-                   << " Obs types(" << vec.size() << "): ";
+            oss.str("");
+            oss << "System " << RinexSatID(sysCode).systemString3()
+                << " Obs types(" << vec.size() << "): ";
 
-               for(i=0; i<vec.size(); i++) oss << " " << vec[i].asString();
+            for(i=0; i<vec.size(); i++) oss << " " << vec[i].asString();
 
-                  // if RINEX ver. 2, then add ver 2 obstypes in parentheses
-                  //map<string, map<string, RinexObsID> > Rinex3ObsHeader::mapSysR2toR3ObsID
-                  //Rhead.mapSysR2toR3ObsID[sys][ot2] = OT3;
-               if(Rhead.version < 3)
+               // if RINEX ver. 2, then add ver 2 obstypes in parentheses
+               //map<string, map<string, RinexObsID> > Rinex3ObsHeader::mapSysR2toR3ObsID
+               //Rhead.mapSysR2toR3ObsID[sys][ot2] = OT3;
+            if(Rhead.version < 3)
+            {
+               oss << " [v2:";
+               for(i=0; i<vec.size(); i++)
                {
-                  oss << " [v2:";
-                  for(i=0; i<vec.size(); i++)
+                  map<string,RinexObsID>::iterator it;
+                  for(it = Rhead.mapSysR2toR3ObsID[sysCode].begin();
+                      it != Rhead.mapSysR2toR3ObsID[sysCode].end(); ++it)
                   {
-                     map<string,RinexObsID>::iterator it;
-                     for(it = Rhead.mapSysR2toR3ObsID[sysCode].begin();
-                         it != Rhead.mapSysR2toR3ObsID[sysCode].end(); ++it)
+                     if(it->second == vec[i])
                      {
-                        if(it->second == vec[i])
-                        {
-                           oss << " " << it->first;
-                           break;
-                        }
+                        oss << " " << it->first;
+                        break;
                      }
                   }
-                  oss << "]";
                }
-
-               LOG(INFO) << oss.str();
+               oss << "]";
             }
+
+            FLOG(INFO) << oss.str();
          }
+      }
 
-            // gaps
-         if(C.dogaps)
+         // gaps
+      if(C.dogaps)
+      {
+            // summary of gaps using count
+         oss.str("");
+         oss << "Summary of gaps (vs count) in the data in this file, "
+             << "assuming dt = " << C.dt << " sec.\n";
+         if(C.dt != dt)
+            oss << " Warning - computed dt does not match input dt\n";
+         oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
+             << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
+         oss << "    Sat    beg - end (count,size) ... "
+             << "[count = # of dt's from first epoch]\n";
+            // print for timetags = all sats
+         k = gapcount.size()-1;               // size() is at least 2
+         oss << "GAP ALL " << setw(5) << gapcount[0]
+             << " - " << setw(5) << gapcount[k];
+
+            // NB DO NOT make ii size_t
+         for(ii=1; ii<=k-2; ii+=2)
+            oss << " (" << gapcount[ii]+1                          // begin of gap
+                << "," << gapcount[ii+1]-gapcount[ii]-1 << ")";   // size
+         oss << endl;
+
+            // loop over sats
+         for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
          {
-               // summary of gaps using count
-            oss.str("");
-            oss << "Summary of gaps (vs count) in the data in this file, "
-                << "assuming dt = " << C.dt << " sec.\n";
-            if(C.dt != dt)
-               oss << " Warning - computed dt does not match input dt\n";
-            oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
-                << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
-            oss << "    Sat    beg - end (count,size) ... "
-                << "[count = # of dt's from first epoch]\n";
-               // print for timetags = all sats
-            k = C.gapcount.size()-1;               // size() is at least 2
-            oss << "GAP ALL " << setw(5) << C.gapcount[0]
-                << " - " << setw(5) << C.gapcount[k];
-
+            k = tabIt->gapcount.size() - 1;
+            oss << "GAP " << tabIt->sat << " " << setw(5) << tabIt->gapcount[0]
+                << " - " << setw(5) << tabIt->gapcount[k];
                // NB DO NOT make ii size_t
             for(ii=1; ii<=k-2; ii+=2)
-               oss << " (" << C.gapcount[ii]+1                          // begin of gap
-                   << "," << C.gapcount[ii+1]-C.gapcount[ii]-1 << ")";   // size
+               oss << " (" << tabIt->gapcount[ii]+1 << ","      // begin count of gap
+                   << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
             oss << endl;
+         }
 
-               // loop over sats
-            for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
-            {
-               k = tabIt->gapcount.size() - 1;
-               oss << "GAP " << tabIt->sat << " " << setw(5) << tabIt->gapcount[0]
-                   << " - " << setw(5) << tabIt->gapcount[k];
-                  // NB DO NOT make ii size_t
-               for(ii=1; ii<=k-2; ii+=2)
-                  oss << " (" << tabIt->gapcount[ii]+1 << ","      // begin count of gap
-                      << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
-               oss << endl;
-            }
-
-            tag = oss.str(); stripTrailing(tag,"\n");
-            LOG(INFO) << tag;
+         tag = oss.str(); stripTrailing(tag,"\n");
+         FLOG(INFO) << tag;
 
-               // summary of gaps using sow
-            oss.str("");
-            double t(static_cast<GPSWeekSecond>(firstObsTime).sow), d(C.dt);
-            oss << "\nSummary of gaps (vs SOW) in the data in this file, assuming dt = "
-                << C.dt << " sec.\n";
-            if(C.dt != dt)
-               oss << " Warning - computed dt does not match input dt\n";
-            oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
-                << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
-            oss << "    Sat      beg -      end (sow,number of missing points)\n";
-
-               // print for timetags = all sats
-            k = C.gapcount.size()-1;               // size() is at least 2
-            oss << "GAP ALL " << fixed << setprecision(1) << setw(8) << t+d*C.gapcount[0]
-                << " - " << setw(8) << t+d*C.gapcount[k];
+            // summary of gaps using sow
+         oss.str("");
+         double t(static_cast<GPSWeekSecond>(firstObsTime).sow), d(C.dt);
+         oss << "\nSummary of gaps (vs SOW) in the data in this file, assuming dt = "
+             << C.dt << " sec.\n";
+         if(C.dt != dt)
+            oss << " Warning - computed dt does not match input dt\n";
+         oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
+             << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
+         oss << "    Sat      beg -      end (sow,number of missing points)\n";
+
+            // print for timetags = all sats
+         k = gapcount.size()-1;               // size() is at least 2
+         oss << "GAP ALL " << fixed << setprecision(1) << setw(8) << t+d*gapcount[0]
+             << " - " << setw(8) << t+d*gapcount[k];
+            // NB DO NOT make ii size_t
+         for(ii=1; ii<=k-2; ii+=2)
+            oss << " (" << t+d*(gapcount[ii]+1)                    // begin of gap
+                << "," << gapcount[ii+1]-gapcount[ii]-1 << ")";   // size
+         oss << endl;
+
+            // loop over sats
+         for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+         {
+            k = tabIt->gapcount.size() - 1;
+            oss << "GAP " << tabIt->sat << " " << fixed << setprecision(1)
+                << setw(8) << t+d*tabIt->gapcount[0]
+                << " - " << setw(8) << t+d*tabIt->gapcount[k];
                // NB DO NOT make ii size_t
             for(ii=1; ii<=k-2; ii+=2)
-               oss << " (" << t+d*(C.gapcount[ii]+1)                    // begin of gap
-                   << "," << C.gapcount[ii+1]-C.gapcount[ii]-1 << ")";   // size
+               oss << " (" << t+d*(tabIt->gapcount[ii]+1) << ","  // begin sow of gap
+                   << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
             oss << endl;
+         }
 
-               // loop over sats
-            for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+         tag = oss.str(); stripTrailing(tag,"\n");
+         FLOG(INFO) << tag;
+
+            // visibility
+         if(C.vres > 0)
+         {
+               // print visibility graphically, resolution C.vres = counts/character
+            double dn(static_cast<double>(C.vres));
+            oss.str("");
+            oss << "\nVisibility - resolution is " << dn << " epochs = " << dn*C.dt
+                << " seconds.\n";
+            oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
+                << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
+            oss << "VIS ALL ";
+            bool isOn(false);
+            for(k=0,i=0; i<gapcount.size()-1; i+=2)
             {
-               k = tabIt->gapcount.size() - 1;
-               oss << "GAP " << tabIt->sat << " " << fixed << setprecision(1)
-                   << setw(8) << t+d*tabIt->gapcount[0]
-                   << " - " << setw(8) << t+d*tabIt->gapcount[k];
-                  // NB DO NOT make ii size_t
-               for(ii=1; ii<=k-2; ii+=2)
-                  oss << " (" << t+d*(tabIt->gapcount[ii]+1) << ","  // begin sow of gap
-                      << tabIt->gapcount[ii+1]-tabIt->gapcount[ii]-1 << ")";   // size
-               oss << endl;
+               ii = int(double(gapcount[i]/dn));
+               if(ii-k > 0)
+               {
+                  oss << string(ii-k,' ');
+                  k = ii;
+                  isOn = false;
+               }
+               ii = int(double(gapcount[i+1]/dn));
+               if(ii-k > 0)
+               {
+                  if(isOn)
+                  {
+                     oss << "x";
+                     ii--;
+                  }
+                  oss << string(ii-k,'X');
+                  k = ii;
+                  isOn = true;
+               }
             }
+            FLOG(INFO) << oss.str();
 
-            tag = oss.str(); stripTrailing(tag,"\n");
-            LOG(INFO) << tag;
+               // timetable of visibility, resolution dn epochs
+               // to get resolution = 1 epoch, remove isOn, kk and //RES=1
+            multimap<int,string> vtab;
 
-               // visibility
-            if(C.vres > 0)
+               // loop over sats
+               //ostringstream ossvt;
+            for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
             {
-                  // print visibility graphically, resolution C.vres = counts/character
-               double dn(static_cast<double>(C.vres));
                oss.str("");
-               oss << "\nVisibility - resolution is " << dn << " epochs = " << dn*C.dt
-                   << " seconds.\n";
-               oss << " First epoch = " << printTime(firstObsTime,C.longfmt)
-                   << " and last epoch = " << printTime(lastObsTime,C.longfmt) << endl;
-               oss << "VIS ALL ";
-               bool isOn(false);
-               for(k=0,i=0; i<C.gapcount.size()-1; i+=2)
+               oss << "VIS " << tabIt->sat << " ";
+
+               isOn = false;
+               bool first(true);
+               int jj,kk(static_cast<int>(tabIt->gapcount[0]/dn)); // + 0.5);
+               for(k=0,i=0; i<tabIt->gapcount.size()-1; i+=2)
                {
-                  ii = int(double(C.gapcount[i]/dn));
-                  if(ii-k > 0)
+                     // satellite 'off'
+                  j = int(double(tabIt->gapcount[i]/dn));
+                  if(!first)
+                  {
+                     vtab.insert(multimap<int, string>::value_type(
+                                    kk, string("-")+asString(tabIt->sat)));
+                     kk = j;
+                  }
+                  first = false;
+                  jj = j-k;
+                  if(jj > 0)
                   {
-                     oss << string(ii-k,' ');
-                     k = ii;
                      isOn = false;
+                     oss << string(jj,' ');
+                     k = j;
                   }
-                  ii = int(double(C.gapcount[i+1]/dn));
-                  if(ii-k > 0)
+                     // satellite 'on'
+                  j = int(double(tabIt->gapcount[i+1]/dn));
+                  vtab.insert(multimap<int, string>::value_type(
+                                 kk, string("+")+asString(tabIt->sat)));
+                  kk = j;
+                  jj = j-k;
+                  if(jj > 0)
                   {
-                     if(isOn)
+                     if(!isOn)
+                     {
+                        isOn = true;
+                     }
+                     else
                      {
                         oss << "x";
-                        ii--;
+                        jj--;
                      }
-                     oss << string(ii-k,'X');
-                     k = ii;
-                     isOn = true;
+                     oss << string(jj,'X');
+                     k = j;
                   }
                }
-               LOG(INFO) << oss.str();
-
-                  // timetable of visibility, resolution dn epochs
-                  // to get resolution = 1 epoch, remove isOn, kk and //RES=1
-               multimap<int,string> vtab;
+               vtab.insert(multimap<int, string>::value_type(
+                              kk, string("-")+asString(tabIt->sat)));
+               FLOG(INFO) << oss.str();
+            }
 
-                  // loop over sats
-                  //ostringstream ossvt;
-               for(tabIt = table.begin(); tabIt != table.end(); ++tabIt)
+            if(C.vistab)
+            {
+               FLOG(INFO) << "\n Visibility Timetable - resolution is "
+                          << dn << " epochs = " << dn*C.dt << " seconds.\n"
+                          << " First epoch = " << printTime(firstObsTime,C.longfmt)
+                          << " and last epoch = " << printTime(lastObsTime,C.longfmt) << "\n"
+                          << "     YYYY/MM/DD HH:MM:SS = week d secs-of-wk Xtot count  nX  "
+                          << "seconds nsats visible satellites";
+               j = k = 0;
+               CommonTime ttag(firstObsTime);
+               vector<string> sats;
+               multimap<int,string>::const_iterator vt;
+               vt = vtab.begin();
+               while(vt != vtab.end())
                {
-                  oss.str("");
-                  oss << "VIS " << tabIt->sat << " ";
-
-                  isOn = false;
-                  bool first(true);
-                  int jj,kk(static_cast<int>(tabIt->gapcount[0]/dn)); // + 0.5);
-                  for(k=0,i=0; i<tabIt->gapcount.size()-1; i+=2)
+                  while(vt != vtab.end() && vt->first == k)
                   {
-                        // satellite 'off'
-                     j = int(double(tabIt->gapcount[i]/dn));
-                     if(!first)
-                     {
-                        vtab.insert(multimap<int, string>::value_type(
-                                       kk, string("-")+asString(tabIt->sat)));
-                        kk = j;
-                     }
-                     first = false;
-                     jj = j-k;
-                     if(jj > 0)
+                     string str(vt->second);
+                     if(str[0] == '+')
                      {
-                        isOn = false;
-                        oss << string(jj,' ');
-                        k = j;
+                           //FLOG(INFO) << "Add " << str.substr(1);
+                        sats.push_back(str.substr(1));
                      }
-                        // satellite 'on'
-                     j = int(double(tabIt->gapcount[i+1]/dn));
-                     vtab.insert(multimap<int, string>::value_type(
-                                    kk, string("+")+asString(tabIt->sat)));
-                     kk = j;
-                     jj = j-k;
-                     if(jj > 0)
+                     else
                      {
-                        if(!isOn)
-                        {
-                           isOn = true;
-                        }
-                        else
+                        vector<string>::iterator fsat;
+                        fsat = find(sats.begin(),sats.end(),str.substr(1));
+                        if(fsat != sats.end())
                         {
-                           oss << "x";
-                           jj--;
+                           sats.erase(fsat);
                         }
-                        oss << string(jj,'X');
-                        k = j;
                      }
+                     ++vt;
                   }
-                  vtab.insert(multimap<int, string>::value_type(
-                                 kk, string("-")+asString(tabIt->sat)));
-                  LOG(INFO) << oss.str();
-               }
 
-               if(C.vistab)
-               {
-                  LOG(INFO) << "\n Visibility Timetable - resolution is "
-                            << dn << " epochs = " << dn*C.dt << " seconds.\n"
-                            << " First epoch = " << printTime(firstObsTime,C.longfmt)
-                            << " and last epoch = " << printTime(lastObsTime,C.longfmt) << "\n"
-                            << "     YYYY/MM/DD HH:MM:SS = week d secs-of-wk Xtot count  nX  "
-                            << "seconds nsats visible satellites";
-                  j = k = 0;
-                  CommonTime ttag(firstObsTime);
-                  vector<string> sats;
-                  multimap<int,string>::const_iterator vt;
-                  vt = vtab.begin();
-                  while(vt != vtab.end())
-                  {
-                     while(vt != vtab.end() && vt->first == k)
-                     {
-                        string str(vt->second);
-                        if(str[0] == '+')
-                        {
-                              //LOG(INFO) << "Add " << str.substr(1);
-                           sats.push_back(str.substr(1));
-                        }
-                        else
-                        {
-                           vector<string>::iterator fsat;
-                           fsat = find(sats.begin(),sats.end(),str.substr(1));
-                           if(fsat != sats.end())
-                           {
-                              sats.erase(fsat);
-                           }
-                        }
-                        ++vt;
-                     }
+                  ttag += (k-j)*C.dt*dn;
 
-                     ttag += (k-j)*C.dt*dn;
+                  if(vt == vtab.end())
+                     break;
 
-                     if(vt == vtab.end())
-                        break;
+                  sort(sats.begin(),sats.end());
 
-                     sort(sats.begin(),sats.end());
-
-                     oss.str("");
-                     oss << "VTAB " << setw(4) << printTime(ttag,C.longfmt)
-                         << " " << setw(4) << k
-                         << " " << setw(5) << k*C.vres
-                         << " " << setw(3) << vt->first - k
-                         << fixed << setprecision(1)
-                         << " " << setw(8) << (vt->first-k)*C.dt*dn
-                         << " " << setw(5) << sats.size();
-                     for(i=0; i<sats.size(); i++) oss << " " << sats[i];
-                     LOG(INFO) << oss.str();
-
-                     j = k;
-                     k = vt->first;
-                  }
-                  LOG(INFO) << "VTAB " << setw(4) << printTime(ttag,C.longfmt)
-                            << " " << setw(4) << k
-                            << " " << setw(5) << int(0.5+(ttag-firstObsTime)/C.dt)
-                            << " END";
+                  oss.str("");
+                  oss << "VTAB " << setw(4) << printTime(ttag,C.longfmt)
+                      << " " << setw(4) << k
+                      << " " << setw(5) << k*C.vres
+                      << " " << setw(3) << vt->first - k
+                      << fixed << setprecision(1)
+                      << " " << setw(8) << (vt->first-k)*C.dt*dn
+                      << " " << setw(5) << sats.size();
+                  for(i=0; i<sats.size(); i++) oss << " " << sats[i];
+                  FLOG(INFO) << oss.str();
+
+                  j = k;
+                  k = vt->first;
                }
+               FLOG(INFO) << "VTAB " << setw(4) << printTime(ttag,C.longfmt)
+                          << " " << setw(4) << k
+                          << " " << setw(5) << int(0.5+(ttag-firstObsTime)/C.dt)
+                          << " END";
+            }
 
-            }  // end if C.vres > 0 (user chose vis output)
-         }
+         }  // end if C.vres > 0 (user chose vis output)
+      }
 
-            // output milliseconds
-         if(C.doms)
-         {
-            C.msh.afterAddbeforeFix();
+         // output milliseconds
+      if(C.doms)
+      {
+         msh.afterAddbeforeFix();
 
-               // true b/c no fixing, but false b/c editing commands follow
-            LOG(INFO) << C.msh.getFindMessage(false);
+            // true b/c no fixing, but false b/c editing commands follow
+         FLOG(INFO) << msh.getFindMessage(false);
 
-            vector<string> cmds = C.msh.getEditCommands();
-            for(i=0; i<cmds.size(); i++)
-               LOG(INFO) << cmds[i] << " # edit cmd for millisecond clock adjust";
-            LOG(INFO) << "";
-         }
+         vector<string> cmds = msh.getEditCommands();
+         for(i=0; i<cmds.size(); i++)
+            FLOG(INFO) << cmds[i] << " # edit cmd for millisecond clock adjust";
+         FLOG(INFO) << "";
+      }
 
-            // Warnings ------------------------------------------------------------
-            // there were records out of time order
-         if(cache.size() > 0)
-         {
-            for(i=0; i<cache.size(); i++)
-               LOG(INFO) << " Warning: " << setw(4) << cache[i].size()
-                         << " data records following epoch "
-                         << printTime(cachetime[i],C.calfmt) << " are out of time order,"
-                         << "\n         with epochs " << printTime(cache[i][0].time,C.calfmt)
-                         << " to " << printTime(cache[i][cache[i].size()-1].time,C.calfmt)
-                         << endl;
-         }
+         // Warnings ------------------------------------------------------------
+         // there were records out of time order
+      if(cache.size() > 0)
+      {
+         for(i=0; i<cache.size(); i++)
+            FLOG(INFO) << " Warning: " << setw(4) << cache[i].size()
+                       << " data records following epoch "
+                       << printTime(cachetime[i],C.calfmt) << " are out of time order,"
+                       << "\n         with epochs " << printTime(cache[i][0].time,C.calfmt)
+                       << " to " << printTime(cache[i][cache[i].size()-1].time,C.calfmt)
+                       << endl;
+      }
 
-         if((Rhead.valid & Rinex3ObsHeader::validInterval)
-            && fabs(dt-Rhead.interval) > 1.e-3)
-            LOG(INFO) << " Warning - Computed interval is " << setprecision(2)
-                      << dt << " sec, while input header has " << setprecision(2)
-                      << Rhead.interval << " sec.";
+      if((Rhead.valid & Rinex3ObsHeader::validInterval)
+         && fabs(dt-Rhead.interval) > 1.e-3)
+         FLOG(INFO) << " Warning - Computed interval is " << setprecision(2)
+                    << dt << " sec, while input header has " << setprecision(2)
+                    << Rhead.interval << " sec.";
 
-         if(C.beginTime == CommonTime::BEGINNING_OF_TIME
-            && fabs(firstObsTime-Rhead.firstObs) > 1.e-8)
-            LOG(INFO) << " Warning - Computed first time does not agree with header";
+      if(C.beginTime == CommonTime::BEGINNING_OF_TIME
+         && fabs(firstObsTime-Rhead.firstObs) > 1.e-8)
+         FLOG(INFO) << " Warning - Computed first time does not agree with header";
 
-         if(C.endTime == CommonTime::END_OF_TIME
-            && (Rhead.valid & Rinex3ObsHeader::validLastTime)
-            && fabs(lastObsTime-Rhead.lastObs) > 1.e-8)
-            LOG(INFO) << " Warning - Computed last time does not agree with header";
+      if(C.endTime == CommonTime::END_OF_TIME
+         && (Rhead.valid & Rinex3ObsHeader::validLastTime)
+         && fabs(lastObsTime-Rhead.lastObs) > 1.e-8)
+         FLOG(INFO) << " Warning - Computed last time does not agree with header";
 
-            // look for empty systems
-         for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
-         {
-            map<char,vector<int> >::const_iterator totIt(totals.find(sit->first[0]));
-            const vector<int>& vec(totIt->second);
-            for(i=0,k=0; k<vec.size(); k++)
-               i += vec[k];
-            if(i == 0)
-            {
-               RinexSatID sat(sit->first);
-               if( (find(C.exSats.begin(), C.exSats.end(),
-                         RinexSatID(-1,sat.system)) == C.exSats.end()) // sys not excluded
-                   &&
-                   (C.onlySats.size() > 0 &&
-                    find(C.onlySats.begin(), C.onlySats.end(), // only system
-                         RinexSatID(-1,sat.system)) != C.onlySats.end()) )
-                  LOG(INFO) << " Warning - System " << sit->first << " = "
-                            << sat.systemString() << " should be removed from the header.";
-            }
-         }
-      
-            // look for obs types that are completely empty
-            // sit declared above map<std::string,vector<RinexObsID> >::const_iterator sit;
-         for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+         // look for empty systems
+      for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+      {
+         map<char,vector<int> >::const_iterator totIt(totals.find(sit->first[0]));
+         const vector<int>& vec(totIt->second);
+         for(i=0,k=0; k<vec.size(); k++)
+            i += vec[k];
+         if(i == 0)
          {
-               // loop over obs types in header - systems first
             RinexSatID sat(sit->first);
-            map<char, vector<int> >::const_iterator totalsIter;
-            totalsIter = totals.find((sit->first)[0]);
+            if( (find(C.exSats.begin(), C.exSats.end(),
+                      RinexSatID(-1,sat.system)) == C.exSats.end()) // sys not excluded
+                &&
+                (C.onlySats.size() > 0 &&
+                 find(C.onlySats.begin(), C.onlySats.end(), // only system
+                      RinexSatID(-1,sat.system)) != C.onlySats.end()) )
+               FLOG(INFO) << " Warning - System " << sit->first << " = "
+                          << sat.systemString() << " should be removed from the header.";
+         }
+      }
+   
+         // look for obs types that are completely empty
+         // sit declared above map<std::string,vector<RinexObsID> >::const_iterator sit;
+      for(sit=Rhead.mapObsTypes.begin(); sit != Rhead.mapObsTypes.end(); ++sit)
+      {
+            // loop over obs types in header - systems first
+         RinexSatID sat(sit->first);
+         map<char, vector<int> >::const_iterator totalsIter;
+         totalsIter = totals.find((sit->first)[0]);
 
-               // this vector is printed after "TOTAL" above
-            const vector<int>& totvec = totalsIter->second;
+            // this vector is printed after "TOTAL" above
+         const vector<int>& totvec = totalsIter->second;
 
-               // compute grand total first - skip if this system has no data at all
-            for(i=0,k=0; k<totvec.size(); k++) i += totvec[k];
-            if(i == 0)
-               continue;
+            // compute grand total first - skip if this system has no data at all
+         for(i=0,k=0; k<totvec.size(); k++) i += totvec[k];
+         if(i == 0)
+            continue;
 
-            for(k=0; k<totvec.size(); k++)
+         for(k=0; k<totvec.size(); k++)
+         {
+            if(totvec[k] == 0)
             {
-               if(totvec[k] == 0)
+               tag = string();
+               if(Rhead.version < 3)
                {
-                  tag = string();
-                  if(Rhead.version < 3)
+                  map<string,RinexObsID>::iterator it;
+                  for(it = Rhead.mapSysR2toR3ObsID[sit->first].begin();
+                      it != Rhead.mapSysR2toR3ObsID[sit->first].end(); ++it)
                   {
-                     map<string,RinexObsID>::iterator it;
-                     for(it = Rhead.mapSysR2toR3ObsID[sit->first].begin();
-                         it != Rhead.mapSysR2toR3ObsID[sit->first].end(); ++it)
+                     if(it->second == sit->second[k])
                      {
-                        if(it->second == sit->second[k])
-                        {
-                           tag = string(", ") + it->first + string(" in ver.2");
-                           break;
-                        }
+                        tag = string(", ") + it->first + string(" in ver.2");
+                        break;
                      }
                   }
-                  LOG(INFO) << " Warning - Obs type "
-                            << sit->first << asString((sit->second)[k])
-                            << " (" << sat.systemString()
-                            << " " << asString((sit->second)[k]) << tag
-                            << ") should be removed from header";
                }
+               FLOG(INFO) << " Warning - Obs type "
+                          << sit->first << asString((sit->second)[k])
+                          << " (" << sat.systemString()
+                          << " " << asString((sit->second)[k]) << tag
+                          << ") should be removed from header";
             }
          }
-         
-            // failure due to critical error
-         if(iret < 0)
-            break;
-
-         if(iret == 0)
-            nfiles++;
-
-      }  // end loop over files
-
-      if(iret < 0)
-         return iret;
+      }
 
-      return nfiles;
+      S.iret = iret;
+      return iret;
    }
    catch(Exception& e)
    {
       GPSTK_RETHROW(e);
    }
-}  // end ProcessFiles()
+}  // end SummarizeFile()
 
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -0,0 +1,312 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+#ifndef STREAMMERGE_HPP
+#define STREAMMERGE_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "CommonTime.hpp"
+#include "Exception.hpp"
+#include "SystemTime.hpp"
+
+/// Merges sorted files record by record, keeping one record per input file
+/// in memory. The next record written is always the least of these, found
+/// with a heap over the inputs, so the output is sorted and memory does not
+/// grow with the amount of data. Records equal to the last one written are
+/// dropped, as std::unique() does on a sorted list.
+///
+/// Inputs must already be sorted by the LessThan used. A file found out of
+/// order while streaming causes an exception, unless the constructor was
+/// asked to check the inputs first; then each unsorted file is read and
+/// sorted in memory by itself, and only those files cost memory.
+///
+/// Use: construct, touchHeader() to merge the headers, start() with the
+/// record ordering, write the merged header, then write() the data.
+template <class FileStream, class FileHeader, class FileData, class LessThan>
+class StreamMerge
+{
+public:
+      /// Open the files and read their headers.
+      /// @param files list of input file names, in priority order for ties
+      /// @param checkOrder read each file once before merging, and sort in
+      ///   memory those that are out of order
+      /// @throw gpstk::Exception if a file cannot be opened; the files
+      ///   already opened are closed first
+   StreamMerge(const std::vector<std::string>& files, bool checkOrder = false)
+      throw(gpstk::Exception)
+         : checkOrder(checkOrder), lt(0), nRead(0), nWritten(0), nDuplicates(0),
+           nBytes(0), startTime(gpstk::SystemTime().convertToCommonTime())
+   {
+      try
+      {
+         for (size_t i = 0; i < files.size(); i++)
+         {
+            sources.push_back(Source());
+            Source& src = sources.back();
+            src.fileName = files[i];
+            src.stream = new FileStream(files[i].c_str());
+            if (!src.stream->good())
+            {
+               gpstk::Exception e("Unable to open " + files[i]);
+               GPSTK_THROW(e);
+            }
+            *src.stream >> src.header;
+
+            std::ifstream sz(files[i].c_str(), std::ios::in|std::ios::ate);
+            if (sz)
+               nBytes += sz.tellg();
+         }
+      }
+      catch (...)
+      {
+            // the destructor is not run for a partly constructed object
+         release();
+         throw;
+      }
+   }
+
+   ~StreamMerge()
+   { release(); }
+
+      /// Apply a header functor (e.g. a *HeaderTouchHeaderMerge) to the
+      /// header of each file, in order.
+   template <class HeaderTouch>
+   void touchHeader(HeaderTouch& ht)
+   {
+      for (size_t i = 0; i < sources.size(); i++)
+         ht(sources[i].header);
+   }
+
+      /// Read the first record of each file and order the files.
+      /// @throw gpstk::Exception if checking the order of a file fails
+   void start(const LessThan& less) throw(gpstk::Exception)
+   {
+      delete lt;
+      lt = new LessThan(less);
+      heap.clear();
+      for (size_t i = 0; i < sources.size(); i++)
+      {
+         if (checkOrder && !isSorted(sources[i].fileName))
+         {
+               // sort this file in memory, like FileFilterFrame would
+            FileData data;
+            while (*sources[i].stream >> data)
+               sources[i].run.push_back(data);
+            sources[i].run.sort(*lt);
+            sources[i].inMemory = true;
+         }
+         if (next(i))
+            heap.push_back(i);
+      }
+      std::make_heap(heap.begin(), heap.end(), HeapOrder(*this));
+   }
+
+      /// True when every record has been written.
+   bool empty() const
+   { return heap.empty(); }
+
+      /// The next record to be written; call start() first, and only if
+      /// !empty().
+   const FileData& front() const
+   { return sources[heap.front()].current; }
+
+      /// Write the remaining records to out, dropping those for which equal
+      /// is true against the previous record written. Returns the number
+      /// of records written.
+   template <class Equal>
+   unsigned long write(FileStream& out, Equal equal) throw(gpstk::Exception)
+   {
+      HeapOrder order(*this);
+      FileData last;
+      bool haveLast(false);
+      unsigned long n(0);
+      while (!heap.empty())
+      {
+         std::pop_heap(heap.begin(), heap.end(), order);
+         size_t i = heap.back();
+         Source& src = sources[i];
+
+         if (haveLast && equal(last, src.current))
+            nDuplicates++;
+         else
+         {
+            out << src.current;
+            last = src.current;
+            haveLast = true;
+            n++;
+         }
+
+         if (next(i))
+            std::push_heap(heap.begin(), heap.end(), order);
+         else
+            heap.pop_back();
+      }
+      nWritten += n;
+      return n;
+   }
+
+      /// Number of records read, written, and dropped as duplicates.
+   unsigned long recordsRead() const { return nRead; }
+   unsigned long recordsWritten() const { return nWritten; }
+   unsigned long duplicates() const { return nDuplicates; }
+
+      /// Total size in bytes of the input files.
+   unsigned long long bytes() const { return nBytes; }
+
+      /// Print the record counts, the time since construction and the
+      /// throughput, as the tools do with -v.
+   void dumpStats(std::ostream& s) const
+   {
+      double dt = gpstk::SystemTime().convertToCommonTime() - startTime;
+      std::ios::fmtflags flags(s.flags());
+      std::streamsize prec(s.precision());
+      s << "Merged " << nRead << " records from " << sources.size()
+        << " files (" << nBytes << " bytes) into " << nWritten
+        << " records, dropping " << nDuplicates << " duplicates, in "
+        << std::fixed << std::setprecision(3) << dt << " s";
+      if (dt > 0)
+         s << " (" << std::setprecision(0) << nRead/dt << " records/s, "
+           << std::setprecision(2) << nBytes/dt/1.e6 << " MB/s)";
+      s << std::endl;
+      s.flags(flags);
+      s.precision(prec);
+   }
+
+private:
+      // the streams are owned, so a copy would delete them twice
+   StreamMerge(const StreamMerge&);
+   StreamMerge& operator=(const StreamMerge&);
+
+      /// Close the files and free the ordering.
+   void release()
+   {
+      for (size_t i = 0; i < sources.size(); i++)
+         delete sources[i].stream;
+      sources.clear();
+      delete lt;
+      lt = 0;
+   }
+
+   struct Source
+   {
+      Source() : stream(0), started(false), inMemory(false) {}
+      std::string fileName;
+      FileStream *stream;
+      FileHeader header;
+      FileData current;
+      bool started;                 ///< current holds a record
+      bool inMemory;                ///< records come from run, not stream
+      std::list<FileData> run;
+   };
+
+      /// Heap ordering: the least record on top; ties go to the earlier file.
+   struct HeapOrder
+   {
+      HeapOrder(const StreamMerge& sm) : sm(sm) {}
+      bool operator()(size_t a, size_t b) const
+      {
+         const FileData& ra = sm.sources[a].current;
+         const FileData& rb = sm.sources[b].current;
+         if ((*sm.lt)(rb, ra)) return true;
+         if ((*sm.lt)(ra, rb)) return false;
+         return b < a;
+      }
+      const StreamMerge& sm;
+   };
+
+      /// Advance file i to its next record; false at the end of the file.
+   bool next(size_t i) throw(gpstk::Exception)
+   {
+      Source& src = sources[i];
+      if (src.inMemory)
+      {
+         if (src.run.empty())
+            return false;
+         src.current = src.run.front();
+         src.run.pop_front();
+         nRead++;
+         return true;
+      }
+
+      FileData data;
+      if (!(*src.stream >> data))
+         return false;
+      nRead++;
+
+      if (src.started && (*lt)(data, src.current))
+      {
+         gpstk::Exception e(src.fileName + " is not sorted by time");
+         GPSTK_THROW(e);
+      }
+      src.current = data;
+      src.started = true;
+      return true;
+   }
+
+      /// Read a file through once, checking that it is sorted.
+   bool isSorted(const std::string& fileName) const
+   {
+      FileStream s(fileName.c_str());
+      FileHeader h;
+      FileData prev, data;
+      if (!(s >> h) || !(s >> prev))
+         return true;
+      while (s >> data)
+      {
+         if ((*lt)(data, prev))
+            return false;
+         prev = data;
+      }
+      return true;
+   }
+
+   bool checkOrder;
+   LessThan *lt;
+   std::vector<Source> sources;
+   std::vector<size_t> heap;
+   unsigned long nRead, nWritten, nDuplicates;
+   unsigned long long nBytes;
+   gpstk::CommonTime startTime;
+};
+
+#endif
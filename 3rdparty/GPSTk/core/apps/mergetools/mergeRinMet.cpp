@@ -41,11 +41,12 @@
 #include "RinexMetHeader.hpp"
 #include "RinexMetData.hpp"
 #include "RinexMetFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "FileUtils.hpp"
 #include "CivilTime.hpp"
 #include "SystemTime.hpp"
 
 #include "MergeFrame.hpp"
+#include "StreamMerge.hpp"
 
 using namespace std;
 using namespace gpstk;
@@ -67,27 +68,37 @@ void MergeRinMet::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the data using
-      // a simple time check
-   FileFilterFrameWithHeader<RinexMetStream, RinexMetData, RinexMetHeader> 
-      fff(files);
+      // open the files and read their headers; the data is merged one
+      // record at a time as it is written
+   StreamMerge<RinexMetStream, RinexMetHeader, RinexMetData,
+               RinexMetDataOperatorLessThanFull> sm(files);
 
       // get the header data
    RinexMetHeaderTouchHeaderMerge merged;
-   fff.touchHeader(merged);
+   sm.touchHeader(merged);
+
+      // read the first record of each file; duplicates are removed as the
+      // data is written
+   sm.start(RinexMetDataOperatorLessThanFull(merged.obsSet));
 
-      // sort and filter the data
-   fff.sort(RinexMetDataOperatorLessThanFull(merged.obsSet));
-   fff.unique(RinexMetDataOperatorEqualsSimple());
-   
       // set the pgm/runby/date field
    merged.theHeader.fileProgram = std::string("mergeRinMet");
    merged.theHeader.fileAgency = std::string("gpstk");
    merged.theHeader.date = CivilTime(SystemTime()).asString();
 
-      // write the header
+      // write the file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+   RinexMetStream out(outputFile.c_str(), std::ios::out|std::ios::trunc);
+   out.exceptions(std::ios::failbit);
+   out << merged.theHeader;
+   sm.write(out, RinexMetDataOperatorEqualsSimple());
+
+   if (verboseLevel)
+      sm.dumpStats(cout);
 }
 
 int main(int argc, char* argv[])
@@ -38,11 +38,12 @@
 #include "RinexNavHeader.hpp"
 #include "RinexNavData.hpp"
 #include "RinexNavFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "FileUtils.hpp"
 #include "SystemTime.hpp"
 #include "CivilTime.hpp"
 
 #include "MergeFrame.hpp"
+#include "StreamMerge.hpp"
 
 using namespace std;
 using namespace gpstk;
@@ -64,19 +65,19 @@ void MergeRinNav::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
-      // a simple time check
-   FileFilterFrameWithHeader<RinexNavStream, RinexNavData, RinexNavHeader> 
-      fff(files);
+      // open the files and read their headers; the data is merged one
+      // record at a time as it is written
+   StreamMerge<RinexNavStream, RinexNavHeader, RinexNavData,
+               RinexNavDataOperatorLessThanFull> sm(files, true);
 
       // get the header data
    RinexNavHeaderTouchHeaderMerge merged;
-   fff.touchHeader(merged);
+   sm.touchHeader(merged);
+
+      // read the first record of each file; duplicates are removed as the
+      // data is written
+   sm.start(RinexNavDataOperatorLessThanFull());
 
-      // sort and filter the data
-   fff.sort(RinexNavDataOperatorLessThanFull());
-   fff.unique(RinexNavDataOperatorEqualsFull());
-   
       // set the pgm/runby/date field
    merged.theHeader.fileType = string("NAVIGATION");
    merged.theHeader.fileProgram = std::string("mergeRinNav");
@@ -88,9 +89,19 @@ void MergeRinNav::process()
    merged.theHeader.valid |= gpstk::RinexNavHeader::commentValid;
    merged.theHeader.valid |= gpstk::RinexNavHeader::endValid;
 
-      // write the header
+      // write the file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+   RinexNavStream out(outputFile.c_str(), std::ios::out|std::ios::trunc);
+   out.exceptions(std::ios::failbit);
+   out << merged.theHeader;
+   sm.write(out, RinexNavDataOperatorEqualsFull());
+
+   if (verboseLevel)
+      sm.dumpStats(cout);
 }
 
 int main(int argc, char* argv[])
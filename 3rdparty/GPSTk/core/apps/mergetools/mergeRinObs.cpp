@@ -41,11 +41,12 @@
 #include "RinexObsHeader.hpp"
 #include "RinexObsData.hpp"
 #include "RinexObsFilterOperators.hpp"
-#include "FileFilterFrameWithHeader.hpp"
+#include "FileUtils.hpp"
 #include "SystemTime.hpp"
 #include "CivilTime.hpp"
 
 #include "MergeFrame.hpp"
+#include "StreamMerge.hpp"
 
 using namespace std;
 using namespace gpstk;
@@ -67,21 +68,22 @@ void MergeRinObs::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
-      // FFF will sort and merge the obs data using
-      // a simple time check
-   FileFilterFrameWithHeader<RinexObsStream, RinexObsData, RinexObsHeader> 
-      fff(files);
+      // open the files and read their headers; the data is merged one
+      // record at a time as it is written
+   StreamMerge<RinexObsStream, RinexObsHeader, RinexObsData,
+               RinexObsDataOperatorLessThanFull> sm(files);
 
       // get the header data
    RinexObsHeaderTouchHeaderMerge merged;
-   fff.touchHeader(merged);
+   sm.touchHeader(merged);
+
+      // read the first record of each file; duplicates are removed as the
+      // data is written
+   sm.start(RinexObsDataOperatorLessThanFull(merged.obsSet));
 
-      // sort and filter the data using the obs set from the merged header
-   fff.sort(RinexObsDataOperatorLessThanFull(merged.obsSet));
-   fff.unique(RinexObsDataOperatorEqualsSimple());
-   
       // set the time of first obs in the header
-   merged.theHeader.firstObs = fff.front().time;
+   if (!sm.empty())
+      merged.theHeader.firstObs = sm.front().time;
 
       // set the pgm/runby/date field
    merged.theHeader.fileProgram = std::string("mergeRinObs");
@@ -90,7 +92,17 @@ void MergeRinObs::process()
 
       // write the file
    std::string outputFile = outputFileOption.getValue().front();
-   fff.writeFile(outputFile, merged.theHeader);
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+   RinexObsStream out(outputFile.c_str(), std::ios::out|std::ios::trunc);
+   out.exceptions(std::ios::failbit);
+   out << merged.theHeader;
+   sm.write(out, RinexObsDataOperatorEqualsSimple());
+
+   if (verboseLevel)
+      sm.dumpStats(cout);
 }
 
 int main(int argc, char* argv[])
@@ -38,6 +38,10 @@
 #include "YDSTime.hpp"
 #include "NeillTropModel.hpp"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define THROW_IF_INVALID_DETAILED() {if (!valid) {                 \
          InvalidTropModel e;                                            \
          if(!validHeight) e.addText("Invalid trop model: Rx Height");   \
@@ -94,6 +98,9 @@ namespace gpstk
    NeillTropModel::NeillTropModel( const Position& RX,
                                    const CommonTime& time )
    {
+      validHeight = false;
+      validLat = false;
+      validDOY = false;
       setReceiverHeight(RX.getAltitude());
       setReceiverLatitude(RX.getGeodeticLatitude( ));
       setDayOfYear(time);
@@ -356,6 +363,54 @@ namespace gpstk
          return 0.0;
       }
 
+      double a, b, c;
+      dry_coefficients(a, b, c);
+
+      double se = ::sin(elevation*DEG_TO_RAD);
+      double map = (1.+a/(1.+b/(1.+c)))/(se+a/(se+b/(se+c)));
+
+      a = 0.0000253;
+      b = 0.00549;
+      c = 0.00114;
+      map += ( NeillHeight/1000.0 ) *
+         ( 1./se - ( (1.+a/(1.+b/(1.+c))) / (se+a/(se+b/(se+c))) ) );
+
+      return map;
+   }
+
+
+      // Compute and return the mapping function for wet component of the
+      // troposphere.
+      //
+      // @param elevation Elevation of satellite as seen at receiver,
+      //                  in degrees.
+   double NeillTropModel::wet_mapping_function(double elevation) const
+      throw(InvalidTropModel)
+   {
+      THROW_IF_INVALID_DETAILED();
+
+      if(elevation < 3.0)
+      {
+         return 0.0;
+      }
+
+      double a, b, c;
+      wet_coefficients(a, b, c);
+
+      double se = ::sin(elevation*DEG_TO_RAD);
+      double map = ( 1.+ a/ (1.+ b/(1.+c) ) ) / (se + a/(se + b/(se+c) ) );
+
+      return map;
+
+   }  // end NeillTropModel::wet_mapping_function()
+
+
+      // Compute the coefficients of the dry mapping function, which depend
+      // on latitude and day of year.
+   void NeillTropModel::dry_coefficients( double& a,
+                                          double& b,
+                                          double& c ) const
+   {
       double lat, t, ct;
       lat = fabs(NeillLat);         // degrees
       t = static_cast<double>(NeillDOY) - 28.0;  // mid-winter
@@ -368,7 +423,6 @@ namespace gpstk
       t *= 360.0/365.25;            // convert to degrees
       ct = ::cos(t*DEG_TO_RAD);
 
-      double a, b, c;
       if(lat < 15.0)
       {
          a = NeillDryA[0];
@@ -393,36 +447,16 @@ namespace gpstk
          b = NeillDryB[4] - ct * NeillDryB1[4];
          c = NeillDryC[4] - ct * NeillDryC1[4];
       }
-
-      double se = ::sin(elevation*DEG_TO_RAD);
-      double map = (1.+a/(1.+b/(1.+c)))/(se+a/(se+b/(se+c)));
-
-      a = 0.0000253;
-      b = 0.00549;
-      c = 0.00114;
-      map += ( NeillHeight/1000.0 ) *
-         ( 1./se - ( (1.+a/(1.+b/(1.+c))) / (se+a/(se+b/(se+c))) ) );
-
-      return map;
    }
 
 
-      // Compute and return the mapping function for wet component of the
-      // troposphere.
-      //
-      // @param elevation Elevation of satellite as seen at receiver,
-      //                  in degrees.
-   double NeillTropModel::wet_mapping_function(double elevation) const
-      throw(InvalidTropModel)
+      // Compute the coefficients of the wet mapping function, which depend
+      // on latitude.
+   void NeillTropModel::wet_coefficients( double& a,
+                                          double& b,
+                                          double& c ) const
    {
-      THROW_IF_INVALID_DETAILED();
-
-      if(elevation < 3.0)
-      {
-         return 0.0;
-      }
-
-      double a,b,c,lat;
+      double lat;
       lat = fabs(NeillLat);         // degrees
       if(lat < 15.0)
       {
@@ -444,13 +478,126 @@ namespace gpstk
          b = NeillWetB[4];
          c = NeillWetC[4];
       }
+   }
 
-      double se = ::sin(elevation*DEG_TO_RAD);
-      double map = ( 1.+ a/ (1.+ b/(1.+c) ) ) / (se + a/(se + b/(se+c) ) );
 
-      return map;
+      // Compute the full delay and the dry and wet mapping functions for an
+      // array of elevations. The coefficients and zenith delays are computed
+      // once, and the mapping functions are evaluated two elevations at a
+      // time with SSE2 when it is available. The results equal those of the
+      // scalar methods.
+      //
+      // @param elevation Elevations of satellites as seen at receiver, in
+      //                  degrees
+      // @param corr      Full tropospheric delays, in meters
+      // @param dryMap    Dry mapping functions
+      // @param wetMap    Wet mapping functions
+   void NeillTropModel::batch_correction( const std::vector<double>& elevation,
+                                          std::vector<double>& corr,
+                                          std::vector<double>& dryMap,
+                                          std::vector<double>& wetMap ) const
+      throw(InvalidTropModel)
+   {
+      THROW_IF_INVALID_DETAILED();
 
-   }  // end NeillTropModel::wet_mapping_function()
+      const size_t n(elevation.size());
+      corr.resize(n);
+      dryMap.resize(n);
+      wetMap.resize(n);
+
+      if(n == 0)
+      {
+         return;
+      }
+
+      double da, db, dc, wa, wb, wc;
+      dry_coefficients(da, db, dc);
+      wet_coefficients(wa, wb, wc);
+
+         // height correction coefficients of the dry mapping function
+      const double ha(0.0000253), hb(0.00549), hc(0.00114);
+      const double hfac( NeillHeight/1000.0 );
+
+      const double dnum( 1.+da/(1.+db/(1.+dc)) );
+      const double wnum( 1.+wa/(1.+wb/(1.+wc)) );
+      const double hnum( 1.+ha/(1.+hb/(1.+hc)) );
+
+      const double dzd( NeillTropModel::dry_zenith_delay() );
+      const double wzd( NeillTropModel::wet_zenith_delay() );
+
+         // sines of the elevations, kept in dryMap until overwritten
+      double *se = &dryMap[0];
+      for(size_t i = 0; i < n; i++)
+      {
+         se[i] = ::sin(elevation[i]*DEG_TO_RAD);
+      }
+
+      size_t i(0);
+
+#ifdef __SSE2__
+      const __m128d vdnum(_mm_set1_pd(dnum)), vwnum(_mm_set1_pd(wnum));
+      const __m128d vhnum(_mm_set1_pd(hnum)), vhfac(_mm_set1_pd(hfac));
+      const __m128d vda(_mm_set1_pd(da)), vdb(_mm_set1_pd(db));
+      const __m128d vdc(_mm_set1_pd(dc));
+      const __m128d vwa(_mm_set1_pd(wa)), vwb(_mm_set1_pd(wb));
+      const __m128d vwc(_mm_set1_pd(wc));
+      const __m128d vha(_mm_set1_pd(ha)), vhb(_mm_set1_pd(hb));
+      const __m128d vhc(_mm_set1_pd(hc));
+      const __m128d vdzd(_mm_set1_pd(dzd)), vwzd(_mm_set1_pd(wzd));
+      const __m128d one(_mm_set1_pd(1.0)), elmin(_mm_set1_pd(3.0));
+
+      for( ; i+2 <= n; i += 2)
+      {
+         __m128d s( _mm_loadu_pd(se+i) );
+
+            // elevations below 3 degrees give zero
+         __m128d low( _mm_cmplt_pd(_mm_loadu_pd(&elevation[i]), elmin) );
+
+         __m128d dry( _mm_div_pd(vdnum,
+            _mm_add_pd(s, _mm_div_pd(vda,
+               _mm_add_pd(s, _mm_div_pd(vdb, _mm_add_pd(s, vdc)))))) );
+
+         __m128d hgt( _mm_sub_pd(_mm_div_pd(one, s),
+            _mm_div_pd(vhnum,
+               _mm_add_pd(s, _mm_div_pd(vha,
+                  _mm_add_pd(s, _mm_div_pd(vhb, _mm_add_pd(s, vhc))))))) );
+
+         dry = _mm_add_pd(dry, _mm_mul_pd(vhfac, hgt));
+
+         __m128d wet( _mm_div_pd(vwnum,
+            _mm_add_pd(s, _mm_div_pd(vwa,
+               _mm_add_pd(s, _mm_div_pd(vwb, _mm_add_pd(s, vwc)))))) );
+
+         dry = _mm_andnot_pd(low, dry);
+         wet = _mm_andnot_pd(low, wet);
+
+         _mm_storeu_pd(&dryMap[i], dry);
+         _mm_storeu_pd(&wetMap[i], wet);
+         _mm_storeu_pd(&corr[i],
+                       _mm_add_pd(_mm_mul_pd(vdzd, dry),
+                                  _mm_mul_pd(vwzd, wet)));
+      }
+#endif
+
+      for( ; i < n; i++)
+      {
+         if(elevation[i] < 3.0)
+         {
+            dryMap[i] = wetMap[i] = corr[i] = 0.0;
+            continue;
+         }
+
+         double s( se[i] );
+         double dry( dnum/(s+da/(s+db/(s+dc))) );
+         dry += hfac * ( 1./s - ( hnum / (s+ha/(s+hb/(s+hc))) ) );
+         double wet( wnum/(s+wa/(s+wb/(s+wc))) );
+
+         dryMap[i] = dry;
+         wetMap[i] = wet;
+         corr[i] = dzd*dry + wzd*wet;
+      }
+
+   }  // end NeillTropModel::batch_correction()
 
 
       // This method configure the model to estimate the weather using height,
@@ -97,7 +97,7 @@ namespace gpstk
          /// @param ht   Height of the receiver above mean sea level, in
          ///             meters.
       NeillTropModel(const double& ht)
-      { setReceiverHeight(ht); };
+      { validLat=false; validDOY=false; setReceiverHeight(ht); };
 
 
          /// Constructor to create a Neill trop model providing the height of
@@ -111,7 +111,8 @@ namespace gpstk
       NeillTropModel( const double& ht,
                       const double& lat,
                       const int& doy )
-      { setReceiverHeight(ht); setReceiverLatitude(lat); setDayOfYear(doy); };
+      { validHeight=false; validLat=false; validDOY=false;
+        setReceiverHeight(ht); setReceiverLatitude(lat); setDayOfYear(doy); };
 
 
          /// Constructor to create a Neill trop model providing the position
@@ -278,6 +279,23 @@ namespace gpstk
          throw(InvalidTropModel);
 
 
+         /// Compute the full delay and the dry and wet mapping functions for
+         /// an array of elevations. The coefficients, which depend on
+         /// height, latitude and day of year, and the zenith delays are
+         /// computed only once for all the elevations.
+         ///
+         /// @param elevation Elevations of satellites as seen at receiver,
+         ///                  in degrees
+         /// @param corr      Full tropospheric delays, in meters
+         /// @param dryMap    Dry mapping functions
+         /// @param wetMap    Wet mapping functions
+      virtual void batch_correction( const std::vector<double>& elevation,
+                                     std::vector<double>& corr,
+                                     std::vector<double>& dryMap,
+                                     std::vector<double>& wetMap ) const
+         throw(InvalidTropModel);
+
+
          /// This method configure the model to estimate the weather using
          /// height, latitude and day of year (DOY). It is called
          /// automatically when setting those parameters.
@@ -338,6 +356,13 @@ namespace gpstk
 
 
    private:
+
+         /// Coefficients a, b, c of the dry mapping function
+      void dry_coefficients(double& a, double& b, double& c) const;
+
+         /// Coefficients a, b, c of the wet mapping function
+      void wet_coefficients(double& a, double& b, double& c) const;
+
       double NeillHeight;
       double NeillLat;
       int NeillDOY;
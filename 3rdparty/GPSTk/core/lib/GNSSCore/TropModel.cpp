@@ -70,6 +70,32 @@ namespace gpstk
 
    }  // end TropModel::correction(elevation)
 
+      // Compute the full delay and the dry and wet mapping functions for an
+      // array of elevations, all with the current model parameters.
+      // @param elevation Elevations of satellites as seen at receiver, in degrees
+      // @param corr      Full tropospheric delays, in meters
+      // @param dryMap    Dry mapping functions
+      // @param wetMap    Wet mapping functions
+   void TropModel::batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& corr,
+                                    std::vector<double>& dryMap,
+                                    std::vector<double>& wetMap) const
+      throw(InvalidTropModel)
+   {
+      const size_t n(elevation.size());
+      corr.resize(n);
+      dryMap.resize(n);
+      wetMap.resize(n);
+
+      for(size_t i = 0; i < n; i++)
+      {
+         corr[i] = correction(elevation[i]);
+         dryMap[i] = dry_mapping_function(elevation[i]);
+         wetMap[i] = wet_mapping_function(elevation[i]);
+      }
+
+   }  // end TropModel::batch_correction()
+
       // Compute and return the full tropospheric delay, given the positions of
       // receiver and satellite and the time tag. This version is most useful
       // within positioning algorithms, where the receiver position and timetag may
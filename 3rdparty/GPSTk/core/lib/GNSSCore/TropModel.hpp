@@ -43,6 +43,7 @@
 #ifndef TROP_MODEL_HPP
 #define TROP_MODEL_HPP
 
+#include <vector>
 #include "Exception.hpp"
 #include "ObsEpochMap.hpp"
 #include "WxObsMap.hpp"
@@ -170,6 +171,23 @@ namespace gpstk
       virtual double wet_mapping_function(double elevation)
          const throw(InvalidTropModel) = 0;
 
+         /// Compute the full delay and the dry and wet mapping functions for
+         /// an array of elevations, all with the current model parameters.
+         /// Each output is resized to the number of elevations, and element
+         /// i equals correction(), dry_mapping_function() and
+         /// wet_mapping_function() of elevation[i]. Models may override this
+         /// to compute the station and epoch dependent terms only once.
+         /// @param elevation Elevations of satellites as seen at receiver,
+         ///                  in degrees
+         /// @param corr      Full tropospheric delays, in meters
+         /// @param dryMap    Dry mapping functions
+         /// @param wetMap    Wet mapping functions
+      virtual void batch_correction(const std::vector<double>& elevation,
+                                    std::vector<double>& corr,
+                                    std::vector<double>& dryMap,
+                                    std::vector<double>& wetMap) const
+         throw(InvalidTropModel);
+
          /// Re-define the tropospheric model with explicit weather data.
          /// Typically called just before correction().
          /// @param T temperature in degrees Celsius
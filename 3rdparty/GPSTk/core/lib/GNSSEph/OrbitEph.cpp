@@ -240,6 +240,153 @@ namespace gpstk {
       return sv;
    }
 
+   // Compute positions of many satellites at the given time. This follows
+   // svXvt() step for step, but each step runs over all satellites before
+   // the next one starts, on elements gathered into contiguous arrays.
+   unsigned OrbitEph::svXvt(const vector<const OrbitEph*>& ephs,
+                            const CommonTime& t, XvtArrays& xvt)
+   {
+      const size_t N(ephs.size());
+      xvt.resize(N);
+
+      // lanes are the satellites that can be computed
+      vector<size_t> lane;
+      lane.reserve(N);
+      for(size_t i=0; i<N; i++)
+         if(ephs[i] && ephs[i]->dataLoadedFlag) lane.push_back(i);
+      const size_t n(lane.size());
+      if(n == 0) return 0;
+
+      GPSEllipsoid ell;
+      const double sqrtgm = SQRT(ell.gm());
+      const double twoPI = 2.0e0 * PI;
+      const double omegaE = ell.angVelocity();
+
+      // gather the elements, and the times since Toe and Toc
+      vector<double> elapte(n), elaptc(n), ToeSOW(n), Ahalf(n), Ak(n), amm(n);
+      vector<double> meana(n), lecc(n), w(n), i0(n), idot(n);
+      vector<double> OMEGA0(n), OMEGAdot(n), Cuc(n), Cus(n), Crc(n), Crs(n);
+      vector<double> Cic(n), Cis(n);
+      size_t k;
+      for(k=0; k<n; k++) {
+         const OrbitEph& eph(*ephs[lane[k]]);
+         elapte[k] = t - eph.ctToe;
+         elaptc[k] = t - eph.ctToc;
+         ToeSOW[k] = GPSWeekSecond(eph.ctToe).sow;
+         Ahalf[k] = SQRT(eph.A);
+         Ak[k] = eph.A + eph.Adot * elapte[k];
+         amm[k] = (sqrtgm / (eph.A*Ahalf[k])) + (eph.dn + 0.5*eph.dndot*elapte[k]);
+         meana[k] = eph.M0 + elapte[k] * amm[k];
+         lecc[k] = eph.ecc;
+         w[k] = eph.w;
+         i0[k] = eph.i0;
+         idot[k] = eph.idot;
+         OMEGA0[k] = eph.OMEGA0;
+         OMEGAdot[k] = eph.OMEGAdot;
+         Cuc[k] = eph.Cuc; Cus[k] = eph.Cus;
+         Crc[k] = eph.Crc; Crs[k] = eph.Crs;
+         Cic[k] = eph.Cic; Cis[k] = eph.Cis;
+      }
+
+      // Kepler's equation, for all lanes together; a lane that has
+      // converged takes zero steps, so it ends where svXvt() would
+      vector<double> ea(n);
+      vector<unsigned char> active(n,1);
+      for(k=0; k<n; k++) {
+         meana[k] = fmod(meana[k], twoPI);
+         ea[k] = meana[k] + lecc[k] * ::sin(meana[k]);
+      }
+      for(int loop_cnt=1; loop_cnt<=20; loop_cnt++) {
+         unsigned nactive(0);
+         for(k=0; k<n; k++) {
+            double F = meana[k] - (ea[k] - lecc[k] * ::sin(ea[k]));
+            double G = 1.0 - lecc[k] * ::cos(ea[k]);
+            double delea = (active[k] ? F/G : 0.0);
+            ea[k] += delea;
+            active[k] = (active[k] && fabs(delea) > 1.0e-11);
+            nactive += active[k];
+         }
+         if(nactive == 0) break;
+      }
+
+      // clock corrections; svRelativity() solves Kepler's equation without
+      // dndot, so only when dndot is zero can this solution be reused
+      for(k=0; k<n; k++) {
+         const OrbitEph& eph(*ephs[lane[k]]);
+         const size_t i(lane[k]);
+         xvt.clkbias[i] = eph.af0 + elaptc[k] * (eph.af1 + elaptc[k] * eph.af2);
+         xvt.clkdrift[i] = eph.af1 + elaptc[k] * eph.af2;
+         if(eph.dndot == 0.0)
+            xvt.relcorr[i] = REL_CONST * lecc[k] * SQRT(Ak[k]) * ::sin(ea[k]);
+         else
+            xvt.relcorr[i] = eph.svRelativity(t);
+      }
+
+      // orbit, as in svXvt()
+      vector<double> X(n), Y(n), Z(n), VX(n), VY(n), VZ(n);
+      for(k=0; k<n; k++) {
+         double q     = SQRT(1.0e0 - lecc[k]*lecc[k]);
+         double sinea = ::sin(ea[k]);
+         double cosea = ::cos(ea[k]);
+         double G     = 1.0e0 - lecc[k] * cosea;
+         double truea = atan2(q * sinea, cosea - lecc[k]);
+
+         double alat  = truea + w[k];
+         double talat = 2.0e0 * alat;
+         double c2al  = ::cos(talat);
+         double s2al  = ::sin(talat);
+
+         double du  = c2al * Cuc[k] +  s2al * Cus[k];
+         double dr  = c2al * Crc[k] +  s2al * Crs[k];
+         double di  = c2al * Cic[k] +  s2al * Cis[k];
+
+         double U    = alat + du;
+         double R    = Ak[k]*G  + dr;
+         double AINC = i0[k] + idot[k] * elapte[k]  +  di;
+         double ANLON = OMEGA0[k] + (OMEGAdot[k] - omegaE) *
+                        elapte[k] - omegaE * ToeSOW[k];
+
+         double cosu = ::cos(U);
+         double sinu = ::sin(U);
+         double xip  = R * cosu;
+         double yip  = R * sinu;
+         double can  = ::cos(ANLON);
+         double san  = ::sin(ANLON);
+         double cinc = ::cos(AINC);
+         double sinc = ::sin(AINC);
+
+         X[k] =  xip*can  -  yip*cinc*san;
+         Y[k] =  xip*san  +  yip*cinc*can;
+         Z[k] =              yip*sinc;
+
+         double dek = amm[k] * Ak[k] / R;
+         double dlk = Ahalf[k] * q * sqrtgm / (R*R);
+         double div = idot[k] - 2.0e0 * dlk * (Cic[k] * s2al - Cis[k] * c2al);
+         double domk = OMEGAdot[k] - omegaE;
+         double duv = dlk*(1.e0+ 2.e0 * (Cus[k]*c2al - Cuc[k]*s2al));
+         double drv = Ak[k] * lecc[k] * dek * sinea
+                      - 2.e0 * dlk * (Crc[k] * s2al - Crs[k] * c2al);
+         double dxp = drv*cosu - R*sinu*duv;
+         double dyp = drv*sinu + R*cosu*duv;
+
+         VX[k] = dxp*can - xip*san*domk - dyp*cinc*san
+                  + yip*(sinc*san*div - cinc*can*domk);
+         VY[k] = dxp*san + xip*can*domk + dyp*cinc*can
+                  - yip*(sinc*can*div + cinc*san*domk);
+         VZ[k] = dyp*sinc + yip*cinc*div;
+      }
+
+      // scatter to the caller's order
+      for(k=0; k<n; k++) {
+         const size_t i(lane[k]);
+         xvt.x[i] = X[k]; xvt.y[i] = Y[k]; xvt.z[i] = Z[k];
+         xvt.vx[i] = VX[k]; xvt.vy[i] = VY[k]; xvt.vz[i] = VZ[k];
+         xvt.valid[i] = 1;
+      }
+
+      return n;
+   }
+
    // Compute satellite relativity correction (sec) at the given time
    // throw Invalid Request if the required data has not been stored.
    double OrbitEph::svRelativity(const CommonTime& t) const
@@ -49,6 +49,7 @@
 #define GPSTK_ORBITEPH_HPP
 
 #include <string>
+#include <vector>
 #include "Exception.hpp"
 #include "CommonTime.hpp"
 #include "ObsID.hpp"
@@ -64,6 +65,46 @@ namespace gpstk
       /// @ingroup GNSSEph
       //@{
 
+      /** Positions, velocities and clock corrections of several
+       * satellites at a single time, stored by component: element i
+       * of each vector belongs to the i-th satellite requested.
+       * Entries with valid[i]==0 were not computed and hold zeros. */
+   struct XvtArrays
+   {
+         /// Set every vector to length n and zero it
+      void resize(size_t n)
+      {
+         x.assign(n,0.0); y.assign(n,0.0); z.assign(n,0.0);
+         vx.assign(n,0.0); vy.assign(n,0.0); vz.assign(n,0.0);
+         clkbias.assign(n,0.0); clkdrift.assign(n,0.0); relcorr.assign(n,0.0);
+         valid.assign(n,0);
+      }
+
+         /// Number of satellites held
+      size_t size(void) const
+      { return valid.size(); }
+
+         /// Return entry i as an Xvt in the WGS84 frame
+      Xvt getXvt(size_t i) const
+      {
+         Xvt sv;
+         sv.x[0] = x[i]; sv.x[1] = y[i]; sv.x[2] = z[i];
+         sv.v[0] = vx[i]; sv.v[1] = vy[i]; sv.v[2] = vz[i];
+         sv.clkbias = clkbias[i];
+         sv.clkdrift = clkdrift[i];
+         sv.relcorr = relcorr[i];
+         sv.frame = ReferenceFrame::WGS84;
+         return sv;
+      }
+
+      std::vector<double> x, y, z;        ///< ECEF position (m)
+      std::vector<double> vx, vy, vz;     ///< ECEF velocity (m/s)
+      std::vector<double> clkbias;        ///< clock bias (s)
+      std::vector<double> clkdrift;       ///< clock drift (s/s)
+      std::vector<double> relcorr;        ///< relativity correction (s)
+      std::vector<unsigned char> valid;   ///< non-zero if entry computed
+   };
+
    class OrbitEph
    {
    public:
@@ -128,6 +169,21 @@ namespace gpstk
           * @throw Invalid Request if the required data has not been stored. */
       Xvt svXvt(const CommonTime& t) const;
 
+         /** Compute the position, velocity and clock corrections of
+          * many satellites at the same time, with the same equations
+          * as svXvt(). Each step is done for all satellites together,
+          * in loops over contiguous arrays that the compiler can
+          * vectorize; Kepler's equation is iterated for all of them
+          * at once until every one has converged.
+          * @param[in] ephs the elements to use, one per satellite; a
+          *   NULL pointer, or one without data loaded, gives an
+          *   entry with valid[i]==0
+          * @param[in] t the time of interest
+          * @param[out] xvt the results, resized to ephs.size()
+          * @return the number of valid entries */
+      static unsigned svXvt(const std::vector<const OrbitEph*>& ephs,
+                            const CommonTime& t, XvtArrays& xvt);
+
          /** Compute satellite relativity correction (sec) at the given time
           * @throw Invalid Request if the required data has not been stored. */
       double svRelativity(const CommonTime& t) const;
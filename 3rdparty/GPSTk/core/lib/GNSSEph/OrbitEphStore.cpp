@@ -45,6 +45,7 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 
 #include "StringUtils.hpp"
 #include "MathBase.hpp"
@@ -80,6 +81,15 @@ namespace gpstk
       catch(InvalidRequest& ir) { GPSTK_RETHROW(ir); }
    }
 
+   //---------------------------------------------------------------------------------
+   unsigned OrbitEphStore::getXvt(const vector<SatID>& sats, const CommonTime& t,
+                                  XvtArrays& xvt) const
+   {
+      vector<const OrbitEph*> ephs;
+      findOrbitEph(sats, t, ephs);
+      return OrbitEph::svXvt(ephs, t, xvt);
+   }
+
    //---------------------------------------------------------------------------------
    void OrbitEphStore::dump(ostream& os, short detail) const
    {
@@ -193,6 +203,7 @@ namespace gpstk
    OrbitEph* OrbitEphStore::addEphemeris(const OrbitEph* eph)
    {
       OrbitEph *ret(0);
+      invalidateIndex();
       try {
          // is the satellite found in the table? If not, create one
          if(satTables.find(eph->satID) == satTables.end()) {
@@ -292,6 +303,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::edit(const CommonTime& tmin, const CommonTime& tmax)
    {
+      invalidateIndex();
       for(SatTableMap::iterator i = satTables.begin(); i != satTables.end(); i++)
       {
          TimeOrbitEphTable& eMap = i->second;
@@ -320,6 +332,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::clear(void)
    {
+      invalidateIndex();
       for(SatTableMap::iterator ui=satTables.begin(); ui!=satTables.end(); ui++) {
          TimeOrbitEphTable& toet = ui->second;
          for(TimeOrbitEphTable::iterator toeti = toet.begin(); toeti != toet.end(); toeti++) {
@@ -504,6 +517,100 @@ namespace gpstk
       return itNext->second;
    }
 
+   //---------------------------------------------------------------------------------
+   // The same choices as findUserOrbitEph() and findNearOrbitEph(), made on the
+   // flat index: k is the first entry of the satellite with key >= t, which is
+   // where both of those start from.
+   unsigned OrbitEphStore::findOrbitEph(const vector<SatID>& sats,
+                                        const CommonTime& t,
+                                        vector<const OrbitEph*>& ephs) const
+   {
+      if(indexStale) buildIndex();
+
+      unsigned nfound(0);
+      ephs.assign(sats.size(), (const OrbitEph *)(0));
+      for(size_t i=0; i<sats.size(); i++) {
+         vector<SatID>::const_iterator sit;
+         sit = lower_bound(indexSats.begin(), indexSats.end(), sats[i]);
+         if(sit == indexSats.end() || *sit != sats[i])
+            continue;
+
+         const size_t j(sit - indexSats.begin());
+         const size_t beg(indexStart[j]), end(indexStart[j+1]);
+         if(beg == end)
+            continue;
+         const size_t k = lower_bound(indexKey.begin()+beg, indexKey.begin()+end, t)
+                          - indexKey.begin();
+
+         size_t found(end);
+         if(strictMethod) {
+            // the last element if t is beyond all keys, else the element at
+            // or after t, else the one before it, if valid at t
+            if(k == end) {
+               if(!(t < indexBegin[k-1] || t > indexEnd[k-1])) found = k-1;
+            }
+            else if(!(t < indexBegin[k] || t > indexEnd[k]))
+               found = k;
+            else if(k != beg && !(t < indexBegin[k-1] || t > indexEnd[k-1]))
+               found = k-1;
+         }
+         else {
+            // exact match, or either end, else the nearer Toe
+            if(k == end)
+               found = k-1;
+            else if(k == beg || indexKey[k] == t)
+               found = k;
+            else {
+               double diffToNext = indexEph[k]->ctToe - t;
+               double diffFromLast = t - indexEph[k-1]->ctToe;
+               found = (diffToNext > diffFromLast ? k-1 : k);
+            }
+         }
+
+         if(found == end)
+            continue;
+         if(onlyHealthy && !indexEph[found]->isHealthy())
+            continue;
+         ephs[i] = indexEph[found];
+         nfound++;
+      }
+
+      return nfound;
+   }
+
+   //---------------------------------------------------------------------------------
+   void OrbitEphStore::buildIndex(void) const
+   {
+      const unsigned n(size());
+      indexSats.clear();
+      indexStart.clear();
+      indexKey.clear();
+      indexBegin.clear();
+      indexEnd.clear();
+      indexEph.clear();
+      indexKey.reserve(n);
+      indexBegin.reserve(n);
+      indexEnd.reserve(n);
+      indexEph.reserve(n);
+
+      // satTables is already sorted by satellite, and each table by key
+      SatTableMap::const_iterator it;
+      for(it = satTables.begin(); it != satTables.end(); it++) {
+         indexSats.push_back(it->first);
+         indexStart.push_back(indexEph.size());
+         TimeOrbitEphTable::const_iterator ei;
+         for(ei = it->second.begin(); ei != it->second.end(); ei++) {
+            indexKey.push_back(ei->first);
+            indexBegin.push_back(ei->second->beginValid);
+            indexEnd.push_back(ei->second->endValid);
+            indexEph.push_back(ei->second);
+         }
+      }
+      indexStart.push_back(indexEph.size());
+
+      indexStale = false;
+   }
+
    //---------------------------------------------------------------------------------
    // Add all ephemerides to an existing list<OrbitEph>.
    // If SatID sat is given, limit selections to sat's satellite system, plus if
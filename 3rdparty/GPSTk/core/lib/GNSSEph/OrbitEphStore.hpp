@@ -48,6 +48,7 @@
 
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include "OrbitEph.hpp"
 #include "Exception.hpp"
@@ -77,7 +78,7 @@ namespace gpstk
       OrbitEphStore()
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              strictMethod(true)
+              strictMethod(true), indexStale(true)
       {
          timeSystem = TimeSystem::Any;
          initialTime.setTimeSystem(timeSystem);
@@ -102,6 +103,19 @@ namespace gpstk
           *   there are no orbit elements at time t. */
       virtual Xvt getXvt(const SatID& id, const CommonTime& t) const;
 
+         /** Compute the position, velocity and clock offset of many
+          * satellites at the same time, as getXvt(id,t) would for
+          * each, but without exceptions: a satellite with no usable
+          * OrbitEph gets xvt.valid[i]==0. The elements are chosen by
+          * findOrbitEph(sats,t,ephs) and evaluated all together by
+          * OrbitEph::svXvt(ephs,t,xvt).
+          * @param[in] sats the satellites of interest
+          * @param[in] t the time to look up
+          * @param[out] xvt the results, in the order of sats
+          * @return the number of satellites computed */
+      unsigned getXvt(const std::vector<SatID>& sats, const CommonTime& t,
+                      XvtArrays& xvt) const;
+
          /** Output summary of store data in human readable form, with detail:
           *  0: Time limits and number of entries for entire store
           *  1: Level 0 plus for each satellite: one line giving
@@ -289,6 +303,22 @@ namespace gpstk
          return (strictMethod ? findUserOrbitEph(sat,t) : findNearOrbitEph(sat, t));
       }
 
+         /** Find an OrbitEph for each of the satellites at time t,
+          * with the rules of the base class findUserOrbitEph() or
+          * findNearOrbitEph(), whichever is the current search
+          * method, and the onlyHealthy flag. The search uses a flat
+          * index of the validity intervals of all satellites, built
+          * on the first call after the store has changed; so the
+          * first call after a change must not run concurrently with
+          * any other.
+          * @param[in] sats the satellites of interest
+          * @param[in] t the time of interest
+          * @param[out] ephs one pointer per satellite, NULL where no
+          *   OrbitEph was found
+          * @return the number of OrbitEph found */
+      unsigned findOrbitEph(const std::vector<SatID>& sats, const CommonTime& t,
+                            std::vector<const OrbitEph*>& ephs) const;
+
          /** Add all ephemerides to an existing list<OrbitEph>.  If
           * SatID sat is given, limit selections to sat's satellite
           * system, plus if sat's id is not -1, limit to sat's id as
@@ -357,6 +387,26 @@ namespace gpstk
           *  getSatXvt and getSatHealth */
       bool strictMethod;
 
+         /** Flat index of satTables, for the batch findOrbitEph(). The
+          * satellites are sorted in indexSats; the OrbitEph of
+          * indexSats[j] are entries indexStart[j] to indexStart[j+1]-1
+          * of the other vectors, in the order of satTables. */
+      mutable std::vector<SatID> indexSats;
+      mutable std::vector<size_t> indexStart;
+      mutable std::vector<CommonTime> indexKey;    ///< key in satTables
+      mutable std::vector<CommonTime> indexBegin;  ///< beginValid
+      mutable std::vector<CommonTime> indexEnd;    ///< endValid
+      mutable std::vector<const OrbitEph*> indexEph;
+      mutable bool indexStale;   ///< satTables changed since the index was built
+
+         /** Mark the index out of date; call this whenever satTables
+          * or the validity of the OrbitEph in it are changed. */
+      void invalidateIndex(void)
+      { indexStale = true; }
+
+         /// Rebuild the index from satTables
+      void buildIndex(void) const;
+
          /// Convenience routines
       void updateTimeLimits(const OrbitEph* eph)
       {
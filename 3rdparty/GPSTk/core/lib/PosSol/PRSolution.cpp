@@ -489,6 +489,86 @@ namespace gpstk
    } // end PRSolution::SimplePRSolution
 
 
+   // -------------------------------------------------------------------------
+   // Evaluate a RAIM exclusion subset from the converged all-satellite solution.
+   // Removing the rows S from the weighted problem changes the state by
+   //    dX = -Cov * P_S^T * (W_S^-1 - P_S * Cov * P_S^T)^-1 * R_S
+   // (Sherman-Morrison-Woodbury; a rank-one downdate when S has one element),
+   // so the post-fit residuals of the remaining data follow without
+   // re-linearizing. P, Cov and R are the partials, covariance and residuals of
+   // the full solution, Wt the (diagonal) weights, Excl the rows to remove.
+   // Stop as soon as the RMS exceeds RMSCut (if RMSCut > 0); return false if
+   // the subset cannot be screened (too few data, a clock left with no data,
+   // singular downdate) and must be solved directly.
+   static bool RAIMScreen(const Matrix<double>& P,
+                          const Matrix<double>& Cov,
+                          const Vector<double>& R,
+                          const Vector<double>& Wt,
+                          const vector<int>& Excl,
+                          const double& RMSCut,
+                          double& rms)
+      throw()
+   {
+      const size_t n(P.rows()), dim(P.cols()), k(Excl.size());
+      size_t i,j,m;
+      if(n < dim+k) return false;
+
+      vector<bool> out(n,false);
+      for(i=0; i<k; i++) {
+         if(Wt(Excl[i]) <= 0.0) return false;
+         out[Excl[i]] = true;
+      }
+
+      // every clock must keep at least one satellite
+      for(j=3; j<dim; j++) {
+         for(i=0; i<n; i++) if(!out[i] && P(i,j) != 0.0) break;
+         if(i == n) return false;
+      }
+
+      // CPT = Cov * P_S^T, and M = W_S^-1 - P_S * CPT
+      Matrix<double> CPT(dim,k,0.0), M(k,k,0.0);
+      for(i=0; i<dim; i++) for(j=0; j<k; j++)
+         for(m=0; m<dim; m++) CPT(i,j) += Cov(i,m) * P(Excl[j],m);
+      for(i=0; i<k; i++) {
+         for(j=0; j<k; j++) {
+            double sum(0.0);
+            for(m=0; m<dim; m++) sum += P(Excl[i],m) * CPT(m,j);
+            M(i,j) = -sum;
+         }
+         M(i,i) += 1.0/Wt(Excl[i]);
+      }
+
+      // V = CPT * M^-1 * R_S; the subset solution is the full one minus V
+      Vector<double> RS(k), U, V;
+      for(i=0; i<k; i++) RS(i) = R(Excl[i]);
+      if(k == 1) {
+         // the leverage of the excluded datum is 1-M*Wt; 1 means unobservable
+         if(::fabs(M(0,0)*Wt(Excl[0])) < 1.e-8) return false;
+         U = Vector<double>(1, RS(0)/M(0,0));
+      }
+      else {
+         try { U = inverseLUD(M) * RS; }
+         catch(Exception& e) { return false; }
+      }
+      V = CPT * U;
+
+      // residuals of the remaining data
+      const double cut(RMSCut > 0.0 ? RMSCut*RMSCut*double(n-k) : 0.0);
+      double sum(0.0);
+      for(i=0; i<n; i++) {
+         if(out[i]) continue;
+         double res(R(i));
+         for(j=0; j<dim; j++) res += P(i,j) * V(j);
+         sum += res*res;
+         if(cut > 0.0 && sum > cut) break;
+      }
+      rms = SQRT(sum/double(n-k));
+
+      return true;
+
+   } // end RAIMScreen
+
+
    // -------------------------------------------------------------------------
    // Compute a solution using RAIM.
    int PRSolution::RAIMCompute(const CommonTime& Tr,
@@ -577,6 +657,12 @@ namespace gpstk
          // Resids stores the post-fit data residuals.
          Vector<double> Resids;
 
+         // The all-satellite solution, saved for screening exclusion subsets:
+         // partials, covariance, residuals and (diagonal) weights.
+         bool haveFull(false);
+         Matrix<double> FullP,FullCov;
+         Vector<double> FullRes,FullWt;
+
          // stage is the number of satellites to reject.
          int stage(0);
 
@@ -584,22 +670,52 @@ namespace gpstk
             // compute all the combinations of N satellites taken stage at a time
             Combinations Combo(N,stage);
 
+            // best screened combination of this stage, solved after the others
+            bool solveBest(false);
+            double ScreenRMS(-1.0);
+            vector<SatID> ScreenSats;
+            vector<int> Excl(stage);
+
             // compute a solution for each combination of marked satellites
             do {
-               // Mark the satellites for this combination
-               Sats = SaveSats;
-               for(i=0; i<GoodIndexes.size(); i++)
-                  if(Combo.isSelected(i))
-                     Sats[GoodIndexes[i]].id = -::abs(Sats[GoodIndexes[i]].id);
-
-               if(LOGlevel >= ConfigureLOG::Level("DEBUG")) {
-                  ostringstream oss;
-                  oss << " RAIM: Try the combo ";
-                  for(i=0; i<Sats.size(); i++) {
-                     RinexSatID rs(::abs(Sats[i].id), Sats[i].system);
-                     oss << " " << (Sats[i].id < 0 ? "-" : " ") << rs;
+               if(solveBest) {
+                  Sats = ScreenSats;
+                  LOG(DEBUG) << " RAIM: solve the best screened combo, RMS "
+                     << fixed << setprecision(3) << ScreenRMS;
+               }
+               else {
+                  // Mark the satellites for this combination
+                  Sats = SaveSats;
+                  for(i=0; i<GoodIndexes.size(); i++)
+                     if(Combo.isSelected(i))
+                        Sats[GoodIndexes[i]].id = -::abs(Sats[GoodIndexes[i]].id);
+
+                  if(LOGlevel >= ConfigureLOG::Level("DEBUG")) {
+                     ostringstream oss;
+                     oss << " RAIM: Try the combo ";
+                     for(i=0; i<Sats.size(); i++) {
+                        RinexSatID rs(::abs(Sats[i].id), Sats[i].system);
+                        oss << " " << (Sats[i].id < 0 ? "-" : " ") << rs;
+                     }
+                     LOG(DEBUG) << oss.str();
+                  }
+
+                  // screen the combination using the all-satellite solution;
+                  // only the best of the stage is iterated
+                  if(haveFull) {
+                     double rms;
+                     for(i=0; i<Excl.size(); i++) Excl[i] = Combo.Selection(i);
+                     if(RAIMScreen(FullP, FullCov, FullRes, FullWt, Excl,
+                                   ScreenRMS, rms)) {
+                        LOG(DEBUG) << " RAIM: screened RMS "
+                           << fixed << setprecision(3) << rms;
+                        if(ScreenRMS < 0.0 || rms < ScreenRMS) {
+                           ScreenRMS = rms;
+                           ScreenSats = Sats;
+                        }
+                        continue;
+                     }
                   }
-                  LOG(DEBUG) << oss.str();
                }
 
                // ----------------------------------------------------------------
@@ -668,7 +784,25 @@ namespace gpstk
                if(stage==0 && RMSResidual < RMSLimit)
                   break;
 
-            } while(Combo.Next() != -1);  // get the next combinations and repeat
+               // save the all-satellite solution for screening the next stages
+               if(stage==0 && iret==0 && ScreenRAIM
+                           && Partials.rows() == GoodIndexes.size()) {
+                  haveFull = true;
+                  FullP = Partials;
+                  FullCov = Covariance;
+                  FullRes = Resids;
+                  FullWt = Vector<double>(Partials.rows(),1.0);
+                  for(i=0; i<invMeasCov.rows(); i++) {
+                     FullWt(i) = invMeasCov(i,i);
+                     for(j=0; j<invMeasCov.cols(); j++)     // correlated data
+                        if(j != i && invMeasCov(i,j) != 0.0) haveFull = false;
+                  }
+               }
+
+            // get the next combination and repeat; when they are exhausted,
+            // go round once more for the best screened combination
+            } while(!solveBest &&
+                    (Combo.Next() != -1 || (solveBest = (ScreenRMS >= 0.0))));
 
             // end of the stage
             if(BestRMS > 0.0 && BestRMS < RMSLimit) {          // success
@@ -387,6 +387,7 @@ namespace gpstk
                              MaxNIterations(10),
                              ConvergenceLimit(3.e-7),
                              hasMemory(true),
+                             ScreenRAIM(true),
                              Valid(false)
          {}
       /// Return the status of solution
@@ -430,6 +431,15 @@ namespace gpstk
       /// and a combined weighted average solution.
       bool hasMemory;
 
+      /// If true, RAIMCompute() does not iterate a solution for every subset of
+      /// satellites when it must reject some. Each subset is instead evaluated
+      /// from the all-satellite solution by downdating its covariance, and only
+      /// the subset with the smallest RMS residual in each stage is iterated.
+      /// Subsets that cannot be evaluated this way (e.g. the last satellite of a
+      /// system is rejected, or the data are correlated) are iterated as before.
+      /// If false, every subset is iterated.
+      bool ScreenRAIM;
+
       // input and output: -------------------------------------------------
 
       /// vector<SatID> containing satellite IDs for all the satellites input, with
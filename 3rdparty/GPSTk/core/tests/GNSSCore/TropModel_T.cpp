@@ -1,15 +1,93 @@
 #include "TestUtil.hpp"
+#include "NeillTropModel.hpp"
+#include "SimpleTropModel.hpp"
 #include <iostream>
+#include <vector>
+
+using namespace gpstk;
 
 class TropModel_T
 {
-        public: 
+        public:
 		TropModel_T(){}// Default Constructor, set the precision value
 		~TropModel_T() {} // Default Desructor
+
+      /** Check that batch_correction() gives, element by element, what the
+       *  scalar methods give, including below the elevation cut off. */
+   int batchTest(TropModel& model, const std::string& name)
+   {
+      TUDEF(name, "batch_correction");
+
+      std::vector<double> elev;
+      for (double e = -5.0; e <= 90.0; e += 0.37)
+         elev.push_back(e);
+      elev.push_back(3.0);
+      elev.push_back(90.0);
+
+      std::vector<double> corr, dryMap, wetMap;
+      model.batch_correction(elev, corr, dryMap, wetMap);
+
+      TUASSERTE(size_t, elev.size(), corr.size());
+      TUASSERTE(size_t, elev.size(), dryMap.size());
+      TUASSERTE(size_t, elev.size(), wetMap.size());
+
+      for (size_t i = 0; i < elev.size(); i++)
+      {
+         TUASSERTFEPS(model.correction(elev[i]), corr[i], 1e-12);
+         TUASSERTFEPS(model.dry_mapping_function(elev[i]), dryMap[i], 1e-12);
+         TUASSERTFEPS(model.wet_mapping_function(elev[i]), wetMap[i], 1e-12);
+      }
+
+         // an empty array gives empty results
+      std::vector<double> none;
+      model.batch_correction(none, corr, dryMap, wetMap);
+      TUASSERTE(size_t, 0, corr.size());
+
+      TURETURN();
+   }
+
+      /** An invalid model throws, as the scalar methods do. */
+   int invalidTest()
+   {
+      TUDEF("NeillTropModel", "batch_correction");
+
+      NeillTropModel model;
+      std::vector<double> elev(3, 45.0), corr, dryMap, wetMap;
+      try
+      {
+         model.batch_correction(elev, corr, dryMap, wetMap);
+         TUFAIL("Invalid model should throw");
+      }
+      catch (InvalidTropModel& e)
+      {
+         TUPASS("Invalid model throws");
+      }
+
+      TURETURN();
+   }
 };
 
 
 int main() //Main function to initialize and run all tests above
 {
-	return 0; //Return the total number of errors
+   TropModel_T testClass;
+   int errorTotal = 0;
+
+      // northern and southern hemisphere, within and outside of the
+      // latitude interpolation band
+   NeillTropModel north(250.0, 40.2, 123);
+   NeillTropModel south(1200.0, -52.7, 301);
+   NeillTropModel polar(10.0, 80.1, 17);
+   SimpleTropModel simple(20.0, 1013.0, 50.0);
+
+   errorTotal += testClass.batchTest(north, "NeillTropModel");
+   errorTotal += testClass.batchTest(south, "NeillTropModel");
+   errorTotal += testClass.batchTest(polar, "NeillTropModel");
+   errorTotal += testClass.batchTest(simple, "SimpleTropModel");
+   errorTotal += testClass.invalidTest();
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorTotal
+             << std::endl;
+
+	return errorTotal; //Return the total number of errors
 }
@@ -75,6 +75,129 @@ public:
       }
       TURETURN();
    }
+
+      /** Compare the batch getXvt() with getXvt() for each
+       * satellite, over a store with gaps, a CNAV-like orbit and
+       * satellites that are not in the store, with both search
+       * methods. */
+   unsigned doBatchXvtTests()
+   {
+      TUDEF("OrbitEphStore","getXvt");
+      try
+      {
+         gpstk::OrbitEphStore store;
+         gpstk::ObsID obsID(gpstk::ObsID::otNavMsg,
+                            gpstk::ObsID::cbL1,
+                            gpstk::ObsID::tcCA);
+         std::vector<gpstk::SatID> sats;
+         for (int prn = 1; prn <= 8; prn++)
+         {
+            gpstk::SatID sat(prn, gpstk::SatID::systemGPS);
+            sats.push_back(sat);
+            for (int hour = 0; hour < 24; hour += 2)
+            {
+                  // PRN 3 has a gap from 8h to 14h
+               if (prn == 3 && hour >= 8 && hour <= 12)
+                  continue;
+               gpstk::OrbitEph eph;
+               eph.dataLoadedFlag = true;
+               eph.satID = sat;
+               eph.obsID = obsID;
+               eph.ctToe = gpstk::GPSWeekSecond(1917, 345600 + hour*3600);
+               eph.ctToc = eph.ctToe;
+               eph.af0 = 1.0e-5 * prn;
+               eph.af1 = -2.0e-12 * prn;
+               eph.af2 = 1.0e-19;
+               eph.M0 = -3.0 + 0.7 * prn + 0.01 * hour;
+               eph.dn = 4.5e-9;
+               eph.ecc = 0.002 * prn;
+               eph.A = 26560.0e3 + 100.0 * prn;
+               eph.OMEGA0 = 0.8 * prn - 3.0;
+               eph.i0 = 0.96 + 0.001 * prn;
+               eph.w = 0.5 * prn - 2.0;
+               eph.OMEGAdot = -8.0e-9;
+               eph.idot = 1.0e-10 * prn;
+               eph.Cuc = 1.0e-6; eph.Cus = 8.0e-6;
+               eph.Crc = 200.0;  eph.Crs = -20.0 * prn;
+               eph.Cic = 1.0e-7; eph.Cis = -5.0e-8;
+               if (prn == 5)
+               {
+                  eph.dndot = 1.0e-13;
+                  eph.Adot = 0.01;
+               }
+               eph.adjustValidity();
+               store.addEphemeris(&eph);
+            }
+         }
+            // one not in the store, and one in another system
+         sats.push_back(gpstk::SatID(30, gpstk::SatID::systemGPS));
+         sats.push_back(gpstk::SatID(1, gpstk::SatID::systemGalileo));
+
+         for (int method = 0; method < 2; method++)
+         {
+            if (method == 0)
+               store.SearchUser();
+            else
+               store.SearchNear();
+               // from before the first to after the last ephemeris
+            for (int sec = -14400; sec < 24*3600+14400; sec += 1799)
+            {
+               gpstk::CommonTime t(gpstk::GPSWeekSecond(1917, 345600 + sec));
+               gpstk::XvtArrays batch;
+               unsigned n = store.getXvt(sats, t, batch);
+               TUASSERTE(size_t, sats.size(), batch.size());
+               unsigned nexp = 0;
+               for (size_t i = 0; i < sats.size(); i++)
+               {
+                  gpstk::Xvt xvt;
+                  bool ok = true;
+                  try
+                  {
+                     xvt = store.getXvt(sats[i], t);
+                  }
+                  catch (gpstk::InvalidRequest&)
+                  {
+                     ok = false;
+                  }
+                  TUASSERTE(bool, ok, batch.valid[i] != 0);
+                  if (!ok || !batch.valid[i])
+                     continue;
+                  nexp++;
+                  gpstk::Xvt got = batch.getXvt(i);
+                  for (int j = 0; j < 3; j++)
+                  {
+                     TUASSERTFEPS(xvt.x[j], got.x[j], 1.0e-6);
+                     TUASSERTFEPS(xvt.v[j], got.v[j], 1.0e-9);
+                  }
+                  TUASSERTFEPS(xvt.clkbias, got.clkbias, 1.0e-15);
+                  TUASSERTFEPS(xvt.clkdrift, got.clkdrift, 1.0e-18);
+                  TUASSERTFEPS(xvt.relcorr, got.relcorr, 1.0e-15);
+               }
+               TUASSERTE(unsigned, nexp, n);
+            }
+         }
+
+            // the index must follow changes to the store
+         store.SearchUser();
+         gpstk::CommonTime t(gpstk::GPSWeekSecond(1917, 345600 + 3600));
+         gpstk::XvtArrays batch;
+         TUASSERT(store.getXvt(sats, t, batch) > 0);
+         store.edit(t + 86400);
+         TUASSERTE(unsigned, 0, store.getXvt(sats, t, batch));
+         store.clear();
+         TUASSERTE(unsigned, 0, store.getXvt(sats, t, batch));
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
 };
 
 
@@ -83,6 +206,7 @@ int main(int argc, char *argv[])
    unsigned total = 0;
    OrbitEphStore_T testClass;
    total += testClass.doFindEphEmptyTests();
+   total += testClass.doBatchXvtTests();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
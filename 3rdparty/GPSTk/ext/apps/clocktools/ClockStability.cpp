@@ -0,0 +1,518 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 2.1 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2009, The University of Texas at Austin
+//
+//============================================================================
+
+/// @file ClockStability.cpp
+/// Allan-family frequency stability estimates from clock phase data.
+
+#include <iostream>
+#include <cstdlib>
+
+#include <stdio.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ClockStability.hpp"
+
+using namespace std;
+
+namespace
+{
+   // Normalization of the summed squared differences: the deviation is
+   // sqrt(sum / (scale * n * tau^2)).
+   double scale(StabilityType type, unsigned long m)
+   {
+      switch(type)
+      {
+         case OverlapHadamard: return 6.0;
+         case ModifiedAllan:   return 2.0*double(m)*double(m);
+         default:              return 2.0;
+      }
+   }
+
+   StabilityPoint makePoint(StabilityType type, double tau0, unsigned long m,
+                            long double sum, unsigned long n)
+   {
+      StabilityPoint pt;
+      pt.tau = m*tau0;
+      pt.n = n;
+      pt.dev = sqrt(double(sum / (scale(type,m) * n * pt.tau * pt.tau)));
+      return pt;
+   }
+
+   // Phase of the total deviation's extended series: the data reflected
+   // (inverted) about each end point.
+   inline double reflected(const vector<double>& x, long k)
+   {
+      const long N(x.size());
+      if(k < 0) return 2*x[0] - x[-k];
+      if(k >= N) return 2*x[N-1] - x[2*(N-1)-k];
+      return x[k];
+   }
+
+   // Everything the batch evaluation of one averaging factor needs; the
+   // phase and the prefix sums are shared, read only, by all threads.
+   struct BatchJob
+   {
+      StabilityType type;
+      const vector<double> *phase;
+      const vector<long double> *psum;       // psum[k] = sum of x[0..k-1]
+      const vector<unsigned long> *pgap;     // pgap[k] = gaps in x[0..k-1]
+      double tau0;
+      const vector<unsigned long> *m;
+      vector<long double> sums;
+      vector<unsigned long> terms;
+      int first, stride;
+   };
+
+   void evaluate(BatchJob& job, size_t k)
+   {
+      const vector<double>& x(*job.phase);
+      const vector<long double>& S(*job.psum);
+      const vector<unsigned long>& G(*job.pgap);
+      const unsigned long N(x.size()), m((*job.m)[k]);
+      long double sum(0);
+      unsigned long i, n(0);
+      double d;
+
+      switch(job.type)
+      {
+         // Sigma^2(Tau) = Sum((X[i+2m]-2X[i+m]+X[i])^2) / (2 n Tau^2)
+         // over all i (overlapping) or i = 0,m,2m,... (normal)
+         case NormalAllan:
+         case OverlapAllan:
+         {
+            const unsigned long step(job.type == NormalAllan ? m : 1);
+            for(i = 0; i+2*m < N; i += step)
+            {
+               if(x[i] == 0 || x[i+m] == 0 || x[i+2*m] == 0) continue;
+               d = x[i+2*m] - 2*x[i+m] + x[i];
+               sum += d*d;
+               n++;
+            }
+            break;
+         }
+         // HSigma^2(Tau) = Sum((X[i+3m]-3X[i+2m]+3X[i+m]-X[i])^2) / (6 n Tau^2)
+         case OverlapHadamard:
+            for(i = 0; i+3*m < N; i++)
+            {
+               if(x[i] == 0 || x[i+m] == 0 || x[i+2*m] == 0 || x[i+3*m] == 0)
+                  continue;
+               d = x[i+3*m] - 3*x[i+2*m] + 3*x[i+m] - x[i];
+               sum += d*d;
+               n++;
+            }
+            break;
+         // ModSigma^2(Tau) = Sum_j(Sum_i=j..j+m-1(X[i+2m]-2X[i+m]+X[i]))^2
+         //                   / (2 m^2 n Tau^2)
+         case ModifiedAllan:
+            // the sum over i=j..j+m-1 of the second differences is a
+            // combination of four windows of m samples each
+            for(i = 0; i+3*m <= N; i++)
+            {
+               if(G[i+3*m] != G[i]) continue;
+               long double w = S[i+3*m] - 3*S[i+2*m] + 3*S[i+m] - S[i];
+               sum += w*w;
+               n++;
+            }
+            break;
+         // TotSigma^2(Tau) = Sum((X*[i-m]-2X*[i]+X*[i+m])^2) / (2 (N-2) Tau^2)
+         // for i = 1..N-2, X* being the reflected series
+         case TotalAllan:
+            for(i = 1; i+1 < N; i++)
+            {
+               d = reflected(x,long(i)-long(m)) - 2*x[i]
+                 + reflected(x,long(i)+long(m));
+               sum += d*d;
+               n++;
+            }
+            break;
+      }
+
+      job.sums[k] = sum;
+      job.terms[k] = n;
+   }
+
+   void *batchThread(void *arg)
+   {
+      BatchJob& job(*static_cast<BatchJob *>(arg));
+      for(size_t k = job.first; k < job.m->size(); k += job.stride)
+         evaluate(job, k);
+      return 0;
+   }
+
+}  // end anonymous namespace
+
+
+unsigned long maxAveragingFactor(StabilityType type, unsigned long N)
+{
+   if(N < 2) return 0;
+   switch(type)
+   {
+      case ModifiedAllan:   return N/3;
+      case OverlapHadamard: return (N-1)/3;
+      case TotalAllan:      return N-1;
+      default:              return (N-1)/2;
+   }
+}
+
+
+vector<unsigned long> tauGrid(const string& grid, unsigned long mMax)
+{
+   vector<unsigned long> m;
+   if(grid == "all")
+   {
+      for(unsigned long i = 1; i <= mMax; i++)
+         m.push_back(i);
+   }
+   else if(grid == "octave")
+   {
+      for(unsigned long i = 1; i <= mMax && i != 0; i *= 2)
+         m.push_back(i);
+   }
+   else if(grid == "decade")
+   {
+      static const unsigned long mant[3] = { 1, 2, 5 };
+      for(unsigned long dec = 1; dec <= mMax; dec *= 10)
+         for(int j = 0; j < 3; j++)
+            if(mant[j]*dec <= mMax)
+               m.push_back(mant[j]*dec);
+   }
+   return m;
+}
+
+
+vector<StabilityPoint> computeStability(StabilityType type,
+                                        const vector<double>& phase,
+                                        double tau0,
+                                        const vector<unsigned long>& m,
+                                        int nThreads)
+{
+   vector<StabilityPoint> result;
+   const unsigned long mMax(maxAveragingFactor(type, phase.size()));
+
+   vector<unsigned long> factors;
+   for(size_t k = 0; k < m.size(); k++)
+      if(m[k] >= 1 && m[k] <= mMax)
+         factors.push_back(m[k]);
+   if(factors.empty())
+      return result;
+
+   // prefix sums for the modified deviation, relative to the first sample to
+   // keep the differences of large sums accurate
+   vector<long double> psum;
+   vector<unsigned long> pgap;
+   if(type == ModifiedAllan)
+   {
+      const double x0(phase[0]);
+      psum.resize(phase.size()+1);
+      pgap.resize(phase.size()+1);
+      psum[0] = 0;
+      pgap[0] = 0;
+      for(size_t i = 0; i < phase.size(); i++)
+      {
+         psum[i+1] = psum[i] + (phase[i] - x0);
+         pgap[i+1] = pgap[i] + (phase[i] == 0 ? 1 : 0);
+      }
+   }
+
+   if(nThreads < 1) nThreads = 1;
+   if(size_t(nThreads) > factors.size()) nThreads = factors.size();
+
+   vector<BatchJob> jobs(nThreads);
+   for(int t = 0; t < nThreads; t++)
+   {
+      BatchJob& job(jobs[t]);
+      job.type = type;
+      job.phase = &phase;
+      job.psum = &psum;
+      job.pgap = &pgap;
+      job.tau0 = tau0;
+      job.m = &factors;
+      job.sums.resize(factors.size());
+      job.terms.resize(factors.size());
+      job.first = t;
+      job.stride = nThreads;
+   }
+
+#ifndef _WIN32
+   vector<pthread_t> threads(nThreads);
+   int started(0);
+   for(int t = 1; t < nThreads; t++, started++)
+      if(pthread_create(&threads[t], NULL, batchThread, &jobs[t]))
+         break;
+   // factors of threads that could not be started are done here
+   for(int t = started+1; t < nThreads; t++)
+      batchThread(&jobs[t]);
+   batchThread(&jobs[0]);
+   for(int t = 1; t <= started; t++)
+      pthread_join(threads[t], NULL);
+#else
+   for(int t = 0; t < nThreads; t++)
+      batchThread(&jobs[t]);
+#endif
+
+   for(size_t k = 0; k < factors.size(); k++)
+   {
+      const BatchJob& job(jobs[k % nThreads]);
+      if(job.terms[k] > 0)
+         result.push_back(makePoint(type, tau0, factors[k],
+                                    job.sums[k], job.terms[k]));
+   }
+
+   return result;
+}
+
+
+StreamingStability::StreamingStability(StabilityType type, double tau0,
+                                       const vector<unsigned long>& m)
+   : type(type), tau0(tau0), valid(false), count(0), offset(0), runSum(0),
+     runGap(0)
+{
+   if(type == TotalAllan)
+      return;
+
+   unsigned long mMax(0);
+   for(size_t k = 0; k < m.size(); k++)
+   {
+      if(m[k] < 1) continue;
+      factors.push_back(m[k]);
+      if(m[k] > mMax) mMax = m[k];
+   }
+   if(factors.empty())
+      return;
+
+   sums.resize(factors.size(), 0);
+   terms.resize(factors.size(), 0);
+   ring.resize(3*mMax+1, 0);
+   if(type == ModifiedAllan)
+   {
+      psum.resize(3*mMax+1, 0);
+      pgap.resize(3*mMax+1, 0);
+   }
+   valid = true;
+}
+
+
+void StreamingStability::add(double phase)
+{
+   if(!valid)
+      return;
+
+   const unsigned long W(ring.size()), t(count);
+   ring[t % W] = phase;
+
+   if(type == ModifiedAllan)
+   {
+      // sums relative to the first sample, as in computeStability()
+      if(t == 0) offset = phase;
+      runSum += phase - offset;
+      runGap += (phase == 0 ? 1 : 0);
+      psum[(t+1) % W] = runSum;
+      pgap[(t+1) % W] = runGap;
+   }
+
+   for(size_t k = 0; k < factors.size(); k++)
+   {
+      const unsigned long m(factors[k]);
+      double d;
+
+      switch(type)
+      {
+         case NormalAllan:
+         case OverlapAllan:
+         {
+            if(t < 2*m) continue;
+            if(type == NormalAllan && t % m != 0) continue;
+            const double x0(ring[(t-2*m) % W]), x1(ring[(t-m) % W]);
+            if(phase == 0 || x0 == 0 || x1 == 0) continue;
+            d = phase - 2*x1 + x0;
+            sums[k] += d*d;
+            terms[k]++;
+            break;
+         }
+         case OverlapHadamard:
+         {
+            if(t < 3*m) continue;
+            const double x0(ring[(t-3*m) % W]), x1(ring[(t-2*m) % W]),
+                         x2(ring[(t-m) % W]);
+            if(phase == 0 || x0 == 0 || x1 == 0 || x2 == 0) continue;
+            d = phase - 3*x2 + 3*x1 - x0;
+            sums[k] += d*d;
+            terms[k]++;
+            break;
+         }
+         case ModifiedAllan:
+         {
+            if(t+1 < 3*m) continue;
+            const unsigned long j(t+1-3*m);
+            if(pgap[(t+1) % W] != pgap[j % W]) continue;
+            long double w = psum[(t+1) % W] - 3*psum[(j+2*m) % W]
+                          + 3*psum[(j+m) % W] - psum[j % W];
+            sums[k] += w*w;
+            terms[k]++;
+            break;
+         }
+         default:
+            break;
+      }
+   }
+
+   count++;
+}
+
+
+vector<StabilityPoint> StreamingStability::result() const
+{
+   vector<StabilityPoint> pts;
+   for(size_t k = 0; k < factors.size(); k++)
+      if(terms[k] > 0)
+         pts.push_back(makePoint(type, tau0, factors[k], sums[k], terms[k]));
+   return pts;
+}
+
+
+int stabilityMain(StabilityType type, const string& prog,
+                  const string& description, int argc, char **argv)
+{
+   string grid("octave");
+   unsigned long maxFactor(0);
+   bool stream(false);
+   int nThreads(1);
+#ifndef _WIN32
+   nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+   for(int i = 1; i < argc; i++)
+   {
+      string arg(argv[i]);
+      bool more(i+1 < argc);
+      if(arg == "-h" || arg == "--help")
+      {
+         cout << prog << ": " << description << endl
+              << "Reads 'time phase' pairs from the standard input and writes"
+              << " 'tau deviation' lines." << endl
+              << "  -g, --grid G        averaging factors: all, octave"
+              << " (default) or decade" << endl
+              << "  -m, --max-factor M  largest averaging factor" << endl
+              << "  -s, --stream        single pass with bounded memory"
+              << " (M defaults to 65536)" << endl
+              << "  -j, --threads N     number of threads (batch mode)" << endl;
+         return 1;
+      }
+      else if((arg == "-g" || arg == "--grid") && more)
+         grid = argv[++i];
+      else if((arg == "-m" || arg == "--max-factor") && more)
+         maxFactor = strtoul(argv[++i], 0, 10);
+      else if(arg == "-s" || arg == "--stream")
+         stream = true;
+      else if((arg == "-j" || arg == "--threads") && more)
+         nThreads = atoi(argv[++i]);
+      else
+      {
+         cerr << prog << ": unknown option " << arg << " (try --help)" << endl;
+         return 1;
+      }
+   }
+
+   if(tauGrid(grid, 1).empty())
+   {
+      cerr << prog << ": unknown grid " << grid << endl;
+      return 1;
+   }
+
+   long double time, phase;
+   double Tau0(0), firstTime(0);
+   vector<StabilityPoint> pts;
+
+   if(stream)
+   {
+      if(type == TotalAllan)
+      {
+         cerr << prog << ": the total deviation has no streaming mode" << endl;
+         return 1;
+      }
+      if(maxFactor == 0) maxFactor = 65536;
+
+      // tau0 is not known until the second sample
+      StreamingStability *pStab(0);
+      unsigned long n(0);
+      double first(0);
+      while(cin >> time >> phase)
+      {
+         if(n == 0)
+         {
+            firstTime = time;
+            first = phase;
+         }
+         else
+         {
+            if(n == 1)
+            {
+               Tau0 = time - firstTime;
+               pStab = new StreamingStability(type, Tau0,
+                                              tauGrid(grid, maxFactor));
+               pStab->add(first);
+            }
+            pStab->add(phase);
+         }
+         n++;
+      }
+      if(pStab)
+      {
+         pts = pStab->result();
+         delete pStab;
+      }
+      else
+         cout << "Not Enough Points to Calculate Tau0" << endl;
+   }
+   else
+   {
+      vector<double> timeArray, phaseArray;
+      while(cin >> time >> phase)
+      {
+         timeArray.push_back(time);
+         phaseArray.push_back(phase);
+      }
+
+      if(timeArray.size() > 1)
+         Tau0 = timeArray[1] - timeArray[0];
+      else
+      {
+         cout << "Not Enough Points to Calculate Tau0" << endl;
+         return 0;
+      }
+
+      unsigned long mMax(maxAveragingFactor(type, phaseArray.size()));
+      if(maxFactor > 0 && maxFactor < mMax) mMax = maxFactor;
+      pts = computeStability(type, phaseArray, Tau0, tauGrid(grid, mMax),
+                             nThreads);
+   }
+
+   for(size_t i = 0; i < pts.size(); i++)
+      fprintf(stdout, "%.1f %.4e \n", pts[i].tau, pts[i].dev);
+
+   return 0;
+}
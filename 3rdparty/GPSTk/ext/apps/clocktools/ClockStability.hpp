@@ -0,0 +1,125 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 2.1 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2009, The University of Texas at Austin
+//
+//============================================================================
+
+/// @file ClockStability.hpp
+/// Allan-family frequency stability estimates from clock phase data, shared
+/// by the clocktools deviation programs.
+
+#ifndef CLOCKSTABILITY_HPP
+#define CLOCKSTABILITY_HPP
+
+#include <string>
+#include <vector>
+
+/// The deviations computed by this library. Phase samples that are exactly
+/// zero are treated as gaps; a difference term touching a gap is not used.
+enum StabilityType
+{
+   NormalAllan,        ///< non-overlapping Allan deviation (nallandev)
+   OverlapAllan,       ///< overlapping Allan deviation (oallandev)
+   ModifiedAllan,      ///< modified Allan deviation (mallandev)
+   TotalAllan,         ///< total deviation (tallandev); batch only, no gaps
+   OverlapHadamard     ///< overlapping Hadamard deviation (ohadamarddev)
+};
+
+/// One point of a stability curve.
+struct StabilityPoint
+{
+   double tau;             ///< averaging time m*tau0
+   double dev;             ///< deviation at tau
+   unsigned long n;        ///< number of difference terms used
+};
+
+/// Largest averaging factor m the deviation supports for N phase samples.
+unsigned long maxAveragingFactor(StabilityType type, unsigned long N);
+
+/// Averaging factors 1 <= m <= mMax on the named grid: "all" (every m),
+/// "octave" (1,2,4,8,...) or "decade" (1,2,5,10,20,50,...).
+/// Returns an empty vector if the grid name is not recognized.
+std::vector<unsigned long> tauGrid(const std::string& grid, unsigned long mMax);
+
+/// Compute the deviation for each averaging factor in m, from the whole
+/// phase series sampled at tau0. Each m costs O(N), using prefix sums for the
+/// modified deviation. The factors are shared among nThreads threads.
+std::vector<StabilityPoint> computeStability(StabilityType type,
+                                             const std::vector<double>& phase,
+                                             double tau0,
+                                             const std::vector<unsigned long>& m,
+                                             int nThreads = 1);
+
+/// Single pass computation of a deviation with bounded memory. Phase samples
+/// are added one at a time, and only the last 3*max(m)+1 of them are kept,
+/// so the largest averaging factor must be chosen in advance. The results
+/// equal those of computeStability() on the same data. The total deviation
+/// needs the whole series and is not supported.
+class StreamingStability
+{
+public:
+   /// Set up for the given deviation, sample interval and averaging factors.
+   /// An unsupported type or an empty m leaves the object invalid.
+   StreamingStability(StabilityType type, double tau0,
+                      const std::vector<unsigned long>& m);
+
+   /// True if the type and averaging factors were accepted.
+   bool isValid() const { return valid; }
+
+   /// Add the next phase sample.
+   void add(double phase);
+
+   /// Number of samples added so far.
+   unsigned long size() const { return count; }
+
+   /// Deviations for the averaging factors that have at least one term.
+   std::vector<StabilityPoint> result() const;
+
+private:
+   StabilityType type;
+   double tau0;
+   bool valid;
+   std::vector<unsigned long> factors;
+
+   /// per factor sum of squared differences and number of terms
+   std::vector<long double> sums;
+   std::vector<unsigned long> terms;
+
+   /// ring buffers, indexed by sample count modulo their length, of the
+   /// phase, of its running sum and of the running count of gaps; the
+   /// running sums are one sample ahead of the phase (psum[k] is the sum of
+   /// the first k samples).
+   std::vector<double> ring;
+   std::vector<long double> psum;
+   std::vector<unsigned long> pgap;
+   unsigned long count;
+   double offset;
+   long double runSum;
+   unsigned long runGap;
+};
+
+/// Command line and output shared by the deviation programs. Reads
+/// "time phase" pairs from standard input and writes "tau deviation" lines
+/// to standard output. Options are -g|--grid all|octave|decade (default
+/// octave), -m|--max-factor M (largest averaging factor), -s|--stream
+/// (single pass, bounded memory) and -j|--threads N.
+int stabilityMain(StabilityType type, const std::string& prog,
+                  const std::string& description, int argc, char **argv);
+
+#endif
@@ -55,6 +55,10 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <sstream>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 // gpstk
 #include "MathBase.hpp"
 #include "RinexSatID.hpp"
@@ -121,6 +125,7 @@ typedef struct configuration {
    Epoch FirstEpoch,LastEpoch;
    bool smoothPR,smoothPH,smooth;
    int debug;
+   int nthreads;                 // number of passes to correct at once
    bool verbose,DChelp;
    vector<string> DCcmds;        // all the --DC... on the cmd line
       // estimate dt from data
@@ -157,6 +162,29 @@ typedef struct configuration {
 // declare (one only) global configuration object
 DFConfig cfg;
 
+// output of the GDC, and of smoothing, for one pass
+typedef struct passResult {
+   passResult() : iret(0), done(false), failed(false) { }
+   string proc;                  // the pass before correction
+   string debug;                 // GDC debug output, when threaded
+   int iret;                     // return value of the GDC
+   string msg;
+   vector<string> EditCmds;
+   bool done,failed;             // done; or failed with exception fatal
+   Exception fatal;
+} PassResult;
+
+#ifndef _WIN32
+// passes shared by the correcting threads; workers take the next pass, and
+// the main thread reports them in order as they are done
+typedef struct passPool {
+   vector<PassResult> results;
+   size_t next;                  // next pass to be taken by a worker
+   pthread_mutex_t lock;
+   pthread_cond_t done;          // signalled whenever a pass is done
+} PassPool;
+#endif
+
 //------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------
 // prototypes
@@ -165,6 +193,12 @@ void DumpConfiguration(void) throw(Exception);
 int Initialize(void) throw(Exception);
 int ShallowCheck(void) throw(Exception);  // called by Initialize()
 int WriteToRINEX(void) throw(Exception);
+void CorrectPasses(void) throw(Exception);
+void CorrectPass(int npass, GDCconfiguration& gdc, PassResult& R) throw();
+void ReportPass(int npass, PassResult& R) throw(Exception);
+#ifndef _WIN32
+void CorrectPassesParallel(void) throw(Exception);
+#endif
 void PrintSPList(ostream&, string, vector<SatPass>&);
 
 //------------------------------------------------------------------------------------
@@ -175,8 +209,6 @@ int main(int argc, char **argv)
       clock_t totaltime = clock();
       int i,nread,npass,iret;
       Epoch ttag;
-      string msg;
-      vector<string> EditCmds;
 
       // Title and description
       cfg.Title = PrgmName+", part of the GPS ToolKit, Ver "+DiscFixVersion+", Run ";
@@ -311,43 +343,7 @@ int main(int argc, char **argv)
          LOG(INFO) << "";
 
          // -------------------------------- call the GDC, output results and smooth
-         for(npass=0; npass<cfg.SPList.size(); npass++) {
-
-            LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << cfg.SPList[npass];
-            //cfg.SPList[npass].dump(*pLOGstrm,"RAW");      // temp
-
-            msg = "";
-            iret=DiscontinuityCorrector(cfg.SPList[npass],cfg.GDConfig,EditCmds,msg);
-            if(iret != 0) {
-               cfg.SPList[npass].status() = -1;         // failed
-               LOG(ERROR) << "GDC failed (" << iret << " "
-                  << (iret==-1 ? "Singularity":
-                     (iret==-3 ? "DT not set, or memory":
-                     (iret==-4 ? "No data":"Bad input")))
-                  << ") for pass "
-                  << npass+1 << " :\n" << msg;
-               continue;
-            }
-            //if(cfg.verbose && LOGlevel < ConfigureLOG::Level("VERBOSE"))
-            LOG(INFO) << msg;
-
-            ttag = cfg.SPList[npass].getFirstGoodTime();
-            if(ttag < cfg.FirstEpoch) cfg.FirstEpoch = ttag;
-            ttag = cfg.SPList[npass].getLastTime();
-            if(ttag > cfg.LastEpoch) cfg.LastEpoch = ttag;
-
-            // output editing commands
-            for(i=0; i<EditCmds.size(); i++)
-               cfg.ofout << EditCmds[i] << " # pass " << npass+1 << endl;
-            EditCmds.clear();
-
-            // smooth pseudorange and debias phase
-            if(cfg.smooth) {
-               cfg.SPList[npass].smooth(cfg.smoothPR, cfg.smoothPH, msg);
-               LOG(INFO) << msg;
-            }
-
-         }  // end for() loop over passes
+         CorrectPasses();
 
          // -------------------------------- write to RINEX
          iret = WriteToRINEX();
@@ -385,6 +381,182 @@ int main(int argc, char **argv)
 
 }   // end main()
 
+//------------------------------------------------------------------------------------
+// Call the GDC on each good pass, write the editing commands, and smooth.
+// With --threads n > 1 the passes are corrected n at a time; the output is the
+// same as a serial run, as it is written by this thread in pass order.
+void CorrectPasses(void) throw(Exception)
+{
+try {
+#ifndef _WIN32
+   if(cfg.nthreads > 1) {
+      CorrectPassesParallel();
+      return;
+   }
+#endif
+
+   for(int npass=0; npass<cfg.SPList.size(); npass++) {
+      LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << cfg.SPList[npass];
+      //cfg.SPList[npass].dump(*pLOGstrm,"RAW");      // temp
+
+      PassResult R;
+      CorrectPass(npass, cfg.GDConfig, R);
+      ReportPass(npass, R);
+   }
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+//------------------------------------------------------------------------------------
+// Call the GDC on one pass; the number of the pass makes the GDC output
+// independent of the order in which passes are corrected. Touches only the
+// pass itself and R, and so may be called on any thread.
+void CorrectPass(int npass, GDCconfiguration& gdc, PassResult& R) throw()
+{
+   try {
+      R.iret = DiscontinuityCorrector(cfg.SPList[npass], gdc, R.EditCmds, R.msg,
+                                      -99, npass+1);
+   }
+   catch(Exception& e) { R.failed = true; R.fatal = e; }
+   catch(exception& e) {
+      R.failed = true; R.fatal = Exception("std except: "+string(e.what()));
+   }
+   catch(...) { R.failed = true; R.fatal = Exception("Unknown exception"); }
+}
+
+//------------------------------------------------------------------------------------
+// Write the results of the GDC for one pass, and smooth it; main thread only.
+void ReportPass(int npass, PassResult& R) throw(Exception)
+{
+try {
+   if(R.failed) GPSTK_RETHROW(R.fatal);
+
+   if(R.iret != 0) {
+      cfg.SPList[npass].status() = -1;         // failed
+      LOG(ERROR) << "GDC failed (" << R.iret << " "
+         << (R.iret==-1 ? "Singularity":
+            (R.iret==-3 ? "DT not set, or memory":
+            (R.iret==-4 ? "No data":"Bad input")))
+         << ") for pass "
+         << npass+1 << " :\n" << R.msg;
+   }
+   else {
+      //if(cfg.verbose && LOGlevel < ConfigureLOG::Level("VERBOSE"))
+      LOG(INFO) << R.msg;
+
+      Epoch ttag = cfg.SPList[npass].getFirstGoodTime();
+      if(ttag < cfg.FirstEpoch) cfg.FirstEpoch = ttag;
+      ttag = cfg.SPList[npass].getLastTime();
+      if(ttag > cfg.LastEpoch) cfg.LastEpoch = ttag;
+   }
+
+   // output editing commands; those of a failed pass delete it
+   for(int i=0; i<R.EditCmds.size(); i++)
+      cfg.ofout << R.EditCmds[i] << " # pass " << npass+1 << endl;
+   if(R.iret != 0) return;
+
+   // smooth pseudorange and debias phase
+   if(cfg.smooth) {
+      string msg;
+      cfg.SPList[npass].smooth(cfg.smoothPR, cfg.smoothPH, msg);
+      LOG(INFO) << msg;
+   }
+}
+catch(Exception& e) { GPSTK_RETHROW(e); }
+}
+
+#ifndef _WIN32
+//------------------------------------------------------------------------------------
+// Worker thread: correct passes until there are none left. Each pass gets its
+// own copy of the GDC configuration, writing debug output to a buffer.
+static void *PassWorker(void *arg)
+{
+   PassPool& pool = *static_cast<PassPool *>(arg);
+   while(true) {
+      pthread_mutex_lock(&pool.lock);
+      size_t npass(pool.next);
+      if(npass < pool.results.size()) pool.next++;
+      pthread_mutex_unlock(&pool.lock);
+      if(npass >= pool.results.size()) break;
+
+      PassResult& R(pool.results[npass]);
+      ostringstream oss;
+      oss << cfg.SPList[npass];
+      R.proc = oss.str();
+
+      ostringstream dbg;
+      GDCconfiguration gdc(cfg.GDConfig);
+      gdc.setDebugStream(dbg);
+      CorrectPass(npass, gdc, R);
+      R.debug = dbg.str();
+
+      pthread_mutex_lock(&pool.lock);
+      R.done = true;
+      pthread_cond_broadcast(&pool.done);
+      pthread_mutex_unlock(&pool.lock);
+   }
+   return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Correct the passes on cfg.nthreads threads, and report them in order
+void CorrectPassesParallel(void) throw(Exception)
+{
+   PassPool pool;
+   pool.results.resize(cfg.SPList.size());
+   pool.next = 0;
+   pthread_mutex_init(&pool.lock, 0);
+   pthread_cond_init(&pool.done, 0);
+
+   vector<pthread_t> threads;
+   for(int i=0; i<cfg.nthreads; i++) {
+      pthread_t t;
+      if(pthread_create(&t, 0, PassWorker, &pool) == 0)
+         threads.push_back(t);
+   }
+
+   bool failed(false);
+   Exception fatal;
+   for(size_t npass=0; npass<pool.results.size(); npass++) {
+      PassResult& R(pool.results[npass]);
+      pthread_mutex_lock(&pool.lock);
+      if(threads.empty() && !R.done) {          // no thread could be started
+         pool.next = npass+1;
+         pthread_mutex_unlock(&pool.lock);
+         ostringstream oss;
+         oss << cfg.SPList[npass];
+         R.proc = oss.str();
+         CorrectPass(npass, cfg.GDConfig, R);
+         R.done = true;
+      }
+      else {
+         while(!R.done) pthread_cond_wait(&pool.done, &pool.lock);
+         pthread_mutex_unlock(&pool.lock);
+      }
+      LOG(INFO) << "Proc " << setw(2) << npass+1 << " " << R.proc;
+      cfg.oflog << R.debug;
+      try { ReportPass(npass, R); }
+      catch(Exception& e) {
+         failed = true;
+         fatal = e;
+         pthread_mutex_lock(&pool.lock);
+         pool.next = pool.results.size();       // stop the workers
+         pthread_mutex_unlock(&pool.lock);
+         break;
+      }
+      R.EditCmds.clear();
+      R.debug = R.msg = R.proc = string();
+   }
+
+   for(size_t i=0; i<threads.size(); i++)
+      pthread_join(threads[i], 0);
+   pthread_cond_destroy(&pool.done);
+   pthread_mutex_destroy(&pool.lock);
+
+   if(failed) GPSTK_RETHROW(fatal);
+}
+#endif
+
 //------------------------------------------------------------------------------------
 int Initialize(void) throw(Exception)
 {
@@ -800,6 +972,7 @@ try {
       // defaults
    cfg.DChelp = false;
    cfg.verbose = false;
+   cfg.nthreads = 1;
    cfg.decimate = 0.0;
    cfg.begTime = Epoch(CommonTime::BEGINNING_OF_TIME);
    cfg.endTime = Epoch(CommonTime::END_OF_TIME);
@@ -914,6 +1087,8 @@ try {
             "Set DC parameter <param> to <value>");
    opts.Add(0, "DChelp", "", false, false, &cfg.DChelp, "",
             "Print list of DC parameters (all if -v) and their defaults, then quit");
+   opts.Add(0, "threads", "n", false, false, &cfg.nthreads, "",
+            "Correct <n> passes at a time, on separate threads");
 
    opts.Add(0, "log", "file", false, false, &cfg.LogFile, "# Output:",
             "Output log file name (" + cfg.LogFile + ")");
@@ -1013,6 +1188,7 @@ try {
 
    if(cfg.noCA1) cfg.useCA1 = false;
    if(cfg.noCA2) cfg.useCA2 = false;
+   if(cfg.nthreads < 1) cfg.nthreads = 1;
 
    // append errors
    cmdlineErrors += oss.str();
@@ -1137,6 +1313,8 @@ try {
    if(cfg.smoothPR) LOG(INFO) << " 'Smoothed range' option is on\n";
    if(cfg.smoothPH) LOG(INFO) << " 'Smoothed phase' option is on\n";
    if(!cfg.smooth) LOG(INFO) << " No smoothing.\n";
+   if(cfg.nthreads > 1)
+      LOG(INFO) << " Correct " << cfg.nthreads << " passes at a time.\n";
 
 } // end try
 catch(Exception& e) { GPSTK_RETHROW(e); }
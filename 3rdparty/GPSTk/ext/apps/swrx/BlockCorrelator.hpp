@@ -0,0 +1,219 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+#ifndef BLOCKCORRELATOR_HPP
+#define BLOCKCORRELATOR_HPP
+
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// A bank of correlators that share one code delay line and work on whole
+// spans of samples at a time. Each correlator applies its own delay (in
+// samples) to the code, so an early/prompt/late set, or any number of
+// extra taps, is one object.
+//
+// The input is given as separate in-phase and quadrature arrays (already
+// wiped off of carrier) and the code as an array of real chip values
+// (normally +1/-1). Since every delay is then a pair of contiguous dot
+// products, the sums are computed with SIMD instructions when available.
+//
+// The delay line keeps its contents across dump(), so a span may end
+// anywhere, e.g. at the end of an integration period.
+//-----------------------------------------------------------------------------
+template <class C>
+class BlockCorrelator
+{
+public:
+
+   typedef std::complex<C> Ctype;
+
+   /// param delays the number of samples to delay the code by, one entry
+   /// per correlator
+   BlockCorrelator(const std::vector<unsigned>& delays = std::vector<unsigned>())
+   { setDelays(delays); }
+
+   void setDelays(const std::vector<unsigned>& d)
+   {
+      delays = d;
+      maxDelay = delays.empty() ? 0 : *std::max_element(delays.begin(),
+                                                        delays.end());
+      sumI.assign(delays.size(), 0);
+      sumQ.assign(delays.size(), 0);
+      line.clear();
+   }
+
+   const std::vector<unsigned>& getDelays() const throw() {return delays;}
+
+   /// Correlate n samples. inI/inQ are the in-phase and quadrature parts
+   /// of the input and code the local code, all of length n.
+   void process(const C* inI, const C* inQ, const C* code, size_t n)
+   {
+      if (n == 0)
+         return;
+
+      // Until we have seen maxDelay samples, the delayed code is the
+      // first one received.
+      if (line.empty())
+         line.assign(maxDelay, code[0]);
+
+      line.resize(maxDelay + n);
+      std::copy(code, code + n, line.begin() + maxDelay);
+
+      for (size_t i=0; i<delays.size(); i++)
+      {
+         const C* c = &line[maxDelay - delays[i]];
+         dot2(inI, inQ, c, n, sumI[i], sumQ[i]);
+      }
+
+      // Keep the tail of the code for the next span
+      std::copy(line.end() - maxDelay, line.end(), line.begin());
+      line.resize(maxDelay);
+   }
+
+   inline void dump() throw()
+   {
+      std::fill(sumI.begin(), sumI.end(), C(0));
+      std::fill(sumQ.begin(), sumQ.end(), C(0));
+   }
+
+   inline Ctype operator()(size_t i) const throw()
+   {return Ctype(sumI[i], sumQ[i]);}
+
+   size_t size() const throw() {return delays.size();}
+
+private:
+
+   // sI += sum(i[k]*c[k]), sQ += sum(q[k]*c[k])
+   static void dot2(const C* i, const C* q, const C* c, size_t n,
+                    C& sI, C& sQ);
+
+   std::vector<unsigned> delays;
+   unsigned maxDelay;
+   std::vector<C> line;
+   std::vector<C> sumI, sumQ;
+};
+
+
+template <class C>
+void BlockCorrelator<C>::dot2(const C* i, const C* q, const C* c, size_t n,
+                              C& sI, C& sQ)
+{
+   // Independent partial sums so the compiler is free to vectorize
+   C aI[4] = {0, 0, 0, 0}, aQ[4] = {0, 0, 0, 0};
+   size_t k=0;
+   for (; k+4<=n; k+=4)
+      for (int j=0; j<4; j++)
+      {
+         aI[j] += i[k+j] * c[k+j];
+         aQ[j] += q[k+j] * c[k+j];
+      }
+   for (; k<n; k++)
+   {
+      aI[0] += i[k] * c[k];
+      aQ[0] += q[k] * c[k];
+   }
+   sI += (aI[0] + aI[1]) + (aI[2] + aI[3]);
+   sQ += (aQ[0] + aQ[1]) + (aQ[2] + aQ[3]);
+}
+
+
+#if defined(__SSE2__)
+template <>
+inline void BlockCorrelator<double>::dot2(const double* i, const double* q,
+                                          const double* c, size_t n,
+                                          double& sI, double& sQ)
+{
+   __m128d aI0 = _mm_setzero_pd(), aI1 = _mm_setzero_pd();
+   __m128d aQ0 = _mm_setzero_pd(), aQ1 = _mm_setzero_pd();
+   size_t k=0;
+   for (; k+4<=n; k+=4)
+   {
+      __m128d c0 = _mm_loadu_pd(c+k), c1 = _mm_loadu_pd(c+k+2);
+      aI0 = _mm_add_pd(aI0, _mm_mul_pd(_mm_loadu_pd(i+k),   c0));
+      aI1 = _mm_add_pd(aI1, _mm_mul_pd(_mm_loadu_pd(i+k+2), c1));
+      aQ0 = _mm_add_pd(aQ0, _mm_mul_pd(_mm_loadu_pd(q+k),   c0));
+      aQ1 = _mm_add_pd(aQ1, _mm_mul_pd(_mm_loadu_pd(q+k+2), c1));
+   }
+   double tI[2], tQ[2];
+   _mm_storeu_pd(tI, _mm_add_pd(aI0, aI1));
+   _mm_storeu_pd(tQ, _mm_add_pd(aQ0, aQ1));
+   double rI = tI[0] + tI[1], rQ = tQ[0] + tQ[1];
+   for (; k<n; k++)
+   {
+      rI += i[k] * c[k];
+      rQ += q[k] * c[k];
+   }
+   sI += rI;
+   sQ += rQ;
+}
+
+
+template <>
+inline void BlockCorrelator<float>::dot2(const float* i, const float* q,
+                                         const float* c, size_t n,
+                                         float& sI, float& sQ)
+{
+   __m128 aI = _mm_setzero_ps(), aQ = _mm_setzero_ps();
+   size_t k=0;
+   for (; k+4<=n; k+=4)
+   {
+      __m128 c0 = _mm_loadu_ps(c+k);
+      aI = _mm_add_ps(aI, _mm_mul_ps(_mm_loadu_ps(i+k), c0));
+      aQ = _mm_add_ps(aQ, _mm_mul_ps(_mm_loadu_ps(q+k), c0));
+   }
+   float tI[4], tQ[4];
+   _mm_storeu_ps(tI, aI);
+   _mm_storeu_ps(tQ, aQ);
+   float rI = (tI[0] + tI[1]) + (tI[2] + tI[3]);
+   float rQ = (tQ[0] + tQ[1]) + (tQ[2] + tQ[3]);
+   for (; k<n; k++)
+   {
+      rI += i[k] * c[k];
+      rQ += q[k] * c[k];
+   }
+   sI += rI;
+   sQ += rQ;
+}
+#endif
+
+#endif
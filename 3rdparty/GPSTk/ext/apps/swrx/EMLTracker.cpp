@@ -59,9 +59,12 @@ EMLTracker::EMLTracker(CCReplica& localReplica, double codeSpacing) :
    eplSpacing(static_cast<unsigned>((codeSpacing / localReplica.tickSize))),
    baseGain(1.0/(0.1767*1.404))
 {
-   early.setDelay(2*eplSpacing);
-   prompt.setDelay(eplSpacing);
-   late.setDelay(0);
+   // All three see the code one tick after it was generated
+   vector<unsigned> delays(3);
+   delays[0] = 2*eplSpacing + 1;
+   delays[1] = eplSpacing + 1;
+   delays[2] = 1;
+   epl.setDelays(delays);
 
    // Since our 'prompt' code is really a late code we should really advance 
    // our local replica by this amount but not have it count as part of our
@@ -80,77 +83,110 @@ EMLTracker::EMLTracker(CCReplica& localReplica, double codeSpacing) :
 
 bool EMLTracker::process(complex<double> in)
 {
-      //if(periodCount%10 == 0)
-      //{
-      integrate(in);
-         //}
-         //else if(periodCount%10 != 0)
-         //periodCount++;
-
-   if (++iadCount == iadCountMax)
+   bool dumped;
+   processBlock(&in, 1, dumped);
+   return dumped;
+}
+
+
+size_t EMLTracker::process(const complex<float>* in, size_t n, bool& dumped)
+{
+   return processBlock(in, n, dumped);
+}
+
+
+template <class T>
+size_t EMLTracker::processBlock(const complex<T>* in, size_t n, bool& dumped)
+{
+   // Never integrate past the end of the period since closing the loops
+   // changes the replica used for the samples that follow.
+   if (iadCount < iadCountMax && iadCountMax - iadCount < n)
+      n = iadCountMax - iadCount;
+
+   integrate(in, n);
+   iadCount += n;
+
+   dumped = (iadCount == iadCountMax);
+   if (dumped)
    {
       updateLoop();
       // and dump our accumulators
-      early.dump();
-      prompt.dump();
-      late.dump();
+      epl.dump();
       inSumSq = 0;
       lrSumSq = 0;
       iadCount=0;
-         //periodCount++;
-      return true;
    }
-   
-   
 
-   return false;
+   return n;
 }
 
 
-void EMLTracker::integrate(complex<double> in)
+template <class T>
+void EMLTracker::integrate(const complex<T>* in, size_t n)
 {
-   localReplica.tick();
-      
-   // First bring the signal level of the input to the same as the
-   // local replicas
-   in *= baseGain;
-
-   complex<double> carrier = localReplica.getCarrier();
-   complex<double> code = localReplica.getCode() ? plusOne : minusOne;
-
-   // mix in the carrier local replica
-   complex<double> m0 = in * conj(carrier);
-
-   // and sum them up.. (yea, the conj of the codes should be a NoOp)
-   code = conj(code);
-   early.process(m0, code);
-   prompt.process(m0, code);
-   late.process(m0, code);
-
-   // Update our sums for normalizing things...
-   complex<double> lr = conj(carrier) * code;
-   inSumSq += in.real()*in.real() + in.imag()*in.imag();
-   lrSumSq += lr.real()*lr.real() + lr.imag()*lr.imag();
+   mixI.resize(n);
+   mixQ.resize(n);
+   chips.resize(n);
+
+   // Within a span the carrier phase moves by the same amount every tick,
+   // so the replica is rotated instead of evaluated at each sample. It is
+   // evaluated again every few samples to keep the rounding in check.
+   const unsigned reseed = 64;
+   complex<double> rotate = sincos(2.0*PI*(localReplica.cyclesPerTick +
+                                           localReplica.carrierFreqOffset));
+   complex<double> carrier;
+
+   for (size_t k=0; k<n; k++)
+   {
+      localReplica.tick();
+
+      if (k % reseed == 0)
+         carrier = localReplica.getCarrier();
+      else
+         carrier *= rotate;
+
+      // First bring the signal level of the input to the same as the
+      // local replicas
+      complex<double> s(in[k].real(), in[k].imag());
+      s *= baseGain;
+
+      // mix in the carrier local replica
+      complex<double> m0 = s * conj(carrier);
+      mixI[k] = m0.real();
+      mixQ[k] = m0.imag();
+
+      // (the conj of the codes would be a NoOp)
+      chips[k] = localReplica.getCode() ? 1.0 : -1.0;
+
+      // Update our sums for normalizing things...
+      inSumSq += s.real()*s.real() + s.imag()*s.imag();
+      lrSumSq += carrier.real()*carrier.real() + carrier.imag()*carrier.imag();
+   }
+
+   // and sum them up..
+   epl.process(&mixI[0], &mixQ[0], &chips[0], n);
 }
 
 
 void EMLTracker::updateLoop()
 {
+   const complex<double> early = epl(0), prompt = epl(1), late = epl(2);
+
    sqrtSumSq = sqrt(inSumSq*lrSumSq);
 
-   emag = abs(early()) / sqrtSumSq;
-   pmag = abs(prompt()) / sqrtSumSq;
-   lmag = abs(late()) / sqrtSumSq;
+   emag = abs(early) / sqrtSumSq;
+   pmag = abs(prompt) / sqrtSumSq;
+   lmag = abs(late) / sqrtSumSq;
 
-   pI = prompt().real();
-   pQ = prompt().imag();
+   pI = prompt.real();
+   pQ = prompt.imag();
 
    snr= 10*log10(pmag*pmag/localReplica.tickSize);
 
    dllError = lmag - emag;
-   pllError = atan(prompt().imag() / prompt().real()) / PI;
+   pllError = atan(prompt.imag() / prompt.real()) / PI;
 
-   promptPhase =atan2(prompt().imag(), prompt().real()) / PI;
+   promptPhase =atan2(prompt.imag(), prompt.real()) / PI;
 
    DllMode oldDllMode=dllMode;
    // Do we have any idea where the peak may lie?
@@ -170,7 +206,7 @@ void EMLTracker::updateLoop()
 
    // At this point all that is left on the inphase is the nav data
    prevNav = nav;
-   nav = prompt().real() > 0;
+   nav = prompt.real() > 0;
    if(prevNav != nav)
    {
      navChange = true;
@@ -41,11 +41,12 @@
 #include <complex>
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include "GNSSconstants.hpp"
 
 #include "CCReplica.hpp"
-#include "SimpleCorrelator.hpp"
+#include "BlockCorrelator.hpp"
 #include "complex_math.h"
 
 
@@ -65,6 +66,12 @@ public:
    // It returns true when a dump was performed
    virtual bool process(std::complex<double> s) = 0;
 
+   // Processes up to n contiguous samples, stopping right after a dump.
+   // It returns the number of samples used and sets dumped when a dump
+   // was performed.
+   virtual size_t process(const std::complex<float>* in, size_t n,
+                          bool& dumped) = 0;
+
    CCReplica& localReplica;
 };
 
@@ -86,6 +93,9 @@ public:
 
    virtual bool process(std::complex<double> in);
 
+   virtual size_t process(const std::complex<float>* in, size_t n,
+                          bool& dumped);
+
    void dump(std::ostream& s, int detail=0) const;
 
    double pllAlpha, pllBeta, dllAlpha, dllBeta;
@@ -113,7 +123,10 @@ public:
    unsigned getIntegrateCount() const {return iadCount;}
 
 private:
-   void integrate(std::complex<double> in);
+   template <class T>
+   size_t processBlock(const std::complex<T>* in, size_t n, bool& dumped);
+   template <class T>
+   void integrate(const std::complex<T>* in, size_t n);
    void updateLoop();
 
    double pllError, dllError, promptPhase;
@@ -125,7 +138,11 @@ private:
    bool prevNav;
 
 
-   SimpleCorrelator<double> early, prompt, late;
+   // The early, prompt and late correlators, in this order
+   BlockCorrelator<double> epl;
+
+   // Carrier wiped input and code chips for the span being integrated
+   std::vector<double> mixI, mixQ, chips;
    double emag, pmag, lmag, pI, pQ;
 
    // These are used to normalize the correlator counts
@@ -38,11 +38,14 @@
 #define SIMPLECORRELATOR_HPP
 
 #include <complex>
-#include <queue>
+#include <vector>
 #include <iostream>
 
 //-----------------------------------------------------------------------------
 // A correlator with a built in delay line to offset the incoming code.
+// The delay line is a fixed size ring so that no allocation happens per
+// sample. See BlockCorrelator.hpp for a version that works on spans of
+// samples.
 //-----------------------------------------------------------------------------
 template <class C>
 class SimpleCorrelator
@@ -52,27 +55,34 @@ public:
    typedef std::complex<C> Ctype;
 
    /// param d this is the number of samples to delay the code by
-   SimpleCorrelator(unsigned d=0) : delay(d+1), sum(0,0)
-   {}
+   SimpleCorrelator(unsigned d=0) : sum(0,0)
+   {setDelay(d);}
    
    inline void process(std::complex<C> in, Ctype code) throw()
    {
-      shiftReg.push(code);
-      sum += in * shiftReg.front();
-      while (shiftReg.size() > delay)
-         shiftReg.pop();
+      const unsigned len = shiftReg.size();
+      shiftReg[head] = code;
+      if (++head == len)
+         head = 0;
+      if (count < len)
+         count++;
+      // Until the line is full the oldest code is the first one
+      sum += in * shiftReg[count < len ? 0 : head];
    }
    
    inline void dump() throw() {sum=Ctype(0,0);}
 
    inline Ctype operator()() const throw() {return sum;}
 
-   void setDelay(unsigned d) throw() {delay=d+1;}
+   /// Note that this restarts the delay line.
+   void setDelay(unsigned d) throw()
+   {delay=d+1; shiftReg.assign(delay+1, Ctype(0,0)); head=0; count=0;}
    unsigned getDelay() const throw() {return delay-1;}
 
 private:
    unsigned delay;
-   std::queue< Ctype > shiftReg;
+   std::vector< Ctype > shiftReg;
+   unsigned head, count;
    Ctype sum;
 };
 
@@ -49,12 +49,14 @@ Example usage:
       = float quantization(default), 2 bands (default), 5 periods.
 
 
-GCC commands: (not added to Jamfile yet, since this links to FFTW)
+The search wipes the carrier of each Doppler bin off the input once, and
+correlates it against the spectrum of every PRN's code. The code spectra
+are computed once per run and the FFTW plans are made once and shared by
+all the worker threads (-n sets how many, the default is one per CPU).
 
-g++ -c -o acquireMT.o -O -I. -I/.../gpstk/dev/apps/swrx -I/.../gpstk/dev/src acquireMT.cpp
+CMake builds this program when FFTW is found. By hand:
 
-g++ -o acquireMT acquireMT.o /.../gpstk/dev/apps/swrx/simlib.a /.../gpstk/dev/src/libgpstk.a -lm -lstdc++ -lfftw3 -lm -lpthread
-.
+g++ -o acquire acquire.cpp -I. -I<gpstk includes> simlib.a libgpstk.a -lfftw3 -lm -lpthread
 */
 
 #include <math.h>
@@ -62,6 +64,9 @@ g++ -o acquireMT acquireMT.o /.../gpstk/dev/apps/swrx/simlib.a /.../gpstk/dev/sr
 #include <iostream>
 #include <vector>
 #include <fftw3.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 #include "BasicFramework.hpp"
 #include "CommandOption.hpp"
 #include "StringUtils.hpp"
@@ -73,11 +78,85 @@ g++ -o acquireMT acquireMT.o /.../gpstk/dev/apps/swrx/simlib.a /.../gpstk/dev/sr
 using namespace gpstk;
 using namespace std;
 
-struct Par
+//-----------------------------------------------------------------------------
+// A minimal pool: 'threads' workers pull indices 0..size-1 from a shared
+// counter and call work(index, arg) for each.
+//-----------------------------------------------------------------------------
+struct JobList
 {
-   fftw_plan plan;
+   void (*work)(int, void*);
+   void *arg;
+   int size;
+   int next;
+   pthread_mutex_t lock;
 };
-void *compute(void*);
+
+extern "C" void *runJobs(void*);
+
+static void parallelFor(int size, int threads,
+                        void (*work)(int, void*), void *arg)
+{
+   JobList jobs;
+   jobs.work = work;
+   jobs.arg = arg;
+   jobs.size = size;
+   jobs.next = 0;
+   pthread_mutex_init(&jobs.lock, NULL);
+
+   if (threads > size)
+      threads = size;
+   vector<pthread_t> thread_id(threads);
+   for (int i = 0; i < threads; i++)
+   {
+      int rc = pthread_create(&thread_id[i], NULL, runJobs, &jobs);
+      if (rc)
+      {
+         printf("ERROR; return code from pthread_create() is %d\n", rc);
+         exit(-1);
+      }
+   }
+   for (int i = 0; i < threads; i++)
+      pthread_join(thread_id[i], NULL);
+
+   pthread_mutex_destroy(&jobs.lock);
+}
+
+static double now()
+{
+   timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+// Everything the workers share. Results are indexed by [prn][bin] so each
+// job writes its own slots.
+//-----------------------------------------------------------------------------
+struct Search
+{
+   int numSamples;
+   int bins;
+   float sampleRate;
+   float interFreq;
+   float freqSearchWidth;
+   float freqBinWidth;
+
+   fftw_complex* in;             // input, time domain
+   vector<int> prns;
+   vector<fftw_complex*> code;   // code spectrum of each PRN
+
+   // Plans are made once; fftw_execute_dft() may then be called on other
+   // (equally aligned) arrays from any thread.
+   fftw_plan forward, backward;
+
+   vector< vector<double> > peak;
+   vector< vector<int> > shift;
+   vector< vector<double> > seconds;
+   vector<double> codeSeconds;
+};
+
+static void codeSpectrum(int j, void *arg);
+static void searchBin(int i, void *arg);
 
 class Acquire : public BasicFramework
 {
@@ -102,8 +181,7 @@ private:
    int periods;
    int bins;
    int height;
-
-   CCReplica* cc;
+   int threads;
 };
 
 Acquire::Acquire() throw() :
@@ -117,7 +195,8 @@ Acquire::Acquire() throw() :
    freqSearchWidth(20000),
    freqBinWidth(200),
    bins(freqSearchWidth / freqBinWidth + 1),
-   height(40)
+   height(40),
+   threads(sysconf(_SC_NPROCESSORS_ONLN))
 {}
 
 //-----------------------------------------------------------------------------
@@ -166,7 +245,11 @@ bool Acquire::initialize(int argc, char *argv[]) throw()
       heightOpt('z',"height",
                 "The cutoff correlation height for acquisition.  This only "
                 "affects our output.  A SNR measure should replace this "
-                "eventually.  Default is 40");
+                "eventually.  Default is 40"),
+
+      threadsOpt('n',"threads",
+                 "Number of threads used for the search. The default is "
+                 "one per processor.");
 
 
    if (!BasicFramework::initialize(argc,argv))
@@ -234,6 +317,12 @@ bool Acquire::initialize(int argc, char *argv[]) throw()
       height = asInt(heightOpt.getValue().front());
    }
 
+   if(threadsOpt.getCount())
+      threads = asInt(threadsOpt.getValue().front());
+   if(threads < 1)
+      threads = 1;
+
+   numSamples = sampleRate*1e-3*periods;
 
 
    return true;
@@ -242,61 +331,24 @@ bool Acquire::initialize(int argc, char *argv[]) throw()
 //-----------------------------------------------------------------------------
 void Acquire::process()
 {
-// Set up all arrays:
 // fftw_complex data type is a double[2] where the 0 element is the real
 // part and the 1 element is the imaginary part.
-
-// Local code replicas in time domain
-   vector< fftw_complex* > l(bins);
-   for(int i=0;i<bins;i++)
-   {
-      fftw_complex* v;
-      v = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-      l[i] = v;
-   }
-// Input data in time domain
-   fftw_complex* in;
-   in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-// Local code replicas in frequency domain
-   vector< fftw_complex* > L(bins);
-   for(int i=0;i<bins;i++)
-   {
-      fftw_complex* v2;
-      v2 = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-      L[i] = v2;
-   }
-// Input data in frequency domain
-   fftw_complex* IN;
-   IN = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-
-   fftw_complex* I;
-   fftw_complex* O;
-
-// Input * local replica in frequency domain.
-   vector< fftw_complex* > MULT(bins);
-   for(int i=0;i<bins;i++)
-   {
-      fftw_complex* v3;
-      v3 = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-      MULT[i] = v3;
-   }
-// Final results in time domain
-   vector< fftw_complex* > fin(bins);
-   for(int i=0;i<bins;i++)
-   {
-      fftw_complex* v4;
-      v4 = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
-      fin[i] = v4;
-   }
-// -------------------------------------------------------------------
+   Search sr;
+   sr.numSamples = numSamples;
+   sr.bins = bins;
+   sr.sampleRate = sampleRate;
+   sr.interFreq = interFreq;
+   sr.freqSearchWidth = freqSearchWidth;
+   sr.freqBinWidth = freqBinWidth;
+   sr.in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
 
    // Get input code
    int sample = 0;
    complex<float> s;
    while (*input >> s && sample < numSamples)
    {
-      in[sample][0] = real(s);
-      in[sample][1] = imag(s);
+      sr.in[sample][0] = real(s);
+      sr.in[sample][1] = imag(s);
       sample ++;
       for(int i = 1; i < bands; i++)
       {*input >> s;} // gpsSim outputs 2 bands (L1 and L2),
@@ -305,128 +357,49 @@ void Acquire::process()
          // the input from L2, or any other bands.
    }
 
-   int count;
    if(prn == 0)  // Check if we are tracking all prns or just one.
-   {
-      count = 32;
-      prn = 1;
-   }
+      for(int i = 1; i <= 32; i++)
+         sr.prns.push_back(i);
    else
-      count = 1;
-
-   while(count > 0)
-   {
-      count--;
-      CACodeGenerator* codeGenPtr = new CACodeGenerator(prn);
-      float chipFreq = gpstk::CA_CHIP_FREQ;
+      sr.prns.push_back(prn);
 
-      // Convert input code to frequency domain.
-      fftw_plan p;
-      p = fftw_plan_dft_1d(numSamples, in, IN, FFTW_FORWARD, FFTW_ESTIMATE);
-      fftw_execute(p);
-
-      // Create local code replicas for each frequency bin.
-      float f = -(freqSearchWidth/2); // initial doppler offset
-      for(int i = 0; i < bins; i++)
-      {
-         cc = new CCReplica(1/sampleRate, chipFreq, interFreq+f, codeGenPtr);
-         cc->reset();
-         for(int k = 0; k < numSamples; k++)
-         {
-            complex<double> carrier = cc->getCarrier();
-            complex<double> code = cc->getCode() ? 1 : -1;
-            l[i][k][0] = real((complex<double>)((code) * (carrier)));
-            l[i][k][1] = imag((complex<double>)((code) * (carrier)));
-            cc->tick();
-         }
-         f += freqBinWidth;
-      }
+   int nprn = sr.prns.size();
 
-      // Convert local code replicas to frequency domain.
-      fftw_plan plans[bins];
-      pthread_t thread_id[bins];
-      vector<Par> par(bins);
-      int rc;
-      for(int i = 0; i < bins; i++)
-      {
-         plans[i] = fftw_plan_dft_1d
-            (numSamples, l[i], L[i], FFTW_FORWARD, FFTW_ESTIMATE);
-         par[i].plan = plans[i];
-      }
+   double t0 = now();
 
-      // Execute FFTs
-      for(int i = 0; i < bins; i++)
-      {
-         rc = pthread_create( &thread_id[i], NULL, compute, &par[i] ) ;
-         if (rc)
-         {
-            printf("ERROR; return code from pthread_create() is %d\n", rc);
-            exit(-1);
-         }
-      }
+   fftw_complex* a = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+   fftw_complex* b = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * numSamples);
+   sr.forward = fftw_plan_dft_1d(numSamples, a, b, FFTW_FORWARD, FFTW_ESTIMATE);
+   sr.backward = fftw_plan_dft_1d(numSamples, a, b, FFTW_BACKWARD, FFTW_ESTIMATE);
+   fftw_free(a);
+   fftw_free(b);
 
-      for(int i = 0; i < bins; i++)
-      {
-         rc = pthread_join( thread_id[i], NULL) ;
-         if (rc)
-         {
-            printf("ERROR; return code from pthread_join() is %d\n", rc);
-            exit(-1);
-         }
-      }
+   sr.code.resize(nprn);
+   sr.codeSeconds.resize(nprn);
+   sr.peak.assign(nprn, vector<double>(bins, 0.0));
+   sr.shift.assign(nprn, vector<int>(bins, 0));
+   sr.seconds.assign(nprn, vector<double>(bins, 0.0));
 
-         // above code replaces following block which = no multithreading.
-      /*for(int i = 0; i < bins ; i++)
-      {
-         fftw_execute(plans[i]);
-      } */
+   // Code spectra first, they are used by every Doppler bin
+   parallelFor(nprn, threads, codeSpectrum, &sr);
+   parallelFor(bins, threads, searchBin, &sr);
 
-      // NOTE: may want to put following  multiplication into the pthread
-      // function.
-      // Will need to pass #bins, #samples and pointers to vectors in a Par.
+   double t1 = now();
 
-      // Right now we're only using pthreads to compute FFT's of local codes
-      // in parallel, and there is hardly any performance increase.
+   for(int j = 0; j < nprn; j++)
+   {
+      prn = sr.prns[j];
 
-   // Multiply conjugate of input frequency samples by
-   // local frequency samples (point by point).
-      complex<double> lo;
-      complex<double> input;
-      complex<double> temp;
+      double max = 0.0, time = sr.codeSeconds[j];
+      int bin = 0, shift = 0;
       for(int i = 0; i < bins; i++)
       {
-         for(int k = 0; k < numSamples; k++)
+         time += sr.seconds[j][i];
+         if(sr.peak[j][i] > max)
          {
-            lo = (complex<double>(L[i][k][0],L[i][k][1]))
-               /(double)sqrt(numSamples);
-            input = conj(complex<double>(IN[k][0],IN[k][1]))
-               /(double)sqrt(numSamples);
-            temp = lo * input;
-            MULT[i][k][0] = real(temp);
-            MULT[i][k][1] = imag(temp);
-         }
-      }
-      // Convert back to time domain and find peak.
-      for(int i = 0; i < bins; i++)
-      {
-         p = fftw_plan_dft_1d(numSamples, MULT[i], fin[i], 1, FFTW_ESTIMATE);
-         fftw_execute(p);
-      }
-      double max = 0.0;
-      int bin, shift;
-      for(int i = 0; i < bins; i++)
-      {
-         for(int k = 0; k < numSamples; k++)
-         {
-            fin[i][k][0] = abs(complex<double>
-                               (fin[i][k][0],fin[i][k][1])
-                               / (double)sqrt(numSamples));
-            if(real(complex<double>(fin[i][k][0],fin[i][k][1])) > max)
-            {
-               max = real(complex<double>(fin[i][k][0],fin[i][k][1]));
-               shift = k;
-               bin = i;
-            }
+            max = sr.peak[j][i];
+            shift = sr.shift[j][i];
+            bin = i;
          }
       }
 
@@ -454,16 +427,121 @@ void Acquire::process()
       // At some point need to add a more sophisticated check for successful
       // acquisition like a snr measure, although a simple cutoff works well.
 
+      // Time spent on this PRN, summed over all threads
+      cout << "       - Search time: " << time * 1e3 << " ms" << endl;
+
+      fftw_free(sr.code[j]);
+   }
+
+   cout << "Searched " << nprn << " PRN(s) x " << bins << " bins in "
+        << (t1 - t0) * 1e3 << " ms using " << threads << " thread(s)" << endl;
+
+   fftw_destroy_plan(sr.forward);
+   fftw_destroy_plan(sr.backward);
+   fftw_free(sr.in);
+}
+
+//-----------------------------------------------------------------------------
+// Computes the spectrum of the code of PRN number j in the list.
+//-----------------------------------------------------------------------------
+static void codeSpectrum(int j, void *arg)
+{
+   Search& sr = *(Search*)arg;
+   double t0 = now();
+   int n = sr.numSamples;
 
-      // Output correlation curve for graphing purposes.
-      /*for(int k = 0; k < numSamples; k++)
+   fftw_complex* l = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+   sr.code[j] = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+
+   CCReplica cc(1/sr.sampleRate, gpstk::CA_CHIP_FREQ_GPS, sr.interFreq,
+                new CACodeGenerator(sr.prns[j]));
+   cc.reset();
+   for(int k = 0; k < n; k++)
+   {
+      l[k][0] = cc.getCode() ? 1 : -1;
+      l[k][1] = 0;
+      cc.tick();
+   }
+
+   fftw_execute_dft(sr.forward, l, sr.code[j]);
+   fftw_free(l);
+
+   sr.codeSeconds[j] = now() - t0;
+}
+
+//-----------------------------------------------------------------------------
+// Wipes the carrier of Doppler bin i off the input and correlates the
+// result with every PRN's code.
+//-----------------------------------------------------------------------------
+static void searchBin(int i, void *arg)
+{
+   Search& sr = *(Search*)arg;
+   double t0 = now();
+   int n = sr.numSamples;
+   double scale = 1.0 / n;
+   double norm = 1.0 / sqrt((double)n);
+
+   fftw_complex* w = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+   fftw_complex* W = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+   fftw_complex* mult = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+   fftw_complex* fin = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * n);
+
+   float f = -(sr.freqSearchWidth/2) + i*sr.freqBinWidth;
+   CCReplica cc(1/sr.sampleRate, gpstk::CA_CHIP_FREQ_GPS, sr.interFreq+f,
+                new CACodeGenerator(1));
+   cc.reset();
+   for(int k = 0; k < n; k++)
+   {
+      complex<double> x = complex<double>(sr.in[k][0], sr.in[k][1])
+                        * conj(cc.getCarrier());
+      w[k][0] = real(x);
+      w[k][1] = imag(x);
+      cc.tick();
+   }
+   fftw_execute_dft(sr.forward, w, W);
+
+   // The input spectrum is shared by all PRNs, so split its time evenly
+   double shared = (now() - t0) / sr.prns.size();
+
+   for(size_t j = 0; j < sr.prns.size(); j++)
+   {
+      double t1 = now();
+
+   // Multiply the local code spectrum by the conjugate of the input
+   // spectrum (point by point) and go back to the time domain.
+      const fftw_complex* C = sr.code[j];
+      for(int k = 0; k < n; k++)
       {
-         cout << float((k/16.368)*1.023) << " " << (fin[bin][k][0]) << endl;
-      }*/
-      prn++;
-      fftw_destroy_plan(p);
-   } //while
-   fftw_free(IN); fftw_free(in);
+         complex<double> temp = complex<double>(C[k][0], C[k][1])
+                              * conj(complex<double>(W[k][0], W[k][1]))
+                              * scale;
+         mult[k][0] = real(temp);
+         mult[k][1] = imag(temp);
+      }
+      fftw_execute_dft(sr.backward, mult, fin);
+
+      // Find the peak
+      double max = 0.0;
+      int shift = 0;
+      for(int k = 0; k < n; k++)
+      {
+         double mag = abs(complex<double>(fin[k][0], fin[k][1])) * norm;
+         if(mag > max)
+         {
+            max = mag;
+            shift = k;
+         }
+      }
+
+      sr.peak[j][i] = max;
+      sr.shift[j][i] = shift;
+      sr.seconds[j][i] = shared + now() - t1;
+   }
+
+   fftw_free(w);
+   fftw_free(W);
+   fftw_free(mult);
+   fftw_free(fin);
 }
 
 //-----------------------------------------------------------------------------
@@ -484,9 +562,17 @@ int main(int argc, char *argv[])
    { cerr << "Caught unknown exception" << endl; }
 }
 
-void *compute(void *par)
+void *runJobs(void *p)
 {
-   Par *p = (Par*)par;
-   fftw_plan plan = p->plan;
-   fftw_execute(plan);
+   JobList *jobs = (JobList*)p;
+   while (true)
+   {
+      pthread_mutex_lock(&jobs->lock);
+      int i = jobs->next++;
+      pthread_mutex_unlock(&jobs->lock);
+      if (i >= jobs->size)
+         break;
+      jobs->work(i, jobs->arg);
+   }
+   return NULL;
 }
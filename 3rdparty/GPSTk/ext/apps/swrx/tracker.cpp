@@ -298,50 +298,75 @@ void RxSim::process()
    nf.debugLevel = debugLevel;
    nf.dump(cout);
 
+   // Samples of the band being tracked are gathered in blocks and handed
+   // to the tracker a span at a time. Along with each sample we keep its
+   // position in the input for the nav framer.
+   const size_t blockSize = 16384;
+   vector< complex<float> > block;
+   vector<long int> blockPoint;
+   block.reserve(blockSize);
+   blockPoint.reserve(blockSize);
+
    complex<float> s;
    int b=0;
-   while (*input >> s)
+   bool more = true;
+   while (more)
    {
-      if (b == band-1 || input->bands==1)
+      block.clear();
+      blockPoint.clear();
+      while (block.size() < blockSize)
       {
-         s *= gain;
-         if (tr->process(s))
+         if (!(*input >> s))
+         {
+            more = false;
+            break;
+         }
+         if (b == band-1 || input->bands==1)
          {
+            s *= gain;
+            block.push_back(s);
+            blockPoint.push_back(dataPoint);
+         }
+         b++;
+         b %= input->bands;
+         dataPoint++;
+      }
+
+      size_t i=0;
+      while (i < block.size())
+      {
+         bool dumped;
+         i += tr->process(&block[i], block.size() - i, dumped);
+         if (dumped)
+         {
+            long int dp = blockPoint[i-1];
+
             if (verboseLevel)
                tr->dump(cout);
 
-               // Test code to skip input to speed up tracking.
-               /*int count2 = 0;
-            while(count2 < 3*16367)
-            {
-               count2++;
-               *input >> s;
-               }*/
-
 // Following two if statements are specific to tracker updating every
 // 1 ms.
             if(tr->navChange)
             {
-               nf.process(*tr, dataPoint,
+               nf.process(*tr, dp,
                           (float)tr->localReplica.getCodePhaseOffsetSec()*1e6);
                count = 0;
             }
             if(count == 20)
             {
                count = 0;
-               nf.process(*tr, dataPoint,
+               nf.process(*tr, dp,
                           (float)tr->localReplica.getCodePhaseOffsetSec()*1e6);
             }
             count++;
          }
-      }
-      b++;
-      b %= input->bands;
-
-      if (cc->localTime > timeLimit)
-         break;
 
-      dataPoint++;
+         if (cc->localTime > timeLimit)
+         {
+            more = false;
+            break;
+         }
+      }
    }
 }
 
@@ -206,6 +206,7 @@ bool RxSim::initialize(int argc, char *argv[]) throw()
       interFreq = asDouble(interFreqOpt.getValue().front()) * 1e6;
 
    numTrackers = codeOpt.getCount();
+   tr.resize(numTrackers);
    for (int i=0; i < (int)codeOpt.getCount(); i++)
    {
       string val=codeOpt.getValue()[i];
@@ -430,7 +431,14 @@ void *Cfunction(void* p)
 
    while(index < bufferSize + 1) // number of data points to track before join.
    {
-      if (tr->process(b->arr[index]))
+      // Hand the tracker everything up to its next dump and move to the
+      // last sample it used.
+      bool dumped;
+      int used = tr->process(&b->arr[index], bufferSize + 1 - index, dumped);
+      index += used - 1;
+      dp += used - 1;
+
+      if (dumped)
       {
          if(v)
             tr->dump(cout);
@@ -281,9 +281,34 @@ namespace gpstk
       throw(InvalidRequest)
    {
 
-         // Here we store the necessary IONEX-extracted values 
-         // (i.e, TEC, RMS, ionosphere height)
-      Triple tecval(0.0,0.0,0.0);
+      try
+      {
+         return getIonexValue( findMaps(t, strategy), RX );
+      }
+      catch(InvalidRequest& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+
+   }  // End of method 'IonexStore::getIonexValue()'
+
+
+
+      /* Find the maps and weights getIonexValue() uses at an epoch.
+       *
+       * @param t          Time tag of signal (CommonTime object)
+       * @param strategy   Interpolation strategy, as in getIonexValue()
+       *
+       * @return           The maps and their weights
+       */
+   IonexStore::EpochMaps IonexStore::findMaps( const CommonTime& t,
+                                               int strategy ) const
+      throw(InvalidRequest)
+   {
+
+      EpochMaps maps;
+      maps.epoch = t;
+      maps.strategy = strategy;
 
          // current time check
       if (t < getInitialTime())
@@ -296,25 +321,13 @@ namespace gpstk
       {
          InvalidRequest e("Inadequate data after requested time");
          GPSTK_THROW(e);
-      }
-
-         // this never should happen but just in case
-      Position pos(RX);
-      if ( pos.getSystemName() != "Geocentric" )
-      {
-
-         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
-
-         GPSTK_THROW(e);
-
       }
 
          //let's define the number of maps to be considered
-      int nmap;
-      if      (strategy == 1) nmap = 1;
-      else if (strategy == 2) nmap = 2;
-      else if (strategy == 3) nmap = 2;
-      else if (strategy == 4) nmap = 1;
+      if      (strategy == 1) maps.nmap = 1;
+      else if (strategy == 2) maps.nmap = 2;
+      else if (strategy == 3) maps.nmap = 2;
+      else if (strategy == 4) maps.nmap = 1;
       else
       {
          InvalidRequest e("Invalid interpolation stategy");
@@ -322,48 +335,56 @@ namespace gpstk
       }
 
          // let's look for valid Ionex maps
-      CommonTime T[2];
+      CommonTime* T = maps.T;
          // iterator
-      IonexMap::const_iterator itm = inxMaps.find(t);
-      try
+      IonexMap::const_iterator itm = inxMaps.lower_bound(t);
+      if( itm == inxMaps.end() || inxMaps.size() < 2 )
       {
+         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
+         GPSTK_THROW(e);
+      }
 
-         if( itm != inxMaps.end() )              // exact match of t
-         {
+      if( itm->first == t )                     // exact match of t
+      {
 
-               // get the current map
-            itm = inxMaps.lower_bound(t);
-               // store current and next epoch
+            // store current and next epoch; at the last map, use the
+            // previous and current epoch instead
+         IonexMap::const_iterator itn = itm;
+         if( ++itn != inxMaps.end() )
+         {
             T[0] = itm->first;
-            T[1] = (++itm)->first;
-
+            T[1] = itn->first;
          }
-         else                                   // t is between two maps
+         else
          {
-
-               // get the next valid map
-            itm = inxMaps.lower_bound(t);
-               // store the next and previous epoch
             T[1] = itm->first;
             T[0] = (--itm)->first;
-
-         }  // end of 'if( itm != inxMaps.end() ) ... else ... '' 
+         }
 
       }
-      catch (...)
+      else                                      // t is between two maps
       {
-         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
-         GPSTK_THROW(e);
-      }
+
+         if( itm == inxMaps.begin() )
+         {
+            InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
+            GPSTK_THROW(e);
+         }
+
+            // store the next and previous epoch
+         T[1] = itm->first;
+         T[0] = (--itm)->first;
+
+      }  // end of 'if( itm->first == t ) ... else ... '' 
 
 
          // factors (As in Eq.(3), pag.2 of the manual)
-      double f[2];
+      double* f = maps.f;
       f[0] = (T[1]-t   ) / (T[1]-T[0]);
       f[1] = (t   -T[0]) / (T[1]-T[0]);
 
          // if only one map, then we have to use the neareast
-      if( nmap == 1 )
+      if( maps.nmap == 1 )
       {
 
             // closer to the next map
@@ -377,56 +398,86 @@ namespace gpstk
 
       }  // if( nmap == 1 )
 
+         // the TEC and RMS maps at each epoch
+      for(int imap = 0; imap < maps.nmap; imap++)
+      {
+
+         const IonexValTypeMap& ivtm = inxMaps.find(T[imap])->second;
+         IonexValTypeMap::const_iterator itv;
+
+         itv = ivtm.find(IonexData::TEC);
+         maps.tec[imap] = (itv != ivtm.end()) ? &itv->second : NULL;
+
+         itv = ivtm.find(IonexData::RMS);
+         maps.rms[imap] = (itv != ivtm.end()) ? &itv->second : NULL;
+
+      }
+
+      return maps;
+
+   }  // End of method 'IonexStore::findMaps()'
+
+
+
+      /* Get IONEX TEC, RMS and ionosphere height values at the epoch
+       * and with the maps found by findMaps().
+       *
+       * @param maps       Maps and weights for the epoch
+       * @param RX         Position of interest, in GEOCENTRIC coordinates
+       *
+       * @return values    TEC, RMS and ionosphere height values
+       */
+   Triple IonexStore::getIonexValue( const EpochMaps& maps,
+                                     const Position& RX ) const
+      throw(InvalidRequest)
+   {
+
+         // Here we store the necessary IONEX-extracted values 
+         // (i.e, TEC, RMS, ionosphere height)
+      Triple tecval(0.0,0.0,0.0);
+
+         // this never should happen but just in case
+      if ( RX.getCoordinateSystem() != Position::Geocentric )
+      {
+
+         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
+
+         GPSTK_THROW(e);
+
+      }
+
          // loop over the number of maps considered
-      for(int imap = 0; imap < nmap; imap++)
+      for(int imap = 0; imap < maps.nmap; imap++)
       {
 
             // now let's determine if we keep fixed position or 
             // take into account the rotation around the Sun
-         Position pos;
-         if (strategy == 1 || strategy == 2)    // fixed position
-         {
-
-            pos = RX;
-
-         }
-         else                                   // rotate the position
+         Position pos(RX);
+         if (maps.strategy == 3 || maps.strategy == 4)   // rotate the position
          {
 
                // seconds of time to degree (360.0 / 86400.0)
             double sec2deg( 4.16666666666667e-3 );
 
                // count the rotation
-            pos = RX;
-            pos.theArray[1] = pos.theArray[1] + ( t - T[imap] ) * sec2deg;
-
-         }  // End of 'if (strategy == 1 || strategy == 2)...'
+            pos.theArray[1] = pos.theArray[1]
+                              + ( maps.epoch - maps.T[imap] ) * sec2deg;
 
-
-            // iterator to the current map
-         itm = inxMaps.find(T[imap]);
-
-            // map to hold the IONEX types for the current map
-         IonexValTypeMap ivtm = (*itm).second;
-
-            // object to hold the corresponding data to the current map
-         IonexData iod;
+         }  // End of 'if (strategy == 3 || strategy == 4)...'
 
             // Compute TEC value
-         if ( ivtm.find(IonexData::TEC) != ivtm.end() )
+         if ( maps.tec[imap] != NULL )
          {
 
-            iod = ivtm[IonexData::TEC];
-            tecval[0] = tecval[0] + f[imap]*iod.getValue(pos);
+            tecval[0] = tecval[0] + maps.f[imap]*maps.tec[imap]->getValue(pos);
 
          }
 
             // Compute RMS value
-         if ( ivtm.find(IonexData::RMS) != ivtm.end() )
+         if ( maps.rms[imap] != NULL )
          {
 
-            iod = ivtm[IonexData::RMS];
-            tecval[1] = tecval[1] + f[imap]*iod.getValue(pos);
+            tecval[1] = tecval[1] + maps.f[imap]*maps.rms[imap]->getValue(pos);
 
          }
 
@@ -442,6 +493,7 @@ namespace gpstk
 
 
 
+
       /** Get slant total electron content (STEC) in TECU
        *
        * @param elevation     Time tag of signal (CommonTime object)
@@ -147,6 +147,53 @@ namespace gpstk
          throw(InvalidRequest);
 
 
+         /** The maps bracketing an epoch and their interpolation weights.
+          *  They depend only on the epoch, so they may be found once with
+          *  findMaps() and then used for every pierce point of that epoch.
+          *  The pointers refer to data in the store, and are not valid
+          *  after the store is changed.
+          */
+      struct EpochMaps
+      {
+         EpochMaps() : strategy(0), nmap(0)
+         { tec[0] = tec[1] = rms[0] = rms[1] = NULL; f[0] = f[1] = 0.0; }
+
+         CommonTime epoch;          ///< Epoch of interest
+         int strategy;              ///< Interpolation strategy
+         int nmap;                  ///< Number of maps used (1 or 2)
+         CommonTime T[2];           ///< Epochs of the maps used
+         double f[2];               ///< Weight of each map
+         const IonexData *tec[2];   ///< TEC map at T[i], or NULL
+         const IonexData *rms[2];   ///< RMS map at T[i], or NULL
+      };
+
+
+         /** Find the maps and weights getIonexValue() uses at an epoch.
+          *
+          * @param t          Time tag of signal (CommonTime object)
+          * @param strategy   Interpolation strategy, as in getIonexValue()
+          *
+          * @return           The maps and their weights
+          */
+      EpochMaps findMaps( const CommonTime& t,
+                          int strategy = 3 ) const
+         throw(InvalidRequest);
+
+
+         /** Get IONEX TEC, RMS and ionosphere height values at the epoch
+          *  and with the maps found by findMaps(). This equals
+          *  getIonexValue(maps.epoch, RX, maps.strategy).
+          *
+          * @param maps       Maps and weights for the epoch
+          * @param RX         Position of interest, in GEOCENTRIC coordinates
+          *
+          * @return values    TEC, RMS and ionosphere height values
+          */
+      Triple getIonexValue( const EpochMaps& maps,
+                            const Position& RX ) const
+         throw(InvalidRequest);
+
+
 
       /** Get slant total electron content (STEC) in TECU
        *
@@ -309,7 +309,11 @@ public:
    static const unsigned short GFDETECT;
    static const unsigned short GFFIX;
 
-   explicit GDCPass(SatPass& sp, const GDCconfiguration& gdc);
+   GDCPass(SatPass& sp, const GDCconfiguration& gdc, int unique);
+
+   /// define wavelengths and other constants for this satellite, given the
+   /// GLONASS frequency channel n
+   void defineWavelengths(int n) throw();
 
    //~GDCPass(void) { };
 
@@ -494,6 +498,20 @@ private:
    /// keep count of various results: slips, deletions, etc.; print to log in finish()
    map<string,int> learn;
 
+   /// number of this call, used in the log and in the return message, and
+   /// number of each (WL,GF) fix within it
+   int GDCUnique, GDCUniqueFix;
+
+   /// obs types of the data; indexes into both data and this vector are L1,L2,etc.
+   vector<string> DCobstypes;
+
+   /// GLONASS frequency channel, and wavelength and other frequency-dependent
+   /// quantities for this satellite; constants used in linear combinations
+   int GLOn;
+   double wl1,wl2,wlwl,wlgf;        // wavelengths: L1,L2,widelane,narrowlane
+   double wl1r,wl2r,wl1p,wl2p;      // coefficients in widelane linear combinations
+   double gf1r,gf2r,gf1p,gf2p;      // coefficients in geometry-free linear combinations
+
 }; // end class GDCPass
 
 //------------------------------------------------------------------------------------
@@ -506,7 +524,6 @@ static const int P1 = 2;
 static const int P2 = 3;
 static const int A1 = 4;
 static const int A2 = 5;
-vector<string> DCobstypes; // indexes into both data and this vector are L1,L2,etc...
 
 //------------------------------------------------------------------------------------
 // Return values (used by all routines within this module):
@@ -519,19 +536,11 @@ static const int Singular=-1;
 static const int ReturnOK=0;
 
 //------------------------------------------------------------------------------------
-// these are used only to associate a unique number in the log file with each pass
-static int GDCUnique=0;     // unique number for each call
-static int GDCUniqueFix;    // unique for each (WL,GF) fix
+// this is used only to associate a unique number in the log file with each pass,
+// when the caller does not give one
+static int GDCCount=0;      // number of calls
 static string GDCtag="GDC"; // begin each line of return message
 
-//------------------------------------------------------------------------------------
-// wavelength and other frequency-dependent quantities, determined early in DC()
-// constants used in linear combinations
-int GLOn;
-double wl1,wl2,wlwl,wlgf;        // wavelengths: L1,L2,widelane,narrowlane
-double wl1r,wl2r,wl1p,wl2p;      // coefficients in widelane linear combinations
-double gf1r,gf2r,gf1p,gf2p;      // coefficients in geometry-free linear combinations
-
 //------------------------------------------------------------------------------------
 // Flags - constants used to mark slips, etc. using the SatPass flag:
 //------------------------------------------------------------------------------------
@@ -571,23 +580,27 @@ int gpstk::DiscontinuityCorrector(SatPass& svp,
                                   GDCconfiguration& gdc,
                                   vector<string>& editCmds,
                                   string& retMessage,
-                                  int GLOn_in)
+                                  int GLOn_in,
+                                  int unique)
    throw(Exception)
 {
 try {
    unsigned int i,j;
    int iret;
 
-   if(gdc.getParameter("ResetUnique") != 0)
-      { GDCUnique=0; gdc.setParameter("ResetUnique=0"); }
-   GDCUnique++;
+   if(unique == 0) {
+      if(gdc.getParameter("ResetUnique") != 0)
+         { GDCCount=0; gdc.setParameter("ResetUnique=0"); }
+      unique = ++GDCCount;
+   }
 
    //if(!retMessage.empty()) { GDCtag = retMessage; }
    retMessage = "";
 
    // --------------------------------------------------------------------------------
    // require obstypes L1,L2,C1/P1,C2/P2, and add two auxiliary arrays
-   DCobstypes.clear();
+   // indexes into both data and this vector are L1,L2,etc...
+   vector<string> DCobstypes;
    DCobstypes.push_back("L1");
    DCobstypes.push_back("L2");
    DCobstypes.push_back((int(gdc.getParameter("useCA1"))) == 0 ? "P1" : "C1");
@@ -634,12 +647,12 @@ try {
 
    // --------------------------------------------------------------------------------
    // create a GDCPass from the input SatPass (modified) and GDC configuration
-   GDCPass gp(nsvp,gdc);
+   GDCPass gp(nsvp,gdc,unique);
 
    // --------------------------------------------------------------------------------
    // if the satellite is Glonass, compute the frequency channel, if necessary,
    // and define wavelengths and other constants for this satellite
-   GLOn = GLOn_in;
+   int GLOn(GLOn_in);
    if(sat.system == SatID::systemGlonass) {
 
       // only compute it if it is out of range
@@ -653,7 +666,7 @@ try {
          }
          else {
             ostringstream oss;
-            oss << GDCtag << " " << setw(3) << GDCUnique << " " << sat
+            oss << GDCtag << " " << setw(3) << unique << " " << sat
                << " " << printTime(svp.getFirstTime(),svp.outFormat)
                << " is returning with error code: failed to find GLONASS frequency\n"
                << msg << endl;
@@ -662,55 +675,8 @@ try {
          }
       }
 
-      // GLO Frequency(Hz) L1 is 1602.0e6 + n*562.5e3 Hz = 9 * (178 + n*0.0625) MHz
-      //                   L2    1246.0e6 + n*437.5e3 Hz = 7 * (178 + n*0.0625) MHz
-      // Note that L1/L2 is always 9/7 for freq, 7/9 for wavelength
-      static const double GLOfreq0L1=1602.0e6;
-      static const double GLOdfreqL1= 562.5e3;
-      static const double GLOfreq0L2=1246.0e6;
-      static const double GLOdfreqL2= 437.5e3;
-      static const double F1oF2 = 9.0/7.0;
-      static const double F2oF1 = 7.0/9.0;
-
-      wl1 = C_MPS/(GLOfreq0L1 + GLOn*GLOdfreqL1);
-      wl2 = C_MPS/(GLOfreq0L2 + GLOn*GLOdfreqL2);
-      wlwl = 1.0 / (1.0/wl1 - 1.0/wl2);
-      wlgf = wl2 - wl1;
-
-      wl1r = 1.0/(1.0+F2oF1);
-      wl2r = 1.0/(1.0+F1oF2);
-      wl1p = wl1/(1.0-F2oF1);
-      wl2p = wl2/(1.0-F1oF2);
-
-      gf1r = -1.0;
-      gf2r = 1.0;
-      gf1p = wl1;
-      gf2p = -wl2;
-   }
-   else {                                                   // GPS satellite
-      static const double CFF=C_MPS/OSC_FREQ_GPS;
-      static const double wl1_GPS = CFF/L1_MULT_GPS;            // 19.0cm
-      static const double wl2_GPS = CFF/L2_MULT_GPS;            // 24.4cm
-      static const double wlwl_GPS = CFF/(L1_MULT_GPS-L2_MULT_GPS); // 86.2cm
-      static const double wlgf_GPS = wl2_GPS - wl1_GPS;     //  5.4cm
-      static const double F1oF2 = L1_MULT_GPS/L2_MULT_GPS;          // 77/60
-      static const double F2oF1 = L2_MULT_GPS/L1_MULT_GPS;          // 60/77
-
-      wl1 = wl1_GPS;
-      wl2 = wl2_GPS;
-      wlwl = wlwl_GPS;
-      wlgf = wlgf_GPS;
-
-      wl1r = 1.0/(1.0+F2oF1);
-      wl2r = 1.0/(1.0+F1oF2);
-      wl1p = wl1/(1.0-F2oF1);
-      wl2p = wl2/(1.0-F1oF2);
-
-      gf1r = -1.0;
-      gf2r = 1.0;
-      gf1p = wl1;
-      gf2p = -wl2;
    }
+   gp.defineWavelengths(GLOn);
 
    // --------------------------------------------------------------------------------
    // implement the DC algorithm using the GDCPass
@@ -754,8 +720,9 @@ catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 //------------------------------------------------------------------------------------
 // class GDCPass member functions
 //------------------------------------------------------------------------------------
-GDCPass::GDCPass(SatPass& sp, const GDCconfiguration& gdc)
-      : SatPass(sp.getSat(), sp.getDT(), sp.getObsTypes())
+GDCPass::GDCPass(SatPass& sp, const GDCconfiguration& gdc, int unique)
+      : SatPass(sp.getSat(), sp.getDT(), sp.getObsTypes()),
+        GDCUnique(unique), GDCUniqueFix(0), DCobstypes(sp.getObsTypes()), GLOn(0)
 {
    int i,j;
    Status = sp.status();
@@ -786,6 +753,64 @@ GDCPass::GDCPass(SatPass& sp, const GDCconfiguration& gdc)
    learn.clear();
 }
 
+//------------------------------------------------------------------------------------
+// define wavelengths and other constants for this satellite, given the GLONASS
+// frequency channel n
+void GDCPass::defineWavelengths(int n) throw()
+{
+   GLOn = n;
+   if(sat.system == SatID::systemGlonass) {
+      // GLO Frequency(Hz) L1 is 1602.0e6 + n*562.5e3 Hz = 9 * (178 + n*0.0625) MHz
+      //                   L2    1246.0e6 + n*437.5e3 Hz = 7 * (178 + n*0.0625) MHz
+      // Note that L1/L2 is always 9/7 for freq, 7/9 for wavelength
+      static const double GLOfreq0L1=1602.0e6;
+      static const double GLOdfreqL1= 562.5e3;
+      static const double GLOfreq0L2=1246.0e6;
+      static const double GLOdfreqL2= 437.5e3;
+      static const double F1oF2 = 9.0/7.0;
+      static const double F2oF1 = 7.0/9.0;
+
+      wl1 = C_MPS/(GLOfreq0L1 + GLOn*GLOdfreqL1);
+      wl2 = C_MPS/(GLOfreq0L2 + GLOn*GLOdfreqL2);
+      wlwl = 1.0 / (1.0/wl1 - 1.0/wl2);
+      wlgf = wl2 - wl1;
+
+      wl1r = 1.0/(1.0+F2oF1);
+      wl2r = 1.0/(1.0+F1oF2);
+      wl1p = wl1/(1.0-F2oF1);
+      wl2p = wl2/(1.0-F1oF2);
+
+      gf1r = -1.0;
+      gf2r = 1.0;
+      gf1p = wl1;
+      gf2p = -wl2;
+   }
+   else {                                                   // GPS satellite
+      static const double CFF=C_MPS/OSC_FREQ_GPS;
+      static const double wl1_GPS = CFF/L1_MULT_GPS;            // 19.0cm
+      static const double wl2_GPS = CFF/L2_MULT_GPS;            // 24.4cm
+      static const double wlwl_GPS = CFF/(L1_MULT_GPS-L2_MULT_GPS); // 86.2cm
+      static const double wlgf_GPS = wl2_GPS - wl1_GPS;     //  5.4cm
+      static const double F1oF2 = L1_MULT_GPS/L2_MULT_GPS;          // 77/60
+      static const double F2oF1 = L2_MULT_GPS/L1_MULT_GPS;          // 60/77
+
+      wl1 = wl1_GPS;
+      wl2 = wl2_GPS;
+      wlwl = wlwl_GPS;
+      wlgf = wlgf_GPS;
+
+      wl1r = 1.0/(1.0+F2oF1);
+      wl2r = 1.0/(1.0+F1oF2);
+      wl1p = wl1/(1.0-F2oF1);
+      wl2p = wl2/(1.0-F1oF2);
+
+      gf1r = -1.0;
+      gf2r = 1.0;
+      gf1p = wl1;
+      gf2p = -wl2;
+   }
+}
+
 //------------------------------------------------------------------------------------
 int GDCPass::preprocess(void) throw(Exception)
 {
@@ -827,20 +852,20 @@ try {
    for(ilast=-1,i=0; i<static_cast<int>(size()); i++) {
 
       // ignore data the caller has marked BAD
-      if(!(spdvector[i].flag & OK)) continue;
+      if(!(spflag[i] & OK)) continue;
 
       // just in case the caller has set it to something else...
-      spdvector[i].flag = OK;
+      spflag[i] = OK;
 
          // look for obvious outliers
          // Don't do this - sometimes the pseudoranges get extreme values b/c the
          // clock is allowed to run off for long times - perfectly normal
-      //if(spdvector[i].data[P1] < cfg(MinRange) ||
-      //   spdvector[i].data[P1] > cfg(MaxRange) ||
-      //   spdvector[i].data[P2] < cfg(MinRange) ||
-      //   spdvector[i].data[P2] > cfg(MaxRange) )
+      //if(spdata[P1][i] < cfg(MinRange) ||
+      //   spdata[P1][i] > cfg(MaxRange) ||
+      //   spdata[P2][i] < cfg(MinRange) ||
+      //   spdata[P2][i] > cfg(MaxRange) )
       //{
-      //   spdvector[i].flag = BAD;
+      //   spflag[i] = BAD;
       //   learn["points deleted: obvious outlier"]++;
       //   if(cfg(Debug) > 6)
       //      log << "Obvious outlier " << GDCUnique << " " << sat
@@ -874,30 +899,30 @@ try {
 
          // loop over points in this segment
       for(i=it->nbeg; i<=it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
 
-         dbias = fabs(spdvector[i].data[P1]-wl1*spdvector[i].data[L1]-biasL1);
+         dbias = fabs(spdata[P1][i]-wl1*spdata[L1][i]-biasL1);
          if(dbias > cfg(RawBiasLimit)) {
             if(cfg(Debug) >= 2) log << "BEFresetL1 " << GDCUnique
                << " " << sat << " " << printTime(time(i),outFormat)
                << " " << fixed << setprecision(3) << biasL1
-               << " " << spdvector[i].data[P1] - wl1 * spdvector[i].data[L1] << endl;
-            biasL1 = spdvector[i].data[P1] - wl1 * spdvector[i].data[L1];
+               << " " << spdata[P1][i] - wl1 * spdata[L1][i] << endl;
+            biasL1 = spdata[P1][i] - wl1 * spdata[L1][i];
          }
 
-         dbias = fabs(spdvector[i].data[P2]-wl2*spdvector[i].data[L2]-biasL2);
+         dbias = fabs(spdata[P2][i]-wl2*spdata[L2][i]-biasL2);
          if(dbias > cfg(RawBiasLimit)) {
             if(cfg(Debug) >= 2) log << "BEFresetL2 " << GDCUnique
                << " " << sat << " " << printTime(time(i),outFormat)
                << " " << fixed << setprecision(3) << biasL2
-               << " " << spdvector[i].data[P2] - wl2 * spdvector[i].data[L2] << endl;
-            biasL2 = spdvector[i].data[P2] - wl2 * spdvector[i].data[L2];
+               << " " << spdata[P2][i] - wl2 * spdata[L2][i] << endl;
+            biasL2 = spdata[P2][i] - wl2 * spdata[L2][i];
          }
 
-         spdvector[i].data[A1] =
-            spdvector[i].data[P1] - wl1 * spdvector[i].data[L1] - biasL1;
-         spdvector[i].data[A2] =
-            spdvector[i].data[P2] - wl2 * spdvector[i].data[L2] - biasL2;
+         spdata[A1][i] =
+            spdata[P1][i] - wl1 * spdata[L1][i] - biasL1;
+         spdata[A2][i] =
+            spdata[P2][i] - wl2 * spdata[L2][i] - biasL2;
 
       }  // end loop over points in the segment
 
@@ -935,16 +960,16 @@ try {
 
       // loop over points in this segment
       for(i=it->nbeg; i<=it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
 
          // narrow lane range (m)
-         wlr = wl1r * spdvector[i].data[P1] + wl2r * spdvector[i].data[P2];
+         wlr = wl1r * spdata[P1][i] + wl2r * spdata[P2][i];
          // wide lane phase (m)
-         wlp = wl1p * spdvector[i].data[L1] + wl2p * spdvector[i].data[L2];
+         wlp = wl1p * spdata[L1][i] + wl2p * spdata[L2][i];
          // geometry-free range (m)
-         gfr =        spdvector[i].data[P1] -        spdvector[i].data[P2];
+         gfr =        spdata[P1][i] -        spdata[P2][i];
          // geometry-free phase (m)
-         gfp = gf1p * spdvector[i].data[L1] + gf2p * spdvector[i].data[L2];
+         gfp = gf1p * spdata[L1][i] + gf2p * spdata[L2][i];
          // wide lane bias (cycles)
          wlbias = (wlp-wlr)/wlwl;
 
@@ -955,10 +980,10 @@ try {
          }
 
          // change the arrays
-         spdvector[i].data[L1] = gfp + gfr;              // only used in GF
-         spdvector[i].data[L2] = gfp;
-         spdvector[i].data[P1] = wlbias;
-         spdvector[i].data[P2] = - gfr;
+         spdata[L1][i] = gfp + gfr;              // only used in GF
+         spdata[L2][i] = gfp;
+         spdata[P1][i] = wlbias;
+         spdata[P2][i] = - gfr;
 
          it->npts++;
       }
@@ -1083,8 +1108,8 @@ try {
       }
       if(i > it->nend) {                  // change segments
          if(outlier) {
-            if(spdvector[ibad].flag & OK) nok--;
-            spdvector[ibad].flag = BAD;
+            if(spflag[ibad] & OK) nok--;
+            spflag[ibad] = BAD;
             learn[string("points deleted: ") + which + string(" slip outlier")]++;
             outlier = false;
          }
@@ -1092,36 +1117,36 @@ try {
          // update nbeg and nend
          while(it->nbeg < it->nend
             && it->nbeg < static_cast<int>(size())
-            && !(spdvector[it->nbeg].flag & OK) ) it->nbeg++;
+            && !(spflag[it->nbeg] & OK) ) it->nbeg++;
          while(it->nend > it->nbeg
             && it->nend > 0
-            && !(spdvector[it->nend].flag & OK) ) it->nend--;
+            && !(spflag[it->nend] & OK) ) it->nend--;
          it++;
          if(it == SegList.end())
             return ReturnOK;
          nok = 0;
       }
 
-      if(!(spdvector[i].flag & OK))
+      if(!(spflag[i] & OK))
          continue;
       nok++;                                   // nok = # good points in segment
 
       if(nogood) { igood = i; nogood=false; }  // igood is index of last good point
 
-      if(fabs(spdvector[i].data[A1]) > limit) {// found an outlier (1st diff, cycles)
+      if(fabs(spdata[A1][i]) > limit) {// found an outlier (1st diff, cycles)
          outlier = true;
          ibad = i;                             // ibad is index of last bad point
       }
       else if(outlier) {                       // this point good, but not past one(s)
          for(unsigned int j=igood+1; j<ibad; j++) {
-            if(spdvector[j].flag & OK)
+            if(spflag[j] & OK)
                nok--;
-            if(spdvector[j].flag & DETECT)
+            if(spflag[j] & DETECT)
                log << "Warning - found an obvious slip, "
                   << "but marking BAD a point already marked with slip "
                   << GDCUnique << " " << sat
                   << " " << printTime(time(j),outFormat) << " " << j << endl;
-            spdvector[j].flag = BAD;             // mark all points between as bad
+            spflag[j] = BAD;             // mark all points between as bad
             learn[string("points deleted: ") + which + string(" slip outlier")]++;
          }
 
@@ -1131,15 +1156,15 @@ try {
          it = createSegment(it,ibad,which+string(" slip gross"));
 
             // mark it
-         spdvector[ibad].flag |= (which == string("WL") ? WLDETECT : GFDETECT);
+         spflag[ibad] |= (which == string("WL") ? WLDETECT : GFDETECT);
 
             // change the bias in the new segment
          if(which == "WL") {
-            wlbias = spdvector[ibad].data[P1];
+            wlbias = spdata[P1][ibad];
             it->bias1 = long(wlbias+(wlbias > 0 ? 0.5 : -0.5));   // WL bias (NWL)
          }
          if(which == "GF")
-            it->bias2 = spdvector[ibad].data[L2];                 // GFP bias
+            it->bias2 = spdata[L2][ibad];                 // GFP bias
 
             // prep for next point
          nok = 2;
@@ -1173,29 +1198,29 @@ try {
 
    for(i=0; i<static_cast<int>(size()); i++) {
       // ignore bad data
-      if(!(spdvector[i].flag & OK)) {
-         spdvector[i].data[A1] = spdvector[i].data[A2] = 0.0;
+      if(!(spflag[i] & OK)) {
+         spdata[A1][i] = spdata[A2][i] = 0.0;
          continue;
       }
 
       // compute first differences - 'change the arrays' A1 and A2
       if(which == string("WL")) {
          if(iprev == -1)
-            spdvector[i].data[A1] = 0.0;
+            spdata[A1][i] = 0.0;
          else
-            spdvector[i].data[A1] =
-               (spdvector[i].data[P1] - spdvector[iprev].data[P1]);
+            spdata[A1][i] =
+               (spdata[P1][i] - spdata[P1][iprev]);
       }
       else if(which == string("GF")) {
          if(iprev == -1)            // first difference not defined at first point
-            spdvector[i].data[A1] = spdvector[i].data[A2] = 0.0;
+            spdata[A1][i] = spdata[A2][i] = 0.0;
          else {
             // compute first difference of L1 = raw residual GFP-GFR
-            spdvector[i].data[A1] =
-               (spdvector[i].data[L1] - spdvector[iprev].data[L1]);
+            spdata[A1][i] =
+               (spdata[L1][i] - spdata[L1][iprev]);
             // compute first difference of L2 = GFP
-            spdvector[i].data[A2] =
-               (spdvector[i].data[L2] - spdvector[iprev].data[L2]);
+            spdata[A2][i] =
+               (spdata[L2][i] - spdata[L2][iprev]);
          }
       }
 
@@ -1224,8 +1249,8 @@ try {
 
    // loop over data, adding to Stats, and counting good points
    for(unsigned int i=it->nbeg; i<=it->nend; i++) {
-      if(!(spdvector[i].flag & OK)) continue;
-      it->WLStats.Add(spdvector[i].data[P1] - it->bias1);
+      if(!(spflag[i] & OK)) continue;
+      it->WLStats.Add(spdata[P1][i] - it->bias1);
       it->npts++;
    }
 
@@ -1263,8 +1288,8 @@ try {
 
       // put wlbias in vecA1, but without gaps: let j index good points only from nbeg
       for(j=i=it->nbeg; i<=it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
-         wlbias = spdvector[i].data[P1] - it->bias1;
+         if(!(spflag[i] & OK)) continue;
+         wlbias = spdata[P1][i] - it->bias1;
          vecA1.push_back(wlbias);
          vecA2.push_back(0.0);
          j++;
@@ -1277,36 +1302,36 @@ try {
       // change the array : A1 is wlbias, A2 (output) will contain the weights
       // copy temps out into A1 and A2
       for(k=0,i=it->nbeg; i<j; k++,i++) {
-         spdvector[i].data[A1] = vecA1[k];
-         spdvector[i].data[A2] = vecA2[k];
+         spdata[A1][i] = vecA1[k];
+         spdata[A2][i] = vecA2[k];
       }
 
       haveslip = false;
       for(j=i=it->nbeg; i<=it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
 
-         wlbias = spdvector[i].data[P1] - it->bias1;
+         wlbias = spdata[P1][i] - it->bias1;
 
          if(fabs(wlbias-ave) > nsigma ||
-               spdvector[j].data[A2] < cfg(WLRobustWeightLimit))
+               spdata[A2][j] < cfg(WLRobustWeightLimit))
             outlier = true;
          else
             outlier = false;
 
          // remove points by sigma stripping
          if(outlier) {
-            if(spdvector[i].flag & DETECT || i == it->nbeg) {
+            if(spflag[i] & DETECT || i == it->nbeg) {
                haveslip = true;
                slipindex = i;        // mark
-               slip = spdvector[i].flag; // save to put on first good point
+               slip = spflag[i]; // save to put on first good point
             }
-            spdvector[i].flag = BAD;
+            spflag[i] = BAD;
             learn["points deleted: WL sigma stripping"]++;
             it->npts--;
             it->WLStats.Subtract(wlbias);
          }
          else if(haveslip) {
-            spdvector[i].flag = slip;
+            spflag[i] = slip;
             haveslip = false;
          }
 
@@ -1315,10 +1340,10 @@ try {
             << " " << it->nseg
             << " " << printTime(time(i),outFormat)
             << fixed << setprecision(3)
-            << " " << setw(3) << spdvector[i].flag
-            << " " << setw(13) << spdvector[j].data[A1] // wlbias
+            << " " << setw(3) << int(spflag[i])
+            << " " << setw(13) << spdata[A1][j] // wlbias
             << " " << setw(13) << fabs(wlbias-ave)
-            << " " << setw(5) << spdvector[j].data[A2]  // 0 <= weight <= 1
+            << " " << setw(5) << spdata[A2][j]  // 0 <= weight <= 1
             << " " << setw(3) << i
             << (outlier ? " outlier" : "");
             if(i == it->nbeg) log
@@ -1339,24 +1364,24 @@ try {
       haveslip = false;
       ave = it->WLStats.Average();
       for(i=it->nbeg; i<=it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
 
-         wlbias = spdvector[i].data[P1] - it->bias1;
+         wlbias = spdata[P1][i] - it->bias1;
 
          // remove points by sigma stripping
          if(fabs(wlbias-ave) > nsigma) { // TD add absolute limit?
-            if(spdvector[i].flag & DETECT) {
+            if(spflag[i] & DETECT) {
                haveslip = true;
                slipindex = i;        // mark
-               slip = spdvector[i].flag; // save to put on first good point
+               slip = spflag[i]; // save to put on first good point
             }
-            spdvector[i].flag = BAD;
+            spflag[i] = BAD;
             learn["points deleted: WL sigma stripping"]++;
             it->npts--;
             it->WLStats.Subtract(wlbias);
          }
          else if(haveslip) {
-            spdvector[i].flag = slip;
+            spflag[i] = slip;
             haveslip = false;
          }
 
@@ -1373,8 +1398,8 @@ try {
       deleteSegment(it,"WL sigma stripping");
    else {
       // update nbeg and nend // TD add limit 0 size()
-      while(it->nbeg < it->nend && !(spdvector[it->nbeg].flag & OK)) it->nbeg++;
-      while(it->nend > it->nbeg && !(spdvector[it->nend].flag & OK)) it->nend--;
+      while(it->nbeg < it->nend && !(spflag[it->nbeg] & OK)) it->nbeg++;
+      while(it->nend > it->nbeg && !(spflag[it->nend] & OK)) it->nend--;
    }
 
 }
@@ -1412,15 +1437,15 @@ try {
 
    // fill up the future window to size 'width', but don't go beyond the segment
    while(futureStats.N() < uwidth && iplus <= it->nend) {
-      if(spdvector[iplus].flag & OK) {                // add only good data
-         futureStats.Add(spdvector[iplus].data[P1] - it->bias1);
+      if(spflag[iplus] & OK) {                // add only good data
+         futureStats.Add(spdata[P1][iplus] - it->bias1);
       }
       iplus++;
    }
 
    // now loop over all points in the segment
    for(i=it->nbeg; i<= it->nend; i++) {
-      if(!(spdvector[i].flag & OK))                      // add only good data
+      if(!(spflag[i] & OK))                      // add only good data
          continue;
 
       // compute test and limit
@@ -1429,10 +1454,10 @@ try {
          test = fabs(futureStats.Average()-pastStats.Average());
       limit = ::sqrt(futureStats.Variance() + pastStats.Variance());
       // 'change the arrays' A1 and A2
-      spdvector[i].data[A1] = test;
-      spdvector[i].data[A2] = limit;
+      spdata[A1][i] = test;
+      spdata[A2][i] = limit;
 
-      wlbias = spdvector[i].data[P1] - it->bias1;        // debiased WLbias
+      wlbias = spdata[P1][i] - it->bias1;        // debiased WLbias
 
       // dump the stats
       if(cfg(Debug) >= 6) log << "WLS " << GDCUnique
@@ -1445,8 +1470,8 @@ try {
          << " " << setw(3) << futureStats.N()
          << " " << setw(7) << futureStats.Average()
          << " " << setw(7) << futureStats.StdDev()
-         << " " << setw(9) << spdvector[i].data[A1]
-         << " " << setw(9) << spdvector[i].data[A2]
+         << " " << setw(9) << spdata[A1][i]
+         << " " << setw(9) << spdata[A2][i]
          << " " << setw(9) << wlbias
          << " " << setw(3) << i
          << endl;
@@ -1457,15 +1482,15 @@ try {
       pastStats.Add(wlbias);
       // ... and move iplus up by one (good) point, ...
       while(futureStats.N() < uwidth && iplus <= it->nend) {
-         if(spdvector[iplus].flag & OK) {
-            futureStats.Add(spdvector[iplus].data[P1] - it->bias1);
+         if(spflag[iplus] & OK) {
+            futureStats.Add(spdata[P1][iplus] - it->bias1);
          }
          iplus++;
       }
       // ... and move iminus up by one good point
       while(static_cast<int>(pastStats.N()) > uwidth && iminus <= it->nend) {
-         if(spdvector[iminus].flag & OK) {
-            pastStats.Subtract(spdvector[iminus].data[P1] - it->bias1);
+         if(spflag[iminus] & OK) {
+            pastStats.Subtract(spdata[P1][iminus] - it->bias1);
          }
          iminus++;
       }
@@ -1520,11 +1545,11 @@ try {
          }
       }
 
-      if(spdvector[i].flag & OK) {
+      if(spflag[i] & OK) {
          nok++;                                 // nok = # good points in segment
 
          if(nok == 1) {                         // change the bias, as WLStats reset
-            wlbias = spdvector[i].data[P1];
+            wlbias = spdata[P1][i];
             it->bias1 = long(wlbias+(wlbias > 0 ? 0.5 : -0.5));
          }
 
@@ -1536,7 +1561,7 @@ try {
             if(cfg(Debug) >= 6) log << "too near end " << GDCUnique
                << " " << i << " " << nok << " " << it->npts-nok
                << " " << printTime(time(i),outFormat)
-               << " " << spdvector[i].data[A1] << " " << spdvector[i].data[A2]
+               << " " << spdata[A1][i] << " " << spdata[A2][i]
                << endl;
          }
          else if(foundWLsmallSlip(it,i)) { // met condition 3
@@ -1548,18 +1573,18 @@ try {
             it = createSegment(it,i,"WL slip small");
 
             // mark it
-            spdvector[i].flag |= WLDETECT;
+            spflag[i] |= WLDETECT;
 
             // prep for next segment
             // biases remain the same in the new segment
             it->npts = k - nok;
             nok = 0;
             it->WLStats.Reset();
-            wlbias = spdvector[i].data[P1]; // change the bias, as WLStats reset
+            wlbias = spdata[P1][i]; // change the bias, as WLStats reset
             it->bias1 = long(wlbias+(wlbias > 0 ? 0.5 : -0.5));
          }
 
-         it->WLStats.Add(spdvector[i].data[P1] - it->bias1);
+         it->WLStats.Add(spdata[P1][i] - it->bias1);
 
       } // end if good data
 
@@ -1598,8 +1623,8 @@ try {
    // A1 = step = fabs(futureStats.Average() - pastStats.Average());
    // A2 = limit = ::sqrt(futureStats.Variance() + pastStats.Variance());
    // all units WL cycles
-   double step = spdvector[i].data[A1];
-   double lim = spdvector[i].data[A2];
+   double step = spdata[A1][i];
+   double lim = spdata[A2][i];
 
    // 050109 if Debug=6, print only possible slips, if 7 print all
    bool isSlip=false, halfCycle=false;
@@ -1613,11 +1638,11 @@ try {
       //<< " " << it->npts << "pt"
       << fixed << setprecision(2)
       << " step=" << step << " lim=" << lim
-      << " (1)" << spdvector[i].data[A1]
-      << (spdvector[i].data[A1] > cfg(WLSlipSize) ? ">" : "<=")
+      << " (1)" << spdata[A1][i]
+      << (spdata[A1][i] > cfg(WLSlipSize) ? ">" : "<=")
       << cfg(WLSlipSize)
-      << " (2)" << spdvector[i].data[A1]-spdvector[i].data[A2]
-      << (spdvector[i].data[A1]-spdvector[i].data[A2]>cfg(WLSlipExcess)?">":"<=")
+      << " (2)" << spdata[A1][i]-spdata[A2][i]
+      << (spdata[A1][i]-spdata[A2][i]>cfg(WLSlipExcess)?">":"<=")
       << cfg(WLSlipExcess); // no endl
 
    Pass = 0;         // 111312 count all tests passed
@@ -1650,20 +1675,20 @@ try {
    jp = jm = i;
    do {
       // find next good point in future
-      do { jp++; } while(jp < it->nend && !(spdvector[jp].flag & OK));
+      do { jp++; } while(jp < it->nend && !(spflag[jp] & OK));
       if(jp >= it->nend) break;
          // CONDITION 4: test(A1) is a local maximum
-      if(spdvector[i].data[A1]-spdvector[jp].data[A1] > j*slope) pass4++;
+      if(spdata[A1][i]-spdata[A1][jp] > j*slope) pass4++;
          // CONDITION 5: limit(A2) is a local minimum
-      if(spdvector[i].data[A2]-spdvector[jp].data[A2] < -(j*slope)) pass5++;
+      if(spdata[A2][i]-spdata[A2][jp] < -(j*slope)) pass5++;
 
       // find next good point in past
-      do { jm--; } while(jm > it->nbeg && !(spdvector[jm].flag & OK));
+      do { jm--; } while(jm > it->nbeg && !(spflag[jm] & OK));
       if(jm <= it->nbeg) break;
          // CONDITION 4: test(A1) is a local maximum
-      if(spdvector[i].data[A1]-spdvector[jm].data[A1] > j*slope) pass4++;
+      if(spdata[A1][i]-spdata[A1][jm] > j*slope) pass4++;
          // CONDITION 5: limit(A2) is a local minimum
-      if(spdvector[i].data[A2]-spdvector[jm].data[A2] < -(j*slope)) pass5++;
+      if(spdata[A2][i]-spdata[A2][jm] < -(j*slope)) pass5++;
 
    } while(++j < minMaxWidth);
 
@@ -1748,8 +1773,8 @@ try {
    if(which == string("WL")) {                                    // WL
       WLPassStats.Reset();
       for(i=kt->nbeg; i <= kt->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
-         WLPassStats.Add(spdvector[i].data[P1] - kt->bias1);
+         if(!(spflag[i] & OK)) continue;
+         WLPassStats.Add(spdata[P1][i] - kt->bias1);
       }
    }
    // change the biases - reset the GFP bias so that it matches the GFR
@@ -1757,14 +1782,14 @@ try {
       //dumpSegments("GFFbefRebias",2,true); //temp
       bool first(true);
       for(i=kt->nbeg; i <= kt->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
          if(first) {
             first = false;
-            kt->bias2 = spdvector[i].data[L2] + spdvector[i].data[P2];
-            kt->bias1 = spdvector[i].data[P1];
+            kt->bias2 = spdata[L2][i] + spdata[P2][i];
+            kt->bias1 = spdata[P1][i];
          }
          // change the data - recompute GFR-GFP so it has one consistent bias
-         spdvector[i].data[L1] = spdvector[i].data[L2] + spdvector[i].data[P2];
+         spdata[L1][i] = spdata[L2][i] + spdata[P2][i];
       }
    }
 
@@ -1887,10 +1912,10 @@ try {
 
    // now do the fixing - change the data in the right segment to match left's
    for(i=right->nbeg; i<=right->nend; i++) {
-      //if(!(spdvector[i].flag & OK)) continue;
+      //if(!(spflag[i] & OK)) continue;
       // 'change the data'
-      spdvector[i].data[P1] -= nwl;                                 // WLbias
-      spdvector[i].data[L2] -= nwl * wl2;                           // GFP
+      spdata[P1][i] -= nwl;                                 // WLbias
+      spdata[L2][i] -= nwl * wl2;                           // GFP
    }
 
    // fix the slips beyond the 'right' segment.
@@ -1903,8 +1928,8 @@ try {
       // can build up and produce errors.
       it->bias1 -= dwl;
       for(i=it->nbeg; i<=it->nend; i++) {
-         spdvector[i].data[P1] -= nwl;                                 // WLbias
-         spdvector[i].data[L2] -= nwl * wl2;                           // GFP
+         spdata[P1][i] -= nwl;                                 // WLbias
+         spdata[L2][i] -= nwl * wl2;                           // GFP
       }
    }
 
@@ -1915,7 +1940,7 @@ try {
    SlipList.push_back(newSlip);
 
    // mark it
-   spdvector[right->nbeg].flag |= WLFIX;
+   spflag[right->nbeg] |= WLFIX;
 
    return;
 }
@@ -1949,11 +1974,11 @@ try {
    nl = 0;
    ilast = -1;                               // ilast is last good point before slip
    while(nb > left->nbeg && i < Npts) {
-      if(spdvector[nb].flag & OK) {
+      if(spflag[nb] & OK) {
          if(ilast == -1) ilast = nb;
          i++; nl++;
-         Lstats.Add(spdvector[nb].data[L1] - left->bias2);
-         //log << "LDATA " << nb << " " << spdvector[nb].data[L1]-left->bias2 << endl;
+         Lstats.Add(spdata[L1][nb] - left->bias2);
+         //log << "LDATA " << nb << " " << spdata[L1][nb]-left->bias2 << endl;
       }
       nb--;
    }
@@ -1961,10 +1986,10 @@ try {
    i = 1;
    nr = 0;
    while(ne < right->nend && i < Npts) {
-      if(spdvector[ne].flag & OK) {
+      if(spflag[ne] & OK) {
          i++; nr++;
-         Rstats.Add(spdvector[ne].data[L1] - right->bias2);
-         //log << "RDATA " << ne << " " << spdvector[ne].data[L1]-right->bias2 <<endl;
+         Rstats.Add(spdata[L1][ne] - right->bias2);
+         //log << "RDATA " << ne << " " << spdata[L1][ne]-right->bias2 <<endl;
       }
       ne++;
    }
@@ -1976,8 +2001,8 @@ try {
    // ultimately, GFR-GFP is accurate but noisy.
    // rms rof should tell you how much weight to put on rof
    // larger rof -> smaller npts and larger degree
-   dn1 = spdvector[right->nbeg].data[L2] - right->bias2
-         - (spdvector[ilast].data[L2] - left->bias2);
+   dn1 = spdata[L2][right->nbeg] - right->bias2
+         - (spdata[L2][ilast] - left->bias2);
    n1 = long(dn1 + (dn1 > 0 ? 0.5 : -0.5));
 
    // estimate the slip using polynomial fits - this prints GFE data
@@ -2029,8 +2054,8 @@ try {
    // now do the fixing : 'change the data' within right segment
    // and through the end of the pass, to fix the slip
    for(i=right->nbeg; i<static_cast<int>(size()); i++) {
-      spdvector[i].data[L2] -= n1;                              // GFP
-      spdvector[i].data[L1] -= n1;                              // GFR+GFP
+      spdata[L2][i] -= n1;                              // GFP
+      spdata[L1][i] -= n1;                              // GFR+GFP
    }
 
    // 'change the bias' for all segments in the future (although right to be deleted)
@@ -2055,7 +2080,7 @@ try {
    }
 
    // mark it
-   spdvector[right->nbeg].flag |= GFFIX;
+   spflag[right->nbeg] |= GFFIX;
 
    return;
 }
@@ -2097,14 +2122,14 @@ try {
 
          // add all the data
          for(i=nb; i<=ne; i++) {
-            if(!(spdvector[i].flag & OK)) continue;
+            if(!(spflag[i] & OK)) continue;
             PF[in[k]].Add(
                // data
-               spdvector[i].data[L2]
+               spdata[L2][i]
                // - (either               left bias - poss. slip : right bias)
                   - (i < right->nbeg ? left->bias2-n1-(nadj+k-1) : right->bias2),
                //  use a debiased count
-               spdvector[i].ndt - spdvector[nb].ndt
+               spndt[i] - spndt[nb]
             );
          }
 
@@ -2113,11 +2138,11 @@ try {
          // compute RMS residual of fit
          rmsrof[in[k]] = 0.0;
          for(i=nb; i<=ne; i++) {
-            if(!(spdvector[i].flag & OK)) continue;
+            if(!(spflag[i] & OK)) continue;
             rof =    // data minus fit
-               spdvector[i].data[L2]
+               spdata[L2][i]
                   - (i < right->nbeg ? left->bias2-n1-(nadj+k-1) : right->bias2)
-               - PF[in[k]].Evaluate(spdvector[i].ndt - spdvector[nb].ndt);
+               - PF[in[k]].Evaluate(spndt[i] - spndt[nb]);
             rmsrof[in[k]] += rof*rof;
          }
          rmsrof[in[k]] = ::sqrt(rmsrof[in[k]]);
@@ -2177,15 +2202,15 @@ try {
    if(cfg(Debug) >= 4) {
       log << "EstimateGFslipFix dump " << endl;
       for(i=nb; i<=ne; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
          log << "GFE " << GDCUnique << " " << sat
             << " " << GDCUniqueFix
             << " " << printTime(time(i),outFormat)
-            << " " << setw(2) << spdvector[i].flag << fixed << setprecision(3);
-         for(k=0; k<3; k++) log << " " << spdvector[i].data[L2]
+            << " " << setw(2) << int(spflag[i]) << fixed << setprecision(3);
+         for(k=0; k<3; k++) log << " " << spdata[L2][i]
                - (i < right->nbeg ? left->bias2-n1-(nadj+k-1) : right->bias2)
-            << " " << PF[in[k]].Evaluate(spdvector[i].ndt - spdvector[nb].ndt);
-         log << " " << setw(3) << spdvector[i].ndt << endl;
+            << " " << PF[in[k]].Evaluate(spndt[i] - spndt[nb]);
+         log << " " << setw(3) << spndt[i] << endl;
       }
    }
 
@@ -2213,7 +2238,7 @@ try {
    nend = SegList.begin()->nend;
 
    for(first=true,i=nbeg; i <= nend; i++) {
-      if(!(spdvector[i].flag & OK)) continue;
+      if(!(spflag[i] & OK)) continue;
 
       // 'change the bias' (initial bias only) in the GFP by changing units, also
       // slip fixing in the WL may have changed the values of GFP
@@ -2224,12 +2249,12 @@ try {
 
       // 'change the arrays'
       // change units on the GFP and the GFR
-      spdvector[i].data[P2] /= wlgf;                    // -gfr (cycles of wlgf)
-      spdvector[i].data[L2] /= wlgf;                    // gfp (cycles of wlgf)
+      spdata[P2][i] /= wlgf;                    // -gfr (cycles of wlgf)
+      spdata[L2][i] /= wlgf;                    // gfp (cycles of wlgf)
 
       // 'change the data'
       // save in L1                          // gfp+gfr residual (cycles of wlgf)
-      spdvector[i].data[L1] = spdvector[i].data[L2] - spdvector[i].data[P2];
+      spdata[L1][i] = spdata[L2][i] - spdata[P2][i];
    }
 
    return ReturnOK;
@@ -2258,11 +2283,11 @@ try {
    for(it=SegList.begin(); it != SegList.end(); it++) {
       // compute stats on dGF/dt
       for(i=it->nbeg; i <= it->nend; i++) {
-         if(!(spdvector[i].flag & OK)) continue;
+         if(!(spflag[i] & OK)) continue;
 
          // compute first-diff stats in meters
          // skip the first point in a segment - it is an obvious GF slip
-         if(i > it->nbeg) GFPassStats.Add(spdvector[i].data[A1]*wlgf);
+         if(i > it->nbeg) GFPassStats.Add(spdata[A1][i]*wlgf);
 
       }  // end loop over data in segment it
 
@@ -2329,8 +2354,8 @@ try {
    it->PF.Reset(ndeg);     // for fit to GF range
 
    for(i=it->nbeg; i <= it->nend; i++) {
-      if(!(spdvector[i].flag & OK)) continue;
-      it->PF.Add(spdvector[i].data[P2],spdvector[i].ndt);
+      if(!(spflag[i] & OK)) continue;
+      it->PF.Add(spdata[P2][i],spndt[i]);
    }
 
    if(it->PF.isSingular()) {     // this should never happen
@@ -2344,32 +2369,32 @@ try {
    rofStats.Reset();
    for(i=it->nbeg; i <= it->nend; i++) {
       // skip bad data
-      if(!(spdvector[i].flag & OK)) continue;
+      if(!(spflag[i] & OK)) continue;
       
-      fit = it->PF.Evaluate(spdvector[i].ndt);
+      fit = it->PF.Evaluate(spndt[i]);
 
       // all (fit, resid, gfr and gfp) are in cycles of wlgf (5.4cm)
 
       // compute gfp-(fit to gfr), store in A1 - 'change the arrays' A1 and A2
       // OR let's try first difference of residual of fit
       //           residual =  phase                            - fit to range
-      spdvector[i].data[A1] = spdvector[i].data[L2] - it->bias2 - fit;
+      spdata[A1][i] = spdata[L2][i] - it->bias2 - fit;
       if(rbias == 0.0) {
-         rbias = spdvector[i].data[A1];
-         nprev = spdvector[i].ndt - 1;
+         rbias = spdata[A1][i];
+         nprev = spndt[i] - 1;
       }
-      spdvector[i].data[A1] -= rbias;                    // debias residual for plots
+      spdata[A1][i] -= rbias;                    // debias residual for plots
 
          // compute stats on residual of fit
-      rofStats.Add(spdvector[i].data[A1]);
+      rofStats.Add(spdata[A1][i]);
 
       if(1) { // 1stD of residual - remember A1 has just been debiased
-         tmp = spdvector[i].data[A1];
-         spdvector[i].data[A1] -= prev;       // diff with previous epoch's
+         tmp = spdata[A1][i];
+         spdata[A1][i] -= prev;       // diff with previous epoch's
          // 040809 should this be divided by delta n?
-         // spdvector[i].data[A1] /= (spdvector[i].ndt - nprev);
+         // spdata[A1][i] /= (spndt[i] - nprev);
          prev = tmp;          // store residual for next point
-         nprev = spdvector[i].ndt;
+         nprev = spndt[i];
       }
       
    }
@@ -2419,7 +2444,7 @@ try {
             iplus++)
       {
          // ignore bad points
-         if(iplus <= static_cast<int>(it->nend) && !(spdvector[iplus].flag & OK))
+         if(iplus <= static_cast<int>(it->nend) && !(spflag[iplus] & OK))
             continue;
          if(ifirst == -1) ifirst = iplus;
 
@@ -2429,14 +2454,14 @@ try {
          {
             inew = futureIndex.front();
             futureIndex.pop_front();
-            futureStats.Subtract(spdvector[inew].data[A1]);
+            futureStats.Subtract(spdata[A1][inew]);
             nok++;
          }
 
          // put iplus into the future deque
          if(iplus <= static_cast<int>(it->nend)) {
             futureIndex.push_back(iplus);
-            futureStats.Add(spdvector[iplus].data[A1]);
+            futureStats.Add(spdata[A1][iplus]);
          }
          else
             futureIndex.push_back(-1);
@@ -2452,15 +2477,15 @@ try {
          if(foundGFoutlier(i,inew,pastStats,futureStats)) {
             // check that i was not marked a slip in the last iteration
             // if so, let inew be the slip and i the outlier
-            if(spdvector[i].flag & DETECT) {
+            if(spflag[i] & DETECT) {
                //log << "Warning - marking a slip point BAD in GF detect small "
                //   << GDCUnique << " " << sat
                //   << " " << printTime(time(i),outFormat) << " " << i << endl;
-               spdvector[inew].flag = spdvector[i].flag;
+               spflag[inew] = spflag[i];
                it->nbeg = inew;
             }
-            spdvector[i].flag = BAD;
-            spdvector[inew].data[A1] += spdvector[i].data[A1];
+            spflag[i] = BAD;
+            spdata[A1][inew] += spdata[A1][i];
             learn["points deleted: GF outlier"]++;
             i = inew;
             nok--;
@@ -2470,13 +2495,13 @@ try {
          if(static_cast<int>(pastIndex.size()) == width) {
             j = pastIndex.front();
             pastIndex.pop_front();
-            pastStats.Subtract(spdvector[j].data[A1]);
+            pastStats.Subtract(spdata[A1][j]);
          }
 
          // move i into the past
          if(i > -1) {
             pastIndex.push_back(i);
-            pastStats.Add(spdvector[i].data[A1]);
+            pastStats.Add(spdata[A1][i]);
          }
 
          // return to original state
@@ -2492,7 +2517,7 @@ try {
             nok = 1;
 
             // mark it
-            spdvector[i].flag |= GFDETECT;
+            spflag[i] |= GFDETECT;
          }
 
       }  // end loop over points in the pass
@@ -2517,8 +2542,8 @@ bool GDCPass::foundGFoutlier(int i, int inew,
 try {
    if(i < 0 || inew < 0) return false;
    bool ok;
-   double pmag = spdvector[i].data[A1]; // -pastSt.Average();
-   double fmag = spdvector[inew].data[A1]; // -futureSt.Average();
+   double pmag = spdata[A1][i]; // -pastSt.Average();
+   double fmag = spdata[A1][inew]; // -futureSt.Average();
    double var = ::sqrt(pastSt.Variance() + futureSt.Variance());
 
    ostringstream oss;
@@ -2578,8 +2603,8 @@ try {
    pmag = fmag = pvar = fvar = 0.0;
    // note when past.N == 1, this is first good point, which has 1stD==0
    // TD be very careful when N is small
-   if(pastSt.N() > 0) pmag = spdvector[i].data[A1]-pastSt.Average();
-   if(futureSt.N() > 0) fmag = spdvector[i].data[A1]-futureSt.Average();
+   if(pastSt.N() > 0) pmag = spdata[A1][i]-pastSt.Average();
+   if(futureSt.N() > 0) fmag = spdata[A1][i]-futureSt.Average();
    if(pastSt.N() > 1) pvar = pastSt.Variance();
    if(futureSt.N() > 1) fvar = futureSt.Variance();
    mag = (pmag + fmag) / 2.0;
@@ -2607,7 +2632,7 @@ try {
       << " " << setw(7) << futureSt.StdDev()
       << " " << setw(7) << mag
       << " " << setw(7) << ::sqrt(pvar+fvar)
-      << " " << setw(9) << spdvector[i].data[A1]
+      << " " << setw(9) << spdata[A1][i]
       << " " << setw(7) << pmag
       << " " << setw(7) << pvar
       << " " << setw(7) << fmag
@@ -2677,8 +2702,8 @@ try {
          double magGFR,mtnGFR;
          Stats<double> pGFRmPh,fGFRmPh;
          for(j=0; j<static_cast<int>(pastIn.size()); j++) {
-            if(pastIn[j] > -1) pGFRmPh.Add(spdvector[pastIn[j]].data[L1]);
-            if(futureIn[j] > -1) fGFRmPh.Add(spdvector[futureIn[j]].data[L1]);
+            if(pastIn[j] > -1) pGFRmPh.Add(spdata[L1][pastIn[j]]);
+            if(futureIn[j] > -1) fGFRmPh.Add(spdata[L1][futureIn[j]]);
          }
          magGFR = fGFRmPh.Average() - pGFRmPh.Average();
          mtnGFR = fabs(magGFR)/::sqrt(pGFRmPh.Variance()+fGFRmPh.Variance());
@@ -2706,15 +2731,15 @@ try {
          Stats<double> fdStats;
          j = i-1; k=0;
          while(j >= ibeg && k < 15) {
-            if(spdvector[j].flag & OK) { fdStats.Add(spdvector[j].data[A2]); k++; }
+            if(spflag[j] & OK) { fdStats.Add(spdata[A2][j]); k++; }
             j--;
          }
          j = i+1; k=0;
          while(j <= iend && k < 15) {
-            if(spdvector[j].flag & OK) { fdStats.Add(spdvector[j].data[A2]); k++; }
+            if(spflag[j] & OK) { fdStats.Add(spdata[A2][j]); k++; }
             j++;
          }
-         magFD = spdvector[i].data[A2] - fdStats.Average();
+         magFD = spdata[A2][i] - fdStats.Average();
 
          if(cfg(Debug) >= 6)
             oss << " (7)1stD(GFP)mag=" << magFD
@@ -2724,7 +2749,7 @@ try {
       }
 
       // 8. if switch is on and there is no WL slip here - skip
-      if(cfg(GFSkipSmall) && !(spdvector[i].flag & WLDETECT)) {
+      if(cfg(GFSkipSmall) && !(spflag[i] & WLDETECT)) {
          if(cfg(Debug) >= 6) oss << " (8)skipGFsmall";
          isSlip = false;
       }
@@ -2757,24 +2782,24 @@ try {
    // loop over the data and look for points with GFDETECT but not WLDETECT or WLFIX
    for(i=0; i<static_cast<int>(size()); i++) {
 
-      if(!(spdvector[i].flag & OK)) continue;        // bad
-      if(!(spdvector[i].flag & DETECT)) continue;    // no slips
-      if(spdvector[i].flag & WLDETECT) continue;     // WL was detected
+      if(!(spflag[i] & OK)) continue;        // bad
+      if(!(spflag[i] & DETECT)) continue;    // no slips
+      if(spflag[i] & WLDETECT) continue;     // WL was detected
 
       // GF only slip - compute WL stats on both sides
       Stats<double> futureStats,pastStats;
       k = i;
       // fill future
       while(k < static_cast<int>(size()) && static_cast<int>(futureStats.N()) < N) {
-         if(spdvector[k].flag & OK)                  // data is good
-            futureStats.Add(spdvector[k].data[P1]);        // wlbias
+         if(spflag[k] & OK)                  // data is good
+            futureStats.Add(spdata[P1][k]);        // wlbias
          k++;
       }
       // fill past
       k = i-1;
       while(k >= 0 && static_cast<int>(pastStats.N()) < N) {
-         if(spdvector[k].flag & OK)                  // data is good
-            pastStats.Add(spdvector[k].data[P1]);          // wlbias
+         if(spflag[k] & OK)                  // data is good
+            pastStats.Add(spdata[P1][k]);          // wlbias
          k--;
       }
 
@@ -2796,10 +2821,10 @@ try {
 
          // now do the fixing - change the data to the future of the slip
          for(k=i; k<static_cast<int>(size()); k++) {
-            //if(!(spdvector[i].flag & OK)) continue;
+            //if(!(spflag[i] & OK)) continue;
             // 'change the data'
-            spdvector[k].data[P1] -= nwl;                                 // WLbias
-            spdvector[k].data[L2] -= nwl * factor;                        // GFP
+            spdata[P1][k] -= nwl;                                 // WLbias
+            spdata[L2][k] -= nwl * factor;                        // GFP
          }
          
          // Add to slip list
@@ -2809,7 +2834,7 @@ try {
          SlipList.push_back(newSlip);
 
          // mark it
-         spdvector[i].flag |= (WLDETECT + WLFIX);
+         spflag[i] |= (WLDETECT + WLFIX);
 
          if(cfg(Debug) >= 7) log << "CHECK " << GDCUnique << " " << sat
             << " " << i
@@ -2873,7 +2898,7 @@ try {
    for(i=0; i<static_cast<int>(size()); i++) {
 
       // is this point bad?
-      if(!(spdvector[i].flag & OK)) {  // data is bad
+      if(!(spflag[i] & OK)) {  // data is bad
          ok = false;
          if(i == static_cast<int>(size()) - 1) {         // but this is the last point 
             i++;
@@ -2970,30 +2995,30 @@ try {
       if(i >= static_cast<int>(size())) break;
 
       // 'change the data' for the last time
-      spdvector[i].data[L1] = svp.data(i,DCobstypes[L1]) - slipL1;
-      spdvector[i].data[L2] = svp.data(i,DCobstypes[L2]) - slipL2;
-      spdvector[i].data[P1] = svp.data(i,DCobstypes[P1]);
-      spdvector[i].data[P2] = svp.data(i,DCobstypes[P2]);
+      spdata[L1][i] = svp.data(i,DCobstypes[L1]) - slipL1;
+      spdata[L2][i] = svp.data(i,DCobstypes[L2]) - slipL2;
+      spdata[P1][i] = svp.data(i,DCobstypes[P1]);
+      spdata[P2][i] = svp.data(i,DCobstypes[P2]);
 
       // compute range minus phase for output
       // do the same at the beginning ("BEG")
 
       // compute WL and GFP
          // narrow lane range (m)
-      double wlr = wl1r * spdvector[i].data[P1] + wl2r * spdvector[i].data[P2];
+      double wlr = wl1r * spdata[P1][i] + wl2r * spdata[P2][i];
          // wide lane phase (m)
-      double wlp = wl1p * spdvector[i].data[L1] + wl2p * spdvector[i].data[L2];
+      double wlp = wl1p * spdata[L1][i] + wl2p * spdata[L2][i];
          // geo-free range (m)
-      double gfr = gf1r * spdvector[i].data[P1] + gf2r * spdvector[i].data[P2];
+      double gfr = gf1r * spdata[P1][i] + gf2r * spdata[P2][i];
          // geo-free phase (m)
-      double gfp = gf1p * spdvector[i].data[L1] + gf2p * spdvector[i].data[L2];
+      double gfp = gf1p * spdata[L1][i] + gf2p * spdata[L2][i];
       if(i == ifirst) {
          WLbias = (wlp-wlr)/wlwl;
          GFbias = gfp;
       }
-      spdvector[i].data[A1] = (wlp-wlr)/wlwl - WLbias; // wide lane bias (cyc)
-      spdvector[i].data[A2] = gfp - GFbias;            // geo-free phase (m)
-      //spdvector[i].data[A2] = gfr - gfp;             // geo-free range - phase (m)
+      spdata[A1][i] = (wlp-wlr)/wlwl - WLbias; // wide lane bias (cyc)
+      spdata[A2][i] = gfp - GFbias;            // geo-free phase (m)
+      //spdata[A2][i] = gfr - gfp;             // geo-free range - phase (m)
 
    } // end loop over all data
 
@@ -3015,10 +3040,10 @@ try {
    // ---------------------------------------------------------
    // copy corrected data into original SatPass, without disturbing other obs types
    for(i=0; i<static_cast<int>(size()); i++) {
-      svp.data(i,DCobstypes[L1]) = spdvector[i].data[L1];
-      svp.data(i,DCobstypes[L2]) = spdvector[i].data[L2];
-      svp.data(i,DCobstypes[P1]) = spdvector[i].data[P1];
-      svp.data(i,DCobstypes[P2]) = spdvector[i].data[P2];
+      svp.data(i,DCobstypes[L1]) = spdata[L1][i];
+      svp.data(i,DCobstypes[L2]) = spdata[L2][i];
+      svp.data(i,DCobstypes[P1]) = spdata[P1][i];
+      svp.data(i,DCobstypes[P2]) = spdata[P2][i];
 
       // change the flag for use by SatPass
       //const unsigned short SatPass::OK  = 1; good data
@@ -3028,19 +3053,19 @@ try {
       //const unsigned short SatPass::LL3 = 6; discontinuity on L1 and L2
       //const unsigned short GDCPass::DETECT   =   6;  // = WLDETECT | GFDETECT
       //const unsigned short GDCPass::FIX      =  24;  // = WLFIX | GFFIX
-      if(spdvector[i].flag & OK) {
-         if(((spdvector[i].flag & DETECT)==0 && (spdvector[i].flag & FIX)!=0)
+      if(spflag[i] & OK) {
+         if(((spflag[i] & DETECT)==0 && (spflag[i] & FIX)!=0)
             || i == ifirst)
-            spdvector[i].flag = LL3 + OK;
+            spflag[i] = LL3 + OK;
          else
-            spdvector[i].flag = OK;
+            spflag[i] = OK;
       }
       else
-         spdvector[i].flag = BAD;
+         spflag[i] = BAD;
 
-      svp.LLI(i,DCobstypes[L1]) = (spdvector[i].flag & LL1) ? 1 : 0;
-      svp.LLI(i,DCobstypes[L2]) = (spdvector[i].flag & LL2) ? 1 : 0;
-      svp.setFlag(i,spdvector[i].flag);
+      svp.LLI(i,DCobstypes[L1]) = (spflag[i] & LL1) ? 1 : 0;
+      svp.LLI(i,DCobstypes[L2]) = (spflag[i] & LL2) ? 1 : 0;
+      svp.setFlag(i,spflag[i]);
    }
 
    // ---------------------------------------------------------
@@ -3063,13 +3088,13 @@ try {
          if(ilast > -1) {
             ifirst = static_cast<int>(it->nbeg);
             while(ifirst <= static_cast<int>(it->nend)
-                  && !(spdvector[ifirst].flag & OK)) ifirst++;
-            i = spdvector[ifirst].ndt - spdvector[ilast].ndt;
+                  && !(spflag[ifirst] & OK)) ifirst++;
+            i = spndt[ifirst] - spndt[ilast];
             oss << " gap_segs " << setprecision(1) << setw(5)
                << cfg(DT)*i << " s = " << i << " pts.";
          }
          ilast = static_cast<int>(it->nend);
-         while(ilast >= static_cast<int>(it->nbeg) && !(spdvector[ilast].flag & OK))
+         while(ilast >= static_cast<int>(it->nbeg) && !(spflag[ilast] & OK))
             ilast--;
       }
       oss << endl;
@@ -3178,16 +3203,16 @@ try {
    sit->nend = ibeg-1;
 
    // 'trim' beg and end indexes
-   while(s.nend > s.nbeg && !(spdvector[s.nend].flag & OK)) s.nend--;
-   while(sit->nend > sit->nbeg && !(spdvector[sit->nend].flag & OK)) sit->nend--;
+   while(s.nend > s.nbeg && !(spflag[s.nend] & OK)) s.nend--;
+   while(sit->nend > sit->nbeg && !(spflag[sit->nend] & OK)) sit->nend--;
 
    // recompute npts // TD is this done somewhere else?
    unsigned int i;
    s.npts = sit->npts = 0;
    for(i=s.nbeg; i<=s.nend; i++)
-      if(spdvector[i].flag & OK) s.npts++;
+      if(spflag[i] & OK) s.npts++;
    for(i=sit->nbeg; i<=sit->nend; i++)
-      if(spdvector[i].flag & OK) sit->npts++;
+      if(spflag[i] & OK) sit->npts++;
 
    // get the segment number right
    s.nseg++;
@@ -3254,13 +3279,13 @@ try {
             << " bias(gf)=" << setw(13) << it->bias2; //biasgf;
          if(ilast > -1) {
             ifirst = it->nbeg;
-            while(ifirst <= it->nend && !(spdvector[ifirst].flag & OK)) ifirst++;
-            i = spdvector[ifirst].ndt - spdvector[ilast].ndt;
+            while(ifirst <= it->nend && !(spflag[ifirst] & OK)) ifirst++;
+            i = spndt[ifirst] - spndt[ilast];
             oss << " Gap " << setprecision(1) << setw(5)
                << cfg(DT)*i << " s = " << i << " pts.";
          }
          ilast = it->nend;
-         while(ilast >= static_cast<int>(it->nbeg) && !(spdvector[ilast].flag & OK))
+         while(ilast >= static_cast<int>(it->nbeg) && !(spflag[ilast] & OK))
             ilast--;
       }
 
@@ -3275,15 +3300,15 @@ try {
 
          oss << "DSC" << label << " " << GDCUnique << " " << sat << " " << it->nseg
             << " " << printTime(time(i),outFormat)
-            << " " << setw(3) << spdvector[i].flag
+            << " " << setw(3) << int(spflag[i])
             << fixed << setprecision(3)
-            << " " << setw(13) << spdvector[i].data[L1] - it->bias2 //biasgf  //temp
-            << " " << setw(13) << spdvector[i].data[L2] - it->bias2 //biasgf
-            << " " << setw(13) << spdvector[i].data[P1] - it->bias1 //biaswl
-            << " " << setw(13) << spdvector[i].data[P2];
+            << " " << setw(13) << spdata[L1][i] - it->bias2 //biasgf  //temp
+            << " " << setw(13) << spdata[L2][i] - it->bias2 //biasgf
+            << " " << setw(13) << spdata[P1][i] - it->bias1 //biaswl
+            << " " << setw(13) << spdata[P2][i];
          if(extra) oss
-            << " " << setw(13) << spdvector[i].data[A1]
-            << " " << setw(13) << spdvector[i].data[A2];
+            << " " << setw(13) << spdata[A1][i]
+            << " " << setw(13) << spdata[A2][i];
          oss << " " << setw(4) << i;
          if(i == it->nbeg) oss
             << " " << setw(13) << it->bias1 //biaswl
@@ -3318,10 +3343,10 @@ try {
       << endl;
 
    it->npts = 0;
-   for(i=it->nbeg; i<=it->nend; i++) if(spdvector[i].flag & OK) {
+   for(i=it->nbeg; i<=it->nend; i++) if(spflag[i] & OK) {
       // count these : learn
       learn["points deleted: " + msg]++;
-      spdvector[i].flag = BAD;
+      spflag[i] = BAD;
    }
 
    learn["segments deleted: " + msg]++;
@@ -242,6 +242,9 @@ namespace gpstk {
    /// the SatPass flag.
    /// Glonass satellites require a frequency channel integer; the caller may pass
    /// this in, or let the GDC compute it from the data - if it fails it returns -6.
+   /// The corrector keeps no state between calls except the call count, so passes
+   /// may be corrected on separate threads, provided each call is given its own
+   /// config (when there is debug output) and a unique number.
    ///
    /// @param SP       SatPass object containing the input data.
    /// @param config   GDCconfiguration object.
@@ -249,6 +252,8 @@ namespace gpstk {
    /// @param retMsg   string summary of results: see 'GDC' in output, class GDCreturn
    ///      if retMsg is not empty on call, replace 'GDC' with retMsg.
    /// @param GLOn     GLONASS frequency channel (-7<=n<7), -99 means UNKNOWN
+   /// @param unique   number identifying this call in the debug output and in
+   ///      retMsg; if 0, calls are numbered in the order they are made.
    /// @return 0 for success, otherwise return an Error code;
    ///
    /// codes are defined as follows.
@@ -262,7 +267,8 @@ namespace gpstk {
                               GDCconfiguration& config,
                               std::vector<std::string>& EditCmds,
                               std::string& retMsg,
-                              int GLOn=-99)
+                              int GLOn=-99,
+                              int unique=0)
       throw(Exception);
 
    //@}
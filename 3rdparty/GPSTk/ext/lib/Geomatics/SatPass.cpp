@@ -43,6 +43,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <climits>
 // gpstk
 #include "SatPass.hpp"
 #include "Stats.hpp"
@@ -102,6 +103,9 @@ void SatPass::init(RinexSatID insat, double indt, vector<string> obstypes) throw
       indexForLabel[obstypes[i]] = i;
       labelForIndex[i] = obstypes[i];
    }
+   spdata.resize(obstypes.size());
+   splli.resize(obstypes.size());
+   spssi.resize(obstypes.size());
 }
 
 SatPass& SatPass::operator=(const SatPass& right) throw()
@@ -115,9 +119,13 @@ SatPass& SatPass::operator=(const SatPass& right) throw()
       firstTime = right.firstTime;
       lastTime = right.lastTime;
       ngood = right.ngood;
-      spdvector.resize(right.spdvector.size());
-      for(int i=0; i<right.spdvector.size(); i++)
-         spdvector[i] = right.spdvector[i];
+      spdata = right.spdata;
+      splli = right.splli;
+      spssi = right.spssi;
+      spflag = right.spflag;
+      spuserflag = right.spuserflag;
+      spndt = right.spndt;
+      sptoffset = right.sptoffset;
    }
 
    return *this;
@@ -149,10 +157,14 @@ int SatPass::addData(const Epoch tt,
                   + StringUtils::asString(ssi.size()));
       GPSTK_THROW(e);
    }
-   if(spdvector.size() > 0 && spdvector[0].data.size() != data.size()) {
+   if(size() > 0 && spdata.size() != data.size()) {
       Exception e("Error - addData passed different dimension that earlier!"
                    + StringUtils::asString(data.size()) + " != "
-                   + StringUtils::asString(spdvector[0].data.size()));
+                   + StringUtils::asString(spdata.size()));
+      GPSTK_THROW(e);
+   }
+   if(flag > UCHAR_MAX) {              // spflag holds one byte per epoch
+      Exception e("Invalid flag in addData() " + StringUtils::asString(flag));
       GPSTK_THROW(e);
    }
 
@@ -228,13 +240,14 @@ try {
    //if(count == -1) return 1;            // 4/16/13
    if(count < 0) return -1;
 
-   unsigned int i, j, n(0);                     // count for ngood
-   for(i=0; i<spdvector.size(); i++) {
-      if(spdvector[i].ndt >= static_cast<unsigned int>(count)) { j=i; break; }
-      if(spdvector[i].flag != SatPass::BAD) n++;
+   unsigned int i, j(size()), n(0);             // count for ngood
+   for(i=0; i<size(); i++) {
+      if(spndt[i] >= static_cast<unsigned int>(count)) { j=i; break; }
+      if(spflag[i] != SatPass::BAD) n++;
    }
-   if(j > -1) {
-      spdvector.resize(j+1);
+   if(j < size()) {
+      if(spflag[j] != SatPass::BAD) n++;
+      resizeData(j+1);
       lastTime = time(j);
       ngood = n;
    }
@@ -287,12 +300,18 @@ try {
 
    bool first,done,ok;
    int i,dn,di,sign(0);
-   const int N(spdvector.size());
+   const int N(size());
    double pP1,pP2,pL1,pL2,pRB1,pRB2;
    TwoSampleStats<double> dN1,dN2;
    static const double testStdDev(40.0),testSlope(0.1),testRatio(10.0),testSigma(.25);
    vector<int> dnSeen;
 
+   // columns of data
+   const vector<double>& colP1(spdata[indexForLabel[(useC1 ? "C1" : "P1")]]);
+   const vector<double>& colP2(spdata[indexForLabel["P2"]]);
+   const vector<double>& colL1(spdata[indexForLabel["L1"]]);
+   const vector<double>& colL2(spdata[indexForLabel["L2"]]);
+
    if(n < -7 || n > 7) n=0;         // just in case
    dn = 0;
    di = (N > 50 ? N/50 : 1);        // want about 50 points total
@@ -309,12 +328,12 @@ try {
       // compute the slope of dBias vs dL: biases B = L - DP
       first = true;
       for(i=0; i<N; i+=di) {
-         if(!(spdvector[i].flag & OK)) continue;         // skip bad data
+         if(!(spflag[i] & OK)) continue;         // skip bad data
 
-         double P1 = spdvector[i].data[indexForLabel[(useC1 ? "C1" : "P1")]];
-         double P2 = spdvector[i].data[indexForLabel["P2"]];
-         double L1 = spdvector[i].data[indexForLabel["L1"]];
-         double L2 = spdvector[i].data[indexForLabel["L2"]];
+         double P1 = colP1[i];
+         double P2 = colP2[i];
+         double L1 = colL1[i];
+         double L2 = colL2[i];
          double RB1 = wl1*L1 - D11*P1 - D12*P2;
          double RB2 = wl2*L2 - D21*P1 - D22*P2;
 
@@ -482,14 +501,20 @@ try {
    long LB1,LB2,LB10,LB20;
    Stats<double> PB1,PB2;
 
+   // columns of data
+   vector<double>& colP1(spdata[indexForLabel[(useC1 ? "C1" : "P1")]]);
+   vector<double>& colP2(spdata[indexForLabel[(useC2 ? "C2" : "P2")]]);
+   vector<double>& colL1(spdata[indexForLabel["L1"]]);
+   vector<double>& colL2(spdata[indexForLabel["L2"]]);
+
    // get the biases B = L - DP
-   for(first=true,i=0; i<spdvector.size(); i++) {
-      if(!(spdvector[i].flag & OK)) continue;        // skip bad data
+   for(first=true,i=0; i<size(); i++) {
+      if(!(spflag[i] & OK)) continue;        // skip bad data
 
-      double P1 = spdvector[i].data[indexForLabel[(useC1 ? "C1" : "P1")]];
-      double P2 = spdvector[i].data[indexForLabel[(useC2 ? "C2" : "P2")]];
-      double L1 = spdvector[i].data[indexForLabel["L1"]] - dLB10;
-      double L2 = spdvector[i].data[indexForLabel["L2"]] - dLB20;
+      double P1 = colP1[i];
+      double P2 = colP2[i];
+      double L1 = colL1[i] - dLB10;
+      double L2 = colL2[i] - dLB20;
 
       if(first) {                   // remove the large numerical range
          LB10 = long(L1-P1/wl1);
@@ -555,25 +580,23 @@ try {
 
    if(!debiasPH && !smoothPR) return;
 
-   for(i=0; i<spdvector.size(); i++) {
-      if(!(spdvector[i].flag & OK)) continue;        // skip bad data
+   for(i=0; i<size(); i++) {
+      if(!(spflag[i] & OK)) continue;        // skip bad data
 
       // replace the phase with the debiased phase, with integer bias (cycles)
       if(debiasPH) {
-         spdvector[i].data[indexForLabel["L1"]] -= LB1;
-         spdvector[i].data[indexForLabel["L2"]] -= LB2;
+         colL1[i] -= LB1;
+         colL2[i] -= LB2;
       }
 
       // replace the pseudorange with the smoothed pseudorange
       if(smoothPR) {
          // compute the debiased phase, with real bias
-         dbL1 = spdvector[i].data[indexForLabel["L1"]] - RB1;
-         dbL2 = spdvector[i].data[indexForLabel["L2"]] - RB2;
+         dbL1 = colL1[i] - RB1;
+         dbL2 = colL2[i] - RB2;
 
-         spdvector[i].data[indexForLabel[(useC1 ? "C1" : "P1")]]
-                                                = D11*wl1*dbL1 + D12*wl2*dbL2;
-         spdvector[i].data[indexForLabel[(useC2 ? "C2" : "P2")]]
-                                                = D21*wl1*dbL1 + D22*wl2*dbL2;
+         colP1[i] = D11*wl1*dbL1 + D12*wl2*dbL2;
+         colP2[i] = D21*wl1*dbL1 + D22*wl2*dbL2;
       }
    }
 }
@@ -584,7 +607,7 @@ catch(Exception& e) { GPSTK_RETHROW(e); }
 // NB may be used as rvalue or lvalue
 double& SatPass::data(unsigned int i, string type) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in data() " + asString(i));
       GPSTK_THROW(e);
    }
@@ -593,21 +616,21 @@ double& SatPass::data(unsigned int i, string type) throw(Exception)
       Exception e("Invalid obs type in data() " + type);
       GPSTK_THROW(e);
    }
-   return spdvector[i].data[it->second];
+   return spdata[it->second][i];
 }
 
 double& SatPass::timeoffset(unsigned int i) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in timeoffset() " + asString(i));
       GPSTK_THROW(e);
    }
-   return spdvector[i].toffset;
+   return sptoffset[i];
 }
 
 unsigned short& SatPass::LLI(unsigned int i, string type) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in LLI() " + asString(i));
       GPSTK_THROW(e);
    }
@@ -616,12 +639,12 @@ unsigned short& SatPass::LLI(unsigned int i, string type) throw(Exception)
       Exception e("Invalid obs type in LLI() " + type);
       GPSTK_THROW(e);
    }
-   return spdvector[i].lli[it->second];
+   return splli[it->second][i];
 }
 
 unsigned short& SatPass::SSI(unsigned int i, string type) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in SSI() " + asString(i));
       GPSTK_THROW(e);
    }
@@ -630,85 +653,105 @@ unsigned short& SatPass::SSI(unsigned int i, string type) throw(Exception)
       Exception e("Invalid obs type in SSI() " + type);
       GPSTK_THROW(e);
    }
-   return spdvector[i].ssi[it->second];
+   return spssi[it->second][i];
+}
+
+// NB the whole column, without copying; invalidated by adding or removing data
+const vector<double>& SatPass::dataSeries(const string& type) const
+   throw(Exception)
+{
+   map<string, unsigned int>::const_iterator it;
+   if((it = indexForLabel.find(type)) == indexForLabel.end()) {
+      Exception e("Invalid obs type in dataSeries() " + type);
+      GPSTK_THROW(e);
+   }
+   return spdata[it->second];
 }
 
 // ---------------------------------- set routines ----------------------------
 void SatPass::setFlag(unsigned int i, unsigned short f) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in setFlag() " + asString(i));
       GPSTK_THROW(e);
    }
+   if(f > UCHAR_MAX) {                 // spflag holds one byte per epoch
+      Exception e("Invalid flag in setFlag() " + asString(f));
+      GPSTK_THROW(e);
+   }
 
-   if(spdvector[i].flag != BAD && f == BAD) ngood--;
-   if(spdvector[i].flag == BAD && f != BAD) ngood++;
-   spdvector[i].flag = f;
+   if(spflag[i] != BAD && f == BAD) ngood--;
+   if(spflag[i] == BAD && f != BAD) ngood++;
+   spflag[i] = f;
 }
 
 // set the userflag at one index to inflag;
 // NB SatPass does nothing w/ this member except setUserFlag() and getUserFlag();
 void SatPass::setUserFlag(unsigned int i, unsigned int f) throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in setUserFlag() " + asString(i));
       GPSTK_THROW(e);
    }
 
-   spdvector[i].userflag = f;
+   if(spuserflag.empty()) {            // allocate only when first used
+      if(f == 0) return;
+      spuserflag.resize(size(),0);
+   }
+   spuserflag[i] = f;
 }
 
 // ---------------------------------- get routines ----------------------------
 // get value of flag at one index
 unsigned short SatPass::getFlag(unsigned int i) const throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in getFlag() " + asString(i));
       GPSTK_THROW(e);
    }
-   return spdvector[i].flag;
+   return spflag[i];
 }
 
 // get the userflag at one index
 // NB SatPass does nothing w/ this member except setUserFlag() and getUserFlag();
 unsigned int SatPass::getUserFlag(unsigned int i) const throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in getUserFlag() " + asString(i));
       GPSTK_THROW(e);
    }
-   return spdvector[i].userflag;
+   return (spuserflag.empty() ? 0 : spuserflag[i]);
 }
 
 // get one element of the count array of this SatPass
 unsigned int SatPass::getCount(unsigned int i) const throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("invalid in getCount() " + asString(i));
       GPSTK_THROW(e);
    }
-   return spdvector[i].ndt;
+   return spndt[i];
 }
 
 // @return the earliest time (full, including toffset) in this SatPass data
 Epoch SatPass::getFirstTime(void) const throw() { return time(0); }
 
 // @return the latest time (full, including toffset) in this SatPass data
-Epoch SatPass::getLastTime(void) const throw() { return time(spdvector.size()-1); }
+Epoch SatPass::getLastTime(void) const throw() { return time(size()-1); }
 
 // these allow you to get e.g. P1 or C1. NB return double not double& as above: rvalue
 double SatPass::data(unsigned int i, string type1, string type2) const
    throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in data() " + asString(i));
       GPSTK_THROW(e);
    }
    map<string, unsigned int>::const_iterator it;
    if((it = indexForLabel.find(type1)) != indexForLabel.end())
-      return spdvector[i].data[it->second];
+      return spdata[it->second][i];
    else if((it = indexForLabel.find(type2)) != indexForLabel.end())
-      return spdvector[i].data[it->second];
+      return spdata[it->second][i];
    else {
       Exception e("Invalid obs types in data() " + type1 + " " + type2);
       GPSTK_THROW(e);
@@ -718,15 +761,15 @@ double SatPass::data(unsigned int i, string type1, string type2) const
 unsigned short SatPass::LLI(unsigned int i, string type1, string type2)
    throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in LLI() " + asString(i));
       GPSTK_THROW(e);
    }
    map<string, unsigned int>::const_iterator it;
    if((it = indexForLabel.find(type1)) != indexForLabel.end())
-      return spdvector[i].lli[it->second];
+      return splli[it->second][i];
    else if((it = indexForLabel.find(type2)) != indexForLabel.end())
-      return spdvector[i].lli[it->second];
+      return splli[it->second][i];
    else {
       Exception e("Invalid obs types in LLI() " + type1 + " " + type2);
       GPSTK_THROW(e);
@@ -736,15 +779,15 @@ unsigned short SatPass::LLI(unsigned int i, string type1, string type2)
 unsigned short SatPass::SSI(unsigned int i, string type1, string type2)
    throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in SSI() " + asString(i));
       GPSTK_THROW(e);
    }
    map<string, unsigned int>::const_iterator it;
    if((it = indexForLabel.find(type1)) == indexForLabel.end())
-      return spdvector[i].ssi[it->second];
+      return spssi[it->second][i];
    else if((it = indexForLabel.find(type2)) == indexForLabel.end())
-      return spdvector[i].ssi[it->second];
+      return spssi[it->second][i];
    else {
       Exception e("Invalid obs types in SSI() " + type1 + " " + type2);
       GPSTK_THROW(e);
@@ -755,12 +798,12 @@ unsigned short SatPass::SSI(unsigned int i, string type1, string type2)
 // return the time corresponding to the given index in the data array
 Epoch SatPass::time(unsigned int i) const throw(Exception)
 {
-   if(i >= spdvector.size()) {
+   if(i >= size()) {
       Exception e("Invalid index in time() " + asString(i));
       GPSTK_THROW(e);
    }
    // computing toff first is necessary to avoid a rare bug in Epoch..
-   double toff = spdvector[i].ndt * dt + spdvector[i].toffset;
+   double toff = spndt[i] * dt + sptoffset[i];
    return (firstTime + toff);
 }
 
@@ -788,14 +831,17 @@ try {
    newSP.Status = Status;
    newSP.indexForLabel = indexForLabel;
    newSP.labelForIndex = labelForIndex;
+   newSP.spdata = vector< vector<double> >(spdata.size());
+   newSP.splli = vector< vector<unsigned short> >(splli.size());
+   newSP.spssi = vector< vector<unsigned short> >(spssi.size());
 
    oldgood = ngood;
    ngood = ilast = 0;
-   for(i=0; i<spdvector.size(); i++) {             // loop over all data
-      n = spdvector[i].ndt;
+   for(i=0; i<size(); i++) {             // loop over all data
+      n = spndt[i];
       tt = time(i);
       if(n < N) {                                     // keep in this SatPass
-         if(spdvector[i].flag != BAD) ngood++;
+         if(spflag[i] != BAD) ngood++;
          ilast = i;
       }
       else {                                          // copy out data into new SP
@@ -804,14 +850,14 @@ try {
             newSP.firstTime = newSP.lastTime = tt;
          }
          j = newSP.countForTime(tt);
-         spdvector[i].ndt = j;
-         spdvector[i].toffset = tt - newSP.firstTime - j*dt;
-         newSP.spdvector.push_back(spdvector[i]);
+         spndt[i] = j;
+         sptoffset[i] = tt - newSP.firstTime - j*dt;
+         newSP.appendData(getData(i));
       }
    }
 
    // now trim this SatPass
-   spdvector.resize(ilast+1);
+   resizeData(ilast+1);
    lastTime = time(ilast);
 
    return true;
@@ -823,7 +869,7 @@ void SatPass::decimate(const int N, Epoch refTime) throw(Exception)
 {
 try {
    if(N <= 1) return;
-   if(spdvector.size() < N) { dt = N*dt; return; }
+   if(size() < N) { dt = N*dt; return; }
    if(refTime == CommonTime::BEGINNING_OF_TIME) refTime = firstTime;
 
    // find new firstTime = time(nstart)
@@ -835,27 +881,27 @@ try {
    // decimate
    ngood = 0;
    Epoch newfirstTime, tt;
-   for(j=0,i=0; i<spdvector.size(); i++) {
-      if(spdvector[i].ndt % N != nstart) continue;
+   for(j=0,i=0; i<size(); i++) {
+      if(spndt[i] % N != nstart) continue;
       lastTime = time(i);
       if(j==0) {
          newfirstTime = time(i);
-         spdvector[i].toffset = 0.0;
-         spdvector[i].ndt = 0;
+         sptoffset[i] = 0.0;
+         spndt[i] = 0;
       }
       else {
          tt = time(i);
-         spdvector[i].ndt = int(0.5+(tt-newfirstTime)/(N*dt));
-         spdvector[i].toffset = tt - newfirstTime - spdvector[i].ndt * N * dt;
+         spndt[i] = int(0.5+(tt-newfirstTime)/(N*dt));
+         sptoffset[i] = tt - newfirstTime - spndt[i] * N * dt;
       }
-      spdvector[j] = spdvector[i];
-      if(spdvector[j].flag != BAD) ngood++;
+      moveData(i,j);
+      if(spflag[j] != BAD) ngood++;
       j++;
    }
 
    dt = N*dt;
    firstTime = newfirstTime;
-   spdvector.resize(j); // trim
+   resizeData(j); // trim
 }
 catch(Exception& e) { GPSTK_RETHROW(e); }
 }
@@ -873,24 +919,24 @@ void SatPass::dump(ostream& os, string msg1, string msg2) throw()
    os << " gap(pts)";
    os << endl;
 
-   for(i=0; i<spdvector.size(); i++) {
+   for(i=0; i<size(); i++) {
       tt = time(i);
       os << msg1
          << " " << setw(3) << i
          << " " << sat
-         << " " << setw(3) << spdvector[i].ndt
-         << " " << setw(2) << spdvector[i].flag
+         << " " << setw(3) << spndt[i]
+         << " " << setw(2) << int(spflag[i])
          << " " << printTime(tt,SatPass::outFormat)
          << fixed << setprecision(6)
-         << " " << setw(9) << spdvector[i].toffset
+         << " " << setw(9) << sptoffset[i]
          << setprecision(3);
       for(j=0; j<indexForLabel.size(); j++)
-         os << " " << setw(13) << spdvector[i].data[j]
-            << " " << spdvector[i].lli[j]
-            << " " << spdvector[i].ssi[j];
-      if(i==0) last = spdvector[i].ndt;
-      if(spdvector[i].ndt - last > 1) os << " " << spdvector[i].ndt-last;
-      last = spdvector[i].ndt;
+         os << " " << setw(13) << spdata[j][i]
+            << " " << splli[j][i]
+            << " " << spssi[j][i];
+      if(i==0) last = spndt[i];
+      if(spndt[i] - last > 1) os << " " << spndt[i]-last;
+      last = spndt[i];
       os << endl;
    }
 }
@@ -898,7 +944,7 @@ void SatPass::dump(ostream& os, string msg1, string msg2) throw()
 // output SatPass to ostream
 ostream& operator<<(ostream& os, SatPass& sp )
 {
-   os << setw(4) << sp.spdvector.size()
+   os << setw(4) << sp.size()
       << " " << sp.sat
       << " " << setw(4) << sp.ngood
       << " " << setw(2) << sp.Status
@@ -917,7 +963,7 @@ int SatPass::push_back(const Epoch tt, SatPassData& spd) throw()
 {
    unsigned int n;
       // if this is the first point, save first time
-   if(spdvector.size() == 0) {
+   if(size() == 0) {
       firstTime = lastTime = tt;
       n = 0;
    }
@@ -926,7 +972,7 @@ int SatPass::push_back(const Epoch tt, SatPassData& spd) throw()
          // compute count for this point - prev line means n is >= 0
       n = countForTime(tt);
          // test size of gap
-      if( (n - spdvector[spdvector.size()-1].ndt) * dt > maxGap)
+      if( (n - spndt[spndt.size()-1]) * dt > maxGap)
          return -1;
       lastTime = tt;
    }
@@ -937,19 +983,80 @@ int SatPass::push_back(const Epoch tt, SatPassData& spd) throw()
    if(spd.flag != SatPass::BAD) ngood++;
    spd.ndt = n;
    spd.toffset = tt - firstTime - n*dt;
-   spdvector.push_back(spd);
-   return (spdvector.size()-1);
+   appendData(spd);
+   return (size()-1);
 }
 
 // get one element of the data array of this SatPass (private)
 struct SatPass::SatPassData SatPass::getData(unsigned int i) const
    throw(Exception)
 {
-   if(i >= spdvector.size()) {         // TD ?? keep this - its private
+   if(i >= size()) {         // TD ?? keep this - its private
       Exception e("invalid in getData() " + asString(i));
       GPSTK_THROW(e);
    }
-   return spdvector[i];
+   SatPassData spd(spdata.size());
+   spd.flag = spflag[i];
+   spd.userflag = (spuserflag.empty() ? 0 : spuserflag[i]);
+   spd.ndt = spndt[i];
+   spd.toffset = sptoffset[i];
+   for(int k=0; k<spdata.size(); k++) {
+      spd.data[k] = spdata[k][i];
+      spd.lli[k] = splli[k][i];
+      spd.ssi[k] = spssi[k][i];
+   }
+   return spd;
+}
+
+// append one epoch of data to the columns (private)
+void SatPass::appendData(const SatPassData& spd) throw()
+{
+   const unsigned int n(size());
+   if(spdata.size() < spd.data.size()) {     // more data than obs types at c'tor
+      spdata.resize(spd.data.size(), vector<double>(n,0.0));
+      splli.resize(spd.data.size(), vector<unsigned short>(n,0));
+      spssi.resize(spd.data.size(), vector<unsigned short>(n,0));
+   }
+   for(int k=0; k<spdata.size(); k++) {
+      bool have(k < spd.data.size());
+      spdata[k].push_back(have ? spd.data[k] : 0.0);
+      splli[k].push_back(have ? spd.lli[k] : 0);
+      spssi[k].push_back(have ? spd.ssi[k] : 0);
+   }
+   if(spuserflag.empty() && spd.userflag != 0) spuserflag.resize(n,0);
+   if(!spuserflag.empty()) spuserflag.push_back(spd.userflag);
+   spflag.push_back(static_cast<unsigned char>(spd.flag));
+   spndt.push_back(spd.ndt);
+   sptoffset.push_back(spd.toffset);
+}
+
+// copy the data at index i to index j (private)
+void SatPass::moveData(unsigned int i, unsigned int j) throw()
+{
+   if(i == j) return;
+   for(int k=0; k<spdata.size(); k++) {
+      spdata[k][j] = spdata[k][i];
+      splli[k][j] = splli[k][i];
+      spssi[k][j] = spssi[k][i];
+   }
+   if(!spuserflag.empty()) spuserflag[j] = spuserflag[i];
+   spflag[j] = spflag[i];
+   spndt[j] = spndt[i];
+   sptoffset[j] = sptoffset[i];
+}
+
+// resize all the columns to n epochs (private)
+void SatPass::resizeData(unsigned int n) throw()
+{
+   for(int k=0; k<spdata.size(); k++) {
+      spdata[k].resize(n,0.0);
+      splli[k].resize(n,0);
+      spssi[k].resize(n,0);
+   }
+   if(!spuserflag.empty()) spuserflag.resize(n,0);
+   spflag.resize(n,BAD);
+   spndt.resize(n,0);
+   sptoffset.resize(n,0.0);
 }
 
 }  // end namespace gpstk
@@ -62,10 +62,13 @@ namespace gpstk {
 /// such as list or vector, they MUST be consistently defined, namely the number
 /// of observation types must be the same, otherwise a nasty segmentation fault
 /// can occur when building the STL container.
+/// The data are stored by column, one contiguous array per observation type, so
+/// a whole series can be handed to e.g. Robust:: routines without copying, using
+/// dataSeries() and flagSeries().
 class SatPass {
 protected:
    // --------------- SatPassData data structure for internal use only ----------
-   //
+   // one epoch of data, as it is added to or taken from the columns of SatPass
    struct SatPassData {
       // member data ----------------------------------
       /// a flag (cf. SatPass::BAD, etc.) that is set to OK at creation
@@ -142,8 +145,17 @@ protected:
    /// number of timetags with good data in the data arrays.
    unsigned int ngood;
 
-   /// ALL data in the pass, stored in SatPassData objects, in time order
-   std::vector<SatPassData> spdvector;
+   /// ALL data in the pass, in time order, stored by column: for each obs type
+   /// (indexed as in labelForIndex) one array each of data, LLI and SSI, and
+   /// one array for each of the per-epoch members of SatPassData.
+   std::vector< std::vector<double> > spdata;
+   std::vector< std::vector<unsigned short> > splli,spssi;
+   /// flags, one byte per epoch; the flags of SatPass and the GDC use 5 bits
+   std::vector<unsigned char> spflag;
+   /// user flags; empty until setUserFlag() is first called
+   std::vector<unsigned int> spuserflag;
+   std::vector<unsigned int> spndt;
+   std::vector<double> sptoffset;
 
    // --------------- private member functions ------------------------
 
@@ -159,6 +171,15 @@ protected:
    /// get a complete SatPassData at count i
    struct SatPassData getData(unsigned int i) const throw(Exception);
 
+   /// append a complete SatPassData to the columns, without checks
+   void appendData(const SatPassData& spd) throw();
+
+   /// copy the data at index i to index j, for compacting the columns
+   void moveData(unsigned int i, unsigned int j) throw();
+
+   /// resize all the columns to n epochs
+   void resizeData(unsigned int n) throw();
+
 public:
    // ------------------ friends --------------------------------------
    /// class gdc is used to detect and correct cycleslips
@@ -249,6 +270,8 @@ public:
    /// @param data      a vector of data values, parallel to the obstypes vector
    /// @param lli       a vector of LLI values, parallel to the obstypes vector
    /// @param ssi       a vector of SSI values, parallel to the obstypes vector
+   /// @param flag      flag of the data, at most 255 (e.g. SatPass::OK)
+   /// @throw Exception if the flag does not fit the one byte flag storage
    /// @return n>=0 if data was added successfully, n is the index of the new data
    ///        -1 if a gap is found (no data is added),
    ///        -2 if time tag is out of order (no data is added)
@@ -322,8 +345,10 @@ public:
    std::string getOutputFormat(void) { return outFormat; }
 
    /// set the flag at one index to flag - use the SatPass constants OK, etc.
+   /// Flags are stored in one byte, so flag must be at most 255.
    /// @param  i    index of the data of interest
    /// @param  flag flag (e.g. SatPass::BAD).
+   /// @throw Exception if i is out of range or flag is larger than 255
    void setFlag(unsigned int i, unsigned short flag) throw(Exception);
 
    /// set the userflag at one index to inflag;
@@ -364,7 +389,7 @@ public:
 
    /// @return the earliest time of good data in this SatPass data
    Epoch getFirstGoodTime(void) const throw() {
-      for(int j=0; j<spdvector.size(); j++) if(spdvector[j].flag & OK) {
+      for(int j=0; j<spflag.size(); j++) if(spflag[j] & OK) {
          return time(j);
       }
       return CommonTime::END_OF_TIME;
@@ -372,7 +397,7 @@ public:
 
    /// @return the latest time of good data in this SatPass data
    Epoch getLastGoodTime(void) const throw() {
-      for(int j=spdvector.size()-1; j>=0; j--) if(spdvector[j].flag & OK) {
+      for(int j=spflag.size()-1; j>=0; j--) if(spflag[j] & OK) {
          return time(j);
       }
       return CommonTime::BEGINNING_OF_TIME;
@@ -392,7 +417,7 @@ public:
 
    /// get the size of (the arrays in) this SatPass
    /// @return the size of the data array in this object
-   unsigned int size(void) const throw() { return spdvector.size(); }
+   unsigned int size(void) const throw() { return spndt.size(); }
 
    /// get one element of the count array of this SatPass
    /// @param  i   index of the data of interest
@@ -424,6 +449,19 @@ public:
    unsigned short SSI(unsigned int i, std::string type1, std::string type2)
       throw(Exception);
 
+   /// Access the data for one obs type at all indexes, in time order, without
+   /// copying; bad data are included, so use flagSeries() to select good data.
+   /// The reference is invalidated by anything that adds or removes data.
+   /// @param  type observation type (e.g. "L1") of the data of interest
+   /// @return the array of size() data of the given type
+   const std::vector<double>& dataSeries(const std::string& type) const
+      throw(Exception);
+
+   /// Access the flags at all indexes, in time order, without copying
+   /// @return the array of size() flags
+   const std::vector<unsigned char>& flagSeries(void) const throw()
+      { return spflag; }
+
    /// Test whether the object has obstype type
    /// @return true if this obstype was passed to the c'tor (i.e. is in indexForLabel)
    inline bool hasType(std::string type) const throw()
@@ -441,7 +479,7 @@ public:
 
    // -------------------------------- utils ---------------------------------
    /// clear the data (but not the obs types) from the arrays
-   void clear(void) throw() { spdvector.clear(); }
+   void clear(void) throw() { resizeData(0); }
 
    /// compute the timetag associated with index i in the data array
    /// @param  i   index of the data of interest
@@ -455,8 +493,8 @@ public:
    {
       int count = countForTime(tt);
       if(count < 0) return -1;
-      for(int i=0; i<spdvector.size(); i++)
-         if(count == spdvector[i].ndt) return i;
+      for(int i=0; i<spndt.size(); i++)
+         if(count == spndt[i]) return i;
       return -1;
    }
 
@@ -70,6 +70,10 @@ namespace gpstk
 
          SatIDSet satRejectedSet;
 
+            // Satellites to be modeled, and their elevations
+         std::vector<SatID> sats;
+         std::vector<double> elevation;
+
             // Loop through all the satellites
          satTypeValueMap::iterator stv;
          for(stv = gData.begin(); stv != gData.end(); ++stv) 
@@ -89,52 +93,93 @@ namespace gpstk
                satRejectedSet.insert( (*stv).first );
                continue;
             }
-            else
+
+            sats.push_back( (*stv).first );
+            elevation.push_back( (*stv).second(TypeID::elevation) );
+
+         }  // End of loop 'for(stv = gData.begin()...'
+
+
+            // Model all the satellites at once; the terms that depend on
+            // the station and epoch are computed only once
+         std::vector<double> tropoCorr, dryMap, wetMap;
+         double dryZDelay(0.0), wetZDelay(0.0);
+         bool batch( !sats.empty() );
+
+         if(batch)
+         {
+
+            try
+            {
+               pTropModel->batch_correction( elevation,
+                                             tropoCorr,
+                                             dryMap,
+                                             wetMap );
+               dryZDelay = pTropModel->dry_zenith_delay();
+               wetZDelay = pTropModel->wet_zenith_delay();
+            }
+            catch(InvalidTropModel& e)
             {
+                  // Model each satellite by itself below, so that only
+                  // those with problems are removed
+               batch = false;
+            }
 
-                  // Scalar to hold satellite elevation
-               double elevation( (*stv).second(TypeID::elevation) );
-               double tropoCorr(0.0), dryZDelay(0.0), wetZDelay(0.0);
-               double dryMap(0.0), wetMap(0.0);
+         }
 
-               try
+         for(size_t i = 0; i < sats.size(); i++)
+         {
+
+            double corr(0.0), dryZ(dryZDelay), wetZ(wetZDelay);
+            double dry(0.0), wet(0.0);
+
+            try
+            {
+
+               if(batch)
+               {
+                  corr = tropoCorr[i];
+                  dry = dryMap[i];
+                  wet = wetMap[i];
+               }
+               else
                {
                      // Compute tropospheric slant correction
-                  tropoCorr = pTropModel->correction(elevation);
-                  dryZDelay = pTropModel->dry_zenith_delay();
-                  wetZDelay = pTropModel->wet_zenith_delay();
-                  dryMap = pTropModel->dry_mapping_function(elevation);
-                  wetMap = pTropModel->wet_mapping_function(elevation);
-
-                     // Check validity
-                  if( !(pTropModel->isValid()) )
-                  {
-                     tropoCorr = 0.0;
-                     dryZDelay = 0.0;
-                     wetZDelay = 0.0;
-                     dryMap    = 0.0;
-                     wetMap    = 0.0;
-                  }
-
+                  corr = pTropModel->correction(elevation[i]);
+                  dryZ = pTropModel->dry_zenith_delay();
+                  wetZ = pTropModel->wet_zenith_delay();
+                  dry = pTropModel->dry_mapping_function(elevation[i]);
+                  wet = pTropModel->wet_mapping_function(elevation[i]);
                }
-               catch(InvalidTropModel& e)
+
+                  // Check validity
+               if( !(pTropModel->isValid()) )
                {
-                     // If some problem appears, then schedule this
-                     // satellite for removal
-                  satRejectedSet.insert( (*stv).first );
-                  continue;    // Skip this SV if problems arise
-               };
-
-                  // Now we have to add the new values to the data structure
-               (*stv).second[TypeID::tropoSlant] = tropoCorr;
-               (*stv).second[TypeID::dryTropo] = dryZDelay;
-               (*stv).second[TypeID::wetTropo] = wetZDelay;
-               (*stv).second[TypeID::dryMap] = dryMap;
-               (*stv).second[TypeID::wetMap] = wetMap;
+                  corr = 0.0;
+                  dryZ = 0.0;
+                  wetZ = 0.0;
+                  dry  = 0.0;
+                  wet  = 0.0;
+               }
 
             }
-
-         }  // End of loop 'for(stv = gData.begin()...'
+            catch(InvalidTropModel& e)
+            {
+                  // If some problem appears, then schedule this
+                  // satellite for removal
+               satRejectedSet.insert( sats[i] );
+               continue;    // Skip this SV if problems arise
+            };
+
+               // Now we have to add the new values to the data structure
+            typeValueMap& tvm( gData(sats[i]) );
+            tvm[TypeID::tropoSlant] = corr;
+            tvm[TypeID::dryTropo] = dryZ;
+            tvm[TypeID::wetTropo] = wetZ;
+            tvm[TypeID::dryMap] = dry;
+            tvm[TypeID::wetMap] = wet;
+
+         }  // End of loop 'for(size_t i = 0; i < sats.size(); i++)'
 
             // Remove satellites with missing data
          gData.removeSatID(satRejectedSet);
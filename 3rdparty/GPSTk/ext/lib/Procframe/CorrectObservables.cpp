@@ -78,7 +78,9 @@ namespace gpstk
 
 
             // Compute initial displacement vectors, in meters [UEN]
-         Triple initialBias( extraBiases + monumentVector );
+         Triple initialBias( ( (pContext != NULL)
+                                ? pContext->getTideDisplacement(time)
+                                : extraBiases ) + monumentVector );
          Triple dispL1( initialBias );
          Triple dispL2( initialBias );
          Triple dispL5( initialBias );
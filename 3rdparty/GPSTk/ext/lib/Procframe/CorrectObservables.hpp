@@ -48,6 +48,7 @@
 #include "ProcessingClass.hpp"
 #include "XvtStore.hpp"
 #include "Triple.hpp"
+#include "EpochContext.hpp"
 #include "Position.hpp"
 #include "Antenna.hpp"
 #include "GNSSconstants.hpp"
@@ -124,7 +125,8 @@ namespace gpstk
 
          /// Default constructor
       CorrectObservables()
-         : pEphemeris(NULL), nominalPos(0.0, 0.0, 0.0), useAzimuth(false),
+         : pEphemeris(NULL), pContext(NULL),
+           nominalPos(0.0, 0.0, 0.0), useAzimuth(false),
            L1PhaseCenter(0.0, 0.0, 0.0), L2PhaseCenter(0.0, 0.0, 0.0),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -138,7 +140,8 @@ namespace gpstk
           *
           */
       CorrectObservables(XvtStore<SatID>& ephem)
-         : pEphemeris(&ephem), nominalPos(0.0, 0.0, 0.0), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(0.0, 0.0, 0.0), useAzimuth(false),
            L1PhaseCenter(0.0, 0.0, 0.0), L2PhaseCenter(0.0, 0.0, 0.0),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -154,7 +157,8 @@ namespace gpstk
           */
       CorrectObservables( XvtStore<SatID>& ephem,
                           const Position& stapos )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(0.0, 0.0, 0.0), L2PhaseCenter(0.0, 0.0, 0.0),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -173,7 +177,8 @@ namespace gpstk
       CorrectObservables( XvtStore<SatID>& ephem,
                           const Position& stapos,
                           const Antenna& antennaObj )
-         : pEphemeris(&ephem), nominalPos(stapos), antenna(antennaObj),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), antenna(antennaObj),
            useAzimuth(true),
            L1PhaseCenter(0.0, 0.0, 0.0), L2PhaseCenter(0.0, 0.0, 0.0),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
@@ -193,7 +198,8 @@ namespace gpstk
       CorrectObservables( XvtStore<SatID>& ephem,
                           const Position& stapos,
                           const Triple& L1pc )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(L1pc), L2PhaseCenter(0.0, 0.0, 0.0),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -215,7 +221,8 @@ namespace gpstk
                           const Position& stapos,
                           const Triple& L1pc,
                           const Triple& L2pc )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(L1pc), L2PhaseCenter(L2pc),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -240,7 +247,8 @@ namespace gpstk
                           const Triple& L1pc,
                           const Triple& L2pc,
                           const Triple& extra )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(L1pc), L2PhaseCenter(L2pc),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -267,7 +275,8 @@ namespace gpstk
                           const Triple& L2pc,
                           const Triple& monument,
                           const Triple& extra )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(L1pc), L2PhaseCenter(L2pc),
            L5PhaseCenter(0.0, 0.0, 0.0), L6PhaseCenter(0.0, 0.0, 0.0),
            L7PhaseCenter(0.0, 0.0, 0.0), L8PhaseCenter(0.0, 0.0, 0.0),
@@ -306,7 +315,8 @@ namespace gpstk
                           const Triple& L8pc,
                           const Triple& monument,
                           const Triple& extra )
-         : pEphemeris(&ephem), nominalPos(stapos), useAzimuth(false),
+         : pEphemeris(&ephem), pContext(NULL),
+           nominalPos(stapos), useAzimuth(false),
            L1PhaseCenter(L1pc), L2PhaseCenter(L2pc),
            L5PhaseCenter(L5pc), L6PhaseCenter(L6pc),
            L7PhaseCenter(L7pc), L8PhaseCenter(L8pc),
@@ -500,6 +510,21 @@ namespace gpstk
       { extraBiases = extra; return (*this); };
 
 
+         /// Returns a pointer to the epoch context being used.
+      virtual EpochContext* getEpochContext(void) const
+      { return pContext; };
+
+
+         /** Sets the epoch context to be shared with other stages. When it
+          *  is set, the tide displacement of each epoch is taken from it,
+          *  instead of the extra biases.
+          *
+          * @param context    EpochContext object to be used.
+          */
+      virtual CorrectObservables& setEpochContext(EpochContext& context)
+      { pContext = &context; return (*this); };
+
+
          /// Returns the antenna object being used.
       virtual Antenna getAntenna(void) const
       { return antenna; };
@@ -542,6 +567,10 @@ namespace gpstk
       XvtStore<SatID> *pEphemeris;
 
 
+         /// Epoch context providing the tide displacement, if any.
+      EpochContext *pContext;
+
+
          /// Receiver position.
       Position nominalPos;
 
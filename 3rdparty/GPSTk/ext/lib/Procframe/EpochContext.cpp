@@ -0,0 +1,194 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file EpochContext.cpp
+ * This class holds the quantities that depend only on the epoch (and on
+ * the station), so that the processing stages of an epoch may share them.
+ */
+
+#include "EpochContext.hpp"
+#include "EphTime.hpp"
+
+
+namespace gpstk
+{
+
+      /* Returns the earth orientation parameters at the given epoch.
+       *
+       * @param t          Epoch of interest.
+       */
+   const EarthOrientation& EpochContext::getEarthOrientation(
+                                                      const CommonTime& t )
+      throw(InvalidRequest)
+   {
+
+      if( validEOP && eopEpoch == t )
+      {
+         return eop;
+      }
+
+      if( pEOPStore == NULL )
+      {
+         InvalidRequest e("EpochContext: EOPStore object was not set");
+         GPSTK_THROW(e);
+      }
+
+      try
+      {
+
+            // The store is indexed by MJD(UTC)
+         EphTime ttag(t);
+         ttag.convertSystemTo(TimeSystem::UTC);
+
+         eop = pEOPStore->getEOP(ttag.dMJD(), iersConvention);
+
+      }
+      catch(InvalidRequest& e)
+      {
+         validEOP = false;
+         GPSTK_RETHROW(e);
+      }
+      catch(Exception& e)
+      {
+         validEOP = false;
+         InvalidRequest ir(e);
+         GPSTK_THROW(ir);
+      }
+
+      eopEpoch = t;
+      validEOP = true;
+
+      return eop;
+
+   }  // End of method 'EpochContext::getEarthOrientation()'
+
+
+
+      /* Returns the tide displacement of the station at the given epoch,
+       * in meters and in the Up-East-North (UEN) reference frame.
+       *
+       * @param t          Epoch of interest.
+       */
+   const Triple& EpochContext::getTideDisplacement(const CommonTime& t)
+      throw(InvalidRequest)
+   {
+
+      if( validTides && tidesEpoch == t )
+      {
+         return tides;
+      }
+
+      validTides = false;
+
+      try
+      {
+
+         Triple sum(0.0, 0.0, 0.0);
+
+         if( useSolidTides )
+         {
+            sum = sum + solid.getSolidTide(t, nominalPos);
+         }
+
+         if( pOceanLoading != NULL )
+         {
+            sum = sum + pOceanLoading->getOceanLoading(stationName, t);
+         }
+
+         if( pEOPStore != NULL )
+         {
+            const EarthOrientation& eo( getEarthOrientation(t) );
+            sum = sum + pole.getPoleTide(t, nominalPos, eo.xp, eo.yp);
+         }
+
+         tides = sum;
+
+      }
+      catch(InvalidRequest& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+
+      tidesEpoch = t;
+      validTides = true;
+
+      return tides;
+
+   }  // End of method 'EpochContext::getTideDisplacement()'
+
+
+
+      /* Returns the IONEX maps and interpolation weights at the given
+       * epoch, to be used with IonexStore::getIonexValue().
+       *
+       * @param t          Epoch of interest.
+       */
+   const IonexStore::EpochMaps& EpochContext::getIonexMaps(
+                                                      const CommonTime& t )
+      throw(InvalidRequest)
+   {
+
+      if( validMaps && maps.epoch == t )
+      {
+         return maps;
+      }
+
+      validMaps = false;
+
+      if( pIonexStore == NULL )
+      {
+         InvalidRequest e("EpochContext: IonexStore object was not set");
+         GPSTK_THROW(e);
+      }
+
+      try
+      {
+         maps = pIonexStore->findMaps(t, ionexStrategy);
+      }
+      catch(InvalidRequest& e)
+      {
+         GPSTK_RETHROW(e);
+      }
+
+      validMaps = true;
+
+      return maps;
+
+   }  // End of method 'EpochContext::getIonexMaps()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,335 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file EpochContext.hpp
+ * This class holds the quantities that depend only on the epoch (and on
+ * the station), so that the processing stages of an epoch may share them.
+ */
+
+#ifndef GPSTK_EPOCHCONTEXT_HPP
+#define GPSTK_EPOCHCONTEXT_HPP
+
+#include <string>
+
+#include "CommonTime.hpp"
+#include "Position.hpp"
+#include "Triple.hpp"
+#include "IonexStore.hpp"
+#include "EOPStore.hpp"
+#include "EarthOrientation.hpp"
+#include "SolidTides.hpp"
+#include "OceanLoading.hpp"
+#include "PoleTides.hpp"
+
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions 
+      //@{
+
+
+      /** This class holds the quantities that depend only on the epoch
+       *  and on the station: earth orientation parameters, tide
+       *  displacement of the station, and the IONEX maps and interpolation
+       *  weights of the epoch.
+       *
+       * Each quantity is computed the first time it is asked for at a given
+       * epoch, and the stored value is returned until the epoch changes.
+       * Processing stages given the same object with their
+       * setEpochContext() method thus compute them once per epoch, instead
+       * of once per stage or per satellite.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *   IonexStore ionexStore;
+       *   ionexStore.loadFile("codg1050.08i");
+       *
+       *   OceanLoading ocean("OCEAN-GOT00.dat");
+       *
+       *   EpochContext context(nominalPos, "ONSA");
+       *   context.setIonexStore(ionexStore)
+       *          .setOceanLoading(ocean);
+       *
+       *   IonexModel ionex(nominalPos, ionexStore);
+       *   ionex.setEpochContext(context);
+       *
+       *   CorrectObservables corr(SP3EphList);
+       *   corr.setNominalPosition(nominalPos);
+       *   corr.setEpochContext(context);
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin >> ... >> ionex >> corr >> ...;
+       *   }
+       * @endcode
+       *
+       * The IONEX maps refer to data held in the IonexStore object. If data
+       * is added to the stores, or a source is changed through the
+       * object itself, call reset() so that nothing stale is used.
+       *
+       * @sa IonexStore, EOPStore, SolidTides, OceanLoading, PoleTides
+       */
+   class EpochContext
+   {
+   public:
+
+         /// Default constructor.
+      EpochContext()
+         : pIonexStore(NULL), ionexStrategy(3), pEOPStore(NULL),
+           iersConvention(IERSConvention::IERS2010), pOceanLoading(NULL),
+           useSolidTides(true), validEOP(false), validTides(false),
+           validMaps(false)
+      { };
+
+
+         /** Common constructor
+          *
+          * @param stapos     Nominal position of the station.
+          * @param name       Name of the station, as in the BLQ file of
+          *                   the ocean loading model.
+          */
+      EpochContext( const Position& stapos,
+                    const std::string& name = "" )
+         : nominalPos(stapos), stationName(name), pIonexStore(NULL),
+           ionexStrategy(3), pEOPStore(NULL),
+           iersConvention(IERSConvention::IERS2010), pOceanLoading(NULL),
+           useSolidTides(true), validEOP(false), validTides(false),
+           validMaps(false)
+      { };
+
+
+         /** Returns the earth orientation parameters at the given epoch.
+          *
+          * @param t          Epoch of interest.
+          *
+          * @throw InvalidRequest If no EOPStore object was set, or if the
+          *                   store can not provide the parameters.
+          */
+      virtual const EarthOrientation& getEarthOrientation(const CommonTime& t)
+         throw(InvalidRequest);
+
+
+         /** Returns the tide displacement of the station at the given
+          *  epoch, in meters and in the Up-East-North (UEN) reference frame.
+          *
+          * This is the sum of the solid tides (unless disabled), the ocean
+          * loading (if an OceanLoading object was set) and the pole tides
+          * (if an EOPStore object was set).
+          *
+          * @param t          Epoch of interest.
+          *
+          * @throw InvalidRequest If any of the models can not be computed.
+          */
+      virtual const Triple& getTideDisplacement(const CommonTime& t)
+         throw(InvalidRequest);
+
+
+         /** Returns the IONEX maps and interpolation weights at the given
+          *  epoch, to be used with IonexStore::getIonexValue().
+          *
+          * @param t          Epoch of interest.
+          *
+          * @throw InvalidRequest If no IonexStore object was set, or if
+          *                   it has no maps for this epoch.
+          */
+      virtual const IonexStore::EpochMaps& getIonexMaps(const CommonTime& t)
+         throw(InvalidRequest);
+
+
+         /// Forgets every stored value, so that all are computed again.
+      virtual EpochContext& reset(void)
+      { validEOP = validTides = validMaps = false; return (*this); };
+
+
+         /// Returns the nominal position of the station.
+      virtual Position getNominalPosition(void) const
+      { return nominalPos; };
+
+
+         /** Sets the nominal position of the station.
+          *
+          * @param stapos     Nominal position of the station.
+          */
+      virtual EpochContext& setNominalPosition(const Position& stapos)
+      { nominalPos = stapos; validTides = false; return (*this); };
+
+
+         /// Returns the name of the station.
+      virtual std::string getStationName(void) const
+      { return stationName; };
+
+
+         /** Sets the name of the station, as in the BLQ file of the ocean
+          *  loading model.
+          *
+          * @param name       Name of the station.
+          */
+      virtual EpochContext& setStationName(const std::string& name)
+      { stationName = name; validTides = false; return (*this); };
+
+
+         /// Returns a pointer to the IonexStore object being used.
+      virtual IonexStore* getIonexStore(void) const
+      { return pIonexStore; };
+
+
+         /** Sets the IonexStore object to be used.
+          *
+          * @param istore     IonexStore object holding the maps.
+          * @param strategy   Interpolation strategy, as in
+          *                   IonexStore::getIonexValue().
+          */
+      virtual EpochContext& setIonexStore( IonexStore& istore,
+                                           int strategy = 3 )
+      {
+         pIonexStore = &istore;
+         ionexStrategy = strategy;
+         validMaps = false;
+         return (*this);
+      };
+
+
+         /// Returns a pointer to the EOPStore object being used.
+      virtual EOPStore* getEOPStore(void) const
+      { return pEOPStore; };
+
+
+         /** Sets the EOPStore object to be used. The earth orientation
+          *  parameters are also used to compute the pole tides.
+          *
+          * @param eopstore   EOPStore object holding the parameters.
+          * @param conv       IERS convention to be used.
+          */
+      virtual EpochContext& setEOPStore( EOPStore& eopstore,
+                                         const IERSConvention& conv =
+                                                   IERSConvention::IERS2010 )
+      {
+         pEOPStore = &eopstore;
+         iersConvention = conv;
+         validEOP = validTides = false;
+         return (*this);
+      };
+
+
+         /// Returns a pointer to the OceanLoading object being used.
+      virtual OceanLoading* getOceanLoading(void) const
+      { return pOceanLoading; };
+
+
+         /** Sets the OceanLoading object to be used. Ocean loading is
+          *  computed for the station name given.
+          *
+          * @param ocean      OceanLoading object to be used.
+          */
+      virtual EpochContext& setOceanLoading(OceanLoading& ocean)
+      { pOceanLoading = &ocean; validTides = false; return (*this); };
+
+
+         /// Returns whether solid tides are part of the tide displacement.
+      virtual bool getUseSolidTides(void) const
+      { return useSolidTides; };
+
+
+         /** Sets whether solid tides are part of the tide displacement.
+          *
+          * @param use        True to include the solid tides.
+          */
+      virtual EpochContext& setUseSolidTides(bool use)
+      { useSolidTides = use; validTides = false; return (*this); };
+
+
+         /// Destructor.
+      virtual ~EpochContext() {};
+
+
+   private:
+
+
+         /// Nominal position of the station.
+      Position nominalPos;
+
+
+         /// Name of the station.
+      std::string stationName;
+
+
+         /// Pointer to the IONEX maps, and interpolation strategy.
+      IonexStore* pIonexStore;
+      int ionexStrategy;
+
+
+         /// Pointer to the earth orientation parameters, and convention.
+      EOPStore* pEOPStore;
+      IERSConvention iersConvention;
+
+
+         /// Pointer to the ocean loading model.
+      OceanLoading* pOceanLoading;
+
+
+         /// Whether solid tides are computed.
+      bool useSolidTides;
+
+
+         /// Tide models.
+      SolidTides solid;
+      PoleTides pole;
+
+
+         /// Stored values, their epochs, and whether they hold.
+      EarthOrientation eop;
+      CommonTime eopEpoch;
+      bool validEOP;
+
+      Triple tides;
+      CommonTime tidesEpoch;
+      bool validTides;
+
+      IonexStore::EpochMaps maps;
+      bool validMaps;
+
+
+   }; // End of class 'EpochContext'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_EPOCHCONTEXT_HPP
@@ -0,0 +1,495 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file GDSDiskBuffer.cpp
+ * Class to spill a sequence of GNSS Data Structures to a binary file and
+ * stream it back in reverse order.
+ */
+
+#include "GDSDiskBuffer.hpp"
+#include <cstdio>
+#include <cstring>
+
+
+namespace gpstk
+{
+
+   namespace
+   {
+
+         // Appends the raw bytes of a value to a string
+      template <class T>
+      inline void putValue(std::string& buf, const T& value)
+      { buf.append( reinterpret_cast<const char*>(&value), sizeof(T) ); }
+
+
+         // Appends a length-prefixed string
+      inline void putString(std::string& buf, const std::string& s)
+      {
+         putValue( buf, static_cast<unsigned short>(s.size()) );
+         buf.append(s);
+      }
+
+
+         // Extracts a value from 'buf' at 'pos', advancing 'pos'
+      template <class T>
+      inline void getValue( const std::string& buf,
+                            size_t& pos,
+                            T& value )
+         throw(InvalidRequest)
+      {
+         if( pos + sizeof(T) > buf.size() )
+         {
+            GPSTK_THROW( InvalidRequest("GDSDiskBuffer: corrupted block") );
+         }
+
+         std::memcpy( &value, buf.data() + pos, sizeof(T) );
+         pos += sizeof(T);
+      }
+
+
+         // Extracts a length-prefixed string
+      inline void getString( const std::string& buf,
+                             size_t& pos,
+                             std::string& s )
+         throw(InvalidRequest)
+      {
+         unsigned short n(0);
+         getValue(buf, pos, n);
+
+         if( pos + n > buf.size() )
+         {
+            GPSTK_THROW( InvalidRequest("GDSDiskBuffer: corrupted block") );
+         }
+
+         s.assign( buf, pos, n );
+         pos += n;
+      }
+
+   }  // End of anonymous namespace
+
+
+
+      /* Common constructor.
+       *
+       * @param fileName      Name of the scratch file to be used.
+       * @param blockEpochs   Number of epochs per block.
+       */
+   GDSDiskBuffer::GDSDiskBuffer( const std::string& fileName,
+                                 int blockEpochs )
+      throw(FileMissingException)
+      : fileName(fileName), blockEpochs(blockEpochs)
+   {
+
+         // At least one epoch per block
+      if( this->blockEpochs < 1 )
+      {
+         this->blockEpochs = 1;
+      }
+
+      clear();
+
+   }  // End of constructor 'GDSDiskBuffer::GDSDiskBuffer()'
+
+
+
+      // Destructor. It removes the scratch file.
+   GDSDiskBuffer::~GDSDiskBuffer()
+   {
+
+      file.close();
+      std::remove( fileName.c_str() );
+
+   }  // End of destructor 'GDSDiskBuffer::~GDSDiskBuffer()'
+
+
+
+      // Discards all stored epochs and truncates the scratch file.
+   GDSDiskBuffer& GDSDiskBuffer::clear(void)
+      throw(FileMissingException)
+   {
+
+      if( file.is_open() )
+      {
+         file.close();
+      }
+
+      file.clear();
+      file.open( fileName.c_str(), std::ios::in  | std::ios::out |
+                                   std::ios::binary | std::ios::trunc );
+
+      if( !file )
+      {
+         FileMissingException e( "GDSDiskBuffer: unable to open '"
+                                 + fileName + "'" );
+         GPSTK_THROW(e);
+      }
+
+      block.clear();
+      blockCount = 0;
+      numEpochs = 0;
+      fileSize = 0;
+      readPos = 0;
+      reading = false;
+      decoded.clear();
+
+      return (*this);
+
+   }  // End of method 'GDSDiskBuffer::clear()'
+
+
+
+      /* Appends a new epoch to the buffer.
+       *
+       * @param gData     Data object holding the data.
+       */
+   GDSDiskBuffer& GDSDiskBuffer::write(const gnssRinex& gData)
+      throw(InvalidRequest)
+   {
+
+      if( reading )
+      {
+         InvalidRequest e( "GDSDiskBuffer: buffer is in reading mode, "
+                           "call 'clear()' first" );
+         GPSTK_THROW(e);
+      }
+
+      encodeEpoch(gData, block);
+      ++blockCount;
+      ++numEpochs;
+
+      if( blockCount >= static_cast<unsigned int>(blockEpochs) )
+      {
+         flushBlock();
+      }
+
+      return (*this);
+
+   }  // End of method 'GDSDiskBuffer::write()'
+
+
+
+      /* Flushes the pending block to disk and prepares the buffer to be
+       * read backwards.
+       */
+   GDSDiskBuffer& GDSDiskBuffer::finish(void)
+      throw(InvalidRequest)
+   {
+
+      if( !reading )
+      {
+         flushBlock();
+         file.flush();
+
+         readPos = fileSize;
+         reading = true;
+      }
+
+      return (*this);
+
+   }  // End of method 'GDSDiskBuffer::finish()'
+
+
+
+      /* Extracts the newest epoch not yet read.
+       *
+       * @param gData     Data object that will hold the epoch.
+       *
+       * @return FALSE when all data have been read, TRUE otherwise.
+       */
+   bool GDSDiskBuffer::readBackward(gnssRinex& gData)
+      throw(InvalidRequest)
+   {
+
+      finish();
+
+         // Load the previous block when the current one is exhausted
+      if( decoded.empty() )
+      {
+
+         if( readPos <= 0 )
+         {
+            return false;
+         }
+
+         const std::streamoff word( sizeof(unsigned int) );
+
+            // The trailing word gives the size of the payload
+         unsigned int size(0);
+         file.seekg( readPos - word );
+         file.read( reinterpret_cast<char*>(&size), word );
+
+         std::streamoff start( readPos - 3*word - size );
+
+         unsigned int lead(0), nEpochs(0);
+         file.seekg( start );
+         file.read( reinterpret_cast<char*>(&lead), word );
+         file.read( reinterpret_cast<char*>(&nEpochs), word );
+
+         if( !file || start < 0 || lead != size )
+         {
+            GPSTK_THROW( InvalidRequest("GDSDiskBuffer: corrupted block") );
+         }
+
+         std::string payload( size, '\0' );
+         if( size > 0 )
+         {
+            file.read( &payload[0], size );
+         }
+
+         if( !file )
+         {
+            GPSTK_THROW( InvalidRequest("GDSDiskBuffer: read error") );
+         }
+
+         decodeBlock(payload, nEpochs, decoded);
+
+         readPos = start;
+
+         if( decoded.empty() )
+         {
+            return readBackward(gData);
+         }
+
+      }  // End of 'if( decoded.empty() )'
+
+      gData = decoded.back();
+      decoded.pop_back();
+
+      return true;
+
+   }  // End of method 'GDSDiskBuffer::readBackward()'
+
+
+
+      // Writes the pending block to disk.
+   void GDSDiskBuffer::flushBlock(void)
+      throw(InvalidRequest)
+   {
+
+      if( blockCount == 0 )
+      {
+         return;
+      }
+
+      unsigned int size( block.size() );
+
+      file.seekp( fileSize );
+      file.write( reinterpret_cast<const char*>(&size), sizeof(size) );
+      file.write( reinterpret_cast<const char*>(&blockCount),
+                  sizeof(blockCount) );
+      file.write( block.data(), size );
+      file.write( reinterpret_cast<const char*>(&size), sizeof(size) );
+
+      if( !file )
+      {
+         InvalidRequest e( "GDSDiskBuffer: unable to write to '"
+                           + fileName + "'" );
+         GPSTK_THROW(e);
+      }
+
+      fileSize += 3*sizeof(unsigned int) + size;
+
+      block.clear();
+      blockCount = 0;
+
+   }  // End of method 'GDSDiskBuffer::flushBlock()'
+
+
+
+      // Appends the encoded form of 'gData' to 'buf'.
+   void GDSDiskBuffer::encodeEpoch( const gnssRinex& gData,
+                                    std::string& buf )
+   {
+
+         // Header
+      long day, msod;
+      double fsod;
+      TimeSystem ts;
+      gData.header.epoch.getInternal(day, msod, fsod, ts);
+
+      putValue( buf, static_cast<int>(gData.header.source.type) );
+      putString( buf, gData.header.source.sourceName );
+      putValue( buf, static_cast<int>(day) );
+      putValue( buf, static_cast<int>(msod) );
+      putValue( buf, fsod );
+      putValue( buf, static_cast<int>(ts.getTimeSystem()) );
+      putString( buf, gData.header.antennaType );
+      putValue( buf, gData.header.antennaPosition[0] );
+      putValue( buf, gData.header.antennaPosition[1] );
+      putValue( buf, gData.header.antennaPosition[2] );
+      putValue( buf, gData.header.epochFlag );
+
+         // Table with the types present in this epoch
+      TypeIDSet types( gData.getTypeID() );
+      std::map<TypeID, unsigned short> typeIndex;
+
+      putValue( buf, static_cast<unsigned short>(types.size()) );
+
+      for( TypeIDSet::const_iterator itType = types.begin();
+           itType != types.end();
+           ++itType )
+      {
+         unsigned short index( typeIndex.size() );
+         typeIndex[ (*itType) ] = index;
+         putValue( buf, static_cast<int>((*itType).type) );
+      }
+
+         // Body
+      putValue( buf, static_cast<unsigned short>(gData.body.size()) );
+
+      for( satTypeValueMap::const_iterator itSat = gData.body.begin();
+           itSat != gData.body.end();
+           ++itSat )
+      {
+
+         putValue( buf, static_cast<short>((*itSat).first.system) );
+         putValue( buf, static_cast<short>((*itSat).first.id) );
+         putValue( buf, static_cast<unsigned short>((*itSat).second.size()) );
+
+         for( typeValueMap::const_iterator itData = (*itSat).second.begin();
+              itData != (*itSat).second.end();
+              ++itData )
+         {
+            putValue( buf, typeIndex[ (*itData).first ] );
+            putValue( buf, (*itData).second );
+         }
+
+      }  // End of 'for( satTypeValueMap::const_iterator itSat = ...'
+
+   }  // End of method 'GDSDiskBuffer::encodeEpoch()'
+
+
+
+      /* Rebuilds the epochs stored in a block payload, appending them to
+       * 'epochs' in the order they were written.
+       *
+       * @param payload     Block payload, without framing words.
+       * @param nEpochs     Number of epochs stored in the block.
+       * @param epochs      Vector where decoded epochs will be appended.
+       */
+   void GDSDiskBuffer::decodeBlock( const std::string& payload,
+                                    unsigned int nEpochs,
+                                    std::vector<gnssRinex>& epochs )
+      throw(InvalidRequest)
+   {
+
+      size_t pos(0);
+
+      epochs.reserve( epochs.size() + nEpochs );
+
+      for( unsigned int i = 0; i < nEpochs; ++i )
+      {
+
+         epochs.push_back( gnssRinex() );
+         gnssRinex& gData( epochs.back() );
+
+            // Header
+         int sourceType, day, msod, ts;
+         double fsod;
+
+         getValue( payload, pos, sourceType );
+         gData.header.source.type =
+                              static_cast<SourceID::SourceType>(sourceType);
+         getString( payload, pos, gData.header.source.sourceName );
+         getValue( payload, pos, day );
+         getValue( payload, pos, msod );
+         getValue( payload, pos, fsod );
+         getValue( payload, pos, ts );
+         gData.header.epoch.setInternal( day, msod, fsod, TimeSystem(ts) );
+         getString( payload, pos, gData.header.antennaType );
+
+         double x, y, z;
+         getValue( payload, pos, x );
+         getValue( payload, pos, y );
+         getValue( payload, pos, z );
+         gData.header.antennaPosition = Triple(x, y, z);
+         getValue( payload, pos, gData.header.epochFlag );
+
+            // Table with the types present in this epoch
+         unsigned short nTypes(0);
+         getValue( payload, pos, nTypes );
+
+         std::vector<TypeID> types( nTypes );
+         for( unsigned short j = 0; j < nTypes; ++j )
+         {
+            int type;
+            getValue( payload, pos, type );
+            types[j] = TypeID( static_cast<TypeID::ValueType>(type) );
+         }
+
+            // Body
+         unsigned short nSats(0);
+         getValue( payload, pos, nSats );
+
+         for( unsigned short j = 0; j < nSats; ++j )
+         {
+
+            short system, id;
+            unsigned short nValues;
+            getValue( payload, pos, system );
+            getValue( payload, pos, id );
+            getValue( payload, pos, nValues );
+
+            typeValueMap& tvMap( gData.body[ SatID( id,
+                              static_cast<SatID::SatelliteSystem>(system) ) ] );
+
+            for( unsigned short k = 0; k < nValues; ++k )
+            {
+               unsigned short index;
+               double value;
+               getValue( payload, pos, index );
+               getValue( payload, pos, value );
+
+               if( index >= nTypes )
+               {
+                  InvalidRequest e("GDSDiskBuffer: corrupted block");
+                  GPSTK_THROW(e);
+               }
+
+               tvMap[ types[index] ] = value;
+            }
+
+         }  // End of 'for( unsigned short j = 0; j < nSats; ++j )'
+
+      }  // End of 'for( unsigned int i = 0; i < nEpochs; ++i )'
+
+   }  // End of method 'GDSDiskBuffer::decodeBlock()'
+
+
+}  // End of namespace gpstk
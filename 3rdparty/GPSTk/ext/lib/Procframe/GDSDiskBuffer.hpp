@@ -0,0 +1,243 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/**
+ * @file GDSDiskBuffer.hpp
+ * Class to spill a sequence of GNSS Data Structures to a binary file and
+ * stream it back in reverse order.
+ */
+
+#ifndef GPSTK_GDSDISKBUFFER_HPP
+#define GPSTK_GDSDISKBUFFER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "DataStructures.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup DataStructures
+      //@{
+
+      /** This class stores a sequence of "gnssRinex" objects in a compact
+       *  binary file, keeping only a bounded number of epochs in memory, and
+       *  returns them in reverse order (last written, first read).
+       *
+       * It is meant to be used as the epoch buffer of forwards-backwards
+       * processors such as "SolverPPPFB", whose memory footprint would
+       * otherwise grow with the span of the data set.
+       *
+       * Epochs are grouped in blocks of a given number of epochs. Each block
+       * is framed as:
+       *
+       * @code
+       *   [payload size][number of epochs][payload][payload size]
+       * @endcode
+       *
+       * so the file may be walked backwards without an index, and every
+       * block carries everything needed to rebuild its epochs. Because of
+       * that, blocks may be decoded independently (see 'decodeBlock()').
+       *
+       * Inside a block, each epoch holds its header, the list of TypeID's
+       * present in that epoch and, per satellite, (type index, value) pairs.
+       *
+       * A typical cycle is:
+       *
+       * @code
+       *   GDSDiskBuffer buffer("ppp.buf");
+       *
+       *   while( ... )  buffer.write(gRin);   // Store
+       *
+       *   buffer.finish();                    // Flush last block
+       *
+       *   while( buffer.readBackward(gRin) )  // Newest epoch first
+       *   {
+       *      ...
+       *   }
+       * @endcode
+       *
+       * \warning The file uses the native byte order of the host and is
+       * intended as scratch storage only. It is removed when the object
+       * is destroyed.
+       */
+   class GDSDiskBuffer
+   {
+   public:
+
+         /** Common constructor.
+          *
+          * @param fileName      Name of the scratch file to be used.
+          * @param blockEpochs   Number of epochs per block.
+          */
+      GDSDiskBuffer( const std::string& fileName,
+                     int blockEpochs = 128 )
+         throw(FileMissingException);
+
+
+         /** Appends a new epoch to the buffer.
+          *
+          * @param gData     Data object holding the data.
+          */
+      virtual GDSDiskBuffer& write(const gnssRinex& gData)
+         throw(InvalidRequest);
+
+
+         /** Flushes the pending block to disk and prepares the buffer to be
+          *  read backwards. It may be safely called several times.
+          */
+      virtual GDSDiskBuffer& finish(void)
+         throw(InvalidRequest);
+
+
+         /** Extracts the newest epoch not yet read.
+          *
+          * @param gData     Data object that will hold the epoch.
+          *
+          * @return FALSE when all data have been read, TRUE otherwise.
+          */
+      virtual bool readBackward(gnssRinex& gData)
+         throw(InvalidRequest);
+
+
+         /// Discards all stored epochs and truncates the scratch file.
+      virtual GDSDiskBuffer& clear(void)
+         throw(FileMissingException);
+
+
+         /// Returns the number of epochs written since the last 'clear()'.
+      virtual size_t size(void) const
+      { return numEpochs; };
+
+
+         /// Returns the name of the scratch file.
+      virtual std::string getFileName(void) const
+      { return fileName; };
+
+
+         /// Returns the number of epochs per block.
+      virtual int getBlockEpochs(void) const
+      { return blockEpochs; };
+
+
+         /** Rebuilds the epochs stored in a block payload, appending them to
+          *  'epochs' in the order they were written.
+          *
+          * This method does not touch any object state, so different blocks
+          * may be decoded concurrently.
+          *
+          * @param payload     Block payload, without framing words.
+          * @param nEpochs     Number of epochs stored in the block.
+          * @param epochs      Vector where decoded epochs will be appended.
+          */
+      static void decodeBlock( const std::string& payload,
+                               unsigned int nEpochs,
+                               std::vector<gnssRinex>& epochs )
+         throw(InvalidRequest);
+
+
+         /// Destructor. It removes the scratch file.
+      virtual ~GDSDiskBuffer();
+
+
+   private:
+
+
+         /// Name of the scratch file.
+      std::string fileName;
+
+
+         /// Number of epochs per block.
+      int blockEpochs;
+
+
+         /// Scratch file stream.
+      std::fstream file;
+
+
+         /// Encoded epochs of the block being written.
+      std::string block;
+
+
+         /// Number of epochs in the block being written.
+      unsigned int blockCount;
+
+
+         /// Number of epochs written since the last 'clear()'.
+      size_t numEpochs;
+
+
+         /// Number of bytes written to disk.
+      std::streamoff fileSize;
+
+
+         /// Offset of the end of the data not yet read.
+      std::streamoff readPos;
+
+
+         /// Flag indicating that the buffer is in reading mode.
+      bool reading;
+
+
+         /// Epochs decoded from the current block, not yet returned.
+      std::vector<gnssRinex> decoded;
+
+
+         /// Writes the pending block to disk.
+      void flushBlock(void)
+         throw(InvalidRequest);
+
+
+         /// Appends the encoded form of 'gData' to 'buf'.
+      static void encodeEpoch( const gnssRinex& gData,
+                               std::string& buf );
+
+
+         // Scratch files must not be shared between objects
+      GDSDiskBuffer(const GDSDiskBuffer&);
+      GDSDiskBuffer& operator=(const GDSDiskBuffer&);
+
+
+   }; // End of class 'GDSDiskBuffer'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_GDSDISKBUFFER_HPP
@@ -61,6 +61,7 @@ namespace gpstk
    {
 
       pDefaultMaps = NULL;
+      pContext = NULL;
       defaultObservable = TypeID::P1;
       useDCB = true;
       setIonoMapType("NONE");
@@ -91,6 +92,7 @@ namespace gpstk
 
          setInitialRxPosition(RxCoordinates);
          setDefaultMaps(istore);
+         pContext = NULL;
          defaultObservable = dObservable;
          useDCB = applyDCB;
          setIonoMapType(ionoMap);
@@ -113,6 +115,10 @@ namespace gpstk
       time.setTimeSystem(TimeSystem::Any);
       SatIDSet satRejectedSet;
 
+         // The maps and weights of this epoch, found for the first satellite
+      IonexStore::EpochMaps localMaps;
+      const IonexStore::EpochMaps* pMaps(NULL);
+
       try
       {
 
@@ -168,7 +174,24 @@ namespace gpstk
                   // at current epoch
                Position pos(IPP);
                pos.transformTo(Position::Geocentric);
-               Triple val = pDefaultMaps->getIonexValue( time, pos );
+
+               if(pMaps == NULL)
+               {
+
+                  if( pContext != NULL &&
+                      pContext->getIonexStore() == pDefaultMaps )
+                  {
+                     pMaps = &pContext->getIonexMaps(time);
+                  }
+                  else
+                  {
+                     localMaps = pDefaultMaps->findMaps(time);
+                     pMaps = &localMaps;
+                  }
+
+               }
+
+               Triple val = pDefaultMaps->getIonexValue( *pMaps, pos );
 
                   // just to make it handy for useage
                double tecval = val[0];
@@ -46,6 +46,7 @@
 #define GPSTK_IONEXMODEL_HPP
 
 #include "IonexStore.hpp"
+#include "EpochContext.hpp"
 #include "Position.hpp"
 #include "ProcessingClass.hpp"
 #include "TypeID.hpp"
@@ -120,7 +121,7 @@ namespace gpstk
 
 
          /// Default constructor.
-      IonexModel() : pDefaultMaps(NULL), useDCB(true)
+      IonexModel() : pDefaultMaps(NULL), pContext(NULL), useDCB(true)
       { };
 
 
@@ -208,6 +209,21 @@ namespace gpstk
       { pDefaultMaps = &istore; return (*this); };
 
 
+         /// Method to get a pointer to the epoch context being used
+      virtual EpochContext* getEpochContext(void) const
+      { return pContext; };
+
+
+         /** Method to set the epoch context to be shared with other stages.
+          *  The IONEX maps of each epoch are taken from it when it uses the
+          *  same IonexStore object as this class.
+          *
+          * @param context     EpochContext object to be used.
+          */
+      virtual IonexModel& setEpochContext(EpochContext& context)
+      { pContext = &context; return (*this); };
+
+
          /// Method to get if DCB is being used
       virtual bool getUseDCB(void) const
       { return useDCB; };
@@ -286,6 +302,10 @@ namespace gpstk
       IonexStore* pDefaultMaps;
 
 
+         /// Pointer to the epoch context, if any.
+      EpochContext* pContext;
+
+
          /// Either estimated or "a priori" position of receiver
       Position rxPos;
 
@@ -41,6 +41,7 @@
  */
 
 #include "SolverPPPFB.hpp"
+#include <algorithm>
 
 
 namespace gpstk
@@ -57,7 +58,7 @@ namespace gpstk
        *                 if false (the default), will compute dx, dy, dz.
        */
    SolverPPPFB::SolverPPPFB(bool useNEU)
-      : firstIteration(true)
+      : firstIteration(true), pStore(NULL), pSpare(NULL)
    {
 
          // Initialize the counter of processed measurements
@@ -97,6 +98,40 @@ namespace gpstk
 
 
 
+      // Destructor.
+   SolverPPPFB::~SolverPPPFB()
+   {
+
+      delete pStore;
+      delete pSpare;
+
+   }  // End of destructor 'SolverPPPFB::~SolverPPPFB()'
+
+
+
+      /* Stores the epochs in scratch files instead of memory.
+       *
+       * @param fileName      Base name of the scratch files.
+       * @param blockEpochs   Number of epochs per block.
+       */
+   SolverPPPFB& SolverPPPFB::setBufferFile( const std::string& fileName,
+                                            int blockEpochs )
+      throw(FileMissingException)
+   {
+
+      delete pStore;
+      delete pSpare;
+      pStore = pSpare = NULL;
+
+      pStore = new GDSDiskBuffer( fileName + ".0", blockEpochs );
+      pSpare = new GDSDiskBuffer( fileName + ".1", blockEpochs );
+
+      return (*this);
+
+   }  // End of method 'SolverPPPFB::setBufferFile()'
+
+
+
       /* Returns a reference to a gnnsSatTypeValue object after
        * solving the previously defined equation system.
        *
@@ -160,7 +195,14 @@ namespace gpstk
             gnssRinex gBak(gData.extractTypeID(keepTypeSet));
 
                // Store observation data
-            ObsData.push_back(gBak);
+            if( isBuffered() )
+            {
+               pStore->write(gBak);
+            }
+            else
+            {
+               ObsData.push_back(gBak);
+            }
 
             // Update the number of processed measurements
             processedMeasurements += gData.numSats();
@@ -208,6 +250,24 @@ namespace gpstk
       try
       {
 
+         if( isBuffered() )
+         {
+
+               // Each pass reverses the order of the stored epochs, so we
+               // need one pass per direction: backwards first
+            diskPass( false, 0.0, 0.0 );
+
+            for (int i=0; i<(cycles-1); i++)
+            {
+               diskPass( false, 0.0, 0.0 );     // Forwards
+               diskPass( false, 0.0, 0.0 );     // Backwards
+            }
+
+            return;
+
+         }  // End of 'if( isBuffered() )'
+
+
          std::list<gnssRinex>::iterator pos;
          std::list<gnssRinex>::reverse_iterator rpos;
 
@@ -283,11 +343,18 @@ namespace gpstk
          std::list<gnssRinex>::reverse_iterator rpos;
 
             // Backwards iteration. We must do this at least once
-         for (rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
+         if( isBuffered() )
+         {
+            diskPass( false, 0.0, 0.0 );
+         }
+         else
          {
+            for (rpos = ObsData.rbegin(); rpos != ObsData.rend(); ++rpos)
+            {
 
-            SolverPPP::Process( (*rpos) );
+               SolverPPP::Process( (*rpos) );
 
+            }
          }
 
             // If both sizes are '0', let's return
@@ -324,6 +391,14 @@ namespace gpstk
             }
 
 
+               // Forwards and backwards iterations over scratch files
+            if( isBuffered() )
+            {
+               diskPass( true, codeLimit, phaseLimit );
+               diskPass( true, codeLimit, phaseLimit );
+               continue;
+            }
+
                // Forwards iteration
             for (pos = ObsData.begin(); pos != ObsData.end(); ++pos)
             {
@@ -422,8 +497,23 @@ namespace gpstk
       try
       {
 
-            // Keep processing while 'ObsData' is not empty
-         if( !(ObsData.empty()) )
+         bool available( false );
+
+         if( isBuffered() )
+         {
+
+               // After the last backwards pass the oldest epoch is at the
+               // end of the scratch file
+            gnssRinex gRin;
+
+            if( pStore->readBackward(gRin) )
+            {
+               gData = SolverPPP::Process( gRin );
+               available = true;
+            }
+
+         }
+         else if( !(ObsData.empty()) )
          {
 
                // Get the first data epoch in 'ObsData' and process it. The
@@ -434,6 +524,14 @@ namespace gpstk
                // memory and preparing for next epoch
             ObsData.pop_front();
 
+            available = true;
+
+         }
+
+            // Keep processing while there are data
+         if( available )
+         {
+
 
                // Update some inherited fields
             solution = SolverPPP::solution;
@@ -452,7 +550,7 @@ namespace gpstk
                // There are no more data
             return false;
 
-         }  // End of 'if( !(ObsData.empty()) )'
+         }  // End of 'if( available )'
 
       }
       catch(Exception& u)
@@ -510,6 +608,50 @@ namespace gpstk
 
 
 
+      /* This method does a pass over the epochs stored in scratch files.
+       *
+       * The epochs are read from the end of 'pStore', processed and written
+       * to 'pSpare', which then becomes the new store. Therefore, the
+       * direction of the pass alternates from one call to the next.
+       *
+       * The pass is serial: every epoch updates the filter state used by
+       * the next one, and every pass starts from the state left by the
+       * previous one.
+       */
+   void SolverPPPFB::diskPass( bool useLimits,
+                               double codeLimit,
+                               double phaseLimit )
+   {
+
+      pSpare->clear();
+
+      gnssRinex gRin;
+
+      while( pStore->readBackward(gRin) )
+      {
+
+         if( useLimits )
+         {
+            checkLimits( gRin, codeLimit, phaseLimit );
+         }
+
+         SolverPPP::Process( gRin );
+
+         pSpare->write( gRin );
+
+      }
+
+      pSpare->finish();
+
+         // The output of this pass is the input of the next one
+      std::swap( pStore, pSpare );
+
+      return;
+
+   }  // End of method 'SolverPPPFB::diskPass()'
+
+
+
       /* Sets if a NEU system will be used.
        *
        * @param useNEU  Boolean value indicating if a NEU system will
@@ -44,6 +44,7 @@
 #define GPSTK_SOLVERPPPFB_HPP
 
 #include "SolverPPP.hpp"
+#include "GDSDiskBuffer.hpp"
 #include <list>
 #include <set>
 
@@ -286,6 +287,21 @@ namespace gpstk
        *
        * @endcode
        *
+       * By default, the epochs are kept in memory, so the memory footprint
+       * grows with the span of the data set. For long data sets, the epochs
+       * may be spilled to a scratch file instead, calling "setBufferFile()"
+       * before the first "Process()" call:
+       *
+       * @code
+       *   SolverPPPFB pppSolver;
+       *   pppSolver.setBufferFile("ppp.buf");
+       * @endcode
+       *
+       * In this mode, every pass reads the epochs left by the previous pass
+       * from the end of a file while writing them to another one, so each
+       * file is always consumed in reverse order and only a block of epochs
+       * is held in memory at any time (see "GDSDiskBuffer.hpp").
+       *
        * \warning "SolverPPPFB" is based on a Kalman filter, and Kalman filters
        * are objets that store their internal state, so you MUST NOT use the
        * SAME object to process DIFFERENT data streams.
@@ -427,6 +443,26 @@ namespace gpstk
       { limitsPhaseList.clear(); return (*this); };
 
 
+         /** Stores the epochs in scratch files instead of memory.
+          *
+          * @param fileName      Base name of the scratch files. Two files,
+          *                      with suffixes ".0" and ".1", will be used.
+          * @param blockEpochs   Number of epochs per block, i.e., the
+          *                      maximum number of epochs held in memory.
+          *
+          * \warning This method must be called before the first call to
+          * 'Process()'.
+          */
+      virtual SolverPPPFB& setBufferFile( const std::string& fileName,
+                                          int blockEpochs = 128 )
+         throw(FileMissingException);
+
+
+         /// Returns TRUE if the epochs are stored in scratch files.
+      virtual bool isBuffered(void) const
+      { return (pStore != NULL); };
+
+
          /// Returns the number of processed measurements.
       virtual int getProcessedMeasurements(void) const
       { return processedMeasurements; };
@@ -452,7 +488,7 @@ namespace gpstk
 
 
          /// Destructor.
-      virtual ~SolverPPPFB() {};
+      virtual ~SolverPPPFB();
 
 
    private:
@@ -466,6 +502,14 @@ namespace gpstk
       std::list<gnssRinex> ObsData;
 
 
+         /// Scratch file holding the epochs, if "setBufferFile()" was called.
+      GDSDiskBuffer* pStore;
+
+
+         /// Scratch file receiving the epochs during a pass.
+      GDSDiskBuffer* pSpare;
+
+
          /// Set storing the TypeID's that we want to keep.
       TypeIDSet keepTypeSet;
 
@@ -490,6 +534,15 @@ namespace gpstk
       void checkLimits( gnssRinex& gData, double codeLimit, double phaseLimit );
 
 
+         /// This method does a pass over the epochs stored in scratch files.
+      void diskPass( bool useLimits, double codeLimit, double phaseLimit );
+
+
+         // Scratch files must not be shared between objects
+      SolverPPPFB(const SolverPPPFB&);
+      SolverPPPFB& operator=(const SolverPPPFB&);
+
+
          // Some methods that we want to hide
       virtual int Compute( const Vector<double>& prefitResiduals,
                            const Matrix<double>& designMatrix )
@@ -0,0 +1,754 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file SolverPPPSRIF.cpp
+ * Class to compute the PPP Solution using a square root information filter.
+ */
+
+#include "SolverPPPSRIF.hpp"
+#include "MatrixFunctors.hpp"
+
+
+namespace gpstk
+{
+
+      // Index initially assigned to this class
+   int SolverPPPSRIF::classIndex = 9310000;
+
+      // Returns an index identifying this object.
+   int SolverPPPSRIF::getIndex() const
+   { return index; }
+
+
+      // Returns a string identifying this object.
+   std::string SolverPPPSRIF::getClassName() const
+   { return "SolverPPPSRIF"; }
+
+
+      /* Common constructor.
+       *
+       * @param useNEU   If true, will compute dLat, dLon, dH coordinates;
+       *                 if false (the default), will compute dx, dy, dz.
+       */
+   SolverPPPSRIF::SolverPPPSRIF(bool useNEU)
+      : firstTime(true)
+   {
+
+         // Set the equation system structure
+      setNEU(useNEU);
+
+         // Call initializing method
+      Init();
+
+      setIndex();
+
+   }  // End of 'SolverPPPSRIF::SolverPPPSRIF()'
+
+
+
+      // Initializing method.
+   void SolverPPPSRIF::Init(void)
+   {
+
+         // Set qdot value for default random walk stochastic model
+      rwalkModel.setQprime(3e-8);
+
+         // Pointer to default stochastic model for troposphere (random walk)
+      pTropoStoModel = &rwalkModel;
+
+         // Set default coordinates stochastic model (constant)
+      setCoordinatesModel( &constantModel );
+
+      whitenoiseModelX.setSigma(100.0);
+      whitenoiseModelY.setSigma(100.0);
+      whitenoiseModelZ.setSigma(100.0);
+
+         // Pointer to default receiver clock stochastic model (white noise)
+      pClockStoModel = &whitenoiseModel;
+
+         // Pointer to stochastic model for phase biases
+      pBiasStoModel  = &biasModel;
+
+         // Set default factor that multiplies phase weights
+         // If code sigma is 1 m and phase sigma is 1 cm, the ratio is 100:1
+      weightFactor = 10000.0;       // 100^2
+
+   }  // End of method 'SolverPPPSRIF::Init()'
+
+
+
+      // Resets the filter, removing all the stored information.
+   SolverPPPSRIF& SolverPPPSRIF::Reset(void)
+   {
+
+      srif = SRIFilter();
+      firstTime = true;
+      valid = false;
+
+      return (*this);
+
+   }  // End of method 'SolverPPPSRIF::Reset()'
+
+
+
+      /* Compute a measurement update of the current SRI with the given
+       * equations set.
+       *
+       * @param prefitResiduals   Vector of prefit residuals
+       * @param designMatrix      Design matrix for the equation system
+       * @param weightVector      Vector of weights assigned to each
+       *                          satellite.
+       *
+       * @return
+       *  0 if OK
+       *  -1 if problems arose
+       */
+   int SolverPPPSRIF::Compute( const Vector<double>& prefitResiduals,
+                               const Matrix<double>& designMatrix,
+                               const Vector<double>& weightVector )
+      throw(InvalidSolver)
+   {
+
+         // By default, results are invalid
+      valid = false;
+
+      int wSize = static_cast<int>(weightVector.size());
+      int pSize = static_cast<int>(prefitResiduals.size());
+      if (!(wSize==pSize))
+      {
+         InvalidSolver e("prefitResiduals size does not match dimension \
+of weightVector");
+         GPSTK_THROW(e);
+      }
+
+      Matrix<double> wMatrix(wSize,wSize,0.0);  // Declare a weight matrix
+
+      for( int i=0; i<wSize; i++ )
+      {
+         wMatrix(i,i) = weightVector(i);
+      }
+
+      return SolverPPPSRIF::Compute( prefitResiduals,
+                                     designMatrix,
+                                     wMatrix );
+
+   }  // End of method 'SolverPPPSRIF::Compute()'
+
+
+
+      // Compute a measurement update of the current SRI with the given
+      // equations set.
+      //
+      // @param prefitResiduals   Vector of prefit residuals
+      // @param designMatrix      Design matrix for equation system
+      // @param weightMatrix      Matrix of weights
+      //
+      // @return
+      //  0 if OK
+      //  -1 if problems arose
+      //
+   int SolverPPPSRIF::Compute( const Vector<double>& prefitResiduals,
+                               const Matrix<double>& designMatrix,
+                               const Matrix<double>& weightMatrix )
+      throw(InvalidSolver)
+   {
+
+         // By default, results are invalid
+      valid = false;
+
+      if (!(weightMatrix.isSquare()))
+      {
+         InvalidSolver e("Weight matrix is not square");
+         GPSTK_THROW(e);
+      }
+
+      int wRow = static_cast<int>(weightMatrix.rows());
+      int pRow = static_cast<int>(prefitResiduals.size());
+      if (!(wRow==pRow))
+      {
+         InvalidSolver e("prefitResiduals size does not match dimension of \
+weightMatrix");
+         GPSTK_THROW(e);
+      }
+
+      int gRow = static_cast<int>(designMatrix.rows());
+      if (!(gRow==pRow))
+      {
+         InvalidSolver e("prefitResiduals size does not match dimension \
+of designMatrix");
+         GPSTK_THROW(e);
+      }
+
+      if ( designMatrix.cols() != srif.size() )
+      {
+         InvalidSolver e("designMatrix columns do not match dimension \
+of the SRI state");
+         GPSTK_THROW(e);
+      }
+
+      try
+      {
+
+            // The SRIF wants the measurement noise covariance matrix
+         Matrix<double> measNoiseMatrix( inverseChol(weightMatrix) );
+
+         Vector<double> data(prefitResiduals);
+         srif.measurementUpdate(designMatrix, data, measNoiseMatrix);
+
+         srif.getStateAndCovariance(solution, covMatrix);
+
+      }
+      catch(Exception& u)
+      {
+         InvalidSolver e("Compute(): " + u.getText());
+         GPSTK_THROW(e);
+      }
+
+         // Compute the postfit residuals Vector
+      postfitResiduals = prefitResiduals - (designMatrix * solution);
+
+      valid = true;
+
+      return 0;
+
+   }  // End of method 'SolverPPPSRIF::Compute()'
+
+
+
+      /* Returns a reference to a gnnsSatTypeValue object after
+       * solving the previously defined equation system.
+       *
+       * @param gData    Data object holding the data.
+       */
+   gnssSatTypeValue& SolverPPPSRIF::Process(gnssSatTypeValue& gData)
+      throw(ProcessingException)
+   {
+
+      try
+      {
+
+            // Build a gnssRinex object and fill it with data
+         gnssRinex g1;
+         g1.header = gData.header;
+         g1.body = gData.body;
+
+            // Call the Process() method with the appropriate input object
+         Process(g1);
+
+            // Update the original gnssSatTypeValue object with the results
+         gData.body = g1.body;
+
+         return gData;
+
+      }
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'SolverPPPSRIF::Process()'
+
+
+
+      /* Returns a reference to a gnnsRinex object after solving
+       * the previously defined equation system.
+       *
+       * @param gData     Data object holding the data.
+       */
+   gnssRinex& SolverPPPSRIF::Process(gnssRinex& gData)
+      throw(ProcessingException)
+   {
+
+      try
+      {
+
+            // By default, results are invalid
+         valid = false;
+
+            // Satellites currently in view. Unlike "SolverPPP", this is also
+            // the set of ambiguities being estimated
+         SatIDSet currSatSet( gData.body.getSatID() );
+         int numCurrentSV( static_cast<int>(gData.numSats()) );
+
+         numVar = defaultEqDef.body.size();
+
+            // Start the filter with the 'core' variables and their a priori
+            // values, the same used by "SolverPPP"
+         if(firstTime)
+         {
+
+            srif = SRIFilter(coreNames);
+
+            Matrix<double> initialErrorCovariance(numVar, numVar, 0.0);
+            initialErrorCovariance(0,0) = 0.25;          // (0.5 m)**2
+            for( int i=1; i<4; i++ )
+            {
+               initialErrorCovariance(i,i) = 10000.0;    // (100 m)**2
+            }
+            initialErrorCovariance(4,4) = 9.0e10;        // (300 km)**2
+
+            srif.addAPriori( initialErrorCovariance,
+                             Vector<double>(numVar, 0.0) );
+
+         }
+
+
+            // Drop ambiguities of satellites that left, append the new ones.
+            // New states carry no information at all until the a priori
+            // rows below are added.
+         std::set<int> newSet;
+         updateAmbiguityStates(currSatSet, newSet);
+
+         Namelist names( srif.getNames() );
+         int numUnknowns( static_cast<int>(names.size()) );
+
+
+            // Get the stochastic models for every state
+         Vector<double> phi(numUnknowns, 1.0);
+         Vector<double> q(numUnknowns, 0.0);
+
+         SatID dummySat;
+
+         pTropoStoModel->Prepare(dummySat, gData);
+         phi(0) = pTropoStoModel->getPhi();
+         q(0)   = pTropoStoModel->getQ();
+
+         pCoordXStoModel->Prepare(dummySat, gData);
+         phi(1) = pCoordXStoModel->getPhi();
+         q(1)   = pCoordXStoModel->getQ();
+
+         pCoordYStoModel->Prepare(dummySat, gData);
+         phi(2) = pCoordYStoModel->getPhi();
+         q(2)   = pCoordYStoModel->getQ();
+
+         pCoordZStoModel->Prepare(dummySat, gData);
+         phi(3) = pCoordZStoModel->getPhi();
+         q(3)   = pCoordZStoModel->getQ();
+
+         pClockStoModel->Prepare(dummySat, gData);
+         phi(4) = pClockStoModel->getPhi();
+         q(4)   = pClockStoModel->getQ();
+
+            // Index of each ambiguity in the SRI, in 'currSatSet' order
+         std::vector<int> ambIndex;
+         for( SatIDSet::const_iterator itSat = currSatSet.begin();
+              itSat != currSatSet.end();
+              ++itSat )
+         {
+
+            int j( names.index( ambiguityName(*itSat) ) );
+            ambIndex.push_back(j);
+
+               // The model must see every satellite, so it keeps track of
+               // the arcs even for satellites just added
+            pBiasStoModel->Prepare(*itSat, gData);
+            phi(j) = pBiasStoModel->getPhi();
+            q(j)   = pBiasStoModel->getQ();
+
+         }
+
+
+            // Time update. Only states with process noise are involved:
+            // phi == 0 is handled as an infinite process noise (the state
+            // information is removed) followed by an a priori value below.
+         std::vector<int> noisy;
+         std::map<int, double> aprioriSigma;
+         bool scaled(false);
+         for( int i=0; i<numUnknowns; i++ )
+         {
+
+            if( newSet.find(i) != newSet.end() )
+            {
+                  // New ambiguity: there is no information to propagate
+               aprioriSigma[i] = ( q(i) > 0.0 ) ? std::sqrt(q(i)) : 2.0e7;
+               continue;
+            }
+
+            if( phi(i) == 0.0 )
+            {
+               noisy.push_back(i);
+               if( q(i) > 0.0 )
+               {
+                  aprioriSigma[i] = std::sqrt(q(i));
+               }
+            }
+            else
+            {
+               if( q(i) > 0.0 ) noisy.push_back(i);
+               if( phi(i) != 1.0 ) scaled = true;
+            }
+
+         }  // End of 'for( int i=0; i<numUnknowns; i++ )'
+
+         if( !noisy.empty() )
+         {
+
+            int ns( static_cast<int>(noisy.size()) );
+
+            Matrix<double> phiInv(numUnknowns, numUnknowns, 0.0);
+            for( int i=0; i<numUnknowns; i++ )
+            {
+               phiInv(i,i) = ( phi(i) != 0.0 ) ? 1.0/phi(i) : 1.0;
+            }
+
+            Matrix<double> rw(ns, ns, 0.0);
+            Matrix<double> g(numUnknowns, ns, 0.0);
+            Vector<double> zw(ns, 0.0);
+            Matrix<double> rwx(ns, numUnknowns, 0.0);
+
+            for( int k=0; k<ns; k++ )
+            {
+               int i( noisy[k] );
+               g(i,k) = 1.0;
+               if( phi(i) != 0.0 )
+               {
+                  rw(k,k) = 1.0/std::sqrt(q(i));
+               }
+            }
+
+            srif.timeUpdate(phiInv, rw, g, zw, rwx);
+
+         }
+         else if(scaled)
+         {
+
+               // No process noise at all, only the deterministic part
+            Matrix<double> phiInv(numUnknowns, numUnknowns, 0.0);
+            for( int i=0; i<numUnknowns; i++ )
+            {
+               phiInv(i,i) = 1.0/phi(i);
+            }
+            srif.transformState(phiInv);
+
+         }  // End of 'if( !noisy.empty() )'
+
+
+            // Measurement update. The partials matrix is sparse: each phase
+            // row only involves the 'core' variables and one ambiguity. The
+            // a priori values of reset and new states are extra rows.
+         int numMeas( 2*numCurrentSV );
+         int numRows( numMeas + static_cast<int>(aprioriSigma.size()) );
+
+         SparseMatrix<double> hMatrix(numRows, numUnknowns);
+         Vector<double> measVector(numRows, 0.0);
+
+         Vector<double> prefitC(gData.getVectorOfTypeID(defaultEqDef.header));
+         Vector<double> prefitL(gData.getVectorOfTypeID(TypeID::prefitL));
+
+            // Generate the appropriate weights. Try to extract them from GDS
+         Vector<double> weightsVector(numCurrentSV, 1.0);
+         satTypeValueMap dummy(gData.body.extractTypeID(TypeID::weight));
+         if ( dummy.numSats() == (size_t)numCurrentSV )
+         {
+            weightsVector = gData.getVectorOfTypeID(TypeID::weight);
+         }
+
+         Matrix<double> dMatrix(gData.body.getMatrixOfTypes(defaultEqDef.body));
+
+         for( int i=0; i<numCurrentSV; i++ )
+         {
+
+               // Whiten code and phase equations
+            double sc( std::sqrt(weightsVector(i)) );
+            double sl( std::sqrt(weightsVector(i) * weightFactor) );
+
+            for( int j=0; j<numVar; j++ )
+            {
+               hMatrix( i               , j ) = dMatrix(i,j) * sc;
+               hMatrix( i + numCurrentSV, j ) = dMatrix(i,j) * sl;
+            }
+
+            hMatrix( i + numCurrentSV, ambIndex[i] ) = sl;
+
+            measVector( i                ) = prefitC(i) * sc;
+            measVector( i + numCurrentSV ) = prefitL(i) * sl;
+
+         }  // End of 'for( int i=0; i<numCurrentSV; i++ )'
+
+         int row( numMeas );
+         for( std::map<int, double>::const_iterator it = aprioriSigma.begin();
+              it != aprioriSigma.end();
+              ++it )
+         {
+            hMatrix( row, (*it).first ) = 1.0/(*it).second;
+            ++row;
+         }
+
+         srif.measurementUpdate(hMatrix, measVector);
+
+
+            // Get the state and covariance, and reorder them as "SolverPPP"
+            // does: 'core' variables first, then ambiguities
+         Vector<double> X;
+         Matrix<double> C;
+         srif.getStateAndCovariance(X, C);
+
+         std::vector<int> perm;
+         for( int j=0; j<numVar; j++ )
+         {
+            perm.push_back(j);
+         }
+         perm.insert(perm.end(), ambIndex.begin(), ambIndex.end());
+
+         solution.resize(numUnknowns, 0.0);
+         covMatrix.resize(numUnknowns, numUnknowns, 0.0);
+         for( int k=0; k<numUnknowns; k++ )
+         {
+            solution(k) = X(perm[k]);
+            for( int l=0; l<numUnknowns; l++ )
+            {
+               covMatrix(k,l) = C(perm[k], perm[l]);
+            }
+         }
+
+
+            // Compute the postfit residuals and add them to the GDS
+         Vector<double> postfitCode(numCurrentSV,0.0);
+         Vector<double> postfitPhase(numCurrentSV,0.0);
+         postfitResiduals.resize(numMeas, 0.0);
+         for( int i=0; i<numCurrentSV; i++ )
+         {
+
+            double model(0.0);
+            for( int j=0; j<numVar; j++ )
+            {
+               model += dMatrix(i,j) * X(j);
+            }
+
+            postfitCode(i)  = prefitC(i) - model;
+            postfitPhase(i) = prefitL(i) - model - X(ambIndex[i]);
+
+            postfitResiduals( i                ) = postfitCode(i);
+            postfitResiduals( i + numCurrentSV ) = postfitPhase(i);
+
+         }
+
+         gData.insertTypeIDVector(TypeID::postfitC, postfitCode);
+         gData.insertTypeIDVector(TypeID::postfitL, postfitPhase);
+
+         firstTime = false;
+         valid = true;
+
+         return gData;
+
+      }
+      catch(Exception& u)
+      {
+            // Throw an exception if something unexpected happens
+         ProcessingException e( getClassName() + ":"
+                                + u.what() );
+
+         GPSTK_THROW(e);
+
+      }
+
+   }  // End of method 'SolverPPPSRIF::Process()'
+
+
+
+      // Label of the ambiguity state belonging to a given satellite
+   std::string SolverPPPSRIF::ambiguityName(const SatID& sat)
+   {
+      return "BL:" + StringUtils::asString(sat);
+   }
+
+
+
+      /* Drop from the SRI the ambiguities of satellites not in view, and
+       * append states for the new ones.
+       *
+       * @param currSatSet    Satellites currently in view.
+       * @param newSet        On output, indexes of the states just added.
+       */
+   void SolverPPPSRIF::updateAmbiguityStates( const SatIDSet& currSatSet,
+                                              std::set<int>& newSet )
+   {
+
+      newSet.clear();
+
+      Namelist wanted;
+      for( SatIDSet::const_iterator itSat = currSatSet.begin();
+           itSat != currSatSet.end();
+           ++itSat )
+      {
+         wanted += ambiguityName(*itSat);
+      }
+
+         // Keep the current order; the 'core' variables always come first
+      Namelist current( srif.getNames() );
+      Namelist keep( coreNames );
+      for( unsigned int i=numVar; i<current.size(); i++ )
+      {
+         if( wanted.contains( current.getName(i) ) )
+         {
+            keep += current.getName(i);
+         }
+      }
+
+         // Marginalize out the ambiguities of the satellites that left
+      if( keep.size() < current.size() )
+      {
+         SRI dropped;
+         srif.split(keep, dropped);
+      }
+
+         // Append the new ones, with no information
+      Namelist added;
+      for( unsigned int i=0; i<wanted.size(); i++ )
+      {
+         if( !keep.contains( wanted.getName(i) ) )
+         {
+            added += wanted.getName(i);
+         }
+      }
+
+      if( added.size() > 0 )
+      {
+         srif += added;
+
+         for( unsigned int i=0; i<added.size(); i++ )
+         {
+            newSet.insert( keep.size() + i );
+         }
+      }
+
+      return;
+
+   }  // End of method 'SolverPPPSRIF::updateAmbiguityStates()'
+
+
+
+      /* Sets if a NEU system will be used.
+       *
+       * @param useNEU  Boolean value indicating if a NEU system will
+       *                be used
+       *
+       */
+   SolverPPPSRIF& SolverPPPSRIF::setNEU( bool useNEU )
+   {
+
+         // First, let's define a set with the typical code-based unknowns
+      TypeIDSet tempSet;
+         // Watch out here: 'tempSet' is a 'std::set', and all sets order their
+         // elements. According to 'TypeID' class, this is the proper order:
+      tempSet.insert(TypeID::wetMap);  // BEWARE: The first is wetMap!!!
+
+      if (useNEU)
+      {
+         tempSet.insert(TypeID::dLat); // #2
+         tempSet.insert(TypeID::dLon); // #3
+         tempSet.insert(TypeID::dH);   // #4
+      }
+      else
+      {
+         tempSet.insert(TypeID::dx);   // #2
+         tempSet.insert(TypeID::dy);   // #3
+         tempSet.insert(TypeID::dz);   // #4
+      }
+      tempSet.insert(TypeID::cdt);     // #5
+
+         // Now, we build the basic equation definition
+      defaultEqDef.header = TypeID::prefitC;
+      defaultEqDef.body = tempSet;
+
+         // The SRI labels follow the same order
+      coreNames.clear();
+      for( TypeIDSet::const_iterator it = tempSet.begin();
+           it != tempSet.end();
+           ++it )
+      {
+         coreNames += StringUtils::asString(*it);
+      }
+
+      numVar = tempSet.size();
+
+         // A different state means starting over
+      Reset();
+
+      return (*this);
+
+   }  // End of method 'SolverPPPSRIF::setNEU()'
+
+
+
+      // Set a single coordinates stochastic model to ALL coordinates.
+   SolverPPPSRIF& SolverPPPSRIF::setCoordinatesModel( StochasticModel* pModel )
+   {
+
+         // All coordinates will have the same model
+      pCoordXStoModel = pModel;
+      pCoordYStoModel = pModel;
+      pCoordZStoModel = pModel;
+
+      return (*this);
+
+   }  // End of method 'SolverPPPSRIF::setCoordinatesModel()'
+
+
+
+      // Set the positioning mode, kinematic or static.
+   SolverPPPSRIF& SolverPPPSRIF::setKinematic( bool kinematicMode,
+                                               double sigmaX,
+                                               double sigmaY,
+                                               double sigmaZ )
+   {
+      if(kinematicMode)
+      {
+         whitenoiseModelX.setSigma(sigmaX);
+         whitenoiseModelY.setSigma(sigmaY);
+         whitenoiseModelZ.setSigma(sigmaZ);
+
+         setXCoordinatesModel(&whitenoiseModelX);
+         setYCoordinatesModel(&whitenoiseModelY);
+         setZCoordinatesModel(&whitenoiseModelZ);
+      }
+      else
+      {
+         setCoordinatesModel(&constantModel);
+      }
+
+      return (*this);
+
+   }  // End of method 'SolverPPPSRIF::setKinematic()'
+
+
+}  // End of namespace gpstk
@@ -0,0 +1,441 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/**
+ * @file SolverPPPSRIF.hpp
+ * Class to compute the PPP Solution using a square root information filter.
+ */
+
+#ifndef GPSTK_SOLVERPPPSRIF_HPP
+#define GPSTK_SOLVERPPPSRIF_HPP
+
+#include "CodeKalmanSolver.hpp"
+#include "SRIFilter.hpp"
+
+
+namespace gpstk
+{
+
+      /// @ingroup GPSsolutions
+      //@{
+
+      /** This class computes the Precise Point Positioning (PPP) solution
+       *  using a square root information filter (SRIF) that combines
+       *  ionosphere-free code and phase measurements.
+       *
+       * It is a drop-in alternative to "SolverPPP": it expects the same
+       * input data, uses the same stochastic models and inserts the same
+       * postfit residuals back into the GNSS data structure. The difference
+       * is the estimation engine:
+       *
+       *    \li The filter state is kept as a square root information matrix
+       *        (class "SRIFilter"), so no covariance matrix is ever inverted
+       *        or propagated in its squared form.
+       *    \li Phase ambiguities are labelled states of the SRI. A new
+       *        ambiguity is appended when a satellite appears, and it is
+       *        reset when the satellite arc changes (see "SatArcMarker").
+       *        When a satellite is no longer in view its ambiguity is
+       *        marginalized out of the SRI with "SRI::split()".
+       *    \li Only the states with process noise (receiver clock, wet
+       *        troposphere, kinematic coordinates and reset ambiguities)
+       *        take part in the time update, and the measurement update is
+       *        done with a sparse partials matrix, because every phase
+       *        equation only involves the 'core' variables and one ambiguity.
+       *
+       * Therefore, the state dimension is always the number of 'core'
+       * variables plus the number of satellites currently in view, no matter
+       * how many satellites (or systems) have been processed before. There is
+       * no limit on the number of satellites, so multi-GNSS data may be
+       * processed as long as the prefit residuals share a common receiver
+       * clock.
+       *
+       * A typical way to use this class follows:
+       *
+       * @code
+       *      // Declare a SolverPPPSRIF object
+       *   SolverPPPSRIF pppSolver;
+       *
+       *   while(rin >> gRin)
+       *   {
+       *      gRin  >> basicM
+       *            >> correctObs
+       *            >> compWindup
+       *            >> computeTropo
+       *            >> linear1      // Compute combinations
+       *            >> pcFilter
+       *            >> markCSLI2
+       *            >> markCSMW
+       *            >> markArc
+       *            >> linear2      // Compute prefit residuals
+       *            >> phaseAlign
+       *            >> pppSolver;
+       *
+       *      cout << pppSolver.getSolution(TypeID::dx) << endl;
+       *   }
+       * @endcode
+       *
+       * After each epoch, the "solution" vector and the "covMatrix" are
+       * ordered as in "SolverPPP": first the 'core' variables (wetMap, dx,
+       * dy, dz, cdt), then one ambiguity per satellite currently in view,
+       * in the order of the satellites in the GDS.
+       *
+       * \warning "SolverPPPSRIF" stores its internal state, so you MUST NOT
+       * use the SAME object to process DIFFERENT data streams.
+       *
+       * @sa SolverPPP.hpp, SRIFilter.hpp and SatArcMarker.hpp.
+       *
+       */
+   class SolverPPPSRIF : public CodeKalmanSolver
+   {
+   public:
+
+         /** Common constructor.
+          *
+          * @param useNEU   If true, will compute dLat, dLon, dH coordinates;
+          *                 if false (the default), will compute dx, dy, dz.
+          */
+      SolverPPPSRIF(bool useNEU = false);
+
+
+         /** Compute a measurement update of the current SRI with the given
+          *  equations set.
+          *
+          * The design matrix must have as many columns as the current state
+          * (see "getNames()"). No time update is done by this method.
+          *
+          * @param prefitResiduals   Vector of prefit residuals
+          * @param designMatrix      Design matrix for the equation system
+          * @param weightMatrix      Matrix of weights
+          *
+          * @return
+          *  0 if OK
+          *  -1 if problems arose
+          */
+      virtual int Compute( const Vector<double>& prefitResiduals,
+                           const Matrix<double>& designMatrix,
+                           const Matrix<double>& weightMatrix )
+         throw(InvalidSolver);
+
+
+         /** Compute a measurement update of the current SRI with the given
+          *  equations set.
+          *
+          * @param prefitResiduals   Vector of prefit residuals
+          * @param designMatrix      Design matrix for the equation system
+          * @param weightVector      Vector of weights assigned to each
+          *                          satellite.
+          *
+          * @return
+          *  0 if OK
+          *  -1 if problems arose
+          */
+      virtual int Compute( const Vector<double>& prefitResiduals,
+                           const Matrix<double>& designMatrix,
+                           const Vector<double>& weightVector )
+         throw(InvalidSolver);
+
+
+         /** Returns a reference to a gnnsSatTypeValue object after
+          *  solving the previously defined equation system.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssSatTypeValue& Process(gnssSatTypeValue& gData)
+         throw(ProcessingException);
+
+
+         /** Returns a reference to a gnnsRinex object after solving
+          *  the previously defined equation system.
+          *
+          * @param gData    Data object holding the data.
+          */
+      virtual gnssRinex& Process(gnssRinex& gData)
+         throw(ProcessingException);
+
+
+         /** Resets the filter, removing all the stored information. Next
+          *  epoch will start again from the a priori values.
+          */
+      virtual SolverPPPSRIF& Reset(void);
+
+
+         /** Sets if a NEU system will be used.
+          *
+          * @param useNEU  Boolean value indicating if a NEU system will
+          *                be used
+          *
+          * \warning Calling this method resets the filter.
+          */
+      virtual SolverPPPSRIF& setNEU( bool useNEU );
+
+
+         /// Get the weight factor multiplying the phase measurements sigmas.
+      virtual double getWeightFactor(void) const
+      { return std::sqrt(weightFactor); };
+
+
+         /** Set the weight factor multiplying the phase measurement sigma
+          *
+          * @param factor      Factor multiplying the phase measurement sigma
+          *
+          * \warning This factor should be the code_sigma/phase_sigma ratio.
+          */
+      virtual SolverPPPSRIF& setWeightFactor(double factor)
+      { weightFactor = (factor*factor); return (*this); };
+
+
+         /// Get stochastic model pointer for dx (or dLat) coordinate
+      StochasticModel* getXCoordinatesModel() const
+      { return pCoordXStoModel; };
+
+
+         /// Set coordinates stochastic model for dx (or dLat) coordinate
+      SolverPPPSRIF& setXCoordinatesModel(StochasticModel* pModel)
+      { pCoordXStoModel = pModel; return (*this); };
+
+
+         /// Get stochastic model pointer for dy (or dLon) coordinate
+      StochasticModel* getYCoordinatesModel() const
+      { return pCoordYStoModel; };
+
+
+         /// Set coordinates stochastic model for dy (or dLon) coordinate
+      SolverPPPSRIF& setYCoordinatesModel(StochasticModel* pModel)
+      { pCoordYStoModel = pModel; return (*this); };
+
+
+         /// Get stochastic model pointer for dz (or dH) coordinate
+      StochasticModel* getZCoordinatesModel() const
+      { return pCoordZStoModel; };
+
+
+         /// Set coordinates stochastic model for dz (or dH) coordinate
+      SolverPPPSRIF& setZCoordinatesModel(StochasticModel* pModel)
+      { pCoordZStoModel = pModel; return (*this); };
+
+
+         /** Set a single coordinates stochastic model to ALL coordinates.
+          *
+          * @param pModel      Pointer to StochasticModel associated with
+          *                    coordinates.
+          *
+          * @warning Do NOT use this method to set the SAME state-aware
+          * stochastic model (like RandomWalkModel, for instance) to ALL
+          * coordinates.
+          */
+      virtual SolverPPPSRIF& setCoordinatesModel(StochasticModel* pModel);
+
+
+         /// Get wet troposphere stochastic model pointer
+      virtual StochasticModel* getTroposphereModel(void) const
+      { return pTropoStoModel; };
+
+
+         /// Set zenital wet troposphere stochastic model
+      virtual SolverPPPSRIF& setTroposphereModel(StochasticModel* pModel)
+      { pTropoStoModel = pModel; return (*this); };
+
+
+         /// Get receiver clock stochastic model pointer
+      virtual StochasticModel* getReceiverClockModel(void) const
+      { return pClockStoModel; };
+
+
+         /// Set receiver clock stochastic model
+      virtual SolverPPPSRIF& setReceiverClockModel(StochasticModel* pModel)
+      { pClockStoModel = pModel; return (*this); };
+
+
+         /// Get phase biases stochastic model pointer
+      virtual StochasticModel* getPhaseBiasesModel(void) const
+      { return pBiasStoModel; };
+
+
+         /** Set phase biases stochastic model.
+          *
+          * \warning Model must be of PhaseAmbiguityModel class (or behave
+          * like it) in order to make sense: phi == 0 means a new arc.
+          */
+      virtual SolverPPPSRIF& setPhaseBiasesModel(StochasticModel* pModel)
+      { pBiasStoModel = pModel; return (*this); };
+
+
+         /** Set the positioning mode, kinematic or static.
+          */
+      virtual SolverPPPSRIF& setKinematic( bool kinematicMode = true,
+                                           double sigmaX = 100.0,
+                                           double sigmaY = 100.0,
+                                           double sigmaZ = 100.0 );
+
+
+         /// Get the Namelist labelling the current SRI state.
+      virtual Namelist getNames(void)
+      { return srif.getNames(); };
+
+
+         /// Get the current square root information filter.
+      virtual const SRIFilter& getSRIFilter(void) const
+      { return srif; };
+
+
+         /// Returns an index identifying this object.
+      virtual int getIndex(void) const;
+
+
+         /// Returns a string identifying this object.
+      virtual std::string getClassName(void) const;
+
+
+         /// Destructor.
+      virtual ~SolverPPPSRIF() {};
+
+
+   private:
+
+
+         /// Number of 'core' variables
+      int numVar;
+
+
+         /// Weight factor for phase measurements
+      double weightFactor;
+
+
+         /// Pointer to stochastic model for dx (or dLat) coordinate
+      StochasticModel* pCoordXStoModel;
+
+
+         /// Pointer to stochastic model for dy (or dLon) coordinate
+      StochasticModel* pCoordYStoModel;
+
+
+         /// Pointer to stochastic model for dz (or dH) coordinate
+      StochasticModel* pCoordZStoModel;
+
+
+         /// Pointer to stochastic model for troposphere
+      StochasticModel* pTropoStoModel;
+
+
+         /// Pointer to stochastic model for receiver clock
+      StochasticModel* pClockStoModel;
+
+
+         /// Pointer to stochastic model for phase biases
+      StochasticModel* pBiasStoModel;
+
+
+         /// Boolean indicating if this filter was run at least once
+      bool firstTime;
+
+
+         /// Square root information filter holding the state
+      SRIFilter srif;
+
+
+         /// Names of the 'core' variables, in 'defaultEqDef.body' order
+      Namelist coreNames;
+
+
+         /// Initializing method.
+      void Init(void);
+
+
+         /// Label of the ambiguity state belonging to a given satellite
+      static std::string ambiguityName(const SatID& sat);
+
+
+         /** Drop from the SRI the ambiguities of satellites not in view, and
+          *  append states for the new ones.
+          *
+          * @param currSatSet    Satellites currently in view.
+          * @param resetSet      On output, states needing a priori
+          *                      information because they were just added.
+          */
+      void updateAmbiguityStates( const SatIDSet& currSatSet,
+                                  std::set<int>& resetSet );
+
+
+         /// Constant stochastic model
+      StochasticModel constantModel;
+
+         /// White noise stochastic model for position
+      WhiteNoiseModel whitenoiseModelX;
+      WhiteNoiseModel whitenoiseModelY;
+      WhiteNoiseModel whitenoiseModelZ;
+
+
+         /// Random Walk stochastic model
+      RandomWalkModel rwalkModel;
+
+
+         /// White noise stochastic model
+      WhiteNoiseModel whitenoiseModel;
+
+
+         /// Phase biases stochastic model (constant + white noise)
+      PhaseAmbiguityModel biasModel;
+
+
+         /// Initial index assigned to this class.
+      static int classIndex;
+
+         /// Index belonging to this object.
+      int index;
+
+         /// Sets the index and increment classIndex.
+      void setIndex(void)
+      { index = classIndex++; };
+
+
+      virtual int Compute( const Vector<double>& prefitResiduals,
+                           const Matrix<double>& designMatrix )
+         throw(InvalidSolver)
+      { return 0; };
+
+
+      virtual SolverPPPSRIF& setDefaultEqDefinition(
+         const gnssEquationDefinition& eqDef )
+      { return (*this); };
+
+
+   }; // End of class 'SolverPPPSRIF'
+
+      //@}
+
+}  // End of namespace gpstk
+
+#endif   // GPSTK_SOLVERPPPSRIF_HPP
@@ -0,0 +1,579 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file EpochContext_T.cpp Test of the IONEX map search of IonexStore, and
+/// of IonexModel and CorrectObservables sharing an EpochContext.
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "IonexStore.hpp"
+#include "EpochContext.hpp"
+#include "IonexModel.hpp"
+#include "CorrectObservables.hpp"
+#include "BasicModel.hpp"
+#include "RinexObsStream.hpp"
+#include "RinexEphemerisStore.hpp"
+#include "DataStructures.hpp"
+#include "SolidTides.hpp"
+#include "CivilTime.hpp"
+#include "WGS84Ellipsoid.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+
+   /// EpochContext that counts the requests it receives
+class CountingContext : public EpochContext
+{
+public:
+   CountingContext(const Position& stapos)
+      : EpochContext(stapos), mapRequests(0), tideRequests(0)
+   { };
+
+   virtual const IonexStore::EpochMaps& getIonexMaps(const CommonTime& t)
+      throw(InvalidRequest)
+   { mapRequests++; return EpochContext::getIonexMaps(t); };
+
+   virtual const Triple& getTideDisplacement(const CommonTime& t)
+      throw(InvalidRequest)
+   { tideRequests++; return EpochContext::getTideDisplacement(t); };
+
+   int mapRequests;
+   int tideRequests;
+};
+
+
+class EpochContext_T
+{
+public:
+   EpochContext_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string file_sep = "/";
+
+      inputObs = dataFilePath + file_sep + "arlm200a.15o";
+      inputNav = dataFilePath + file_sep + "arlm200a.15n";
+
+         // Five TEC and RMS maps, every two hours from the first epoch of
+         // the observation file
+      t0 = CivilTime(2015, 7, 19, 0, 0, 0.0, TimeSystem::Any)
+              .convertToCommonTime();
+      numMaps = 5;
+      for (int k = 0; k < numMaps; k++)
+      {
+         IonexData tec(makeMap(k, IonexData::TEC));
+         IonexData rms(makeMap(k, IonexData::RMS));
+         store.addMap(tec);
+         store.addMap(rms);
+         tecMaps[tec.time] = tec;
+         rmsMaps[rms.time] = rms;
+      }
+   }
+
+//=============================================================================
+//    Check that the maps found once per epoch give the values of the search
+//    and interpolation getIonexValue() did before findMaps() was split out
+//=============================================================================
+   int findMapsTest(void)
+   {
+      TUDEF("IonexStore", "getIonexValue(EpochMaps)");
+
+      int compared(0);
+      for (int i = 0; i < 97; i++)
+      {
+            // Every 5 minutes up to the last map, plus odd seconds; this
+            // includes exact matches on all maps but the last one
+         CommonTime t(t0 + 300.0*i + ((i%3 == 0) ? 0.0 : 17.0*i));
+         if (t >= tecMaps.rbegin()->first)
+            break;
+
+         for (int strategy = 1; strategy <= 4; strategy++)
+         {
+            IonexStore::EpochMaps maps(store.findMaps(t, strategy));
+            TUASSERTE(int, strategy, maps.strategy);
+            TUASSERT(maps.epoch == t);
+
+            for (int j = 0; j < 7; j++)
+            {
+               Position pos(piercePoint(i + j));
+               Triple expected(oldIonexValue(t, pos, strategy));
+               Triple got(store.getIonexValue(maps, pos));
+               Triple old(store.getIonexValue(t, pos, strategy));
+               for (int k = 0; k < 3; k++)
+               {
+                  TUASSERTE(double, expected[k], got[k]);
+                  TUASSERTE(double, got[k], old[k]);
+               }
+               compared++;
+            }
+         }
+      }
+
+      TUASSERT(compared > 2000);
+
+      TURETURN();
+   }
+
+//=============================================================================
+//    An exact match on the last map uses that map and the one before it
+//=============================================================================
+   int lastMapTest(void)
+   {
+      TUDEF("IonexStore", "findMaps(last map)");
+
+      CommonTime last(tecMaps.rbegin()->first);
+      CommonTime previous((++tecMaps.rbegin())->first);
+      const IonexData& lastTEC(tecMaps.rbegin()->second);
+      const IonexData& lastRMS(rmsMaps.rbegin()->second);
+
+      for (int strategy = 1; strategy <= 4; strategy++)
+      {
+         IonexStore::EpochMaps maps(store.findMaps(last, strategy));
+         TUASSERTE(int, (strategy == 1 || strategy == 4) ? 1 : 2, maps.nmap);
+         if (maps.nmap == 2)
+         {
+            TUASSERT(maps.T[0] == previous);
+            TUASSERT(maps.T[1] == last);
+            TUASSERTE(double, 0.0, maps.f[0]);
+            TUASSERTE(double, 1.0, maps.f[1]);
+         }
+         else
+         {
+               // The nearest map is the last one
+            TUASSERT(maps.T[0] == last);
+            TUASSERTE(double, 1.0, maps.f[0]);
+         }
+
+         for (int j = 0; j < 7; j++)
+         {
+            Position pos(piercePoint(j));
+            Triple got(store.getIonexValue(maps, pos));
+            TUASSERTE(double, lastTEC.getValue(pos), got[0]);
+            TUASSERTE(double, lastRMS.getValue(pos), got[1]);
+            TUASSERTE(double, pos.theArray[2], got[2]);
+
+            Triple old(store.getIonexValue(last, pos, strategy));
+            TUASSERTE(double, got[0], old[0]);
+            TUASSERTE(double, got[1], old[1]);
+         }
+      }
+
+      TURETURN();
+   }
+
+//=============================================================================
+//    Requests the maps can not answer
+//=============================================================================
+   int invalidTest(void)
+   {
+      TUDEF("IonexStore", "findMaps(invalid)");
+
+      Position pos(piercePoint(0));
+
+         // Outside the span of the maps
+      TUCSM("findMaps(before first map)");
+      try { store.findMaps(t0 - 1.0); TUFAIL("No exception"); }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+      TUCSM("findMaps(after last map)");
+      try
+      {
+         store.findMaps(tecMaps.rbegin()->first + 1.0);
+         TUFAIL("No exception");
+      }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+      TUCSM("findMaps(strategy)");
+      try { store.findMaps(t0 + 600.0, 5); TUFAIL("No exception"); }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+         // A store needs two maps to interpolate, even at an exact match
+      IonexStore single;
+      single.addMap(makeMap(0, IonexData::TEC));
+      single.addMap(makeMap(0, IonexData::RMS));
+
+      for (int strategy = 1; strategy <= 4; strategy++)
+      {
+         TUCSM("findMaps(one map)");
+         try { single.findMaps(t0, strategy); TUFAIL("No exception"); }
+         catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+         TUCSM("getIonexValue(one map)");
+         try { single.getIonexValue(t0, pos, strategy); TUFAIL("No exception"); }
+         catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+      }
+
+      TUCSM("findMaps(no map)");
+      try { IonexStore().findMaps(t0); TUFAIL("No exception"); }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+         // The interpolation needs geocentric coordinates
+      TUCSM("getIonexValue(Cartesian)");
+      Position cartesian(pos);
+      cartesian.transformTo(Position::Cartesian);
+      try
+      {
+         store.getIonexValue(store.findMaps(t0 + 600.0), cartesian);
+         TUFAIL("No exception");
+      }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+      TURETURN();
+   }
+
+//=============================================================================
+//    EpochContext finds the maps once per epoch
+//=============================================================================
+   int contextMapsTest(void)
+   {
+      TUDEF("EpochContext", "getIonexMaps");
+
+      EpochContext context;
+
+      try { context.getIonexMaps(t0); TUFAIL("No exception"); }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+
+      context.setIonexStore(store, 2);
+      CommonTime t(t0 + 1234.0);
+      const IonexStore::EpochMaps& maps(context.getIonexMaps(t));
+      IonexStore::EpochMaps expected(store.findMaps(t, 2));
+
+      TUASSERT(maps.epoch == t);
+      TUASSERTE(int, 2, maps.strategy);
+      TUASSERTE(int, expected.nmap, maps.nmap);
+      for (int i = 0; i < 2; i++)
+      {
+         TUASSERT(maps.T[i] == expected.T[i]);
+         TUASSERTE(double, expected.f[i], maps.f[i]);
+         TUASSERT(maps.tec[i] == expected.tec[i]);
+         TUASSERT(maps.rms[i] == expected.rms[i]);
+      }
+
+         // The same epoch returns the stored maps, a new one finds them again
+      TUASSERT(&context.getIonexMaps(t) == &maps);
+      TUASSERT(context.getIonexMaps(t + 3000.0).epoch == t + 3000.0);
+      TUASSERT(context.reset().getIonexMaps(t).epoch == t);
+
+         // A failed search leaves nothing stale behind
+      try
+      {
+         context.getIonexMaps(tecMaps.rbegin()->first + 1.0);
+         TUFAIL("No exception");
+      }
+      catch (InvalidRequest& e) { TUPASS("InvalidRequest"); }
+      TUASSERT(context.getIonexMaps(t).epoch == t);
+
+      TURETURN();
+   }
+
+//=============================================================================
+//    IonexModel gives the same delays with and without an EpochContext, and
+//    with one it asks the context for the maps once per epoch
+//=============================================================================
+   int ionexModelTest(void)
+   {
+      TUDEF("IonexModel", "Process(EpochContext)");
+
+      RinexEphemerisStore ephStore;
+      ephStore.loadFile(inputNav);
+
+      RinexObsStream rin(inputObs.c_str());
+      RinexObsHeader roh;
+      rin >> roh;
+      Position nominalPos(roh.antennaPosition);
+
+      BasicModel basic(nominalPos, ephStore);
+      IonexModel alone(nominalPos, store, TypeID::P1, false, "SLM");
+      IonexModel shared(nominalPos, store, TypeID::P1, false, "SLM");
+      CountingContext context(nominalPos);
+      context.setIonexStore(store);
+      shared.setEpochContext(context);
+      TUASSERT(shared.getEpochContext() == &context);
+
+         // A context over another store is not used
+      IonexStore other;
+      CountingContext otherContext(nominalPos);
+      otherContext.setIonexStore(other);
+      IonexModel unshared(nominalPos, store, TypeID::P1, false, "SLM");
+      unshared.setEpochContext(otherContext);
+
+      int epochs(0), sats(0);
+      gnssRinex gRin;
+      while (rin >> gRin && epochs < 20)
+      {
+         gRin >> basic;
+         if (gRin.numSats() == 0)
+            continue;
+
+         gnssRinex gAlone(gRin), gShared(gRin), gUnshared(gRin);
+         gAlone >> alone;
+         gShared >> shared;
+         gUnshared >> unshared;
+
+         epochs++;
+         TUASSERTE(int, epochs, context.mapRequests);
+         TUASSERTE(int, 0, otherContext.mapRequests);
+         TUASSERTE(int, gAlone.numSats(), gShared.numSats());
+         TUASSERTE(int, gAlone.numSats(), gUnshared.numSats());
+
+         for (satTypeValueMap::const_iterator it = gAlone.body.begin();
+              it != gAlone.body.end();
+              ++it)
+         {
+            double tec(it->second.getValue(TypeID::ionoTEC));
+            TUASSERTE(double, tec,
+                      gShared.getValue(it->first, TypeID::ionoTEC));
+            TUASSERTE(double, it->second.getValue(TypeID::ionoL1),
+                      gShared.getValue(it->first, TypeID::ionoL1));
+            TUASSERTE(double, tec,
+                      gUnshared.getValue(it->first, TypeID::ionoTEC));
+
+               // The same value as a lookup of the pierce point by itself
+            Position ipp(nominalPos.getIonosphericPiercePoint(
+                                 it->second.getValue(TypeID::elevation),
+                                 it->second.getValue(TypeID::azimuth),
+                                 450000.0));
+            ipp.transformTo(Position::Geocentric);
+            CommonTime t(gRin.header.epoch);
+            t.setTimeSystem(TimeSystem::Any);
+            TUASSERTE(double, store.getIonexValue(t, ipp)[0], tec);
+            sats++;
+         }
+      }
+
+      TUASSERTE(int, 20, epochs);
+      TUASSERT(sats > 5*epochs);
+
+      TURETURN();
+   }
+
+//=============================================================================
+//    CorrectObservables with an EpochContext corrects as if its extra biases
+//    were the tide displacement of the epoch
+//=============================================================================
+   int correctObservablesTest(void)
+   {
+      TUDEF("CorrectObservables", "Process(EpochContext)");
+
+      RinexEphemerisStore ephStore;
+      ephStore.loadFile(inputNav);
+
+      RinexObsStream rin(inputObs.c_str());
+      RinexObsHeader roh;
+      rin >> roh;
+      Position nominalPos(roh.antennaPosition);
+
+      BasicModel basic(nominalPos, ephStore);
+      CountingContext context(nominalPos);
+      CorrectObservables shared(ephStore, nominalPos);
+      shared.setEpochContext(context);
+      TUASSERT(shared.getEpochContext() == &context);
+
+      SolidTides solid;
+
+      int epochs(0);
+      gnssRinex gRin;
+      while (rin >> gRin && epochs < 20)
+      {
+         gRin >> basic;
+         if (gRin.numSats() == 0)
+            continue;
+
+         Triple tide(solid.getSolidTide(gRin.header.epoch, nominalPos));
+         TUASSERT(tide.mag() > 0.0);
+
+         CorrectObservables alone(ephStore, nominalPos);
+         alone.setExtraBiases(tide);
+
+         gnssRinex gAlone(gRin), gShared(gRin);
+         gAlone >> alone;
+         gShared >> shared;
+
+         epochs++;
+         TUASSERTE(int, epochs, context.tideRequests);
+         TUASSERTE(int, gAlone.numSats(), gShared.numSats());
+
+         for (satTypeValueMap::const_iterator it = gAlone.body.begin();
+              it != gAlone.body.end();
+              ++it)
+         {
+            const TypeID types[] = { TypeID::P1, TypeID::P2,
+                                     TypeID::L1, TypeID::L2 };
+            for (int k = 0; k < 4; k++)
+            {
+               TUASSERTE(double, it->second.getValue(types[k]),
+                         gShared.getValue(it->first, types[k]));
+            }
+
+               // The displacement does change the observables
+            TUASSERT(it->second.getValue(TypeID::P1) !=
+                     gRin.getValue(it->first, TypeID::P1));
+         }
+      }
+
+      TUASSERTE(int, 20, epochs);
+
+      TURETURN();
+   }
+
+private:
+
+      /// A TEC or RMS map on a coarse global grid, at epoch t0 + 2k hours
+   IonexData makeMap(int k, const IonexData::IonexValType& type)
+   {
+      IonexData iod;
+      iod.mapID = k + 1;
+      iod.time = t0 + 7200.0*k;
+      iod.type = type;
+      iod.lat[0] = 87.5; iod.lat[1] = -87.5; iod.lat[2] = -17.5;
+      iod.lon[0] = -180.0; iod.lon[1] = 180.0; iod.lon[2] = 30.0;
+      iod.hgt[0] = 450.0; iod.hgt[1] = 450.0; iod.hgt[2] = 0.0;
+      iod.dim[0] = 11; iod.dim[1] = 13; iod.dim[2] = 1;
+      iod.exponent = -1;
+      iod.valid = true;
+
+      iod.data.resize(iod.dim[0]*iod.dim[1]);
+      for (size_t i = 0; i < iod.data.size(); i++)
+      {
+         double tec(5.0 + 3.0*k + 0.1*((i*37 + k*11) % 97));
+         iod.data[i] = (type == IonexData::TEC) ? tec : 0.1*tec;
+      }
+
+      return iod;
+   }
+
+      /// A point at the height of the grid, spread over the globe
+   Position piercePoint(int i)
+   {
+      WGS84Ellipsoid wgs84;
+      double lat(-80.0 + (i*23 % 160) + 0.37);
+      double lon(20.0 + (i*47 % 280) + 0.61);
+      return Position(lat, lon, wgs84.a() + 450000.0, Position::Geocentric);
+   }
+
+      /// The search and interpolation of getIonexValue() before findMaps()
+      /// was split out of it, over copies of the maps in the store
+   Triple oldIonexValue(const CommonTime& t, const Position& RX, int strategy)
+   {
+      int nmap((strategy == 1 || strategy == 4) ? 1 : 2);
+
+      CommonTime T[2];
+      std::map<CommonTime, IonexData>::const_iterator itm;
+      itm = tecMaps.lower_bound(t);
+      if (itm->first == t)
+      {
+         T[0] = itm->first;
+         T[1] = (++itm)->first;
+      }
+      else
+      {
+         T[1] = itm->first;
+         T[0] = (--itm)->first;
+      }
+
+      double f[2];
+      f[0] = (T[1]-t   ) / (T[1]-T[0]);
+      f[1] = (t   -T[0]) / (T[1]-T[0]);
+      if (nmap == 1)
+      {
+         if (f[1] > f[0])
+            T[0] = T[1];
+         f[0] = 1.0;
+      }
+
+      Triple tecval(0.0, 0.0, 0.0);
+      for (int imap = 0; imap < nmap; imap++)
+      {
+         Position pos(RX);
+         if (strategy == 3 || strategy == 4)
+         {
+            double sec2deg( 4.16666666666667e-3 );
+            pos.theArray[1] = pos.theArray[1] + ( t - T[imap] ) * sec2deg;
+         }
+
+         IonexData tec(tecMaps[T[imap]]);
+         IonexData rms(rmsMaps[T[imap]]);
+         tecval[0] = tecval[0] + f[imap]*tec.getValue(pos);
+         tecval[1] = tecval[1] + f[imap]*rms.getValue(pos);
+      }
+      tecval[2] = RX.theArray[2];
+
+      return tecval;
+   }
+
+   std::string inputObs;
+   std::string inputNav;
+
+   CommonTime t0;
+   int numMaps;
+   IonexStore store;
+   std::map<CommonTime, IonexData> tecMaps;
+   std::map<CommonTime, IonexData> rmsMaps;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   int check, errorCounter = 0;
+   EpochContext_T testClass;
+
+   check = testClass.findMapsTest();
+   errorCounter += check;
+
+   check = testClass.lastMapTest();
+   errorCounter += check;
+
+   check = testClass.invalidTest();
+   errorCounter += check;
+
+   check = testClass.contextMapsTest();
+   errorCounter += check;
+
+   check = testClass.ionexModelTest();
+   errorCounter += check;
+
+   check = testClass.correctObservablesTest();
+   errorCounter += check;
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter <<
+             std::endl;
+
+   return errorCounter; // Return the total number of errors
+}
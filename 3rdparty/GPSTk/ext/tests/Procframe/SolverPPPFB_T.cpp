@@ -0,0 +1,296 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file SolverPPPFB_T.cpp Regression test of SolverPPPFB with its epochs
+/// buffered in scratch files against SolverPPPFB with its epochs in memory.
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "RinexObsStream.hpp"
+#include "RinexEphemerisStore.hpp"
+#include "NeillTropModel.hpp"
+#include "YDSTime.hpp"
+#include "DataStructures.hpp"
+#include "RequireObservables.hpp"
+#include "SimpleFilter.hpp"
+#include "BasicModel.hpp"
+#include "ComputeTropModel.hpp"
+#include "ComputeLinear.hpp"
+#include "LinearCombinations.hpp"
+#include "LICSDetector2.hpp"
+#include "MWCSDetector.hpp"
+#include "SatArcMarker.hpp"
+#include "PhaseCodeAlignment.hpp"
+#include "SolverPPPFB.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+
+class SolverPPPFB_T
+{
+public:
+   SolverPPPFB_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string tempFilePath = gpstk::getPathTestTemp();
+      std::string file_sep = "/";
+
+      inputObs = dataFilePath + file_sep + "arlm200a.15o";
+      inputNav = dataFilePath + file_sep + "arlm200a.15n";
+      bufferFile = tempFilePath + file_sep + "SolverPPPFB_T.buf";
+   }
+
+//=============================================================================
+//    Run the forward-backward filter over one hour of 30 s dual frequency
+//    data, with the epochs in memory and in scratch files, and check that
+//    both give the same solutions and postfit residuals in every epoch of
+//    the last forward pass
+//=============================================================================
+   int cyclesTest(void)
+   {
+      TUDEF("SolverPPPFB", "ReProcess(cycles)");
+
+      Results inMemory, buffered;
+      run(false, false, inMemory);
+      run(true, false, buffered);
+
+      compare(testFramework, inMemory, buffered);
+
+      TURETURN();
+   }
+
+   int limitsTest(void)
+   {
+      TUDEF("SolverPPPFB", "ReProcess(limits)");
+
+      Results inMemory, buffered;
+      run(false, true, inMemory);
+      run(true, true, buffered);
+
+         // The limits do reject some satellites
+      TUASSERT(inMemory.rejected > 0);
+      TUASSERTE(int, inMemory.rejected, buffered.rejected);
+
+      compare(testFramework, inMemory, buffered);
+
+      TURETURN();
+   }
+
+private:
+
+      /// Solutions and postfit residuals of the last pass, in epoch order
+   struct Results
+   {
+      std::vector<double> solution;
+      std::vector<double> postfit;
+      int epochs;
+      int processed;
+      int rejected;
+   };
+
+   void run(bool useBuffer, bool useLimits, Results& res)
+   {
+      RinexEphemerisStore ephStore;
+      ephStore.loadFile(inputNav);
+
+      RinexObsStream rin(inputObs.c_str());
+      RinexObsHeader roh;
+      rin >> roh;
+
+      Position nominalPos(roh.antennaPosition);
+      NeillTropModel neillTM( nominalPos.getAltitude(),
+                              nominalPos.getGeodeticLatitude(),
+                              static_cast<YDSTime>(roh.firstObs).doy );
+
+      RequireObservables requireObs(TypeID::P1);
+      requireObs.addRequiredType(TypeID::P2);
+      requireObs.addRequiredType(TypeID::L1);
+      requireObs.addRequiredType(TypeID::L2);
+
+      LinearCombinations comb;
+      ComputeLinear linear1(comb.pdeltaCombination);
+      linear1.addLinear(comb.ldeltaCombination);
+      linear1.addLinear(comb.mwubbenaCombination);
+      linear1.addLinear(comb.liCombination);
+      LICSDetector2 markCSLI;
+      MWCSDetector markCSMW;
+      SatArcMarker markArc;
+      markArc.setDeleteUnstableSats(true);
+      markArc.setUnstablePeriod(151.0);
+
+      BasicModel basic(nominalPos, ephStore);
+      ComputeTropModel computeTropo(neillTM);
+      ComputeLinear linear2(comb.pcCombination);
+      linear2.addLinear(comb.lcCombination);
+      SimpleFilter pcFilter;
+      pcFilter.setFilteredType(TypeID::PC);
+      PhaseCodeAlignment phaseAlign;
+      ComputeLinear linear3(comb.pcPrefit);
+      linear3.addLinear(comb.lcPrefit);
+
+      SolverPPPFB fbpppSolver;
+      if (useBuffer)
+      {
+            // Small blocks, so the hour spans several of them
+         fbpppSolver.setBufferFile(bufferFile, 16);
+      }
+      if (useLimits)
+      {
+         fbpppSolver.addCodeLimit(10.0);
+         fbpppSolver.addCodeLimit(5.0);
+         fbpppSolver.addPhaseLimit(0.1);
+         fbpppSolver.addPhaseLimit(0.05);
+      }
+
+      gnssRinex gRin;
+      while (rin >> gRin)
+      {
+         try
+         {
+            gRin >> requireObs
+                 >> linear1
+                 >> markCSLI
+                 >> markCSMW
+                 >> markArc
+                 >> basic
+                 >> computeTropo
+                 >> linear2
+                 >> pcFilter
+                 >> phaseAlign
+                 >> linear3;
+         }
+         catch(Exception& e)
+         {
+            continue;
+         }
+
+            // SatArcMarker drops the satellites of the first 151 s, and
+            // SolverPPP can not recover from an epoch it fails to solve
+         if (gRin.numSats() < 5)
+            continue;
+
+         gRin >> fbpppSolver;
+      }
+
+      if (useLimits)
+         fbpppSolver.ReProcess();
+      else
+         fbpppSolver.ReProcess(2);
+
+      const TypeID core[] = { TypeID::wetMap, TypeID::dx, TypeID::dy,
+                              TypeID::dz, TypeID::cdt };
+      const int numCore(sizeof(core)/sizeof(core[0]));
+
+      res.epochs = 0;
+      while (fbpppSolver.LastProcess(gRin))
+      {
+         res.epochs++;
+         for (int i = 0; i < numCore; i++)
+            res.solution.push_back(fbpppSolver.getSolution(core[i]));
+
+         for (satTypeValueMap::const_iterator it = gRin.body.begin();
+              it != gRin.body.end();
+              ++it)
+         {
+            res.postfit.push_back(gRin.getValue(it->first, TypeID::postfitC));
+            res.postfit.push_back(gRin.getValue(it->first, TypeID::postfitL));
+         }
+      }
+      res.processed = fbpppSolver.getProcessedMeasurements();
+      res.rejected = fbpppSolver.getRejectedMeasurements();
+   }
+
+   void compare(TestUtil& testFramework,
+                const Results& inMemory,
+                const Results& buffered)
+   {
+         // Most of the hour is solved, with several satellites per epoch
+      TUASSERT(inMemory.epochs > 100);
+      TUASSERT(inMemory.postfit.size() > 10*inMemory.epochs);
+
+      TUASSERTE(int, inMemory.epochs, buffered.epochs);
+      TUASSERTE(int, inMemory.processed, buffered.processed);
+      TUASSERTE(size_t, inMemory.solution.size(), buffered.solution.size());
+      TUASSERTE(size_t, inMemory.postfit.size(), buffered.postfit.size());
+      if (inMemory.solution.size() != buffered.solution.size() ||
+          inMemory.postfit.size() != buffered.postfit.size())
+         return;
+
+         // The scratch files store the values exactly, so the filter sees
+         // the same input in the same order
+      double maxSolution(0.0), maxPostfit(0.0);
+      for (size_t i = 0; i < inMemory.solution.size(); i++)
+         maxSolution = std::max( maxSolution,
+                                 std::abs( inMemory.solution[i]
+                                           - buffered.solution[i] ) );
+      for (size_t i = 0; i < inMemory.postfit.size(); i++)
+         maxPostfit = std::max( maxPostfit,
+                                std::abs( inMemory.postfit[i]
+                                          - buffered.postfit[i] ) );
+
+      TUASSERTE(double, 0.0, maxSolution);
+      TUASSERTE(double, 0.0, maxPostfit);
+   }
+
+   std::string inputObs;
+   std::string inputNav;
+   std::string bufferFile;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   int check, errorCounter = 0;
+   SolverPPPFB_T testClass;
+
+   check = testClass.cyclesTest();
+   errorCounter += check;
+
+   check = testClass.limitsTest();
+   errorCounter += check;
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter <<
+             std::endl;
+
+   return errorCounter; // Return the total number of errors
+}
@@ -0,0 +1,247 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S.
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software.
+//
+//Pursuant to DoD Directive 523024
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+/// @file SolverPPPSRIF_T.cpp Regression test of SolverPPPSRIF against
+/// SolverPPP on the bundled ARL:UT observations.
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "RinexObsStream.hpp"
+#include "RinexEphemerisStore.hpp"
+#include "NeillTropModel.hpp"
+#include "YDSTime.hpp"
+#include "DataStructures.hpp"
+#include "RequireObservables.hpp"
+#include "SimpleFilter.hpp"
+#include "BasicModel.hpp"
+#include "ComputeTropModel.hpp"
+#include "ComputeLinear.hpp"
+#include "LinearCombinations.hpp"
+#include "LICSDetector2.hpp"
+#include "MWCSDetector.hpp"
+#include "SatArcMarker.hpp"
+#include "PhaseCodeAlignment.hpp"
+#include "SolverPPP.hpp"
+#include "SolverPPPSRIF.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+
+class SolverPPPSRIF_T
+{
+public:
+   SolverPPPSRIF_T()
+   {
+      std::string dataFilePath = gpstk::getPathData();
+      std::string file_sep = "/";
+
+      inputObs = dataFilePath + file_sep + "arlm200a.15o";
+      inputNav = dataFilePath + file_sep + "arlm200a.15n";
+   }
+
+//=============================================================================
+//    Run SolverPPP and SolverPPPSRIF on the same prefit residuals, one hour
+//    of 30 s dual frequency data with broadcast ephemerides, and check that
+//    the two filters give the same solution, variances and postfit residuals
+//=============================================================================
+   int compareTest(void)
+   {
+      TUDEF("SolverPPPSRIF", "Process");
+
+      RinexEphemerisStore ephStore;
+      ephStore.loadFile(inputNav);
+
+      RinexObsStream rin(inputObs.c_str());
+      RinexObsHeader roh;
+      rin >> roh;
+
+      Position nominalPos(roh.antennaPosition);
+      NeillTropModel neillTM( nominalPos.getAltitude(),
+                              nominalPos.getGeodeticLatitude(),
+                              static_cast<YDSTime>(roh.firstObs).doy );
+
+      RequireObservables requireObs(TypeID::P1);
+      requireObs.addRequiredType(TypeID::P2);
+      requireObs.addRequiredType(TypeID::L1);
+      requireObs.addRequiredType(TypeID::L2);
+
+      LinearCombinations comb;
+      ComputeLinear linear1(comb.pdeltaCombination);
+      linear1.addLinear(comb.ldeltaCombination);
+      linear1.addLinear(comb.mwubbenaCombination);
+      linear1.addLinear(comb.liCombination);
+      LICSDetector2 markCSLI;
+      MWCSDetector markCSMW;
+      SatArcMarker markArc;
+      markArc.setDeleteUnstableSats(true);
+      markArc.setUnstablePeriod(151.0);
+
+      BasicModel basic(nominalPos, ephStore);
+      ComputeTropModel computeTropo(neillTM);
+      ComputeLinear linear2(comb.pcCombination);
+      linear2.addLinear(comb.lcCombination);
+      SimpleFilter pcFilter;
+      pcFilter.setFilteredType(TypeID::PC);
+      PhaseCodeAlignment phaseAlign;
+      ComputeLinear linear3(comb.pcPrefit);
+      linear3.addLinear(comb.lcPrefit);
+
+      SolverPPP ppp;
+      SolverPPPSRIF srif;
+
+         // Both filters share their input; the core states are compared
+      const TypeID core[] = { TypeID::wetMap, TypeID::dx, TypeID::dy,
+                              TypeID::dz, TypeID::cdt };
+      const int numCore(sizeof(core)/sizeof(core[0]));
+      double maxSolution(0.0), maxVariance(0.0), maxPostfit(0.0);
+      int epochs(0), postfits(0);
+
+      gnssRinex gRin;
+      while (rin >> gRin)
+      {
+         try
+         {
+            gRin >> requireObs
+                 >> linear1
+                 >> markCSLI
+                 >> markCSMW
+                 >> markArc
+                 >> basic
+                 >> computeTropo
+                 >> linear2
+                 >> pcFilter
+                 >> phaseAlign
+                 >> linear3;
+         }
+         catch(Exception& e)
+         {
+            continue;
+         }
+
+            // SatArcMarker drops the satellites of the first 151 s, and
+            // SolverPPP can not recover from an epoch it fails to solve
+         if (gRin.numSats() < 5)
+            continue;
+
+         gnssRinex gSRIF(gRin);
+         try
+         {
+            gRin >> ppp;
+         }
+         catch(Exception& e)
+         {
+            continue;
+         }
+
+         try
+         {
+            gSRIF >> srif;
+         }
+         catch(Exception& e)
+         {
+            TUFAIL("SolverPPPSRIF failed where SolverPPP did not: "
+                   + e.what());
+            continue;
+         }
+         epochs++;
+
+         for (int i = 0; i < numCore; i++)
+         {
+            maxSolution = std::max( maxSolution,
+                                    std::abs( ppp.getSolution(core[i])
+                                              - srif.getSolution(core[i]) ) );
+            maxVariance = std::max( maxVariance,
+                                    std::abs( ppp.getVariance(core[i])
+                                              - srif.getVariance(core[i]) )
+                                    / ppp.getVariance(core[i]) );
+         }
+
+         for (satTypeValueMap::const_iterator it = gRin.body.begin();
+              it != gRin.body.end();
+              ++it)
+         {
+            const SatID& sat(it->first);
+            TUASSERT(gSRIF.body.find(sat) != gSRIF.body.end());
+            if (gSRIF.body.find(sat) == gSRIF.body.end())
+               continue;
+
+            maxPostfit = std::max( maxPostfit,
+                                   std::abs( gRin.getValue(sat, TypeID::postfitC)
+                                             - gSRIF.getValue(sat, TypeID::postfitC) ) );
+            maxPostfit = std::max( maxPostfit,
+                                   std::abs( gRin.getValue(sat, TypeID::postfitL)
+                                             - gSRIF.getValue(sat, TypeID::postfitL) ) );
+            postfits++;
+         }
+      }
+
+         // Most of the hour is solved, with several satellites per epoch
+      TUASSERT(epochs > 100);
+      TUASSERT(postfits > 5*epochs);
+
+         // Solutions and postfit residuals agree to a tenth of a mm,
+         // variances to 1e-6 relative
+      TUASSERTFEPS(0.0, maxSolution, 1.e-4);
+      TUASSERTFEPS(0.0, maxPostfit, 1.e-4);
+      TUASSERTFEPS(0.0, maxVariance, 1.e-6);
+
+      TURETURN();
+   }
+
+private:
+   std::string inputObs;
+   std::string inputNav;
+};
+
+
+int main() // Main function to initialize and run all tests above
+{
+   int check, errorCounter = 0;
+   SolverPPPSRIF_T testClass;
+
+   check = testClass.compareTest();
+   errorCounter += check;
+
+   std::cout << "Total Failures for " << __FILE__ << ": " << errorCounter <<
+             std::endl;
+
+   return errorCounter; // Return the total number of errors
+}
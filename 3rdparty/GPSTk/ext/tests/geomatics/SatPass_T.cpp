@@ -0,0 +1,177 @@
+//============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  Copyright 2004, The University of Texas at Austin
+//
+//============================================================================
+
+//============================================================================
+//
+//This software developed by Applied Research Laboratories at the University of
+//Texas at Austin, under contract to an agency or agencies within the U.S. 
+//Department of Defense. The U.S. Government retains all rights to use,
+//duplicate, distribute, disclose, or release this software. 
+//
+//Pursuant to DoD Directive 523024 
+//
+// DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                           release, distribution is unlimited.
+//
+//=============================================================================
+
+
+/// @file SatPass_T.cpp Test the storage of class SatPass, in SatPass.hpp
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SatPass.hpp"
+#include "GPSWeekSecond.hpp"
+
+//------------------------------------------------------------------------------------
+using namespace std;
+using namespace gpstk;
+
+//------------------------------------------------------------------------------------
+// test a condition, counting and reporting failures
+static int nfail(0);
+static void check(bool ok, const string& label)
+{
+   if(!ok) { cout << label << " failed\n"; nfail++; }
+}
+
+//------------------------------------------------------------------------------------
+// fill a pass with N epochs at 30s, with a gap of two epochs after the 10th;
+// L1 = 100+i, L2 = 200+i, P1 = 300+i, P2 = 400+i, LLI = i%8, SSI = i%10
+static void fill(SatPass& sp, int N)
+{
+   vector<string> ots(sp.getObsTypes());
+   for(int i=0,n=0; i<N; i++,n++) {
+      if(i == 10) n += 2;
+      Epoch tt(GPSWeekSecond(1900, 30.0*n));
+      vector<double> data;
+      vector<unsigned short> lli,ssi;
+      for(int k=0; k<ots.size(); k++) {
+         data.push_back(100.0*(k+1)+i);
+         lli.push_back(i%8);
+         ssi.push_back(i%10);
+      }
+      sp.addData(tt, ots, data, lli, ssi);
+   }
+}
+
+//------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+try {
+   SatPass sp(RinexSatID("G05"), 30.0);
+   fill(sp, 20);
+
+   // sizes and counts
+   check(sp.size() == 20, "size");
+   check(sp.getNgood() == 20, "ngood");
+   check(sp.getCount(9) == 9 && sp.getCount(10) == 12, "count across gap");
+   check(sp.time(10) == Epoch(GPSWeekSecond(1900, 360.0)), "time");
+
+   // whole series, without copying
+   const vector<double>& L1(sp.dataSeries("L1"));
+   const vector<double>& P2(sp.dataSeries("P2"));
+   check(L1.size() == 20 && P2.size() == 20, "dataSeries size");
+   check(L1[7] == 107.0 && P2[19] == 419.0, "dataSeries values");
+   sp.data(7,"L1") = -1.0;
+   check(L1[7] == -1.0 && &L1[7] == &sp.data(7,"L1"), "dataSeries zero copy");
+   check(sp.LLI(13,"L2") == 5 && sp.SSI(13,"P1") == 3, "LLI SSI");
+
+   bool threw(false);
+   try { sp.dataSeries("C5"); }
+   catch(Exception& e) { threw = true; }
+   check(threw, "dataSeries invalid type");
+
+   // flags and user flags
+   sp.setFlag(4, SatPass::BAD);
+   check(sp.getNgood() == 19, "setFlag ngood");
+   check(sp.flagSeries().size() == 20 && sp.flagSeries()[4] == SatPass::BAD
+         && sp.flagSeries()[5] == SatPass::OK, "flagSeries");
+   sp.setFlag(6, 255);
+   check(sp.getFlag(6) == 255, "setFlag largest flag");
+   sp.setFlag(6, SatPass::OK);
+
+   threw = false;
+   try { sp.setFlag(6, 256); }
+   catch(Exception& e) { threw = true; }
+   check(threw && sp.getFlag(6) == SatPass::OK && sp.getNgood() == 19,
+         "setFlag flag too large");
+
+   threw = false;
+   try {
+      vector<string> ots(sp.getObsTypes());
+      vector<double> data(ots.size(), 0.0);
+      vector<unsigned short> lli(ots.size(), 0), ssi(ots.size(), 0);
+      sp.addData(Epoch(GPSWeekSecond(1900, 30.0*40)), ots, data, lli, ssi, 0x101);
+   }
+   catch(Exception& e) { threw = true; }
+   check(threw && sp.size() == 20, "addData flag too large");
+
+   check(sp.getUserFlag(3) == 0, "default user flag");
+   sp.setUserFlag(3, 77);
+   check(sp.getUserFlag(3) == 77 && sp.getUserFlag(2) == 0, "setUserFlag");
+
+   // copy
+   SatPass cp(RinexSatID("G01"), 30.0);
+   cp = sp;
+   check(cp.size() == 20 && cp.data(7,"L1") == -1.0 && cp.getUserFlag(3) == 77
+         && cp.getFlag(4) == SatPass::BAD, "copy");
+   cp.data(8,"L1") = -2.0;
+   check(sp.data(8,"L1") == 108.0, "deep copy");
+
+   // split at count 12 (index 10): new pass has the last 10 points
+   SatPass nsp(RinexSatID("G05"), 30.0);
+   cp.split(12, nsp);
+   check(cp.size() == 10 && nsp.size() == 10, "split sizes");
+   check(nsp.getFirstTime() == Epoch(GPSWeekSecond(1900, 360.0)), "split time");
+   check(nsp.getCount(0) == 0 && nsp.getCount(9) == 9, "split count");
+   check(nsp.data(0,"L1") == 110.0 && nsp.LLI(0,"L1") == 2
+         && nsp.SSI(9,"P2") == 9, "split data");
+   check(nsp.dataSeries("P1").size() == 10, "split series");
+
+   // trim after the 6th point
+   cp.trimAfter(Epoch(GPSWeekSecond(1900, 150.0)));
+   check(cp.size() == 6 && cp.dataSeries("L2").size() == 6
+         && cp.getNgood() == 5 && cp.getUserFlag(3) == 77, "trimAfter");
+
+   // decimate by 2: keep even counts, 0..8 and 12..20
+   sp.decimate(2);
+   check(sp.size() == 10 && sp.getDT() == 60.0, "decimate size");
+   check(sp.data(1,"L2") == 202.0 && sp.data(5,"L2") == 210.0
+         && sp.getCount(5) == 6, "decimate data");
+   check(sp.dataSeries("L2").size() == 10 && sp.flagSeries().size() == 10,
+         "decimate series");
+   check(sp.getFlag(2) == SatPass::BAD && sp.getNgood() == 9, "decimate flags");
+
+   // clear
+   sp.clear();
+   check(sp.size() == 0 && sp.dataSeries("L1").empty(), "clear");
+
+   cout << "Error count is " << nfail << endl;
+   return nfail;
+
+} catch(Exception& e) {
+   cout << "Threw " << e.what() << endl;
+   return 1;
+}
+}
@@ -0,0 +1,114 @@
+/*
+ * libcluster -- A collection of hierarchical Bayesian clustering algorithms.
+ * Copyright (C) 2013 Daniel M. Steinberg (daniel.m.steinberg@gmail.com)
+ *
+ * This file is part of libcluster.
+ *
+ * libcluster is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * libcluster is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libcluster. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Time the VDP and the diagonal Gaussian mixture on synthetic 2, 3 and 4
+ *  dimensional data, e.g. GNSS residuals. Build the library with and without
+ *  BUILD_FIXED_DIMS to compare the fixed and dynamic size cluster code.
+ *
+ *  usage: bench_vdp [observations] [repeats]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include "libcluster.h"
+
+using namespace std;
+using namespace Eigen;
+using namespace libcluster;
+using namespace distributions;
+
+
+/* Draw N observations from six well separated Gaussian clusters in D
+ *  dimensions, always from the same seed.
+ */
+MatrixXd makedata (const int N, const int D)
+{
+  mt19937 gen(42);
+  normal_distribution<double> norm;
+
+  MatrixXd X(N, D);
+  for (int n = 0; n < N; ++n)
+    for (int d = 0; d < D; ++d)
+      X(n, d) = norm(gen) + 4.0 * ((n % 6) == d) - 4.0 * ((n % 6) == d + D);
+
+  return X;
+}
+
+
+template <class T> double timeit (T learn, const int repeats, double& F,
+                                  unsigned int& K)
+{
+  double best = 0;
+  for (int r = 0; r < repeats; ++r)
+  {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    learn(F, K);
+    double t = chrono::duration<double>(chrono::steady_clock::now()
+                                        - start).count();
+    if ((r == 0) || (t < best))
+      best = t;
+  }
+
+  return best;
+}
+
+
+int main (int argc, char* argv[])
+{
+  const int N       = (argc > 1) ? atoi(argv[1]) : 2000;
+  const int repeats = (argc > 2) ? atoi(argv[2]) : 3;
+
+#ifdef NO_FIXED_DIMS
+  printf("Dynamic size clusters, N = %d, best of %d\n", N, repeats);
+#else
+  printf("Fixed size clusters, N = %d, best of %d\n", N, repeats);
+#endif
+
+  for (int D = 2; D <= 4; ++D)
+  {
+    const MatrixXd X = makedata(N, D);
+    double F;
+    unsigned int K;
+
+    double t = timeit([&](double& F, unsigned int& K)
+    {
+      MatrixXd qZ;
+      StickBreak weights;
+      vector<GaussWish> clusters;
+      F = learnVDP(X, qZ, weights, clusters, 1, -1, false, 1);
+      K = clusters.size();
+    }, repeats, F, K);
+    printf("  VDP  D = %d: %8.3f s, K = %2u, F = %.6f\n", D, t, K, F);
+
+    t = timeit([&](double& F, unsigned int& K)
+    {
+      MatrixXd qZ;
+      Dirichlet weights;
+      vector<NormGamma> clusters;
+      F = learnDGMM(X, qZ, weights, clusters, 1, -1, false, 1);
+      K = clusters.size();
+    }, repeats, F, K);
+    printf("  DGMM D = %d: %8.3f s, K = %2u, F = %.6f\n", D, t, K, F);
+  }
+
+  return 0;
+}
@@ -48,6 +48,8 @@ const double APRIOR      = 1.0;      //!< a prior value (Exponential)
 //
 
 typedef Eigen::Array<bool, Eigen::Dynamic, 1> ArrayXb; //!< Boolean Array
+typedef Eigen::Ref<const Eigen::MatrixXd> RefMatrixXd; //!< Matrix view
+typedef Eigen::Ref<const Eigen::VectorXd> RefVectorXd; //!< Vector view
 
 
 //
@@ -209,8 +211,8 @@ public:
    *           to qZk.
    */
   virtual void addobs (
-      const Eigen::VectorXd& qZk,
-      const Eigen::MatrixXd& X
+      const RefVectorXd& qZk,
+      const RefMatrixXd& X
       ) = 0;
 
   /*! \brief Update the cluster parameters from the observations added from
@@ -227,7 +229,7 @@ public:
    *  \param X a matrix of observations, [obs x dims].
    *  \returns An array of likelihoods for the observations given this dist.
    */
-  virtual Eigen::VectorXd Eloglike (const Eigen::MatrixXd& X) const = 0;
+  virtual Eigen::VectorXd Eloglike (const RefMatrixXd& X) const = 0;
 
   /*! \brief Get the free energy contribution of these cluster parameters.
    *  \returns the free energy contribution of these cluster parameters.
@@ -240,7 +242,7 @@ public:
    *  \note this needs to consistently split observations between multiple
    *        subsequent calls, but can change after each update().
    */
-  virtual ArrayXb splitobs (const Eigen::MatrixXd& X) const = 0;
+  virtual ArrayXb splitobs (const RefMatrixXd& X) const = 0;
 
   /*! \brief Return the number of observations belonging to this cluster.
    *  \returns the number of observations belonging to this cluster.
@@ -275,6 +277,10 @@ protected:
 
 /*!
  *  \brief Gaussian-Wishart parameter distribution for full Gaussian clusters.
+ *
+ *  For 2, 3 and 4 dimensional data the observation-wise computations use
+ *  fixed size types and a closed form inverse, unless the library is built
+ *  with NO_FIXED_DIMS. Other dimensions use dynamic sizes.
  */
 class GaussWish : public ClusterDist
 {
@@ -288,15 +294,15 @@ public:
    */
   GaussWish (const double clustwidth, const unsigned int D);
 
-  void addobs (const Eigen::VectorXd& qZk, const Eigen::MatrixXd& X);
+  void addobs (const RefVectorXd& qZk, const RefMatrixXd& X);
 
   void update ();
 
   void clearobs ();
 
-  Eigen::VectorXd Eloglike (const Eigen::MatrixXd& X) const;
+  Eigen::VectorXd Eloglike (const RefMatrixXd& X) const;
 
-  ArrayXb splitobs (const Eigen::MatrixXd& X) const;
+  ArrayXb splitobs (const RefMatrixXd& X) const;
 
   double fenergy () const;
 
@@ -334,11 +340,20 @@ private:
   Eigen::RowVectorXd x_s;
   Eigen::MatrixXd xx_s;
 
+  // Fixed dimension (DIM == D) versions of the public methods
+  template <int DIM> void addobsfix (const RefVectorXd& qZk,
+                                     const RefMatrixXd& X);
+  template <int DIM> void updatefix ();
+  template <int DIM> Eigen::VectorXd Eloglikefix (const RefMatrixXd& X) const;
+  template <int DIM> ArrayXb splitobsfix (const RefMatrixXd& X) const;
+
 };
 
 
 /*!
  *  \brief Normal-Gamma parameter distribution for diagonal Gaussian clusters.
+ *
+ *  As GaussWish, 2, 3 and 4 dimensional data use fixed size types.
  */
 class NormGamma : public ClusterDist
 {
@@ -352,15 +367,15 @@ public:
    */
   NormGamma (const double clustwidth, const unsigned int D);
 
-  void addobs (const Eigen::VectorXd& qZk, const Eigen::MatrixXd& X);
+  void addobs (const RefVectorXd& qZk, const RefMatrixXd& X);
 
   void update ();
 
   void clearobs ();
 
-  Eigen::VectorXd Eloglike (const Eigen::MatrixXd& X) const;
+  Eigen::VectorXd Eloglike (const RefMatrixXd& X) const;
 
-  ArrayXb splitobs (const Eigen::MatrixXd& X) const;
+  ArrayXb splitobs (const RefMatrixXd& X) const;
 
   double fenergy () const;
 
@@ -397,6 +412,11 @@ private:
   Eigen::RowVectorXd x_s;
   Eigen::RowVectorXd xx_s;
 
+  // Fixed dimension (DIM == D) versions of the public methods
+  template <int DIM> void addobsfix (const RefVectorXd& qZk,
+                                     const RefMatrixXd& X);
+  template <int DIM> Eigen::VectorXd Eloglikefix (const RefMatrixXd& X) const;
+
 };
 
 
@@ -416,15 +436,15 @@ public:
    */
   ExpGamma (const double obsmag, const unsigned int D);
 
-  void addobs (const Eigen::VectorXd& qZk, const Eigen::MatrixXd& X);
+  void addobs (const RefVectorXd& qZk, const RefMatrixXd& X);
 
   void update ();
 
   void clearobs ();
 
-  Eigen::VectorXd Eloglike (const Eigen::MatrixXd& X) const;
+  Eigen::VectorXd Eloglike (const RefMatrixXd& X) const;
 
-  ArrayXb splitobs (const Eigen::MatrixXd& X) const;
+  ArrayXb splitobs (const RefMatrixXd& X) const;
 
   double fenergy () const;
 
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <Eigen/Dense>
 #include <vector>
+#include <functional>
 #include <omp.h>
 #include "distributions.h"
 
@@ -138,6 +139,45 @@ typedef std::vector<Eigen::MatrixXd>                  vMatrixXd;
 typedef std::vector< std::vector<Eigen::MatrixXd> >   vvMatrixXd;
 
 
+//
+// Parallel Execution
+//
+
+/*! \brief Interface for running the parallel loops of the algorithms on a
+ *         thread pool other than OpenMP's, e.g. a TBB arena of the caller.
+ *
+ *  Implement operator() and pass the object to setparallelfor(). The nthreads
+ *  argument of the algorithms is passed on as the limit of concurrent calls.
+ */
+class ParallelFor
+{
+public:
+
+  virtual ~ParallelFor () {}
+
+  /*! \brief Call body(n) for every n in [0, N).
+   *
+   *  \param N the number of loop iterations.
+   *  \param nthreads the most calls of body that should run at once.
+   *  \param body the loop body, which may itself run parallel loops.
+   *  \note This must only return once every call of body has finished.
+   */
+  virtual void operator() (
+      const int N,
+      const unsigned int nthreads,
+      const std::function<void (int)>& body
+      ) const = 0;
+};
+
+
+/*! \brief Set the parallel loop backend of all the algorithms.
+ *
+ *  \param backend the backend to use, or NULL to use OpenMP (the default).
+ *         This is not copied, so it must outlive any running algorithm.
+ */
+void setparallelfor (const ParallelFor* backend);
+
+
 //
 // Mixture Models for Clustering (cluster.cpp)
 //
@@ -66,8 +66,12 @@ bool checkComponent(Eigen::MatrixXd data, Eigen::MatrixXd qZ, mixtureComponents
 
 bool checkComponentGMM(mixtureComponents prior, mixtureComponents test, double alpha);
 
+// Merge each group of equlivant components into one. The pairwise checks run
+// in parallel, the groups are the connected components of the pairs found.
+vector<mixtureComponents> mergeEquivalent(vector<mixtureComponents> gmm, double alpha);
+
 // Implementaion of Algo. 1  in [1] to merge statistically equlivant components of a mixture model.
-vector<mixtureComponents> mergeMixtureModel(Eigen::MatrixXd data, Eigen::MatrixXd qZ, vector<mixtureComponents> priorModel, vector<GaussWish> currModel, StickBreak currWeight, double alpha, int truncLevel);
+vector<mixtureComponents> mergeMixtureModel(Eigen::MatrixXd data, Eigen::MatrixXd qZ, vector<mixtureComponents> priorModel, vector<GaussWish> currModel, StickBreak currWeight, double alpha, int truncLevel, const unsigned int nthreads = omp_get_max_threads());
 
 // Return the highest probability mixture component given an observation
 observationModel getMixtureComponent(vector<mixtureComponents> gmm, Eigen::VectorXd observation);
@@ -113,7 +113,7 @@ Eigen::MatrixXd cov (const std::vector<Eigen::MatrixXd>& X);
  *          dimensionality, or if A is not PSD.
  */
 Eigen::VectorXd mahaldist (
-    const Eigen::MatrixXd& X,
+    const Eigen::Ref<const Eigen::MatrixXd>& X,
     const Eigen::RowVectorXd& mu,
     const Eigen::MatrixXd& A
     );
@@ -140,6 +140,15 @@ Eigen::VectorXd logsumexp (const Eigen::MatrixXd& X);
 double eigpower (const Eigen::MatrixXd& A, Eigen::VectorXd& eigvec);
 
 
+/*! \brief The eigen power method for a fixed size DIMxDIM matrix, DIM = 2, 3
+ *         or 4. Otherwise the same as eigpower() above.
+ */
+template <int DIM> double eigpower (
+    const Eigen::Matrix<double, DIM, DIM>& A,
+    Eigen::Matrix<double, DIM, 1>& eigvec
+    );
+
+
 /*! \brief Get the log of the determinant of a PSD matrix.
  *
  *  \param A a DxD positive semi-definite matrix.
@@ -150,6 +159,12 @@ double eigpower (const Eigen::MatrixXd& A, Eigen::VectorXd& eigvec);
 double logdet (const Eigen::MatrixXd& A);
 
 
+/*! \brief Get the log of the determinant of a fixed size DIMxDIM PSD matrix,
+ *         DIM = 2, 3 or 4. Otherwise the same as logdet() above.
+ */
+template <int DIM> double logdet (const Eigen::Matrix<double, DIM, DIM>& A);
+
+
 /*! \brief Calculate digamma(X) for each element of X.
  *
  *  \param X an NxM matrix
@@ -45,40 +45,28 @@ using namespace libcluster;
 //
 
 
-/* Update the group and model sufficient statistics based on assignments qZj.
+/* Update the sufficient statistics of one cluster from the assignments qZ of
+ *  every group. The groups are added in order, so the result does not depend
+ *  on how the clusters are scheduled.
  *
- *  mutable: the clusters (add sufficient stats).
- *  returns: the number of observations in each cluster for this groups.
+ *  mutable: the cluster (add sufficient stats).
  */
-template <class C> ArrayXd updateSS (
-    const MatrixXd& Xj,   // Observations in group j
-    const MatrixXd& qZj,  // Observations to group mixture assignments
-    vector<C>& clusters,  // Cluster Distributions
-    const bool sparse     // Do sparse updates to groups
+template <class C> void updateSS (
+    const vMapMatrixXd& X,        // Observations
+    const vMatrixXd& qZ,          // Observations to group mixture assignments
+    const vector<ArrayXd>& Njk,   // Number of observations in each group
+    const unsigned int k,         // Cluster to update
+    C& cluster,                   // Cluster Distribution k
+    const bool sparse             // Do sparse updates to groups
     )
 {
-  const unsigned int K = qZj.cols();
-
-  const ArrayXd Njk = qZj.colwise().sum();  // count obs. in this group
-  ArrayXi Kful = ArrayXi::Zero(1),          // Initialise and set K = 1 defaults
-          Kemp = ArrayXi::Zero(0);
-
-  // Find empty clusters if sparse
-  if ( (sparse == false) && (K > 1) )
-    Kful = ArrayXi::LinSpaced(Sequential, K, 0, K-1);
-  else if (sparse == true)
-    arrfind((Njk >= ZEROCUTOFF), Kful, Kemp);
-
-  const unsigned int nKful = Kful.size();
-
-  // Sufficient statistics - with observations
-  for (unsigned int k = 0; k < nKful; ++k)
-  {
-    #pragma omp critical
-    clusters[Kful(k)].addobs(qZj.col(Kful(k)), Xj);
-  }
+  const unsigned int J = X.size();
 
-  return Njk;
+  // Sufficient statistics - with observations, skipping the groups that have
+  //  none in this cluster if sparse
+  for (unsigned int j = 0; j < J; ++j)
+    if ( (sparse == false) || (Njk[j](k) >= ZEROCUTOFF) )
+      cluster.addobs(qZ[j].col(k), X[j]);
 }
 
 
@@ -89,7 +77,7 @@ template <class C> ArrayXd updateSS (
  *  throws: invalid_argument rethrown from other functions.
  */
 template <class W, class C> double vbexpectation (
-    const MatrixXd& Xj,         // Observations in group J
+    const MapMatrixXd& Xj,      // Observations in group J
     const W& weights,           // Group Weight parameter distribution
     const vector<C>& clusters,  // Cluster parameter distributions
     MatrixXd& qZj,              // Observations to group mixture assignments
@@ -175,7 +163,7 @@ template <class W, class C> double fenergy (
  *  throws: runtime_error if there is a negative free energy.
  */
 template <class W, class C> double vbem (
-    const vMatrixXd& X,         // Observations
+    const vMapMatrixXd& X,      // Observations
     vMatrixXd& qZ,              // Observations to model mixture assignments
     vector<W>& weights,         // Group weight distributions
     vector<C>& clusters,        // Cluster Distributions
@@ -203,24 +191,26 @@ template <class W, class C> double vbem (
     for (int k = 0; k < K; ++k)
       clusters[k].clearobs();
 
-    // Update Suff Stats and VBM for weights
-    #pragma omp parallel for schedule(guided)
-    for (int j = 0; j < J; ++j)
+    // VBM for weights
+    vector<ArrayXd> Njk(J);
+    parfor(J, [&](int j)
     {
-      ArrayXd Njk = updateSS<C>(X[j], qZ[j], clusters, sparse);
-      weights[j].update(Njk);
-    }
+      Njk[j] = qZ[j].colwise().sum();   // count obs. in this group
+      weights[j].update(Njk[j]);
+    });
 
-    // VBM for clusters
-    #pragma omp parallel for schedule(guided)
-    for (int k = 0; k < K; ++k)
+    // Update Suff Stats and VBM for clusters
+    parfor(K, [&](int k)
+    {
+      updateSS<C>(X, qZ, Njk, k, clusters[k], sparse);
       clusters[k].update();
+    });
 
     // VBE
-    double Fz = 0;
-    #pragma omp parallel for schedule(guided) reduction(+ : Fz)
-    for (int j = 0; j < J; ++j)
-      Fz += vbexpectation<W,C>(X[j], weights[j], clusters, qZ[j], sparse);
+    double Fz = parsum(J, [&](int j)
+    {
+      return vbexpectation<W,C>(X[j], weights[j], clusters, qZ[j], sparse);
+    });
 
     // Calculate free energy of model
     F = fenergy<W,C>(weights, clusters, Fz);
@@ -255,7 +245,7 @@ template <class W, class C> double vbem (
  */
 #ifdef EXHAUST_SPLIT
 template <class W, class C> bool split_ex (
-    const vMatrixXd& X,         // Observations
+    const vMapMatrixXd& X,      // Observations
     const vector<C>& clusters,  // Cluster Distributions
     vMatrixXd& qZ,              // Probabilities qZ
     const double F,             // Current model free energy
@@ -271,10 +261,14 @@ template <class W, class C> bool split_ex (
   if ( ((signed) K >= maxclusters) && (maxclusters >= 0) )
       return false;
 
-  // Pre allocate big objects for loops (this makes a runtime difference)
+  // Pre allocate big objects for loops (this makes a runtime difference), the
+  //  partitions and augmented qZ reuse this storage for every split candidate
   double Fbest = numeric_limits<double>::infinity();
   vector<ArrayXi> mapidx(J, ArrayXi());
-  vMatrixXd qZref(J,MatrixXd()), qZaug(J,MatrixXd()), Xk(J,MatrixXd()), qZbest;
+  vector<VectorXd> Xkbuf(J, VectorXd());
+  vMapMatrixXd Xk(J, MapMatrixXd(0, 0, X[0].cols()));
+  vMatrixXd qZref(J,MatrixXd()), qZaug(J,MatrixXd()), qZbest(J,MatrixXd());
+  ArrayXi Mj(J), scountj(J);    // Per group observation and split counts
 
   // Loop through each potential cluster in order and split it
   for (unsigned int k = 0; k < K; ++k)
@@ -284,14 +278,11 @@ template <class W, class C> bool split_ex (
       continue;
 
     // Now split observations and qZ.
-    int scount = 0, Mtot = 0;
-
-    #pragma omp parallel for schedule(guided) reduction(+ : Mtot, scount)
-    for (unsigned int j = 0; j < J; ++j)
+    parfor(J, [&](int j)
     {
-      // Make COPY of the observations with only relevant data points, p > 0.5
-      mapidx[j] = partX(X[j], (qZ[j].col(k).array()>0.5), Xk[j]);  // Copy :-(
-      Mtot += Xk[j].rows();
+      // Gather the observations with only relevant data points, p > 0.5
+      mapidx[j] = partobs(X[j], (qZ[j].col(k).array()>0.5), Xkbuf[j], Xk[j]);
+      Mj(j) = Xk[j].rows();
 
       // Initial cluster split
       ArrayXb splitk = clusters[k].splitobs(Xk[j]);
@@ -300,8 +291,10 @@ template <class W, class C> bool split_ex (
       qZref[j].col(1) = (splitk == false).cast<double>();
 
       // keep a track of number of splits
-      scount += splitk.count();
-    }
+      scountj(j) = splitk.count();
+    });
+
+    const int scount = scountj.sum(), Mtot = Mj.sum();
 
     // Don't waste time with clusters that haven't been split sufficiently
     if ( (scount < 2) || (scount > (Mtot-2)) )
@@ -316,9 +309,10 @@ template <class W, class C> bool split_ex (
       continue;
 
     // Map the refined splits back to original whole-data problem
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int j = 0; j < J; ++j)
-      qZaug[j] = augmentqZ(k, mapidx[j], (qZref[j].col(1).array()>0.5), qZ[j]);
+    parfor(J, [&](int j)
+    {
+      auglabels(k, mapidx[j], (qZref[j].col(1).array()>0.5), qZ[j], qZaug[j]);
+    });
 
     // Calculate free energy of this split with ALL data (and refine a bit)
     double Fsplit = vbem<W,C>(X, qZaug, wspl, cspl,  clusters[0].getprior(), 1,
@@ -334,7 +328,7 @@ template <class W, class C> bool split_ex (
     // Record best splits so far
     if (Fsplit < Fbest)
     {
-      qZbest = qZaug;
+      qZbest.swap(qZaug);   // Both hold J matrices, auglabels() resizes them
       Fbest  = Fsplit;
     }
   }
@@ -342,7 +336,7 @@ template <class W, class C> bool split_ex (
   // See if this split actually improves the model
   if ( (Fbest < F) && (abs((F-Fbest)/F) > CONVERGE) )
   {
-    qZ = qZbest;
+    qZ.swap(qZbest);
     return true;
   }
   else
@@ -365,7 +359,7 @@ template <class W, class C> bool split_ex (
  */
 #ifndef EXHAUST_SPLIT
 template <class W, class C> bool split_gr (
-    const vMatrixXd& X,         // Observations
+    const vMapMatrixXd& X,      // Observations
     const vector<W>& weights,   // Group weight distributions
     const vector<C>& clusters,  // Cluster Distributions
     vMatrixXd& qZ,              // Probabilities qZ
@@ -388,38 +382,39 @@ template <class W, class C> bool split_gr (
   vector<GreedOrder> ord(K);
 
   // Get cluster parameters and their free energy
-  #pragma omp parallel for schedule(guided)
-  for (unsigned int k = 0; k < K; ++k)
+  parfor(K, [&](int k)
   {
     ord[k].k     = k;
     ord[k].tally = tally[k];
     ord[k].Fk    = clusters[k].fenergy();
-  }
+  });
 
   // Get cluster likelihoods
-  #pragma omp parallel for schedule(guided)
-  for (unsigned int j = 0; j < J; ++j)
+  MatrixXd LL(J, K);
+  parfor(J, [&](int j)
   {
     // Get cluster weights
     ArrayXd logpi = weights[j].Elogweight();
 
-    // Add in cluster log-likelihood, weighted by responsability
+    // Cluster log-likelihood, weighted by responsability
     for (unsigned int k = 0; k < K; ++k)
-    {
-      double LL = qZ[j].col(k).dot((logpi(k)
+      LL(j, k) = qZ[j].col(k).dot((logpi(k)
                                 + clusters[k].Eloglike(X[j]).array()).matrix());
+  });
 
-      #pragma omp atomic
-      ord[k].Fk -= LL;
-    }
-  }
+  for (unsigned int k = 0; k < K; ++k)
+    ord[k].Fk -= LL.col(k).sum();
 
   // Sort clusters by split tally, then free energy contributions
   sort(ord.begin(), ord.end(), greedcomp);
 
-  // Pre allocate big objects for loops (this makes a runtime difference)
+  // Pre allocate big objects for loops (this makes a runtime difference), the
+  //  partitions and augmented qZ reuse this storage for every split candidate
   vector<ArrayXi> mapidx(J, ArrayXi());
-  vMatrixXd qZref(J, MatrixXd()), qZaug(J,MatrixXd()), Xk(J,MatrixXd());
+  vector<VectorXd> Xkbuf(J, VectorXd());
+  vMapMatrixXd Xk(J, MapMatrixXd(0, 0, X[0].cols()));
+  vMatrixXd qZref(J, MatrixXd()), qZaug(J,MatrixXd());
+  ArrayXi Mj(J), scountj(J);    // Per group observation and split counts
 
   // Loop through each potential cluster in order and split it
   for (vector<GreedOrder>::iterator i = ord.begin(); i < ord.end(); ++i)
@@ -433,14 +428,11 @@ template <class W, class C> bool split_gr (
       continue;
 
     // Now split observations and qZ.
-    int scount = 0, Mtot = 0;
-
-    #pragma omp parallel for schedule(guided) reduction(+ : Mtot, scount)
-    for (unsigned int j = 0; j < J; ++j)
+    parfor(J, [&](int j)
     {
-      // Make COPY of the observations with only relevant data points, p > 0.5
-      mapidx[j] = partobs(X[j], (qZ[j].col(k).array()>0.5), Xk[j]);  // Copy :-(
-      Mtot += Xk[j].rows();
+      // Gather the observations with only relevant data points, p > 0.5
+      mapidx[j] = partobs(X[j], (qZ[j].col(k).array()>0.5), Xkbuf[j], Xk[j]);
+      Mj(j) = Xk[j].rows();
 
       // Initial cluster split
       ArrayXb splitk = clusters[k].splitobs(Xk[j]);
@@ -449,8 +441,10 @@ template <class W, class C> bool split_gr (
       qZref[j].col(1) = (splitk == false).cast<double>();
 
       // keep a track of number of splits
-      scount += splitk.count();
-    }
+      scountj(j) = splitk.count();
+    });
+
+    const int scount = scountj.sum(), Mtot = Mj.sum();
 
     // Don't waste time with clusters that haven't been split sufficiently
     if ( (scount < 2) || (scount > (Mtot-2)) )
@@ -465,9 +459,10 @@ template <class W, class C> bool split_gr (
       continue;
 
     // Map the refined splits back to original whole-data problem
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int j = 0; j < J; ++j)
-      qZaug[j] = auglabels(k, mapidx[j], (qZref[j].col(1).array()>0.5), qZ[j]);
+    parfor(J, [&](int j)
+    {
+      auglabels(k, mapidx[j], (qZref[j].col(1).array()>0.5), qZ[j], qZaug[j]);
+    });
 
     // Calculate free energy of this split with ALL data (and refine a bit)
     double Fsplit = vbem<W,C>(X, qZaug, wspl, cspl,  clusters[0].getprior(), 1,
@@ -483,7 +478,7 @@ template <class W, class C> bool split_gr (
     // Test whether this cluster split is a keeper
     if ( (Fsplit < F) && (abs((F-Fsplit)/F) > CONVERGE) )
     {
-      qZ = qZaug;
+      qZ.swap(qZaug);
       tally[k] = 0;   // Reset tally if successfully split
       return true;
     }
@@ -546,7 +541,7 @@ template <class W, class C> bool prune_clusters (
     weights[j].update(newqZ[j].colwise().sum()); // new weights
   }
 
-  qZ = newqZ;
+  qZ.swap(newqZ);
 
   return true;
 }
@@ -562,7 +557,7 @@ template <class W, class C> bool prune_clusters (
  *  throws: runtime_error if free energy increases.
  */
 template <class W, class C> double cluster (
-    const vMatrixXd& X,           // Observations
+    const vMapMatrixXd& X,        // Observations
     vMatrixXd& qZ,                // Observations to model mixture assignments
     vector<W>& weights,           // Group weight distributions
     vector<C>& clusters,          // Cluster Distributions
@@ -570,12 +565,12 @@ template <class W, class C> double cluster (
     const int maxclusters,        // Maximum number of clusters to search for
     const bool sparse,            // Do sparse updates to groups
     const bool verbose,           // Verbose output
-    const unsigned int nthreads   // Number of threads for OpenMP to use
+    const unsigned int nthreads   // Number of threads for parfor() to use
     )
 {
   if (nthreads < 1)
     throw invalid_argument("Must specify at least one thread for execution!");
-  omp_set_num_threads(nthreads);
+  ThreadScope threads(nthreads);
 
   const unsigned int J = X.size();
 
@@ -647,9 +642,11 @@ double libcluster::learnVDP (
   if (verbose == true)
     cout << "Learning VDP..." << endl; // Print start
 
-  // Make temporary vectors of data to use with cluster()
-  vMatrixXd vecX(1, X);                 // copies :-(
-  vMatrixXd vecqZ;
+  // Make temporary vectors to use with cluster(), these view X rather than
+  //  copying it. qZ is only swapped out once cluster() has succeeded, so it is
+  //  left unchanged if cluster() throws
+  vMapMatrixXd vecX(1, MapMatrixXd(X.data(), X.rows(), X.cols()));
+  vMatrixXd vecqZ(1);
   vector<StickBreak> vecweights(1, weights);
 
   // Perform model learning and selection
@@ -658,7 +655,7 @@ double libcluster::learnVDP (
                                         verbose, nthreads);
 
   // Return final Free energy and qZ
-  qZ = vecqZ[0];                        // copies :-(
+  qZ.swap(vecqZ[0]);
   weights = vecweights[0];
   return F;
 }
@@ -678,9 +675,11 @@ double libcluster::learnBGMM (
   if (verbose == true)
     cout << "Learning Bayesian GMM..." << endl; // Print start
 
-  // Make temporary vectors of data to use with cluster()
-  vMatrixXd vecX(1, X);                   // copies :-(
-  vMatrixXd vecqZ;
+  // Make temporary vectors to use with cluster(), these view X rather than
+  //  copying it. qZ is only swapped out once cluster() has succeeded, so it is
+  //  left unchanged if cluster() throws
+  vMapMatrixXd vecX(1, MapMatrixXd(X.data(), X.rows(), X.cols()));
+  vMatrixXd vecqZ(1);
   vector<Dirichlet> vecweights(1, weights);
 
   // Perform model learning and selection
@@ -689,7 +688,7 @@ double libcluster::learnBGMM (
                                         verbose, nthreads);
 
   // Return final Free energy and qZ
-  qZ = vecqZ[0];                          // copies :-(
+  qZ.swap(vecqZ[0]);
   weights = vecweights[0];
   return F;
 }
@@ -709,9 +708,11 @@ double libcluster::learnDGMM (
   if (verbose == true)
     cout << "Learning Bayesian diagonal GMM..." << endl; // Print start
 
-  // Make temporary vectors of data to use with cluster()
-  vMatrixXd vecX(1, X);                   // copies :-(
-  vMatrixXd vecqZ;
+  // Make temporary vectors to use with cluster(), these view X rather than
+  //  copying it. qZ is only swapped out once cluster() has succeeded, so it is
+  //  left unchanged if cluster() throws
+  vMapMatrixXd vecX(1, MapMatrixXd(X.data(), X.rows(), X.cols()));
+  vMatrixXd vecqZ(1);
   vector<Dirichlet> vecweights(1, weights);
 
   // Perform model learning and selection
@@ -720,7 +721,7 @@ double libcluster::learnDGMM (
                                         verbose, nthreads);
 
   // Return final Free energy and qZ
-  qZ = vecqZ[0];                          // copies :-(
+  qZ.swap(vecqZ[0]);
   weights = vecweights[0];
   return F;
 }
@@ -743,9 +744,11 @@ double libcluster::learnBEMM (
   if (verbose == true)
     cout << "Learning Bayesian EMM..." << endl; // Print start
 
-  // Make temporary vectors of data to use with cluster()
-  vMatrixXd vecX(1, X);                   // copies :-(
-  vMatrixXd vecqZ;
+  // Make temporary vectors to use with cluster(), these view X rather than
+  //  copying it. qZ is only swapped out once cluster() has succeeded, so it is
+  //  left unchanged if cluster() throws
+  vMapMatrixXd vecX(1, MapMatrixXd(X.data(), X.rows(), X.cols()));
+  vMatrixXd vecqZ(1);
   vector<Dirichlet> vecweights(1, weights);
 
   // Perform model learning and selection
@@ -754,7 +757,7 @@ double libcluster::learnBEMM (
                                         verbose, nthreads);
 
   // Return final Free energy and qZ
-  qZ = vecqZ[0];                          // copies :-(
+  qZ.swap(vecqZ[0]);
   weights = vecweights[0];
   return F;
 }
@@ -778,9 +781,9 @@ double libcluster::learnGMC (
   if (verbose == true)
     cout << "Learning " << spnote << "GMC..." << endl;
 
-  return cluster<GDirichlet, GaussWish>(X, qZ, weights, clusters, clusterprior,
-                                        maxclusters, sparse, verbose,
-                                        nthreads);
+  return cluster<GDirichlet, GaussWish>(mapobs(X), qZ, weights, clusters,
+                                        clusterprior, maxclusters, sparse,
+                                        verbose, nthreads);
 }
 
 
@@ -802,8 +805,9 @@ double libcluster::learnSGMC (
   if (verbose == true)
     cout << "Learning " << spnote << "Symmetric GMC..." << endl;
 
-  return cluster<Dirichlet, GaussWish>(X, qZ, weights, clusters, clusterprior,
-                                       maxclusters, sparse, verbose, nthreads);
+  return cluster<Dirichlet, GaussWish>(mapobs(X), qZ, weights, clusters,
+                                       clusterprior, maxclusters, sparse,
+                                       verbose, nthreads);
 }
 
 
@@ -825,9 +829,9 @@ double libcluster::learnDGMC (
   if (verbose == true)
     cout << "Learning " << spnote << "Diagonal GMC..." << endl;
 
-  return cluster<GDirichlet, NormGamma>(X, qZ, weights, clusters, clusterprior,
-                                        maxclusters, sparse, verbose,
-                                        nthreads);
+  return cluster<GDirichlet, NormGamma>(mapobs(X), qZ, weights, clusters,
+                                        clusterprior, maxclusters, sparse,
+                                        verbose, nthreads);
 }
 
 
@@ -854,6 +858,7 @@ double libcluster::learnEGMC (
   if (verbose == true)
     cout << "Learning " << spnote << "Exponential GMC..." << endl;
 
-  return cluster<GDirichlet, ExpGamma>(X, qZ, weights, clusters, clusterprior,
-                                       maxclusters, sparse, verbose, nthreads);
+  return cluster<GDirichlet, ExpGamma>(mapobs(X), qZ, weights, clusters,
+                                       clusterprior, maxclusters, sparse,
+                                       verbose, nthreads);
 }
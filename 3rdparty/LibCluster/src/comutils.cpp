@@ -18,6 +18,8 @@
  * along with libcluster. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <new>
+#include <atomic>
 #include "comutils.h"
 
 
@@ -32,10 +34,78 @@ using namespace probutils;
 using namespace distributions;
 
 
+//
+//  File scope variables
+//
+
+// Backend for parfor(), NULL for OpenMP
+static atomic<const ParallelFor*> parbackend(NULL);
+
+// Number of threads parfor() uses on this thread
+static thread_local unsigned int parthreads = 1;
+
+
 //
 // Public Functions
 //
 
+void libcluster::setparallelfor (const ParallelFor* backend)
+{
+  parbackend.store(backend);
+}
+
+
+comutils::ThreadScope::ThreadScope (const unsigned int nthreads)
+  : oldthreads(parthreads)
+{
+  parthreads = nthreads;
+}
+
+
+comutils::ThreadScope::~ThreadScope ()
+{
+  parthreads = this->oldthreads;
+}
+
+
+void comutils::parfor (const int N, const function<void (int)>& body)
+{
+  const unsigned int nthreads = parthreads;
+
+  if ((nthreads <= 1) || (N <= 1))
+  {
+    for (int n = 0; n < N; ++n)
+      body(n);
+    return;
+  }
+
+  // Worker threads take the thread count with them for nested loops
+  const function<void (int)> scoped = [&](int n)
+  {
+    ThreadScope threads(nthreads);
+    body(n);
+  };
+
+  const ParallelFor* backend = parbackend.load();
+  if (backend != NULL)
+    (*backend)(N, nthreads, scoped);
+  else
+  {
+    #pragma omp parallel for schedule(guided) num_threads(nthreads)
+    for (int n = 0; n < N; ++n)
+      scoped(n);
+  }
+}
+
+
+double comutils::parsum (const int N, const function<double (int)>& body)
+{
+  ArrayXd terms(N);
+  parfor(N, [&](int n) { terms(n) = body(n); });
+  return terms.sum();
+}
+
+
 void comutils::arrfind (
     const ArrayXb& expression,
     ArrayXi& indtrue,
@@ -53,8 +123,19 @@ void comutils::arrfind (
 }
 
 
+comutils::vMapMatrixXd comutils::mapobs (const vMatrixXd& X)
+{
+  vMapMatrixXd Xv;
+  Xv.reserve(X.size());
+  for (unsigned int j = 0; j < X.size(); ++j)
+    Xv.push_back(MapMatrixXd(X[j].data(), X[j].rows(), X[j].cols()));
+
+  return Xv;
+}
+
+
 ArrayXi comutils::partobs (
-    const MatrixXd& X,
+    const Ref<const MatrixXd>& X,
     const ArrayXb& Xpart,
     MatrixXd& Xk
     )
@@ -72,12 +153,52 @@ ArrayXi comutils::partobs (
 }
 
 
+ArrayXi comutils::partobs (
+    const Ref<const MatrixXd>& X,
+    const ArrayXb& Xpart,
+    VectorXd& buf,
+    MapMatrixXd& Xk
+    )
+{
+  const int M = Xpart.count(),
+            D = X.cols();
+
+  ArrayXi pidx, npidx;
+  comutils::arrfind(Xpart, pidx, npidx);
+
+  if (buf.size() < M*D)
+    buf.resize(M*D);
+
+  Map<MatrixXd> Xpk(buf.data(), M, D);
+  for (int m=0; m < M; ++m)           // index copy X to the buffer
+    Xpk.row(m) = X.row(pidx(m));
+
+  new (&Xk) MapMatrixXd(buf.data(), M, D); // rebind the view (see Eigen::Map)
+
+  return pidx;
+}
+
+
 MatrixXd  comutils::auglabels (
     const double k,
     const ArrayXi& map,
     const ArrayXb& Zsplit,
     const MatrixXd& qZ
     )
+{
+  MatrixXd qZaug;
+  comutils::auglabels(k, map, Zsplit, qZ, qZaug);
+  return qZaug;
+}
+
+
+void comutils::auglabels (
+    const double k,
+    const ArrayXi& map,
+    const ArrayXb& Zsplit,
+    const MatrixXd& qZ,
+    MatrixXd& qZaug
+    )
 {
   const int K = qZ.cols(),
             S = Zsplit.count();
@@ -85,9 +206,9 @@ MatrixXd  comutils::auglabels (
   if (Zsplit.size() != map.size())
     throw invalid_argument("map and split must be the same size!");
 
-  // Create new qZ for all data with split
-  MatrixXd qZaug = qZ;    // Copy the existing qZ into the new
-  qZaug.conservativeResize(Eigen::NoChange, K+1);
+  // Copy the existing qZ into the new, this is a nop resize if it is reused
+  qZaug.resize(qZ.rows(), K+1);
+  qZaug.leftCols(K) = qZ;
   qZaug.col(K).setZero();
 
   ArrayXi sidx, nsidx;
@@ -99,6 +220,4 @@ MatrixXd  comutils::auglabels (
     qZaug(map(sidx(s)), K) = qZ(map(sidx(s)), k); // Add new cluster onto end
     qZaug(map(sidx(s)), k) = 0;
   }
-
-  return qZaug;
 }
@@ -24,6 +24,7 @@
 #include <Eigen/Dense>
 #include <vector>
 #include <stdexcept>
+#include <functional>
 #include "libcluster.h"
 #include "probutils.h"
 #include "distributions.h"
@@ -34,6 +35,18 @@ namespace comutils
 {
 
 
+//
+// Helper types
+//
+
+/* Read-only view of one group's observations. The algorithms take these
+ *  instead of matrices so they can run on caller-owned data, or on partition
+ *  buffers reused between split candidates, without copying.
+ */
+typedef Eigen::Map<const Eigen::MatrixXd> MapMatrixXd;
+typedef std::vector<MapMatrixXd>          vMapMatrixXd;
+
+
 //
 // Helper structures
 //
@@ -49,6 +62,40 @@ struct GreedOrder
 };
 
 
+//
+// Parallel loops
+//
+
+/* Sets the number of threads parfor() uses on the calling thread for the
+ *  lifetime of this object. Without one parfor() runs serially.
+ */
+class ThreadScope
+{
+public:
+
+  explicit ThreadScope (const unsigned int nthreads);
+
+  ~ThreadScope ();
+
+private:
+
+  unsigned int oldthreads;
+};
+
+
+/* Call body(n) for n = 0..N-1 in parallel, on the backend given to
+ *  libcluster::setparallelfor(), or with OpenMP. This uses the thread count of
+ *  the innermost ThreadScope, which is also in effect inside body.
+ */
+void parfor (const int N, const std::function<void (int)>& body);
+
+
+/* As parfor(), but returns the sum of the values of body. The values are
+ *  summed in order of n, so the result does not depend on the scheduling.
+ */
+double parsum (const int N, const std::function<double (int)>& body);
+
+
 //
 // Helper functions
 //
@@ -81,18 +128,41 @@ void arrfind (
     );
 
 
+/* Make views of a vector of observation matrices.
+ *
+ *  returns: one view per group, pointing at the data in X.
+ */
+vMapMatrixXd mapobs (const libcluster::vMatrixXd& X);
+
+
 /* Partition the observations, X according to a logical array.
  *
  *  mutable: Xk, MxD matrix of observations that have a correspoding 1 in Xpart.
  *  returns: an Mx1 array of the locations of Xk in X.
  */
 Eigen::ArrayXi partobs (
-    const Eigen::MatrixXd& X,            // NxD matrix of observations.
+    const Eigen::Ref<const Eigen::MatrixXd>& X, // NxD matrix of observations.
     const distributions::ArrayXb& Xpart, // Nx1 indicator vector to partition X.
     Eigen::MatrixXd& Xk          // MxD matrix of obs. beloning to new partition
     );
 
 
+/* Partition the observations, X according to a logical array, into reusable
+ *  storage. buf only grows, so calling this for every split candidate does not
+ *  allocate once buf holds the largest partition.
+ *
+ *  mutable: buf, holds the MxD partitioned observations (column major).
+ *  mutable: Xk, rebound to view the MxD partitioned observations in buf.
+ *  returns: an Mx1 array of the locations of Xk in X.
+ */
+Eigen::ArrayXi partobs (
+    const Eigen::Ref<const Eigen::MatrixXd>& X, // NxD matrix of observations.
+    const distributions::ArrayXb& Xpart, // Nx1 indicator vector to partition X.
+    Eigen::VectorXd& buf,        // Storage for the partitioned observations
+    MapMatrixXd& Xk              // MxD view of obs. beloning to new partition
+    );
+
+
 /* Augment the assignment matrix, qZ with the split cluster entry.
  *
  * The new cluster assignments are put in the K+1 th column in the return matrix
@@ -107,6 +177,22 @@ Eigen::MatrixXd  auglabels (
     );
 
 
+/* Augment the assignment matrix, qZ with the split cluster entry, into an
+ *  existing matrix. qZaug is only reallocated if it is not already [Nx(K+1)],
+ *  so it can be reused for every split candidate.
+ *
+ *  mutable: qZaug, the new observation assignments, [Nx(K+1)].
+ *  throws: std::invalid_argument if map.size() != Zsplit.size().
+ */
+void auglabels (
+    const double k,               // Cluster to split (i.e. which column of qZ)
+    const Eigen::ArrayXi& map,    // Mapping from array of partitioned obs to qZ
+    const distributions::ArrayXb& Zsplit, // Boolean array of assignments.
+    const Eigen::MatrixXd& qZ,    // [NxK] observation assignment prob. matrix.
+    Eigen::MatrixXd& qZaug        // [Nx(K+1)] augmented assignments
+    );
+
+
 /* Check if any sufficient statistics are empty.
  *
  *  returns: True if any of the sufficient statistics are empty
@@ -76,6 +76,19 @@ ArrayXd enumdims (const int D)
 }
 
 
+/* Fixed column (DIM) view of an observation matrix, so Eigen can unroll the
+ *  per-observation arithmetic in the fixed dimension cluster code.
+ */
+template <int DIM> struct FixedObs
+{
+        typedef Matrix<double, Dynamic, DIM> Mat;
+        typedef Map<const Mat, 0, OuterStride<> > View;
+
+        static View view (const Ref<const MatrixXd>& X)
+        { return View(X.data(), X.rows(), DIM, OuterStride<>(X.outerStride())); }
+};
+
+
 //
 // Stick-Breaking (Dirichlet Process) weight distribution.
 //
@@ -299,13 +312,22 @@ distributions::GaussWish::GaussWish (
 }
 
 
-void distributions::GaussWish::addobs(const VectorXd& qZk, const MatrixXd& X)
+void distributions::GaussWish::addobs(const RefVectorXd& qZk, const RefMatrixXd& X)
 {
         if (X.cols() != this->D)
                 throw invalid_argument("Mismatched dims. of cluster params and obs.!");
         if (qZk.rows() != X.rows())
                 throw invalid_argument("qZk and X ar not the same length!");
 
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: this->addobsfix<2>(qZk, X); return;
+        case 3: this->addobsfix<3>(qZk, X); return;
+        case 4: this->addobsfix<4>(qZk, X); return;
+        }
+#endif
+
         MatrixXd qZkX = qZk.asDiagonal() * X;
 
         this->N_s += qZk.sum();
@@ -316,6 +338,15 @@ void distributions::GaussWish::addobs(const VectorXd& qZk, const MatrixXd& X)
 
 void distributions::GaussWish::update ()
 {
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: this->updatefix<2>(); return;
+        case 3: this->updatefix<3>(); return;
+        case 4: this->updatefix<4>(); return;
+        }
+#endif
+
         // Prepare the Sufficient statistics
         RowVectorXd xk = RowVectorXd::Zero(this->D);
         if (this->N_s > 0)
@@ -354,8 +385,62 @@ void distributions::GaussWish::clearobs ()
 }
 
 
-VectorXd distributions::GaussWish::Eloglike (const MatrixXd& X) const
+template <int DIM>
+void distributions::GaussWish::addobsfix (const RefVectorXd& qZk,
+                                          const RefMatrixXd& X)
+{
+        const typename FixedObs<DIM>::View Xf = FixedObs<DIM>::view(X);
+        const typename FixedObs<DIM>::Mat qZkX = qZk.asDiagonal() * Xf;
+        const Matrix<double, DIM, DIM> xx = qZkX.transpose() * Xf;
+
+        this->N_s  += qZk.sum();
+        this->x_s  += qZkX.colwise().sum();
+        this->xx_s += xx;
+}
+
+
+template <int DIM>
+void distributions::GaussWish::updatefix ()
+{
+        typedef Matrix<double, 1, DIM> RowDIM;
+        typedef Matrix<double, DIM, DIM> MatDIM;
+
+        // Prepare the Sufficient statistics
+        const RowDIM x_s = this->x_s, m_p = this->m_p;
+        RowDIM xk = RowDIM::Zero();
+        if (this->N_s > 0)
+                xk = x_s/this->N_s;
+        const MatDIM Sk = MatDIM(this->xx_s) - xk.transpose() * x_s;
+        const RowDIM xk_m = xk - m_p;              // for iW, (xk - m)
+
+        // Update posterior params
+        this->N    = this->N_s;
+        this->nu   = this->nu_p + this->N;
+        this->beta = this->beta_p + this->N;
+        this->m    = (this->beta_p * m_p + x_s) / this->beta;
+
+        const MatDIM iWf = MatDIM(this->iW_p) + Sk
+                           + (this->beta_p * this->N/this->beta) * xk_m.transpose() * xk_m;
+        this->iW   = iWf;
+
+        try
+        { this->logdW = -logdet<DIM>(iWf); }
+        catch (invalid_argument e)
+        { throw runtime_error(string("Calc log(det(W)): ").append(e.what())); }
+}
+
+
+VectorXd distributions::GaussWish::Eloglike (const RefMatrixXd& X) const
 {
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: return this->Eloglikefix<2>(X);
+        case 3: return this->Eloglikefix<3>(X);
+        case 4: return this->Eloglikefix<4>(X);
+        }
+#endif
+
         // Expectations of log Gaussian likelihood
         VectorXd E_logX(X.rows());
         double sumpsi = mxdigamma((this->nu+1-enumdims(this->D)).matrix()/2).sum();
@@ -371,10 +456,46 @@ VectorXd distributions::GaussWish::Eloglike (const MatrixXd& X) const
 }
 
 
+template <int DIM>
+VectorXd distributions::GaussWish::Eloglikefix (const RefMatrixXd& X) const
+{
+        if (X.cols() != DIM)
+                throw(string("Calculating Gaussian likelihood: ")
+                      .append("Arguments do not have the same dimensionality"));
+
+        // Same positive definite check as mahaldist, then the inverse in closed
+        //  form so the distance is one small product per observation.
+        const Matrix<double, DIM, DIM> iWf = this->iW;
+        if ((LDLT< Matrix<double, DIM, DIM> >(iWf).vectorD().array() <= 0).any())
+                throw(string("Calculating Gaussian likelihood: ")
+                      .append("Matrix A is not positive definite"));
+        const Matrix<double, DIM, DIM> Wf = iWf.inverse();
+        const Matrix<double, 1, DIM> mf = this->m;
+
+        double sumpsi = 0;
+        for (int d = 1; d <= DIM; ++d)
+                sumpsi += digamma((this->nu + 1 - d) / 2);
+
+        const typename FixedObs<DIM>::Mat Xm = FixedObs<DIM>::view(X).rowwise() - mf;
+        const ArrayXd dist = ((Xm * Wf).array() * Xm.array()).rowwise().sum();
+
+        return 0.5 * (sumpsi + this->logdW - DIM * (1/this->beta + log(pi))
+                      - this->nu * dist).matrix();
+}
+
+
 distributions::ArrayXb distributions::GaussWish::splitobs (
-        const MatrixXd& X
+        const RefMatrixXd& X
         ) const
 {
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: return this->splitobsfix<2>(X);
+        case 3: return this->splitobsfix<3>(X);
+        case 4: return this->splitobsfix<4>(X);
+        }
+#endif
 
         // Find the principle eigenvector using the power method if not done so
         VectorXd eigvec;
@@ -386,6 +507,26 @@ distributions::ArrayXb distributions::GaussWish::splitobs (
 }
 
 
+template <int DIM>
+distributions::ArrayXb distributions::GaussWish::splitobsfix (
+        const RefMatrixXd& X
+        ) const
+{
+        if (X.cols() != DIM)
+                throw invalid_argument("Mismatched dims. of cluster params and obs.!");
+
+        // Find the principle eigenvector using the power method
+        const Matrix<double, DIM, DIM> iWf = this->iW;
+        Matrix<double, DIM, 1> eigvec;
+        eigpower<DIM>(iWf, eigvec);
+
+        // 'split' the observations perpendicular to this eigenvector.
+        const Matrix<double, 1, DIM> mf = this->m;
+        return (((FixedObs<DIM>::view(X).rowwise() - mf)
+                 * eigvec.asDiagonal()).array().rowwise().sum()) >= 0;
+}
+
+
 double distributions::GaussWish::fenergy () const
 {
         const ArrayXd l = enumdims(this->D);
@@ -424,13 +565,22 @@ distributions::NormGamma::NormGamma (
 }
 
 
-void distributions::NormGamma::addobs (const VectorXd& qZk, const MatrixXd& X)
+void distributions::NormGamma::addobs (const RefVectorXd& qZk, const RefMatrixXd& X)
 {
         if (X.cols() != this->D)
                 throw invalid_argument("Mismatched dims. of cluster params and obs.!");
         if (qZk.rows() != X.rows())
                 throw invalid_argument("qZk and X ar not the same length!");
 
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: this->addobsfix<2>(qZk, X); return;
+        case 3: this->addobsfix<3>(qZk, X); return;
+        case 4: this->addobsfix<4>(qZk, X); return;
+        }
+#endif
+
         MatrixXd qZkX = qZk.asDiagonal() * X;
 
         this->N_s  += qZk.sum();
@@ -481,8 +631,30 @@ void distributions::NormGamma::clearobs ()
 }
 
 
-VectorXd distributions::NormGamma::Eloglike (const MatrixXd& X) const
+template <int DIM>
+void distributions::NormGamma::addobsfix (const RefVectorXd& qZk,
+                                          const RefMatrixXd& X)
+{
+        const typename FixedObs<DIM>::View Xf = FixedObs<DIM>::view(X);
+        const typename FixedObs<DIM>::Mat qZkX = qZk.asDiagonal() * Xf;
+
+        this->N_s  += qZk.sum();
+        this->x_s  += qZkX.colwise().sum();
+        this->xx_s += (qZkX.array() * Xf.array()).colwise().sum().matrix();
+}
+
+
+VectorXd distributions::NormGamma::Eloglike (const RefMatrixXd& X) const
 {
+#ifndef NO_FIXED_DIMS
+        switch (this->D)
+        {
+        case 2: return this->Eloglikefix<2>(X);
+        case 3: return this->Eloglikefix<3>(X);
+        case 4: return this->Eloglikefix<4>(X);
+        }
+#endif
+
         // Distance evaluation in the exponent
         VectorXd Xmdist = (X.rowwise() - this->m).array().square().matrix()
                           * this->L.array().inverse().matrix().transpose();
@@ -493,8 +665,26 @@ VectorXd distributions::NormGamma::Eloglike (const MatrixXd& X) const
 }
 
 
+template <int DIM>
+VectorXd distributions::NormGamma::Eloglikefix (const RefMatrixXd& X) const
+{
+        if (X.cols() != DIM)
+                throw(string("Calculating Gaussian likelihood: ")
+                      .append("Arguments do not have the same dimensionality"));
+
+        const Matrix<double, DIM, 1> iLf = this->L.array().inverse().matrix().transpose();
+        const Matrix<double, 1, DIM> mf = this->m;
+
+        const ArrayXd Xmdist = (FixedObs<DIM>::view(X).rowwise() - mf).array()
+                               .square().matrix() * iLf;
+
+        return 0.5 * (DIM * (digamma(this->nu) - log(2 * pi) - 1/this->beta)
+                      - this->logL - this->nu * Xmdist);
+}
+
+
 distributions::ArrayXb distributions::NormGamma::splitobs (
-        const MatrixXd& X
+        const RefMatrixXd& X
         ) const
 {
         // Find location of largest element in L, this is the 'eigenvector'
@@ -531,7 +721,7 @@ distributions::ExpGamma::ExpGamma (const double obsmag, const unsigned int D)
 }
 
 
-void distributions::ExpGamma::addobs (const VectorXd& qZk, const MatrixXd& X)
+void distributions::ExpGamma::addobs (const RefVectorXd& qZk, const RefMatrixXd& X)
 {
         if (X.cols() != this->D)
                 throw invalid_argument("Mismatched dims. of cluster params and obs.!");
@@ -566,7 +756,7 @@ void distributions::ExpGamma::clearobs ()
 }
 
 
-VectorXd distributions::ExpGamma::Eloglike (const MatrixXd& X) const
+VectorXd distributions::ExpGamma::Eloglike (const RefMatrixXd& X) const
 {
         return this->D * digamma(this->a) - this->logb
                - (this->a * X * this->ib.transpose()).array();
@@ -574,7 +764,7 @@ VectorXd distributions::ExpGamma::Eloglike (const MatrixXd& X) const
 
 
 distributions::ArrayXb distributions::ExpGamma::splitobs (
-        const MatrixXd& X
+        const RefMatrixXd& X
         ) const
 {
         ArrayXd XdotL = X;// * (this->a * this->ib).transpose();
@@ -215,24 +215,24 @@ template<class WJ, class WT, class CT, class CK> double vbem (
 
     MatrixXd Ntk = MatrixXd::Zero(T, K); // Clear Sufficient Stats
 
-    // VBM for top-level cluster weights
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int j = 0; j < J; ++j)
+    // VBM for top-level cluster weights, with the bottom-level cluster counts
+    //  of each group summed in group order so they do not depend on the
+    //  scheduling
+    vMatrixXd Ntkj(J, MatrixXd::Zero(T, K));
+    parfor(J, [&](int j)
     {
       // Accumulate suff. stats for bottom-level cluster counts
       for (unsigned int i = 0; i < X[j].size(); ++i)
-      {
-        MatrixXd Ntkji = qY[j].row(i).transpose() * qZ[j][i].colwise().sum();
-        #pragma omp critical
-        Ntk += Ntkji;
-      }
+        Ntkj[j] += qY[j].row(i).transpose() * qZ[j][i].colwise().sum();
 
       weights_j[j].update(qY[j].colwise().sum());
-    }
+    });
+
+    for (unsigned int j = 0; j < J; ++j)
+      Ntk += Ntkj[j];
 
     // VBM for top-level cluster parameters and proportions
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int t = 0; t < T; ++t)
+    parfor(T, [&](int t)
     {
       clusters_t[t].clearobs();                  // Clear Sufficient Stats
 
@@ -241,11 +241,10 @@ template<class WJ, class WT, class CT, class CK> double vbem (
 
       weights_t[t].update(Ntk.row(t));           // Bottom-level cluster counts.
       clusters_t[t].update();
-    }
+    });
 
     // VBM for bottom-level cluster parameters
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int k = 0; k < K; ++k)
+    parfor(K, [&](int k)
     {
       clusters_k[k].clearobs();                  // Clear Sufficient Stats
 
@@ -254,24 +253,26 @@ template<class WJ, class WT, class CT, class CK> double vbem (
           clusters_k[k].addobs(qZ[j][i].col(k), X[j][i]);
 
       clusters_k[k].update();                    // Bottom-level observations
-    }
+    });
 
     // Free energy data fit term accumulators
     double Fz = 0, Fyz = 0;
 
     // VBE for top-level cluster indicators
-    #pragma omp parallel for schedule(guided) reduction(+ : Fyz)
-    for (unsigned int j = 0; j < J; ++j)
-      Fyz += vbeY<WJ,WT,CT>(W[j], qZ[j], weights_j[j], weights_t, clusters_t,
+    Fyz = parsum(J, [&](int j)
+    {
+      return vbeY<WJ,WT,CT>(W[j], qZ[j], weights_j[j], weights_t, clusters_t,
                             qY[j]);
+    });
 
     // VBE for bottom-level cluster indicators
     for (unsigned int j = 0; j < J; ++j)
     {
-      #pragma omp parallel for schedule(guided) reduction(+ : Fz)
-      for (unsigned int i = 0; i < X[j].size(); ++i)
-        Fz += vbeZ<WT,CK>(X[j][i], qY[j].row(i), weights_t, clusters_k, 
-                          qZ[j][i]);
+      Fz += parsum(X[j].size(), [&](int i)
+      {
+        return vbeZ<WT,CK>(X[j][i], qY[j].row(i), weights_t, clusters_k,
+                           qZ[j][i]);
+      });
     }
 
     // Calculate free energy of model
@@ -344,16 +345,16 @@ template <class WJ, class WT, class CT, class CK> bool ssplit (
   // Get bottom-level cluster likelihoods
   for (unsigned int j = 0; j < J; ++j)
   {
-    // Add in cluster log-likelihood, weighted by global responsability
-    #pragma omp parallel for schedule(guided)
-    for (unsigned int i = 0; i < X[j].size(); ++i)
+    // Cluster log-likelihood, weighted by global responsability
+    MatrixXd LL(X[j].size(), K);
+    parfor(X[j].size(), [&](int i)
+    {
       for (unsigned int k = 0; k < K; ++k)
-      {
-        double LL = qZ[j][i].col(k).dot(clusters_k[k].Eloglike(X[j][i]));
+        LL(i, k) = qZ[j][i].col(k).dot(clusters_k[k].Eloglike(X[j][i]));
+    });
 
-        #pragma omp atomic
-        ord[k].Fk -= LL;
-      }
+    for (unsigned int k = 0; k < K; ++k)
+      ord[k].Fk -= LL.col(k).sum();
   }
 
   // Sort clusters by split tally, then free energy contributions
@@ -384,13 +385,13 @@ template <class WJ, class WT, class CT, class CK> bool ssplit (
       qZaug[j].resize(X[j].size());
       Xk[j].resize(X[j].size());
 
-      #pragma omp parallel for schedule(guided) reduction(+ : Mtot, scount)
-      for (unsigned int i = 0; i < X[j].size(); ++i)
+      ArrayXi Mi(X[j].size()), scounti(X[j].size());
+      parfor(X[j].size(), [&](int i)
       {
         // Make COPY of the observations with only relevant data points, p > 0.5
         mapidx[j][i] = partobs(X[j][i], (qZ[j][i].col(k).array()>0.5),
                                Xk[j][i]);
-        Mtot += Xk[j][i].rows();
+        Mi(i) = Xk[j][i].rows();
 
         // Initial cluster split
         ArrayXb splitk = clusters_k[k].splitobs(Xk[j][i]);
@@ -399,8 +400,11 @@ template <class WJ, class WT, class CT, class CK> bool ssplit (
         qZref[j][i].col(1) = (splitk == false).cast<double>();
 
         // keep a track of number of splits
-        scount += splitk.count();
-      }
+        scounti(i) = splitk.count();
+      });
+
+      Mtot   += Mi.sum();
+      scount += scounti.sum();
     }
 
     // Don't waste time with clusters that haven't been split sufficiently
@@ -422,10 +426,11 @@ template <class WJ, class WT, class CT, class CK> bool ssplit (
     // Map the refined splits back to original whole-data problem
     for (unsigned int j = 0; j < J; ++j)
     {
-      #pragma omp parallel for schedule(guided)
-      for (unsigned int i = 0; i < X[j].size(); ++i)
-        qZaug[j][i] = auglabels(k, mapidx[j][i],
-                                (qZref[j][i].col(1).array() > 0.5), qZ[j][i]);
+      parfor(X[j].size(), [&](int i)
+      {
+        auglabels(k, mapidx[j][i], (qZref[j][i].col(1).array() > 0.5),
+                  qZ[j][i], qZaug[j][i]);
+      });
     }
 
     // Calculate free energy of this split with ALL data (and refine a bit)
@@ -443,8 +448,8 @@ template <class WJ, class WT, class CT, class CK> bool ssplit (
     // Test whether this cluster split is a keeper
     if ( (Fs < F) && (abs((F-Fs)/F) > CONVERGE) )
     {
-      qY = qYaug;
-      qZ = qZaug;
+      qY.swap(qYaug);
+      qZ.swap(qZaug);
       tally[k] = 0;   // Reset tally if successfully split
       return true;
     }
@@ -537,12 +542,12 @@ template<class WJ, class WT, class CT, class CK> double mcluster (
     const unsigned int maxT,      // Truncation level for top-level clusters
     const int maxK,               // max number of (bottom) clusters
     const bool verbose,           // Verbose output
-    const unsigned int nthreads   // Number of threads for OpenMP to use
+    const unsigned int nthreads   // Number of threads for parfor() to use
     )
 {
   if (nthreads < 1)
     throw invalid_argument("Must specify at least one thread for execution!");
-  omp_set_num_threads(nthreads);
+  ThreadScope threads(nthreads);
 
   // Do some observation validity checks
   if (W.size() != X.size()) // Same number of groups in observations
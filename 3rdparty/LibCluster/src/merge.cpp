@@ -249,16 +249,101 @@ vector<merge::mixtureComponents> merge::pruneMixtureModel(vector<merge::mixtureC
         return gmm;
 }
 
-vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data, Eigen::MatrixXd qZ, vector<merge::mixtureComponents> priorModel, vector<GaussWish> currModel, StickBreak currWeight, double alpha, int truncLevel)
+// find the root of a component in the union-find forest, with path halving
+static int findRoot(vector<int>& parent, int i)
 {
+        while (parent[i] != i)
+        {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+        }
+        return i;
+}
+
+vector<merge::mixtureComponents> merge::mergeEquivalent(vector<merge::mixtureComponents> gmm, double alpha)
+{
+        const int K = gmm.size();
+
+        // pairwise compatibility graph, the test is not symmetric so either
+        // direction joins a pair
+        vector< vector<char> > equiv(K, vector<char>(K, 0));
+        parfor(K, [&](int i)
+        {
+                for (int j=i+1; j<K; j++)
+                {
+                        equiv[i][j] = checkComponentGMM(gmm[i], gmm[j], alpha)
+                                      || checkComponentGMM(gmm[j], gmm[i], alpha);
+                }
+        });
+
+        // connected components, each rooted at its lowest index
+        vector<int> parent(K);
+        for (int i=0; i<K; i++) { parent[i] = i; }
+        for (int i=0; i<K; i++)
+        {
+                for (int j=i+1; j<K; j++)
+                {
+                        if (!equiv[i][j]) {continue; }
+                        int ri = findRoot(parent, i);
+                        int rj = findRoot(parent, j);
+                        if (ri < rj) { parent[rj] = ri; }
+                        else if (rj < ri) { parent[ri] = rj; }
+                }
+        }
+
+        // collapse each group with one moment matching step --> REF:: [1] Eq. 6, 7
+        vector<merge::mixtureComponents> merged;
+        vector<int> slot(K, -1);
+        vector<double> wsum;
+        for (int i=0; i<K; i++)
+        {
+                int r = findRoot(parent, i);
+                int NP = gmm[i].get<0>();
+                double NPWP = NP*gmm[i].get<2>();
+                Eigen::RowVectorXd MP = gmm[i].get<3>();
+                Eigen::MatrixXd S = NPWP*(gmm[i].get<4>() + MP.transpose()*MP);
+
+                if (slot[r] < 0)
+                {
+                        // the group keeps the total obs. of its first component
+                        slot[r] = merged.size();
+                        merged.push_back(boost::make_tuple(NP, gmm[i].get<1>(), 0.0,
+                                                           NPWP*MP, S));
+                        wsum.push_back(NPWP);
+                }
+                else
+                {
+                        merge::mixtureComponents& g = merged[slot[r]];
+                        g.get<1>() += gmm[i].get<1>();
+                        g.get<3>() += NPWP*MP;
+                        g.get<4>() += S;
+                        wsum[slot[r]] += NPWP;
+                }
+        }
+
+        for (unsigned int g=0; g<merged.size(); g++)
+        {
+                Eigen::RowVectorXd n_mean = merged[g].get<3>()/wsum[g];
+                merged[g].get<2>() = merged[g].get<1>()/(double) merged[g].get<0>();
+                merged[g].get<3>() = n_mean;
+                merged[g].get<4>() = merged[g].get<4>()/wsum[g] - n_mean.transpose()*n_mean;
+        }
+
+        return merged;
+}
+
+vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data, Eigen::MatrixXd qZ, vector<merge::mixtureComponents> priorModel, vector<GaussWish> currModel, StickBreak currWeight, double alpha, int truncLevel, const unsigned int nthreads)
+{
+        if (nthreads < 1)
+                throw invalid_argument("Must specify at least one thread for execution!");
+        ThreadScope threads(nthreads);
+
         vector<merge::mixtureComponents> gmm;
         int dataCard = data.rows();
 
         auto pWeights =  getPriorWeights(priorModel);
         auto cWeights =  currWeight.Elogweight().exp().transpose();
         int cc = 0;
-        vector<int> pModelMatches;
-        vector<int> cModelMatches;
 
         if ( priorModel.size() == 0)
         {
@@ -289,14 +374,16 @@ vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data,
                 m_inc++;
         }
 
+        vector<bool> pModelMatched(priorModel.size(), false);
+        vector<bool> cModelMatched(currModel.size(), false);
+
         for (unsigned int i=0; i<priorModel.size(); i++)
         {
 
                 for (vector<GaussWish>::iterator j = currModel.begin(); j < currModel.end(); ++j)
                 {
-                        if( checkComponent(data, qZ, priorModel[i], *j, cWeights[cc], cc, alpha)
-                            && !(std::find(pModelMatches.begin(), pModelMatches.end(), i) != pModelMatches.end())
-                            && !(std::find(cModelMatches.begin(), cModelMatches.end(), cc) != cModelMatches.end()) )
+                        if( !pModelMatched[i] && !cModelMatched[cc]
+                            && checkComponent(data, qZ, priorModel[i], *j, cWeights[cc], cc, alpha) )
                         {
                                 // merge components
                                 mixtureComponents pModel = priorModel[i];
@@ -333,8 +420,8 @@ vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data,
                                 double w =  (NPWP + NC) /(double) (NP + dataCard);
 
                                 gmm.push_back(boost::make_tuple(NP+dataCard, n, w, n_mean, n_cov));
-                                pModelMatches.push_back(i);
-                                cModelMatches.push_back(cc);
+                                pModelMatched[i] = true;
+                                cModelMatched[cc] = true;
                         }
                         cc+=1;
                 }
@@ -345,7 +432,7 @@ vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data,
         int idx = 0;
         for (vector<GaussWish>::iterator j = currModel.begin(); j < currModel.end(); ++j)
         {
-                if (!(std::find(cModelMatches.begin(), cModelMatches.end(), idx) != cModelMatches.end()))
+                if (!cModelMatched[idx])
                 {
                         Eigen::RowVectorXd MC = j->getmean();
                         Eigen::MatrixXd CC = j->getcov();
@@ -367,7 +454,7 @@ vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data,
         {
                 mixtureComponents pModel;
                 pModel = priorModel[i];
-                if (!(std::find(pModelMatches.begin(), pModelMatches.end(), idx) != pModelMatches.end()))
+                if (!pModelMatched[idx])
                 {
                         int NP = pModel.get<1>();
                         int n = pModel.get<0>() + dataCard;
@@ -382,55 +469,7 @@ vector<merge::mixtureComponents> merge::mergeMixtureModel(Eigen::MatrixXd data,
         }
 
         // Merge equilavent components in new GMM
-        for (unsigned int i=0; i<gmm.size(); i++)
-        {
-                for (unsigned int j=0; j<gmm.size(); j++)
-                {
-                        if (i==j) {continue; }
-                        if (checkComponentGMM(gmm[i], gmm[j], alpha))
-                        {
-
-                                int NP = gmm[i].get<0>();
-                                int n = gmm[i].get<1>();
-                                double WP = gmm[i].get<2>();
-                                Eigen::RowVectorXd MP = gmm[i].get<3>();
-                                Eigen::MatrixXd CM = gmm[i].get<4>();
-                                double NPWP = NP*WP;
-
-                                int NH = gmm[j].get<0>();
-                                int nh = gmm[j].get<1>();
-                                double WH = gmm[j].get<2>();
-                                Eigen::RowVectorXd MH = gmm[j].get<3>();
-                                Eigen::MatrixXd CH = gmm[j].get<4>();
-                                double NHWH = NH*WH;
-
-                                auto denom = NPWP + NHWH;
-
-                                /// update mean --> REF:: [1] Eq. 6
-                                Eigen::RowVectorXd n_mean = (NPWP*MP + NHWH*MH )*(1/denom);
-
-                                Eigen::MatrixXd A = (NPWP*CM + NHWH*CH)*(1/denom);
-
-                                Eigen::MatrixXd cov_p = MP.transpose()*MP;
-                                Eigen::MatrixXd cov_c = MH.transpose()*MH;
-
-                                Eigen::MatrixXd B = ( NPWP*cov_p + NHWH*cov_c )*(1/denom);
-
-                                Eigen::MatrixXd C = n_mean.transpose() * n_mean;
-
-
-                                gmm[i].get<1>() = (n + nh);
-                                gmm[i].get<2>() = gmm[i].get<1>()/(double) (NP);
-                                gmm[i].get<3>() = n_mean;
-                                /// update cov --> REF:: [1] Eq. 7
-                                gmm[i].get<4>() = A + B - C;
-
-                                // remove merged component from global GMM
-                                gmm.erase(gmm.begin() + j);
-                        }
-                }
-
-        }
+        gmm = mergeEquivalent(gmm, alpha);
 
         // prune the model to specified truncation level
         gmm = pruneMixtureModel(gmm, truncLevel);
@@ -40,6 +40,51 @@ const double EIGCONTHRESH = 1.0e-8f;
 const int    MAXITER      = 100;
 
 
+//
+// Private Functions
+//
+
+
+/* The power method iterations of eigpower(), for any size of matrix. */
+template <class M, class V> double powermethod (const M& A, V& eigvec)
+{
+  // Initialise working vectors
+  V v = V::LinSpaced(A.rows(), -1, 1);
+  V oeigvec(A.rows());
+
+  // Initialise eigenvalue and eigenvectors etc
+  double eigval = v.norm();
+  double vdist = numeric_limits<double>::infinity();
+  eigvec = v/eigval;
+
+  // Loop until eigenvector converges or we reach max iterations
+  for (int i=0; (vdist>EIGCONTHRESH) && (i<MAXITER); ++i)
+  {
+    oeigvec = eigvec;
+    v.noalias() = A * oeigvec;
+    eigval = v.norm();
+    eigvec = v/eigval;
+    vdist = (eigvec - oeigvec).norm();
+  }
+
+  return eigval;
+}
+
+
+/* The log determinant of logdet(), for any size of matrix. */
+template <class M> double ldltlogdet (const M& A)
+{
+  // Get the diagonal from a Cholesky decomp.
+  const Matrix<double, M::RowsAtCompileTime, 1> d = A.ldlt().vectorD();
+
+  // Check if A is PD
+  if ((d.array() <= 0).any() == true)
+    throw domain_error("Matrix A is not positive definite.");
+
+  return (d.array().log()).sum();   // ln(det(A)) = sum(log(d))
+}
+
+
 //
 // Public Functions
 //
@@ -111,7 +156,7 @@ MatrixXd probutils::cov (const vector<MatrixXd>& X)
 
 
 VectorXd probutils::mahaldist (
-    const MatrixXd& X,
+    const Ref<const MatrixXd>& X,
     const RowVectorXd& mu,
     const MatrixXd& A
     )
@@ -163,26 +208,16 @@ double probutils::eigpower (const MatrixXd& A, VectorXd& eigvec)
     return A(0,0);
   }
 
-  // Initialise working vectors
-  VectorXd v = VectorXd::LinSpaced(A.rows(), -1, 1);
-  VectorXd oeigvec(A.rows());
+  return powermethod(A, eigvec);
+}
 
-  // Initialise eigenvalue and eigenvectors etc
-  double eigval = v.norm();
-  double vdist = numeric_limits<double>::infinity();
-  eigvec = v/eigval;
 
-  // Loop until eigenvector converges or we reach max iterations
-  for (int i=0; (vdist>EIGCONTHRESH) && (i<MAXITER); ++i)
-  {
-    oeigvec = eigvec;
-    v.noalias() = A * oeigvec;
-    eigval = v.norm();
-    eigvec = v/eigval;
-    vdist = (eigvec - oeigvec).norm();
-  }
-
-  return eigval;
+template <int DIM> double probutils::eigpower (
+    const Matrix<double, DIM, DIM>& A,
+    Matrix<double, DIM, 1>& eigvec
+    )
+{
+  return powermethod(A, eigvec);
 }
 
 
@@ -192,16 +227,25 @@ double probutils::logdet (const MatrixXd& A)
   if (A.rows() != A.cols())
     throw invalid_argument("Matrix A must be square!");
 
-  VectorXd d = A.ldlt().vectorD();  // Get the diagonal from a Cholesky decomp.
+  return ldltlogdet(A);
+}
 
-  // Check if A is PD
-  if ((d.array() <= 0).any() == true)
-    throw domain_error("Matrix A is not positive definite.");
 
-  return (d.array().log()).sum();   // ln(det(A)) = sum(log(d))
+template <int DIM> double probutils::logdet (const Matrix<double, DIM, DIM>& A)
+{
+  return ldltlogdet(A);
 }
 
 
+// The fixed sizes used by the cluster distributions
+template double probutils::eigpower<2> (const Matrix2d&, Vector2d&);
+template double probutils::eigpower<3> (const Matrix3d&, Vector3d&);
+template double probutils::eigpower<4> (const Matrix4d&, Vector4d&);
+template double probutils::logdet<2> (const Matrix2d&);
+template double probutils::logdet<3> (const Matrix3d&);
+template double probutils::logdet<4> (const Matrix4d&);
+
+
 MatrixXd probutils::mxdigamma (const MatrixXd& X)
 {
   const int I = X.rows(),
@@ -19,7 +19,7 @@ Vector GNSSDCSFactor::whitenedError(const gtsam::Values& x,
         const nonBiasStates& q = x.at<nonBiasStates>(k1_);
         const phaseBias& g = x.at<phaseBias>(k2_);
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         Matrix gnssPartials = Z_1x1;
 
         double res_range = (h.transpose() * q) - measured_[0];
@@ -84,7 +84,7 @@ Vector GNSSDCSFactor::unwhitenedError(const gtsam::Values& x,
         const nonBiasStates& q = x.at<nonBiasStates>(k1_);
         const phaseBias& g = x.at<phaseBias>(k2_);
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         Matrix gnssPartials = Z_1x1;
 
         double res_range = (h.transpose() * q) - measured_[0];
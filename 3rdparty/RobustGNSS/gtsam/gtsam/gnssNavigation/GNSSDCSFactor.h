@@ -12,6 +12,7 @@
 #include <gtsam/geometry/Point2.h>
 #include <gtsam/geometry/Point3.h>
 #include <gtsam/linear/GaussianFactor.h>
+#include <gtsam/gnssNavigation/GnssJacobianFactor.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 #include <gtsam/gnssNavigation/nonBiasStates.h>
@@ -55,6 +56,7 @@ GNSSDCSFactor() : measured_() {
 GNSSDCSFactor(Key deltaStates, Key bias, const Vector2 measurement,
               const Point3 satXYZ, const Point3 nomXYZ, Eigen::MatrixXd &model, const Vector2 k) :
         Base(cref_list_of<2>(deltaStates)(bias)), k1_(deltaStates), k2_(bias), k_(k), measured_(measurement), satXYZ_(satXYZ), nomXYZ_(nomXYZ), model_(model), iter_count_(0) {
+        h_ = obsMap(satXYZ, nomXYZ, 1);
 }
 
 virtual ~GNSSDCSFactor() {
@@ -115,26 +117,20 @@ bool active(const gtsam::Values& x) const {
  * \f$ Ax-b \approx h(x+\delta x)-z = h(x) + A \delta x - z \f$
  * Hence \f$ b = z - h(x) = - \mathtt{error\_vector}(x) \f$
  */
-/* This version of linearize recalculates the noise model each time */
+/* This version of linearize recalculates the noise model each time and
+   emits it as whitened rows of a fixed size factor */
 virtual boost::shared_ptr<gtsam::GaussianFactor> linearize(
         const gtsam::Values& x) const {
 
         iter_count_ += 1;
 
         if (!active(x))
-                return boost::shared_ptr<JacobianFactor>();
+                return boost::shared_ptr<GnssJacobianFactor>();
 
         // Call evaluate error to get Jacobians and RHS vector b
         std::vector<Matrix> A(this->size());
         Vector b = unwhitenedError(x, A);
 
-        // Fill in terms, needed to create JacobianFactor below
-        std::vector<std::pair<Key, Matrix> > terms(size());
-        for (size_t j = 0; j < size(); ++j) {
-                terms[j].first = keys()[j];
-                terms[j].second.swap(A[j]);
-        }
-
         // DCS Base scaling of cov.
         double v_range, v_phase;
 
@@ -160,9 +156,9 @@ virtual boost::shared_ptr<gtsam::GaussianFactor> linearize(
                 v_phase = model_(1,1)/scale;
         }
 
-        auto jacobianFactor = GaussianFactor::shared_ptr( new JacobianFactor(terms, -b, noiseModel::Diagonal::Variances((gtsam::Vector(2) << v_range, v_phase).finished()) ));
-
-        return jacobianFactor;
+        // Whiten the rows with the scaled variances
+        return gnssJacobianFactor(k1_, A[0], k2_, A[1], b,
+                                  Vector2(std::sqrt(v_range), std::sqrt(v_phase)));
 }
 
 
@@ -12,7 +12,7 @@ namespace gtsam {
 //***************************************************************************
 Vector GNSSFactor::evaluateError(const nonBiasStates& q, const phaseBias& g, boost::optional<Matrix&> H1, boost::optional<Matrix&> H2) const {
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         Matrix gnssPartials = Z_1x1;
 
         if (H1)
@@ -35,4 +35,17 @@ Vector GNSSFactor::evaluateError(const nonBiasStates& q, const phaseBias& g, boo
         return (Vector(2) << res_range, res_phase).finished();
 }
 
+//***************************************************************************
+boost::shared_ptr<GaussianFactor> GNSSFactor::linearize(const Values& x) const {
+
+        noiseModel::Diagonal::shared_ptr diagonal =
+                boost::dynamic_pointer_cast<noiseModel::Diagonal>(noiseModel_);
+        if (!diagonal || diagonal->isConstrained())
+                return Base::linearize(x);
+
+        Matrix H1, H2;
+        Vector e = evaluateError(x.at<nonBiasStates>(key1()), x.at<phaseBias>(key2()), H1, H2);
+        return gnssJacobianFactor(key1(), H1, key2(), H2, e, diagonal->sigmas());
+}
+
 }  //namespace
@@ -12,6 +12,7 @@
 #include <gtsam/geometry/Point2.h>
 #include <gtsam/geometry/Point3.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssJacobianFactor.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 #include <gtsam/gnssNavigation/nonBiasStates.h>
 
@@ -45,6 +46,7 @@ GNSSFactor(Key deltaStates, Key bias, const Vector2 measurement,
 {
         satXYZ_=satXYZ;
         nomXYZ_=nomXYZ;
+        h_ = obsMap(satXYZ, nomXYZ, 1);
 }
 
 
@@ -66,6 +68,10 @@ Vector evaluateError(const nonBiasStates& q, const phaseBias& g,
                      boost::optional<Matrix&> H1 = boost::none,
                      boost::optional<Matrix&> H2 = boost::none ) const;
 
+/// Linearize to a fixed size factor with whitened rows when the noise model
+/// is diagonal, and as any NoiseModelFactor otherwise.
+virtual boost::shared_ptr<GaussianFactor> linearize(const Values& x) const;
+
 private:
 
 /// Serialization function
@@ -18,7 +18,7 @@ Vector GNSSMultiModalFactor::unwhitenedError(const gtsam::Values& x,
         const nonBiasStates& q = x.at<nonBiasStates>(k1_);
         const phaseBias& g = x.at<phaseBias>(k2_);
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         Matrix gnssPartials = Z_1x1;
 
         double res_range = (h.transpose() * q) - measured_[0];
@@ -89,7 +89,7 @@ Vector GNSSMultiModalFactor::whitenedError(const gtsam::Values& x,
                                            boost::optional<std::vector<Matrix>&> H) const {
 
         Vector res = unwhitenedError(x);
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         Matrix gnssPartials = Z_1x1;
 
         if (H) {
@@ -115,12 +115,17 @@ vector<rnxDataWEl> readGNSS_SingleFreqTmp(const std::string &fileLoc) {
 
 
 vector<faultyRnxData> readGNSSFaulty(const std::string &fileLoc, const double &mean, const double &stdDev, const double &percentFaulty) {
+        return readGNSSFaulty(fileLoc, mean, stdDev, percentFaulty, (unsigned)time( NULL ));
+}
+
+vector<faultyRnxData> readGNSSFaulty(const std::string &fileLoc, const double &mean, const double &stdDev, const double &percentFaulty, const unsigned int &seed) {
         /*
            inputs ::
            fileLoc ---> path to data file
            mean --> mean of distribution to generate observation faults
            stdDev --> 1 sigma of observation fault distribution
            percentFaulty --> number of faults to add to data set. scale == [0,1]
+           seed --> seed of the draws that pick the faulty observations
            output ::
            data ---> gnss data in gtsam format
                            { epoch, svn, satXYZ, computed_range, rangeLC, phaseLC }
@@ -137,7 +142,7 @@ vector<faultyRnxData> readGNSSFaulty(const std::string &fileLoc, const double &m
 
         double rangeMag, phaseMag;
 
-        srand( (unsigned)time( NULL ) );
+        srand( seed );
 
         string satType;
         int svn, count, numFault=0, faultInd=0;
@@ -235,13 +240,14 @@ void writeNavFrame(Values &results, Point3 &nom, vector<string> timeIndex, strin
         ofstream outFile(outputFile.c_str());
         // outFile << "/** ENU\n\n *time (sec), e (m), n (m), u (m)\n\n **/" << endl;
         int epoch = 0;
+        GnssReceiver rec(nom);
         Values::ConstFiltered<nonBiasStates> result_poses = results.filter<nonBiasStates>();
         foreach (const Values::ConstFiltered<nonBiasStates>::KeyValuePair& key_value, result_poses)
         {
                 nonBiasStates p = key_value.value;
                 Point3 delta(p.x(),p.y(),p.z());
                 Point3 ecef = (nom - delta);
-                Point3 enu = xyz2enu(ecef,nom);
+                Point3 enu = rec.toENU(ecef);
                 int index = epoch++;
                 outFile << timeIndex[index] << " " << enu.x()
                         << " " << enu.y() << " " << enu.z() << endl;
@@ -16,10 +16,12 @@
 #include <gtsam/base/VectorSpace.h>
 #include <gtsam/robustModels/GNSSSwitch.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
 #include <gtsam/gnssNavigation/nonBiasStates.h>
 
 #include "boost/foreach.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -49,9 +51,24 @@ vector<rnxDataWEl> readGNSS_SingleFreqTmp(const std::string& fileLoc);
 typedef boost::tuple<double, int, int, Point3, double, double, double, int, int> faultyRnxData;
 vector<faultyRnxData> readGNSSFaulty(const std::string& fileLoc, const double& mean, const double& stdDev, const double& percentFaulty);
 
+/// Same fault model, with the faulty observations picked from a fixed seed
+vector<faultyRnxData> readGNSSFaulty(const std::string& fileLoc, const double& mean, const double& stdDev, const double& percentFaulty, const unsigned int& seed);
+
 
 vector<faultyRnxData> readGNSSOracle(const std::string& fileLoc, const double& mean, const double& stdDev, const double& percentFaulty);
 
+/// Length of a vector indexed by the svn of the observations in data: one
+/// more than the largest svn, and at least 34, the size of gnssStateVector.
+/// Works with the tuples of all the readers above, which keep svn at get<2>.
+template<class DATA>
+int svnCount(const vector<DATA>& data) {
+        int count = 34;
+        for (size_t i = 0; i < data.size(); ++i) {
+                count = std::max(count, data[i].template get<2>() + 1);
+        }
+        return count;
+}
+
 /// Write GNSS states to text file
 void writeStates(Values &results, vector<string> timeIndex, string outputFile);
 
@@ -0,0 +1,110 @@
+/**
+ * @file   GnssGeometry.cpp
+ * @brief  Receiver to satellite geometry for all satellites of an epoch at once
+ */
+
+#include <gtsam/gnssNavigation/GnssGeometry.h>
+
+namespace gtsam {
+
+GnssReceiver::GnssReceiver(const Point3& p1) : xyz_(p1) {
+        /*
+           inputs ::
+           p1 --> ECEF xyz receiver coordinates [meter]
+         */
+        llh_ = xyz2llh(p1);
+        double sinPhi = sin(llh_(0));
+        double cosPhi = cos(llh_(0));
+        double sinLam = sin(llh_(1));
+        double cosLam = cos(llh_(1));
+        R_ << (-1*sinLam), cosLam, 0,
+                ((-1*sinPhi)*cosLam), ((-1*sinPhi)*sinLam), cosPhi,
+                (cosPhi*cosLam), (cosPhi*sinLam), sinPhi;
+        tropDry_ = gtsam::tropDry(p1);
+}
+
+Point3 GnssReceiver::toENU(const Point3& p1) const {
+        Vector3 posDiff = p1 - xyz_;
+        Vector3 pos = R_*posDiff;
+        return Point3(pos(0), pos(1), pos(2));
+}
+
+Point3 GnssReceiver::toECEF(const Point3& p1) const {
+        Vector3 enu(p1.x(), p1.y(), p1.z());
+        Vector3 deltaXYZ = R_.transpose()*enu;
+        return xyz_ + Point3(deltaXYZ(0), deltaXYZ(1), deltaXYZ(2));
+}
+
+double GnssReceiver::elevation(const Point3& p1) const {
+        Point3 posENU = toENU(p1);
+        double norm = sqrt(posENU.x()*posENU.x() + posENU.y()*posENU.y() + posENU.z()*posENU.z());
+        return std::atan2(posENU.z(), norm);
+}
+
+double GnssReceiver::elDepWeight(const Point3& p1, double measWeight) const {
+        return (1 / ( sin(elevation(p1)) )) * measWeight;
+}
+
+void gnssGeometry(const Matrix& sats, const GnssReceiver& rec, GnssGeometry& geom) {
+        /*
+           inputs ::
+           sats --> n x 3 ECEF xyz satellite coordinates [meter]
+           rec --> receiver terms, computed once for all satellites
+           outputs ::
+           geom --> mapping rows, ranges, elevations, troposphere maps,
+                    weights and ENU coordinates of every satellite
+         */
+        const int n = static_cast<int>(sats.rows());
+        const Point3& p = rec.xyz();
+        const Matrix3& R = rec.R();
+
+        // Each step works on whole columns, so Eigen evaluates it with
+        // packet (SIMD) operations where the scalar type allows it.
+        Eigen::ArrayXd dx = sats.col(0).array() - p.x();
+        Eigen::ArrayXd dy = sats.col(1).array() - p.y();
+        Eigen::ArrayXd dz = sats.col(2).array() - p.z();
+        Eigen::ArrayXd r = (dx*dx + dy*dy + dz*dz).sqrt();
+
+        Eigen::ArrayXd e = R(0,0)*dx + R(0,1)*dy + R(0,2)*dz;
+        Eigen::ArrayXd nn = R(1,0)*dx + R(1,1)*dy + R(1,2)*dz;
+        Eigen::ArrayXd u = R(2,0)*dx + R(2,1)*dy + R(2,2)*dz;
+        Eigen::ArrayXd enuNorm = (e*e + nn*nn + u*u).sqrt();
+
+        geom.range = r.matrix();
+        geom.enu.resize(n, 3);
+        geom.enu.col(0) = e.matrix();
+        geom.enu.col(1) = nn.matrix();
+        geom.enu.col(2) = u.matrix();
+
+        geom.el.resize(n);
+        for (int i = 0; i < n; i++) {
+                geom.el(i) = std::atan2(u(i), enuNorm(i));
+        }
+        geom.map = tropMap(geom.el);
+        geom.elWeight = (1.0/geom.el.array().sin()).matrix();
+
+        geom.H.resize(n, 5);
+        geom.H.col(0) = (dx/r).matrix();
+        geom.H.col(1) = (dy/r).matrix();
+        geom.H.col(2) = (dz/r).matrix();
+        geom.H.col(3).setOnes();
+        geom.H.col(4) = geom.map;
+}
+
+GnssGeometry gnssGeometry(const Matrix& sats, const GnssReceiver& rec) {
+        GnssGeometry geom;
+        gnssGeometry(sats, rec, geom);
+        return geom;
+}
+
+Matrix satelliteArray(const std::vector<Point3>& sats) {
+        Matrix m(sats.size(), 3);
+        for (size_t i = 0; i < sats.size(); i++) {
+                m(i,0) = sats[i].x();
+                m(i,1) = sats[i].y();
+                m(i,2) = sats[i].z();
+        }
+        return m;
+}
+
+}
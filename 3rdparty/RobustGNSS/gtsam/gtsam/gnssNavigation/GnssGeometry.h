@@ -0,0 +1,100 @@
+/**
+ * @file   GnssGeometry.h
+ * @brief  Receiver to satellite geometry for all satellites of an epoch at once
+ */
+
+#pragma once
+
+#include <gtsam/config.h>
+#include <gtsam/dllexport.h>
+#include <gtsam/base/Vector.h>
+#include <gtsam/base/Matrix.h>
+#include <gtsam/geometry/Point3.h>
+#include <gtsam/gnssNavigation/GnssTools.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/// Terms of one receiver position that are shared by every satellite it
+/// sees: geodetic coordinates, ECEF to ENU rotation and dry troposphere
+/// delay. Build it once per receiver position instead of letting xyz2enu,
+/// calcEl and tropDry recompute them for each satellite.
+class GTSAM_EXPORT GnssReceiver {
+
+public:
+
+GnssReceiver() : tropDry_(0.0) {
+        R_.setIdentity();
+}
+
+/// p1 --> ECEF xyz receiver coordinates [meter]
+explicit GnssReceiver(const Point3& p1);
+
+/// ECEF receiver coordinates [meter]
+const Point3& xyz() const { return xyz_; }
+
+/// latitude, longitude, height [rad,rad,meter], as xyz2llh
+const Vector3& llh() const { return llh_; }
+
+/// rotation from ECEF to ENU, as used by xyz2enu
+const Matrix3& R() const { return R_; }
+
+/// dry troposphere delay [meter], as tropDry
+double tropDry() const { return tropDry_; }
+
+/// ENU coordinates of an ECEF point [meter], as xyz2enu(p1, xyz())
+Point3 toENU(const Point3& p1) const;
+
+/// ECEF coordinates of an ENU point [meter], as enu2xyz(p1, xyz())
+Point3 toECEF(const Point3& p1) const;
+
+/// elevation of a satellite [rad], as calcEl(p1, xyz())
+double elevation(const Point3& p1) const;
+
+/// elevation dependent weight, as elDepWeight(p1, xyz(), measWeight)
+double elDepWeight(const Point3& p1, double measWeight) const;
+
+private:
+
+Point3 xyz_;
+Vector3 llh_;
+Matrix3 R_;
+double tropDry_;
+
+};
+
+/// Geometry of n satellites seen from one receiver. Element (or row) i
+/// belongs to satellite i.
+struct GTSAM_EXPORT GnssGeometry {
+
+        Matrix H;          ///< n x 5 measurement mapping rows, as obsMap(sat, rec, 1)
+        Vector range;      ///< geometric ranges [meter]
+        Vector el;         ///< elevation angles [rad], as calcEl
+        Vector map;        ///< troposphere mapping, as tropMap(el)
+        Vector elWeight;   ///< 1/sin(el); elDepWeight(sat, rec, w) is w*elWeight(i)
+        Matrix enu;        ///< n x 3 ENU coordinates of the satellites [meter]
+
+        size_t size() const { return static_cast<size_t>(range.size()); }
+
+        /// troposphere slant delays [meter], as deltaTrop(sat, rec)
+        Vector tropDelay(const GnssReceiver& rec) const { return map*rec.tropDry(); }
+
+        /// elevation dependent weights, as elDepWeight(sat, rec, measWeight)
+        Vector weights(double measWeight) const { return elWeight*measWeight; }
+};
+
+//// Compute the geometry of all satellites in one pass.
+////
+//// sats --> n x 3 ECEF xyz satellite coordinates [meter]; each column is
+////          contiguous, so x, y and z are separate arrays
+//// rec --> receiver terms
+//// geom --> output, resized to n satellites
+void gnssGeometry(const Matrix& sats, const GnssReceiver& rec, GnssGeometry& geom);
+
+GnssGeometry gnssGeometry(const Matrix& sats, const GnssReceiver& rec);
+
+//// Pack satellite positions as the n x 3 array used by gnssGeometry.
+Matrix satelliteArray(const std::vector<Point3>& sats);
+
+}
@@ -0,0 +1,39 @@
+/**
+ * @file   GnssJacobianFactor.h
+ * @brief  Fixed size linearization shared by the GNSS factors
+ */
+
+#pragma once
+
+#include <gtsam/base/Vector.h>
+#include <gtsam/base/Matrix.h>
+#include <gtsam/inference/Key.h>
+#include <gtsam/linear/BinaryJacobianFactor.h>
+
+namespace gtsam {
+
+/// Linearized GNSS factor: two rows (range, phase) on the five non-bias
+/// states and the one phase bias. Elimination and the Hessian update use
+/// fixed size math for this type.
+typedef BinaryJacobianFactor<2, 5, 1> GnssJacobianFactor;
+
+/// Build the linearized factor with its rows already whitened, so that no
+/// noise model has to be allocated for each linearization.
+///
+/// H1 --> 2 x 5 Jacobian with respect to the non-bias states
+/// H2 --> 2 x 1 Jacobian with respect to the phase bias
+/// error --> unwhitened error h(x) - z
+/// sigmas --> standard deviation of the range and phase rows
+inline boost::shared_ptr<GnssJacobianFactor> gnssJacobianFactor(
+        Key deltaStates, const Matrix& H1, Key bias, const Matrix& H2,
+        const Vector& error, const Vector2& sigmas) {
+
+        const Vector2 invSigmas = sigmas.cwiseInverse();
+        const Eigen::Matrix<double, 2, 5> A1 = invSigmas.asDiagonal() * H1;
+        const Eigen::Matrix<double, 2, 1> A2 = invSigmas.asDiagonal() * H2;
+        const Vector2 b = -invSigmas.cwiseProduct(error);
+
+        return boost::make_shared<GnssJacobianFactor>(deltaStates, A1, bias, A2, b);
+}
+
+}
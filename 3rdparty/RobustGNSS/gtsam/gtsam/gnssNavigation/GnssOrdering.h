@@ -0,0 +1,35 @@
+/**
+ * @file   GnssOrdering.h
+ * @brief  Ordering constraints that keep the newest GNSS states at the ISAM2 root
+ */
+
+#pragma once
+
+#include <gtsam/base/FastMap.h>
+#include <gtsam/inference/Key.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/// Constraint groups for the constrainedKeys argument of ISAM2::update.
+/// Without constraints ISAM2 already puts the keys an update observes in
+/// one last group, so the newest state and the biases in view reach the
+/// root clique either way. These groups split that last group: the active
+/// biases are eliminated next to last and the newest state last, so the
+/// state is always the final frontal of the root. All other affected
+/// variables are ordered freely before them. They also apply to updates
+/// without new factors, which ISAM2 orders unconstrained.
+///
+/// newestState --> key of the non-bias states of the current epoch
+/// activeBiases --> keys of the phase biases observed in the current epoch
+inline FastMap<Key, int> gnssOrderingConstraints(Key newestState,
+                                                 const std::vector<Key>& activeBiases) {
+        FastMap<Key, int> constraints;
+        for (size_t i = 0; i < activeBiases.size(); i++)
+                constraints[activeBiases[i]] = 1;
+        constraints[newestState] = 2;
+        return constraints;
+}
+
+}
@@ -18,18 +18,28 @@ vector<double> getResiduals( Point3& nomXYZ, Values &results, vector<rnxData> da
          * output ::
          *   postFit --> GNSS postfit residuals [vector<double>]
          */
-        unsigned int epoch = 0;
-        unsigned int epochKey = 0;
+        size_t epoch = 0;
+        int epochKey = 0;
         vector<double> postFit;
+        GnssReceiver rec(nomXYZ);
+        GnssGeometry geom;
         Values::ConstFiltered<nonBiasStates> result_poses = results.filter<nonBiasStates>();
         foreach (const Values::ConstFiltered<nonBiasStates>::KeyValuePair& key_value, result_poses) {
                 nonBiasStates q = key_value.value;
-                while ( epochKey == get<1>(data[epoch]) ) {
-                        Vector h = obsMap(get<3>(data[epoch]),nomXYZ, 1);
-                        double est = h.transpose() * q;
-                        double residual = est - (get<5>(data[epoch]) - get<4>(data[epoch]));
+                size_t first = epoch;
+                while ( epoch < data.size() && epochKey == get<1>(data[epoch]) ) { epoch++; }
+
+                // geometry of all satellites of this epoch at once
+                Matrix sats(epoch-first, 3);
+                for (size_t i = first; i < epoch; i++) {
+                        sats.row(i-first) = get<3>(data[i]).transpose();
+                }
+                gnssGeometry(sats, rec, geom);
+
+                for (size_t i = first; i < epoch; i++) {
+                        double est = geom.H.row(i-first) * q;
+                        double residual = est - (get<5>(data[i]) - get<4>(data[i]));
                         postFit.push_back(residual);
-                        epoch++;
                 }
                 epochKey++;
         }
@@ -12,6 +12,7 @@
 #include <gtsam/geometry/Point4.h>
 #include <gtsam/gnssNavigation/GnssData.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
 
 #ifndef FOREACH_HPP
   #define FOREACH_HPP
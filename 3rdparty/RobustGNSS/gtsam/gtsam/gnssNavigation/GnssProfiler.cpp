@@ -0,0 +1,167 @@
+/**
+ * @file   GnssProfiler.cpp
+ * @brief  Per-epoch stage timing of the GNSS estimators, written as a binary trace
+ */
+
+#include <gtsam/gnssNavigation/GnssProfiler.h>
+#include <gtsam/nonlinear/ISAM2.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace gtsam {
+
+namespace {
+
+/// trace layout: magic, version, number of spans, then the spans as stored
+const char traceMagic[8] = {'G', 'N', 'S', 'S', 'P', 'R', 'O', 'F'};
+const uint32_t traceVersion = 1;
+
+const char* stageNames[GNSS_NUM_STAGES] = {
+        "graph_build", "relinearize", "eliminate", "back_substitute",
+        "classify", "vdp", "merge", "output", "epoch"
+};
+
+/// nearest rank percentile of sorted values: the smallest value with at
+/// least p percent of the values at or below it
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p*sorted.size()/100.0));
+        rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted.size());
+        return sorted[rank-1];
+}
+
+}
+
+const char* gnssStageName(int stage) {
+        if (stage < 0 || stage >= GNSS_NUM_STAGES)
+                return "unknown";
+        return stageNames[stage];
+}
+
+GnssProfiler::GnssProfiler(bool enabled) :
+        enabled_(enabled), origin_(std::chrono::steady_clock::now()), epoch_(0),
+        epochStart_(0) {
+        std::fill(start_, start_ + GNSS_NUM_STAGES, 0);
+        std::fill(duration_, duration_ + GNSS_NUM_STAGES, 0);
+        std::fill(active_, active_ + GNSS_NUM_STAGES, false);
+}
+
+uint64_t GnssProfiler::now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - origin_).count();
+}
+
+void GnssProfiler::add(GnssStage stage, uint64_t start, uint64_t duration) {
+        if (!enabled_)
+                return;
+        if (!active_[stage]) {
+                active_[stage] = true;
+                start_[stage] = start;
+        }
+        duration_[stage] += duration;
+}
+
+void GnssProfiler::add(GnssStage stage, double seconds) {
+        if (!enabled_)
+                return;
+        const uint64_t duration = static_cast<uint64_t>(seconds*1e9);
+        const uint64_t end = now();
+        add(stage, end > duration ? end - duration : 0, duration);
+}
+
+void GnssProfiler::add(const ISAM2Result& result) {
+        if (!enabled_ || !result.stageTimes)
+                return;
+        add(GNSS_RELINEARIZE, result.stageTimes->relinearize);
+        add(GNSS_ELIMINATE, result.stageTimes->eliminate);
+        add(GNSS_BACK_SUBSTITUTE, result.stageTimes->backSubstitute);
+}
+
+void GnssProfiler::nextEpoch() {
+        if (!enabled_)
+                return;
+        const uint64_t end = now();
+        add(GNSS_EPOCH, epochStart_, end - epochStart_);
+        for (int s = 0; s < GNSS_NUM_STAGES; s++) {
+                if (!active_[s])
+                        continue;
+                Span span = { epoch_, static_cast<uint32_t>(s), start_[s], duration_[s] };
+                spans_.push_back(span);
+                active_[s] = false;
+                duration_[s] = 0;
+        }
+        ++epoch_;
+        epochStart_ = end;
+}
+
+void GnssProfiler::write(const std::string& file) const {
+        std::ofstream os(file.c_str(), std::ios::binary);
+        const uint64_t n = spans_.size();
+        os.write(traceMagic, sizeof(traceMagic));
+        os.write(reinterpret_cast<const char*>(&traceVersion), sizeof(traceVersion));
+        os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        if (n)
+                os.write(reinterpret_cast<const char*>(&spans_[0]), n*sizeof(Span));
+        if (!os)
+                throw std::runtime_error("GnssProfiler: cannot write " + file);
+}
+
+std::vector<GnssProfiler::Span> GnssProfiler::read(const std::string& file) {
+        std::ifstream is(file.c_str(), std::ios::binary);
+        char magic[sizeof(traceMagic)];
+        uint32_t version(0);
+        uint64_t n(0);
+        is.read(magic, sizeof(magic));
+        is.read(reinterpret_cast<char*>(&version), sizeof(version));
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!is || std::memcmp(magic, traceMagic, sizeof(magic)) != 0 || version != traceVersion)
+                throw std::runtime_error("GnssProfiler: " + file + " is not a profiler trace");
+
+        std::vector<Span> spans(n);
+        if (n)
+                is.read(reinterpret_cast<char*>(&spans[0]), n*sizeof(Span));
+        if (!is)
+                throw std::runtime_error("GnssProfiler: " + file + " is truncated");
+        return spans;
+}
+
+void GnssProfiler::summarize(const std::vector<Span>& spans, std::ostream& os) {
+        std::vector<std::vector<uint64_t> > durations(GNSS_NUM_STAGES);
+        for (size_t i = 0; i < spans.size(); i++)
+                if (spans[i].stage < GNSS_NUM_STAGES)
+                        durations[spans[i].stage].push_back(spans[i].duration);
+
+        const std::ios::fmtflags flags = os.flags();
+        const std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision(3)
+           << std::left << std::setw(16) << "stage" << std::right
+           << std::setw(10) << "epochs" << std::setw(12) << "mean[ms]"
+           << std::setw(12) << "p50[ms]" << std::setw(12) << "p90[ms]"
+           << std::setw(12) << "p99[ms]" << std::setw(12) << "max[ms]" << "\n";
+
+        for (int s = 0; s < GNSS_NUM_STAGES; s++) {
+                std::vector<uint64_t>& d = durations[s];
+                if (d.empty())
+                        continue;
+                std::sort(d.begin(), d.end());
+                double sum = 0.0;
+                for (size_t i = 0; i < d.size(); i++)
+                        sum += d[i];
+                os << std::left << std::setw(16) << gnssStageName(s) << std::right
+                   << std::setw(10) << d.size()
+                   << std::setw(12) << sum/d.size()*1e-6
+                   << std::setw(12) << percentile(d, 50.0)*1e-6
+                   << std::setw(12) << percentile(d, 90.0)*1e-6
+                   << std::setw(12) << percentile(d, 99.0)*1e-6
+                   << std::setw(12) << d.back()*1e-6 << "\n";
+        }
+        os.flags(flags);
+        os.precision(precision);
+}
+
+}
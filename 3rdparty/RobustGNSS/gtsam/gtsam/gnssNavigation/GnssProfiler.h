@@ -0,0 +1,124 @@
+/**
+ * @file   GnssProfiler.h
+ * @brief  Per-epoch stage timing of the GNSS estimators, written as a binary trace
+ */
+
+#pragma once
+
+#include <gtsam/config.h>
+#include <gtsam/dllexport.h>
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace gtsam {
+
+struct ISAM2Result;
+
+/// Stages of one epoch of the estimators. ISAM2 updates are split into
+/// relinearize, eliminate and back-substitute with ISAM2Result::stageTimes.
+enum GnssStage {
+        GNSS_GRAPH_BUILD = 0,
+        GNSS_RELINEARIZE,
+        GNSS_ELIMINATE,
+        GNSS_BACK_SUBSTITUTE,
+        GNSS_CLASSIFY,
+        GNSS_VDP,
+        GNSS_MERGE,
+        GNSS_OUTPUT,
+        GNSS_EPOCH,
+        GNSS_NUM_STAGES
+};
+
+/// name of a stage, as written in the trace
+GTSAM_EXPORT const char* gnssStageName(int stage);
+
+/// Records how long each stage took in each epoch. Time spent in a stage is
+/// summed over the epoch, so the trace holds at most one span per stage and
+/// epoch however often the stage is entered. Recording is a clock read and
+/// an add; a disabled profiler does neither.
+///
+/// Use: a Scope around each stage, nextEpoch() at the end of the epoch and
+/// write() at the end of the run. gnss_profile_summary prints percentiles
+/// per stage from the written trace.
+class GTSAM_EXPORT GnssProfiler {
+
+public:
+
+/// One stage of one epoch [ns since the profiler was made]
+struct Span {
+        uint32_t epoch;
+        uint32_t stage;
+        uint64_t start;
+        uint64_t duration;
+};
+
+/// Adds the time from its construction to stop(), or to its destruction,
+/// to a stage
+class Scope {
+public:
+Scope(GnssProfiler& profiler, GnssStage stage) :
+        profiler_(profiler.enabled() ? &profiler : 0), stage_(stage) {
+        if (profiler_) start_ = profiler_->now();
+}
+~Scope() { stop(); }
+void stop() {
+        if (profiler_) profiler_->add(stage_, start_, profiler_->now() - start_);
+        profiler_ = 0;
+}
+private:
+GnssProfiler* profiler_;
+GnssStage stage_;
+uint64_t start_;
+};
+
+explicit GnssProfiler(bool enabled = true);
+
+bool enabled() const { return enabled_; }
+
+/// ns since the profiler was made
+uint64_t now() const;
+
+/// add duration [ns] to a stage of the current epoch
+void add(GnssStage stage, uint64_t start, uint64_t duration);
+
+/// add a duration measured elsewhere [s]
+void add(GnssStage stage, double seconds);
+
+/// add the relinearize, eliminate and back-substitute times of an ISAM2
+/// update; the ISAM2 needs ISAM2Params::enableStageTimes set
+void add(const ISAM2Result& result);
+
+/// close the current epoch, recording its total time as GNSS_EPOCH
+void nextEpoch();
+
+const std::vector<Span>& spans() const { return spans_; }
+
+/// Write the spans of all closed epochs. Throws std::runtime_error if the
+/// file cannot be written.
+void write(const std::string& file) const;
+
+/// Read a trace written by write(). Throws std::runtime_error if the file
+/// cannot be read or is not a trace.
+static std::vector<Span> read(const std::string& file);
+
+/// Print count, mean, p50, p90, p99 and max [ms] of each stage
+static void summarize(const std::vector<Span>& spans, std::ostream& os);
+
+private:
+
+bool enabled_;
+std::chrono::steady_clock::time_point origin_;
+uint32_t epoch_;
+uint64_t epochStart_;
+uint64_t start_[GNSS_NUM_STAGES];
+uint64_t duration_[GNSS_NUM_STAGES];
+bool active_[GNSS_NUM_STAGES];
+std::vector<Span> spans_;
+
+};
+
+}
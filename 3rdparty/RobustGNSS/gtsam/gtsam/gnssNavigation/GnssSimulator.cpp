@@ -0,0 +1,440 @@
+/**
+ * @file   GnssSimulator.cpp
+ * @brief  Synthetic multi-constellation GNSS data in the estimator input formats
+ */
+
+#include <gtsam/gnssNavigation/GnssSimulator.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
+#include <gtsam/gnssNavigation/GnssTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace gtsam {
+
+namespace {
+
+/// binary layout: magic, version, number of observations, then the
+/// observations as stored
+const char binaryMagic[8] = {'G', 'N', 'S', 'S', 'D', 'A', 'T', 'A'};
+const uint32_t binaryVersion = 1;
+
+const char* constellationNames[GNSS_NUM_CONSTELLATIONS] = {
+        "GPS", "GLONASS", "Galileo", "BeiDou"
+};
+
+/// Nominal Walker layout of each constellation; nodes are offset between
+/// constellations so that their planes do not coincide
+struct Shell {
+        int planes;
+        double radius;       ///< [meter]
+        double inclination;  ///< [deg]
+        double node;         ///< right ascension of the first plane [deg]
+};
+
+const Shell shells[GNSS_NUM_CONSTELLATIONS] = {
+        { 6, 26559.7e3, 55.0, 0.0 },
+        { 3, 25508.2e3, 64.8, 15.0 },
+        { 3, 29599.8e3, 56.0, 40.0 },
+        { 3, 27906.1e3, 55.0, 75.0 }
+};
+
+const double earthMu = 3.986004418e14;       ///< [m^3/s^2]
+const double earthRate = 7.2921151467e-5;    ///< [rad/s]
+const double deg2rad = M_PI/180.0;
+
+/// Run f(begin, end) on ranges of [0, n), one range per thread
+template<class F>
+void parallelFor(size_t n, unsigned int threads, const F& f) {
+        threads = std::max(1u, std::min(threads, static_cast<unsigned int>(n)));
+        if (threads <= 1) {
+                f(0, n);
+                return;
+        }
+        std::vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; t++)
+                workers.push_back(std::thread(f, n*t/threads, n*(t+1)/threads));
+        for (size_t t = 0; t < workers.size(); t++)
+                workers[t].join();
+}
+
+const double powers10[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+
+/// Write an unsigned integer at p and return the end
+char* putUInt(char* p, uint64_t v) {
+        char digits[20];
+        int n = 0;
+        do {
+                digits[n++] = static_cast<char>('0' + v % 10);
+                v /= 10;
+        } while (v);
+        while (n)
+                *p++ = digits[--n];
+        return p;
+}
+
+/// Write v with a fixed number of decimals (at most 6) at p and return the
+/// end. Much faster than snprintf's exact rounding, which would otherwise
+/// dominate writing text; the last digit may differ from printf's for values
+/// half way between two.
+char* putFixed(char* p, double v, int decimals) {
+        if (v < 0.0) {
+                *p++ = '-';
+                v = -v;
+        }
+        const uint64_t scale = static_cast<uint64_t>(powers10[decimals]);
+        const uint64_t scaled = static_cast<uint64_t>(v*powers10[decimals] + 0.5);
+        p = putUInt(p, scaled/scale);
+        if (decimals > 0) {
+                *p++ = '.';
+                uint64_t frac = scaled % scale;
+                for (int d = decimals - 1; d >= 0; d--) {
+                        p[d] = static_cast<char>('0' + frac % 10);
+                        frac /= 10;
+                }
+                p += decimals;
+        }
+        return p;
+}
+
+char* putText(char* p, const char* s) {
+        while (*s)
+                *p++ = *s++;
+        return p;
+}
+
+/// Format observations [begin, end) as text lines of the given format:
+/// week sow epoch type svn range phase rho cb rel grav_delay trop_slant
+/// [iono_slant] windup satPC satX satY satZ break_flag c1Del [c2Del]
+void formatText(const std::vector<GnssSimObservation>& obs, size_t begin, size_t end,
+                const GnssSimParams& params, GnssSimFormat format, std::string& text) {
+        const char* zeros = format == GNSS_TEXT_SINGLE_FREQ ? " 0 0 0 0 0 0 0 " : " 0 0 0 0 0 0 ";
+        const char* tail = format == GNSS_TEXT_SINGLE_FREQ ? " 0\n" : " 0 0\n";
+        char line[512];
+        text.clear();
+        text.reserve((end - begin)*160);
+        for (size_t i = begin; i < end; i++) {
+                const GnssSimObservation& o = obs[i];
+                char* p = line;
+                p = putUInt(p, static_cast<uint64_t>(std::max(params.week, 0)));
+                *p++ = ' ';
+                p = putFixed(p, o.sow, 3);
+                *p++ = ' ';
+                p = putUInt(p, o.epoch);
+                *p++ = ' ';
+                p = putText(p, constellationNames[o.constellation]);
+                *p++ = ' ';
+                p = putUInt(p, o.svn);
+                *p++ = ' ';
+                p = putFixed(p, o.range, 4);
+                *p++ = ' ';
+                p = putFixed(p, o.phase, 4);
+                *p++ = ' ';
+                p = putFixed(p, o.rho, 4);
+                p = putText(p, zeros);
+                p = putFixed(p, o.satXYZ[0], 4);
+                *p++ = ' ';
+                p = putFixed(p, o.satXYZ[1], 4);
+                *p++ = ' ';
+                p = putFixed(p, o.satXYZ[2], 4);
+                *p++ = ' ';
+                p = putUInt(p, o.arc);
+                p = putText(p, tail);
+                text.append(line, p - line);
+        }
+}
+
+}
+
+const char* gnssConstellationName(int constellation) {
+        if (constellation < 0 || constellation >= GNSS_NUM_CONSTELLATIONS)
+                return "unknown";
+        return constellationNames[constellation];
+}
+
+GnssSimParams::GnssSimParams() :
+        nomXYZ(856215.0, -4843097.0, 4047924.0), offset(Vector3::Zero()),
+        trajectory(GNSS_STATIC), speed(0.0), radius(0.0), heading(0.0),
+        hours(1.0), rate(1.0), week(2000), sow(0.0),
+        elevationMask(10.0*deg2rad),
+        rangeSigma(0.5), phaseSigma(0.005), clockSigma(0.5), zwd(0.1),
+        zwdSigma(1e-4), ambiguitySigma(10.0),
+        multipathSigma(0.0), multipathTau(60.0),
+        nlosRate(0.0), nlosDuration(30.0), nlosMean(25.0), nlosStdDev(5.0),
+        slipRate(0.0), seed(42), threads(0) {
+        satellites[GNSS_GPS] = 32;
+        satellites[GNSS_GLONASS] = 24;
+        satellites[GNSS_GALILEO] = 30;
+        satellites[GNSS_BEIDOU] = 27;
+}
+
+GnssSimulator::GnssSimulator(const GnssSimParams& params) :
+        params_(params), nominal_(params.nomXYZ), epoch_(0), clock_(0.0), zwd_(params.zwd) {
+        if (params_.rate <= 0.0 || params_.hours < 0.0)
+                throw std::invalid_argument("GnssSimulator: rate must be positive and hours not negative");
+        if (params_.threads == 0)
+                params_.threads = std::max(1u, std::thread::hardware_concurrency());
+        numEpochs_ = static_cast<size_t>(params_.hours*3600.0*params_.rate + 0.5);
+
+        // satellite i of a constellation of n on P planes sits in plane i % P,
+        // slot i / P, with Walker phasing of one slot spacing over all planes
+        for (int c = 0; c < GNSS_NUM_CONSTELLATIONS; c++) {
+                const Shell& shell = shells[c];
+                const int n = std::max(params_.satellites[c], 0);
+                const int perPlane = (n + shell.planes - 1)/shell.planes;
+                for (int i = 0; i < n; i++) {
+                        const int plane = i % shell.planes, slot = i / shell.planes;
+                        Satellite sat;
+                        sat.constellation = GnssConstellation(c);
+                        sat.svn = 100*c + i + 1;
+                        sat.radius = shell.radius;
+                        sat.inclination = shell.inclination*deg2rad;
+                        sat.node = shell.node*deg2rad + 2.0*M_PI*plane/shell.planes;
+                        sat.anomaly = 2.0*M_PI*slot/perPlane
+                                      + 2.0*M_PI*plane/(perPlane*shell.planes);
+                        sat.meanMotion = sqrt(earthMu/(shell.radius*shell.radius*shell.radius));
+                        std::seed_seq seq = { params_.seed, static_cast<unsigned int>(sat.svn) };
+                        sat.rng.seed(seq);
+                        sat.inView = sat.nlos = false;
+                        sat.arc = 0;
+                        sat.ambiguity = sat.multipath = sat.nlosBias = 0.0;
+                        sats_.push_back(sat);
+                }
+        }
+        std::seed_seq seq = { params_.seed, 0u };
+        rng_.seed(seq);
+}
+
+Point3 GnssSimulator::satellitePosition(size_t sat, double t) const {
+        const Satellite& s = sats_[sat];
+        const double u = s.anomaly + s.meanMotion*t;
+        const double node = s.node - earthRate*t;
+        const double cu = cos(u), su = sin(u), cn = cos(node), sn = sin(node);
+        const double ci = cos(s.inclination), si = sin(s.inclination);
+        return Point3(s.radius*(cu*cn - su*ci*sn),
+                      s.radius*(cu*sn + su*ci*cn),
+                      s.radius*su*si);
+}
+
+Point3 GnssSimulator::receiverPosition(double t) const {
+        Vector3 enu = params_.offset;
+        const double d = params_.speed*t;
+        if (params_.trajectory == GNSS_LINE) {
+                enu(0) += d*sin(params_.heading);
+                enu(1) += d*cos(params_.heading);
+        }
+        else if (params_.trajectory == GNSS_CIRCLE && params_.radius > 0.0) {
+                const double angle = d/params_.radius;
+                enu(0) += params_.radius*(cos(angle) - 1.0);
+                enu(1) += params_.radius*sin(angle);
+        }
+        return nominal_.toECEF(Point3(enu(0), enu(1), enu(2)));
+}
+
+bool GnssSimulator::next(size_t maxEpochs, std::vector<GnssSimObservation>& obs,
+                         std::vector<GnssSimTruth>& truth) {
+        obs.clear();
+        truth.clear();
+        const size_t n = std::min(maxEpochs, numEpochs_ - epoch_);
+        if (n == 0)
+                return false;
+
+        // the states shared by all satellites come from one stream, in order
+        const double dt = 1.0/params_.rate;
+        for (size_t k = 0; k < n; k++) {
+                const double t = (epoch_ + k)*dt;
+                if (epoch_ + k > 0) {
+                        clock_ += params_.clockSigma*sqrt(dt)*randn_(rng_);
+                        zwd_ += params_.zwdSigma*sqrt(dt)*randn_(rng_);
+                }
+                GnssSimTruth epoch = { params_.sow + t, static_cast<uint32_t>(epoch_ + k),
+                                       receiverPosition(t), clock_, zwd_ };
+                truth.push_back(epoch);
+        }
+
+        // one slot per epoch and satellite, filled by the satellite's thread
+        const size_t nSats = sats_.size();
+        std::vector<GnssSimObservation> block(n*nSats);
+        std::vector<std::vector<bool> > valid(nSats, std::vector<bool>(n, false));
+        parallelFor(nSats, params_.threads, [&](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; s++)
+                        simulate(s, truth, block, valid[s]);
+        });
+
+        for (size_t k = 0; k < n; k++)
+                for (size_t s = 0; s < nSats; s++)
+                        if (valid[s][k])
+                                obs.push_back(block[k*nSats + s]);
+        epoch_ += n;
+        return true;
+}
+
+void GnssSimulator::simulate(size_t sat, const std::vector<GnssSimTruth>& truth,
+                             std::vector<GnssSimObservation>& block, std::vector<bool>& valid) {
+        Satellite& s = sats_[sat];
+        const double dt = 1.0/params_.rate;
+        const double mpPhi = params_.multipathTau > 0.0 ? exp(-dt/params_.multipathTau) : 0.0;
+        const double mpSigma = params_.multipathSigma*sqrt(1.0 - mpPhi*mpPhi);
+        const double pNlos = params_.nlosRate/3600.0*dt;
+        const double pClear = params_.nlosDuration > 0.0 ? std::min(dt/params_.nlosDuration, 1.0) : 1.0;
+        const double pSlip = params_.slipRate/3600.0*dt;
+        std::uniform_real_distribution<double> randu;
+
+        for (size_t k = 0; k < truth.size(); k++) {
+                const double t = truth[k].sow - params_.sow;
+                const Point3 satXYZ = satellitePosition(sat, t);
+                const Point3 rxXYZ = truth[k].xyz;
+                const Point3 los = nominal_.toENU(satXYZ) - nominal_.toENU(rxXYZ);
+                const double el = atan2(los.z(), los.norm());
+                if (el < params_.elevationMask) {
+                        s.inView = false;
+                        continue;
+                }
+
+                // a rising satellite starts a new arc with fresh multipath; a
+                // cycle slip only starts a new arc
+                if (!s.inView) {
+                        s.inView = true;
+                        ++s.arc;
+                        s.ambiguity = params_.ambiguitySigma*s.randn(s.rng);
+                        s.multipath = params_.multipathSigma*s.randn(s.rng);
+                }
+                else {
+                        if (pSlip > 0.0 && randu(s.rng) < pSlip) {
+                                ++s.arc;
+                                s.ambiguity = params_.ambiguitySigma*s.randn(s.rng);
+                        }
+                        s.multipath = mpPhi*s.multipath + mpSigma*s.randn(s.rng);
+                }
+
+                if (s.nlos) {
+                        if (randu(s.rng) < pClear)
+                                s.nlos = false;
+                }
+                else if (pNlos > 0.0 && randu(s.rng) < pNlos) {
+                        s.nlos = true;
+                        s.nlosBias = std::max(0.0, params_.nlosMean + params_.nlosStdDev*s.randn(s.rng));
+                }
+                const double extra = s.nlos ? s.nlosBias : 0.0;
+
+                const double geometric = (satXYZ - rxXYZ).norm() + truth[k].clock
+                                         + tropMap(el)*truth[k].zwd + extra;
+                GnssSimObservation& o = block[k*sats_.size() + sat];
+                o.sow = truth[k].sow;
+                o.epoch = truth[k].epoch;
+                o.constellation = static_cast<uint16_t>(s.constellation);
+                o.svn = static_cast<uint16_t>(s.svn);
+                o.satXYZ[0] = satXYZ.x();
+                o.satXYZ[1] = satXYZ.y();
+                o.satXYZ[2] = satXYZ.z();
+                o.rho = (satXYZ - params_.nomXYZ).norm();
+                o.range = geometric + s.multipath + params_.rangeSigma*s.randn(s.rng);
+                o.phase = geometric + s.ambiguity + 0.01*s.multipath
+                          + params_.phaseSigma*s.randn(s.rng);
+                o.arc = s.arc;
+                o.fault = s.nlos ? 1 : 0;
+                valid[k] = true;
+        }
+}
+
+size_t writeGnssSim(GnssSimulator& sim, const std::string& file, GnssSimFormat format,
+                    const std::string& truthFile) {
+        std::ofstream os(file.c_str(), std::ios::binary);
+        if (!os)
+                throw std::runtime_error("writeGnssSim: cannot write " + file);
+        std::ofstream ts;
+        if (!truthFile.empty()) {
+                ts.open(truthFile.c_str());
+                if (!ts)
+                        throw std::runtime_error("writeGnssSim: cannot write " + truthFile);
+        }
+
+        // the count is filled in once the observations are written
+        uint64_t count = 0;
+        if (format == GNSS_BINARY) {
+                os.write(binaryMagic, sizeof(binaryMagic));
+                os.write(reinterpret_cast<const char*>(&binaryVersion), sizeof(binaryVersion));
+                os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+
+        // a few seconds of data per block keeps every thread busy without
+        // holding the whole dataset in memory
+        const size_t blockEpochs = std::max(static_cast<size_t>(60.0*sim.params().rate), static_cast<size_t>(1));
+        const unsigned int threads = sim.params().threads;
+        std::vector<GnssSimObservation> obs;
+        std::vector<GnssSimTruth> truth;
+        std::vector<std::string> text(threads);
+        char line[256];
+
+        while (sim.next(blockEpochs, obs, truth)) {
+                if (format == GNSS_BINARY) {
+                        if (!obs.empty())
+                                os.write(reinterpret_cast<const char*>(&obs[0]), obs.size()*sizeof(GnssSimObservation));
+                }
+                else {
+                        const size_t n = obs.size();
+                        parallelFor(threads, threads, [&](size_t begin, size_t end) {
+                                for (size_t t = begin; t < end; t++)
+                                        formatText(obs, n*t/threads, n*(t+1)/threads, sim.params(), format, text[t]);
+                        });
+                        for (size_t t = 0; t < text.size(); t++)
+                                os.write(text[t].data(), text[t].size());
+                }
+                count += obs.size();
+
+                for (size_t k = 0; ts.is_open() && k < truth.size(); k++) {
+                        const GnssSimTruth& e = truth[k];
+                        const int n = snprintf(line, sizeof(line), "%u %.3f %.4f %.4f %.4f %.4f %.6f\n",
+                                               e.epoch, e.sow, e.xyz.x(), e.xyz.y(), e.xyz.z(), e.clock, e.zwd);
+                        ts.write(line, n);
+                }
+        }
+
+        if (format == GNSS_BINARY) {
+                os.seekp(sizeof(binaryMagic) + sizeof(binaryVersion));
+                os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+        if (!os || (ts.is_open() && !ts))
+                throw std::runtime_error("writeGnssSim: cannot write " + file);
+        return count;
+}
+
+std::vector<faultyRnxData> readGNSSBinary(const std::string& fileLoc) {
+        std::ifstream is(fileLoc.c_str(), std::ios::binary);
+        char magic[sizeof(binaryMagic)];
+        uint32_t version(0);
+        uint64_t n(0);
+        is.read(magic, sizeof(magic));
+        is.read(reinterpret_cast<char*>(&version), sizeof(version));
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!is || std::memcmp(magic, binaryMagic, sizeof(magic)) != 0 || version != binaryVersion)
+                throw std::runtime_error("readGNSSBinary: " + fileLoc + " is not a binary GNSS file");
+
+        // read in chunks, so a corrupt count cannot reserve more than the file holds
+        std::vector<faultyRnxData> data;
+        std::vector<GnssSimObservation> chunk(65536);
+        while (n > 0) {
+                const size_t m = static_cast<size_t>(std::min<uint64_t>(n, chunk.size()));
+                is.read(reinterpret_cast<char*>(&chunk[0]), m*sizeof(GnssSimObservation));
+                if (!is)
+                        throw std::runtime_error("readGNSSBinary: " + fileLoc + " is truncated");
+                for (size_t i = 0; i < m; i++) {
+                        const GnssSimObservation& o = chunk[i];
+                        data.push_back(faultyRnxData(o.sow, o.epoch, o.svn,
+                                                     Point3(o.satXYZ[0], o.satXYZ[1], o.satXYZ[2]),
+                                                     o.rho, o.range, o.phase, o.arc, o.fault));
+                }
+                n -= m;
+        }
+        // the text readers end with a copy of the last observation, which
+        // the examples rely on when they look ahead at data[i+1]
+        if (!data.empty()) data.push_back(data.back());
+        return data;
+}
+
+}
@@ -0,0 +1,201 @@
+/**
+ * @file   GnssSimulator.h
+ * @brief  Synthetic multi-constellation GNSS data in the estimator input formats
+ */
+
+#pragma once
+
+#include <gtsam/config.h>
+#include <gtsam/dllexport.h>
+#include <gtsam/base/Vector.h>
+#include <gtsam/geometry/Point3.h>
+#include <gtsam/gnssNavigation/GnssData.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace gtsam {
+
+/// Constellations of the simulator. Satellite i of constellation c gets
+/// svn 100*c + i + 1, so that svn, which the estimators key the phase
+/// biases on, is unique over all constellations. svn then goes past the 34
+/// entries of gnssStateVector; size svn indexed state with svnCount.
+enum GnssConstellation {
+        GNSS_GPS = 0,
+        GNSS_GLONASS,
+        GNSS_GALILEO,
+        GNSS_BEIDOU,
+        GNSS_NUM_CONSTELLATIONS
+};
+
+/// name of a constellation, as written in the satType column
+GTSAM_EXPORT const char* gnssConstellationName(int constellation);
+
+/// Receiver motion about its start point
+enum GnssTrajectory {
+        GNSS_STATIC = 0,   ///< stays at the start point
+        GNSS_CIRCLE,       ///< drives a horizontal circle through the start point
+        GNSS_LINE          ///< drives a straight horizontal line
+};
+
+/// Output formats of writeGnssSim
+enum GnssSimFormat {
+        GNSS_TEXT = 0,          ///< read with readGNSS
+        GNSS_TEXT_SINGLE_FREQ,  ///< read with readGNSS_SingleFreq
+        GNSS_BINARY             ///< read with readGNSSBinary
+};
+
+/// Settings of a simulated dataset; the defaults are a static receiver at
+/// 1 Hz with 113 satellites and neither multipath nor NLOS
+struct GTSAM_EXPORT GnssSimParams {
+
+        Point3 nomXYZ;          ///< nominal receiver position, as in the conf files [ECEF, meter]
+        Vector3 offset;         ///< start of the trajectory from nomXYZ [ENU, meter]
+        GnssTrajectory trajectory;
+        double speed;           ///< along the circle or line [meter/sec]
+        double radius;          ///< of the circle [meter]
+        double heading;         ///< of the line, clockwise from north [rad]
+
+        double hours;           ///< length of the dataset
+        double rate;            ///< epochs per second
+        int week;               ///< GPS week of the first epoch
+        double sow;             ///< GPS seconds of week of the first epoch
+
+        /// satellites of each constellation, 0 to leave it out; the default
+        /// is 32 GPS, 24 GLONASS, 30 Galileo and 27 BeiDou MEO
+        int satellites[GNSS_NUM_CONSTELLATIONS];
+        double elevationMask;   ///< [rad]
+
+        double rangeSigma;      ///< range white noise [meter]
+        double phaseSigma;      ///< phase white noise [meter]
+        double clockSigma;      ///< receiver clock random walk [meter/sqrt(sec)]
+        double zwd;             ///< zenith wet delay of the first epoch [meter]
+        double zwdSigma;        ///< zenith wet delay random walk [meter/sqrt(sec)]
+        double ambiguitySigma;  ///< phase ambiguity of each new arc [meter]
+
+        double multipathSigma;  ///< steady state sigma of the range multipath, 1/100 of it on phase [meter]
+        double multipathTau;    ///< correlation time of the multipath [sec]
+
+        double nlosRate;        ///< NLOS episodes per satellite and hour
+        double nlosDuration;    ///< mean length of an NLOS episode [sec]
+        double nlosMean;        ///< mean extra path of an NLOS episode [meter]
+        double nlosStdDev;      ///< sigma of the extra path of an NLOS episode [meter]
+        double slipRate;        ///< cycle slips per satellite and hour
+
+        unsigned int seed;
+        unsigned int threads;   ///< worker threads, 0 for all processors
+
+        GnssSimParams();
+
+};
+
+/// One observation. The binary format stores these as they are.
+struct GnssSimObservation {
+        double sow;
+        uint32_t epoch;
+        uint16_t constellation;
+        uint16_t svn;
+        double satXYZ[3];       ///< [ECEF, meter]
+        double rho;             ///< range from nomXYZ, as the rho column [meter]
+        double range;           ///< [meter]
+        double phase;           ///< [meter]
+        uint32_t arc;           ///< break flag, changes when phase lock is lost
+        uint32_t fault;         ///< 1 in an NLOS episode, 0 otherwise
+};
+
+/// True states of one epoch
+struct GnssSimTruth {
+        double sow;
+        uint32_t epoch;
+        Point3 xyz;             ///< receiver position [ECEF, meter]
+        double clock;           ///< receiver clock [meter]
+        double zwd;             ///< zenith wet delay [meter]
+};
+
+/// Simulates range and phase observations of a moving receiver to circular
+/// orbit (Walker) constellations. The receiver clock and zenith wet delay
+/// are random walks shared by all satellites. Each satellite carries its own
+/// ambiguity per arc, first order Gauss-Markov multipath and a two state
+/// Markov NLOS process, which adds a positive extra path to range and phase
+/// while it lasts.
+///
+/// Epochs are simulated in blocks, each block on several threads with a
+/// share of the satellites per thread. Every satellite has a random stream
+/// of its own, seeded from the seed and the satellite, so the data depend on
+/// the seed only, not on the threads or block sizes.
+class GTSAM_EXPORT GnssSimulator {
+
+public:
+
+explicit GnssSimulator(const GnssSimParams& params);
+
+const GnssSimParams& params() const { return params_; }
+
+size_t numSatellites() const { return sats_.size(); }
+
+size_t numEpochs() const { return numEpochs_; }
+
+/// next epoch next() will simulate
+size_t epoch() const { return epoch_; }
+
+GnssConstellation constellation(size_t sat) const { return sats_[sat].constellation; }
+
+int svn(size_t sat) const { return sats_[sat].svn; }
+
+/// position of a satellite t seconds after the first epoch [ECEF, meter]
+Point3 satellitePosition(size_t sat, double t) const;
+
+/// true receiver position t seconds after the first epoch [ECEF, meter]
+Point3 receiverPosition(double t) const;
+
+/// Simulate up to maxEpochs more epochs, replacing the contents of obs and
+/// truth. The observations are in epoch, then satellite order. Returns
+/// false once all epochs have been simulated.
+bool next(size_t maxEpochs, std::vector<GnssSimObservation>& obs,
+          std::vector<GnssSimTruth>& truth);
+
+private:
+
+struct Satellite {
+        GnssConstellation constellation;
+        int svn;
+        double radius, inclination, node, anomaly, meanMotion;
+        std::mt19937 rng;
+        std::normal_distribution<double> randn;  ///< kept, as it caches every other draw
+        bool inView, nlos;
+        uint32_t arc;
+        double ambiguity, multipath, nlosBias;
+};
+
+void simulate(size_t sat, const std::vector<GnssSimTruth>& truth,
+              std::vector<GnssSimObservation>& block, std::vector<bool>& valid);
+
+GnssSimParams params_;
+GnssReceiver nominal_;
+size_t numEpochs_;
+size_t epoch_;
+std::vector<Satellite> sats_;
+std::mt19937 rng_;
+std::normal_distribution<double> randn_;
+double clock_, zwd_;
+
+};
+
+/// Simulate the whole dataset into file, and the truth of each epoch into
+/// truthFile unless it is empty, as "epoch sow x y z clock zwd" lines. Text
+/// lines are formatted on the simulator's threads and written in order.
+/// Returns the number of observations written. Throws std::runtime_error if
+/// a file cannot be written.
+GTSAM_EXPORT size_t writeGnssSim(GnssSimulator& sim, const std::string& file,
+                                 GnssSimFormat format, const std::string& truthFile = "");
+
+/// Read a file written with GNSS_BINARY. The fault flag is the simulated
+/// one. As with the text readers, the last observation is repeated at the
+/// end, so the vector holds one more record than the file.
+/// Throws std::runtime_error if the file cannot be read or is not one.
+GTSAM_EXPORT std::vector<faultyRnxData> readGNSSBinary(const std::string& fileLoc);
+
+}
@@ -83,7 +83,7 @@ Matrix earthToNavTrans( const Point3 &p1){
                     -1*sLat*sLon, cLon, -1*cLat*sLon,
                     cLat, 0.0, -1*sLat ).finished();
 
-        return R.inverse();
+        return R.transpose();
 
 }
 
@@ -190,7 +190,7 @@ Point3 enu2xyz(const Point3& p1, const Point3& p2) {
                      -1*sinPhi*cosLam, -1*sinPhi*sinLam, cosPhi,
                      cosPhi*cosLam, cosPhi*sinLam, sinPhi ).finished();
         Point3 deltaXYZ;
-        deltaXYZ = R.inverse()*p1;
+        deltaXYZ = R.transpose()*p1;
         return p2 + deltaXYZ;
 }
 
@@ -257,6 +257,17 @@ double tropMap(const double& El){
         return m;
 }
 
+Vector tropMap(const Vector& El){
+        /*
+           inputs ::
+           El --> receiver to satellite elevation angles [rad]
+           output ::
+           m --> troposphere delay maps, as tropMap(El(i))
+         */
+        Vector m = 1.001/(0.002001 + El.array().sin().square()).sqrt();
+        return m;
+}
+
 double tropDry(const Point3& p1){
         /*
            inputs ::
@@ -87,6 +87,10 @@ double tropMap(const double& El);
 ////        Satellites for Geodesy
 double tropDry(const Point3& p1);
 
+//// Elevation angle only troposphere mapping for an array of elevation angles,
+//// evaluated element-wise with Eigen array operations.
+Vector tropMap(const Vector& El);
+
 //// time difference carrier-phase observations
 double dopplerObs(const Point3& p1, double tdcp1, const Point3& p2, double tdcp2);
 
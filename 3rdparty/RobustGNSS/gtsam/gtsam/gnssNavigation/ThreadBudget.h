@@ -0,0 +1,113 @@
+/**
+ * @file   ThreadBudget.h
+ * @brief  One thread budget for the estimator and the mixture model learning
+ */
+
+#pragma once
+
+#include <gtsam/config.h>
+
+#include <libcluster/libcluster.h>
+
+#include <boost/scoped_ptr.hpp>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/task_scheduler_init.h>
+#include <tbb/task_arena.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#endif
+
+namespace gtsam {
+
+#ifdef GTSAM_USE_TBB
+namespace internal {
+
+/// Runs LibCluster's loops as TBB tasks. A loop asking for fewer threads
+/// than the budget gets its own arena of that size.
+class TbbParallelFor : public libcluster::ParallelFor {
+
+public:
+
+explicit TbbParallelFor(unsigned int budget) : budget_(budget) {}
+
+virtual void operator()(const int N, const unsigned int nthreads,
+                        const std::function<void (int)>& body) const {
+        auto loop = [&]() {
+                        tbb::parallel_for(tbb::blocked_range<int>(0, N),
+                                          [&](const tbb::blocked_range<int>& r) {
+                                                  for (int n = r.begin(); n != r.end(); ++n)
+                                                          body(n);
+                                          });
+                };
+
+        if (nthreads >= budget_)
+                loop();
+        else {
+                tbb::task_arena arena(static_cast<int>(nthreads));
+                arena.execute(loop);
+        }
+}
+
+private:
+
+unsigned int budget_;
+
+};
+
+}
+#endif
+
+/// Shares one pool of threads between GTSAM (TBB) and LibCluster (OpenMP by
+/// default). While a ThreadBudget lives, TBB runs at most threads() workers
+/// and the parallel loops of the libcluster learn* functions run as TBB
+/// tasks in that same pool, so ISAM2 and learnVDP running side by side do
+/// not oversubscribe the cores. Pass threads() as the nthreads argument of
+/// the learn* functions. Without TBB, LibCluster keeps OpenMP and threads()
+/// is only its thread limit.
+///
+/// Create one, early in main(), before any other use of TBB.
+///
+/// Header only, so that libgtsam does not depend on LibCluster: a program
+/// using ThreadBudget links -lcluster itself.
+class ThreadBudget {
+
+public:
+
+/// nThreads --> total threads to use, or <= 0 for all processors
+explicit ThreadBudget(int nThreads = -1) {
+#ifdef GTSAM_USE_TBB
+        threads_ = (nThreads > 0) ? nThreads
+                   : tbb::task_scheduler_init::default_num_threads();
+        init_.reset(new tbb::task_scheduler_init(threads_));
+        loops_.reset(new internal::TbbParallelFor(threads_));
+        libcluster::setparallelfor(loops_.get());
+#else
+        threads_ = (nThreads > 0) ? nThreads : omp_get_max_threads();
+#endif
+}
+
+/// restores LibCluster's OpenMP loops
+~ThreadBudget() {
+#ifdef GTSAM_USE_TBB
+        libcluster::setparallelfor(NULL);
+#endif
+}
+
+/// number of threads in the budget
+unsigned int threads() const { return threads_; }
+
+private:
+
+ThreadBudget(const ThreadBudget&);
+ThreadBudget& operator=(const ThreadBudget&);
+
+unsigned int threads_;
+#ifdef GTSAM_USE_TBB
+boost::scoped_ptr<tbb::task_scheduler_init> init_;
+boost::scoped_ptr<libcluster::ParallelFor> loops_;
+#endif
+
+};
+
+}
@@ -0,0 +1,138 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGnssGeometry.cpp
+ * @brief   Unit tests of the batched geometry against the per satellite tools
+ */
+
+#include <gtsam/gnssNavigation/GnssGeometry.h>
+#include <gtsam/gnssNavigation/GnssTools.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace example {
+// receivers in the northern and southern hemispheres and near the equator
+vector<Point3> receivers() {
+  vector<Point3> r;
+  r.push_back(Point3(859154.0695, -4836304.2164, 4059971.1525));
+  r.push_back(Point3(-4052052.7349, 4212835.9896, -2545104.6015));
+  r.push_back(Point3(6378137.0 + 120.0, 1000.0, -500.0));
+  return r;
+}
+
+// satellites at GNSS orbit radius, from near the horizon to the zenith of
+// each receiver and at several azimuths
+vector<Point3> satellites(const Point3& rec) {
+  const Vector3 up = Vector3(rec.x(), rec.y(), rec.z()).normalized();
+  const Vector3 east = Vector3(0, 0, 1).cross(up).normalized();
+  const Vector3 north = up.cross(east);
+  const double elevations[] = { 0.1, 0.3, 0.7, 1.2, M_PI/2 - 1e-3 };
+  const double azimuths[] = { 0.0, 1.3, 2.9, 4.4, 5.8 };
+  const double radius = 26560e3;
+
+  vector<Point3> sats;
+  for (size_t i = 0; i < 5; i++) {
+    const Vector3 los = cos(elevations[i])*(cos(azimuths[i])*north
+                        + sin(azimuths[i])*east) + sin(elevations[i])*up;
+    // distance along the line of sight that reaches the orbit radius
+    const Vector3 r(rec.x(), rec.y(), rec.z());
+    const double b = r.dot(los);
+    const double d = -b + sqrt(b*b - r.squaredNorm() + radius*radius);
+    const Vector3 s = r + d*los;
+    sats.push_back(Point3(s(0), s(1), s(2)));
+  }
+  return sats;
+}
+}
+
+/* ************************************************************************* */
+TEST(GnssGeometry, receiver) {
+  using namespace example;
+  const vector<Point3> recs = receivers();
+  for (size_t j = 0; j < recs.size(); j++) {
+    const GnssReceiver rec(recs[j]);
+    EXPECT(assert_equal(Vector(xyz2llh(recs[j])), Vector(rec.llh()), 1e-12));
+    EXPECT_DOUBLES_EQUAL(tropDry(recs[j]), rec.tropDry(), 1e-12);
+
+    const vector<Point3> sats = satellites(recs[j]);
+    for (size_t i = 0; i < sats.size(); i++) {
+      EXPECT(assert_equal(xyz2enu(sats[i], recs[j]), rec.toENU(sats[i]), 1e-6));
+      EXPECT_DOUBLES_EQUAL(calcEl(sats[i], recs[j]), rec.elevation(sats[i]), 1e-12);
+      EXPECT_DOUBLES_EQUAL(elDepWeight(sats[i], recs[j], 2.0),
+                           rec.elDepWeight(sats[i], 2.0), 1e-12);
+
+      // ENU to ECEF uses the transpose of R in place of its inverse
+      const Point3 enu(100.0*i, -250.0, 40.0*j);
+      EXPECT(assert_equal(enu2xyz(enu, recs[j]), rec.toECEF(enu), 1e-6));
+      EXPECT(assert_equal(sats[i], rec.toECEF(rec.toENU(sats[i])), 1e-6));
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(GnssGeometry, gnssGeometry) {
+  using namespace example;
+  const vector<Point3> recs = receivers();
+  for (size_t j = 0; j < recs.size(); j++) {
+    const GnssReceiver rec(recs[j]);
+    const vector<Point3> sats = satellites(recs[j]);
+    const GnssGeometry geom = gnssGeometry(satelliteArray(sats), rec);
+    LONGS_EQUAL(sats.size(), geom.size());
+
+    const Vector tropDelay = geom.tropDelay(rec);
+    const Vector weights = geom.weights(2.0);
+    for (size_t i = 0; i < sats.size(); i++) {
+      // the rows the GNSS factors cache as h_
+      EXPECT(assert_equal(obsMap(sats[i], recs[j], 1),
+                          Vector(geom.H.row(i).transpose()), 1e-12));
+
+      const double el = calcEl(sats[i], recs[j]);
+      EXPECT_DOUBLES_EQUAL(el, geom.el(i), 1e-12);
+      EXPECT_DOUBLES_EQUAL(tropMap(el), geom.map(i), 1e-12);
+      EXPECT_DOUBLES_EQUAL(sats[i].distance(recs[j]), geom.range(i), 1e-6);
+      EXPECT_DOUBLES_EQUAL(deltaTrop(sats[i], recs[j]), tropDelay(i), 1e-9);
+      EXPECT_DOUBLES_EQUAL(elDepWeight(sats[i], recs[j], 2.0), weights(i), 1e-12);
+
+      const Point3 enu = xyz2enu(sats[i], recs[j]);
+      EXPECT_DOUBLES_EQUAL(enu.x(), geom.enu(i, 0), 1e-6);
+      EXPECT_DOUBLES_EQUAL(enu.y(), geom.enu(i, 1), 1e-6);
+      EXPECT_DOUBLES_EQUAL(enu.z(), geom.enu(i, 2), 1e-6);
+    }
+  }
+}
+
+/* ************************************************************************* */
+TEST(GnssGeometry, reuse) {
+  using namespace example;
+  const vector<Point3> recs = receivers();
+
+  // a geometry resized from five satellites down to two
+  GnssGeometry geom;
+  gnssGeometry(satelliteArray(satellites(recs[0])), GnssReceiver(recs[0]), geom);
+  vector<Point3> sats = satellites(recs[1]);
+  sats.resize(2);
+  gnssGeometry(satelliteArray(sats), GnssReceiver(recs[1]), geom);
+
+  LONGS_EQUAL(2, geom.size());
+  LONGS_EQUAL(2, geom.H.rows());
+  LONGS_EQUAL(2, geom.enu.rows());
+  for (size_t i = 0; i < sats.size(); i++)
+    EXPECT(assert_equal(obsMap(sats[i], recs[1], 1),
+                        Vector(geom.H.row(i).transpose()), 1e-12));
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -0,0 +1,189 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGnssProfiler.cpp
+ * @brief   Unit tests for the stage profiler trace and its summary
+ */
+
+#include <gtsam/gnssNavigation/GnssProfiler.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace gtsam;
+
+namespace example {
+string tempFile() {
+  return (boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path("testGnssProfiler-%%%%-%%%%")).string();
+}
+
+GnssProfiler::Span span(uint32_t epoch, GnssStage stage, uint64_t ms) {
+  GnssProfiler::Span s = { epoch, static_cast<uint32_t>(stage), epoch*1000000ULL,
+                           ms*1000000ULL };
+  return s;
+}
+
+// the count, mean, p50, p90, p99 and max columns of a stage in a summary
+vector<double> summaryRow(const string& summary, const string& stage) {
+  istringstream is(summary);
+  string line, name;
+  vector<double> row;
+  while (getline(is, line)) {
+    istringstream ls(line);
+    ls >> name;
+    if (name != stage)
+      continue;
+    double v;
+    while (ls >> v)
+      row.push_back(v);
+  }
+  return row;
+}
+}
+
+/* ************************************************************************* */
+TEST(GnssProfiler, roundTrip) {
+  using namespace example;
+  GnssProfiler profiler;
+  for (int epoch = 0; epoch < 3; epoch++) {
+    profiler.add(GNSS_GRAPH_BUILD, 10 + epoch, 5 + epoch);
+    profiler.add(GNSS_VDP, 20 + epoch, 7);
+    profiler.add(GNSS_VDP, 40 + epoch, 3);  // summed into one span
+    profiler.nextEpoch();
+  }
+  // the open epoch is not written
+  profiler.add(GNSS_MERGE, 100, 1);
+
+  const string file = tempFile();
+  profiler.write(file);
+  const vector<GnssProfiler::Span> spans = GnssProfiler::read(file);
+  boost::filesystem::remove(file);
+
+  // graph build, vdp and the epoch total for each of the three epochs
+  LONGS_EQUAL(9, spans.size());
+  LONGS_EQUAL(profiler.spans().size(), spans.size());
+  for (size_t i = 0; i < spans.size(); i++) {
+    LONGS_EQUAL(profiler.spans()[i].epoch, spans[i].epoch);
+    LONGS_EQUAL(profiler.spans()[i].stage, spans[i].stage);
+    EXPECT(profiler.spans()[i].start == spans[i].start);
+    EXPECT(profiler.spans()[i].duration == spans[i].duration);
+  }
+  LONGS_EQUAL(GNSS_GRAPH_BUILD, spans[3].stage);
+  LONGS_EQUAL(1, spans[3].epoch);
+  EXPECT(spans[3].start == 11 && spans[3].duration == 6);
+  LONGS_EQUAL(GNSS_VDP, spans[4].stage);
+  EXPECT(spans[4].start == 21 && spans[4].duration == 10);
+  LONGS_EQUAL(GNSS_EPOCH, spans[5].stage);
+}
+
+/* ************************************************************************* */
+TEST(GnssProfiler, emptyTrace) {
+  using namespace example;
+  const string file = tempFile();
+  GnssProfiler().write(file);
+  EXPECT(GnssProfiler::read(file).empty());
+  boost::filesystem::remove(file);
+}
+
+/* ************************************************************************* */
+TEST(GnssProfiler, readErrors) {
+  using namespace example;
+  const string file = tempFile();
+
+  // missing file
+  CHECK_EXCEPTION(GnssProfiler::read(file), std::runtime_error);
+
+  // a file of the right size that is not a trace
+  {
+    ofstream os(file.c_str(), ios::binary);
+    os << "GNSSPROX" << string(12, '\0');
+  }
+  CHECK_EXCEPTION(GnssProfiler::read(file), std::runtime_error);
+
+  // a trace cut short in its last span
+  GnssProfiler profiler;
+  profiler.add(GNSS_CLASSIFY, 0, 1);
+  profiler.nextEpoch();
+  profiler.write(file);
+  const uintmax_t size = boost::filesystem::file_size(file);
+  boost::filesystem::resize_file(file, size - 4);
+  CHECK_EXCEPTION(GnssProfiler::read(file), std::runtime_error);
+
+  // a header promising more spans than the file holds
+  boost::filesystem::resize_file(file, size - 2*sizeof(GnssProfiler::Span));
+  CHECK_EXCEPTION(GnssProfiler::read(file), std::runtime_error);
+
+  // a header cut short
+  boost::filesystem::resize_file(file, 10);
+  CHECK_EXCEPTION(GnssProfiler::read(file), std::runtime_error);
+  boost::filesystem::remove(file);
+
+  // an unwritable file
+  CHECK_EXCEPTION(profiler.write(file + "/trace"), std::runtime_error);
+}
+
+/* ************************************************************************* */
+TEST(GnssProfiler, summarize) {
+  using namespace example;
+  vector<GnssProfiler::Span> spans;
+
+  // seven vdp spans, given out of order: 1 2 3 4 5 6 70 ms
+  const uint64_t vdp[] = { 4, 70, 1, 6, 3, 5, 2 };
+  for (uint32_t i = 0; i < 7; i++)
+    spans.push_back(span(i, GNSS_VDP, vdp[i]));
+
+  // 1 to 100 ms for the epochs
+  for (uint32_t i = 0; i < 100; i++)
+    spans.push_back(span(i, GNSS_EPOCH, 100 - i));
+
+  // a span of an unknown stage is ignored
+  spans.push_back(span(0, GNSS_NUM_STAGES, 1));
+
+  ostringstream os;
+  GnssProfiler::summarize(spans, os);
+  const string summary = os.str();
+
+  // count, mean, p50, p90, p99, max [ms]; nearest rank: the p-th percentile
+  // of n values is the ceil(p*n/100)-th smallest
+  vector<double> row = summaryRow(summary, "vdp");
+  LONGS_EQUAL(6, row.size());
+  DOUBLES_EQUAL(7, row[0], 0);
+  DOUBLES_EQUAL(13.0, row[1], 1e-3);
+  DOUBLES_EQUAL(4.0, row[2], 1e-3);   // rank 4
+  DOUBLES_EQUAL(70.0, row[3], 1e-3);  // rank 7, 6.3 rounded up
+  DOUBLES_EQUAL(70.0, row[4], 1e-3);
+  DOUBLES_EQUAL(70.0, row[5], 1e-3);
+
+  row = summaryRow(summary, "epoch");
+  LONGS_EQUAL(6, row.size());
+  DOUBLES_EQUAL(100, row[0], 0);
+  DOUBLES_EQUAL(50.5, row[1], 1e-3);
+  DOUBLES_EQUAL(50.0, row[2], 1e-3);
+  DOUBLES_EQUAL(90.0, row[3], 1e-3);
+  DOUBLES_EQUAL(99.0, row[4], 1e-3);
+  DOUBLES_EQUAL(100.0, row[5], 1e-3);
+
+  // stages without spans are not listed
+  EXPECT(summaryRow(summary, "merge").empty());
+  EXPECT(summary.find("unknown") == string::npos);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
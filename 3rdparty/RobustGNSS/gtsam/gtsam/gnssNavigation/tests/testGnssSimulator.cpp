@@ -0,0 +1,131 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGnssSimulator.cpp
+ * @brief   Unit tests for the GNSS simulator and its file formats
+ */
+
+#include <gtsam/gnssNavigation/GnssSimulator.h>
+#include <gtsam/gnssNavigation/GnssData.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace gtsam;
+
+namespace example {
+// 3 minutes of all four constellations, with NLOS so the fault flag is set
+GnssSimParams params() {
+  GnssSimParams p;
+  p.hours = 0.05;
+  p.nlosRate = 20.0;
+  p.nlosDuration = 30.0;
+  p.slipRate = 20.0;
+  p.seed = 7;
+  return p;
+}
+
+string tempFile() {
+  return (boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path("testGnssSimulator-%%%%-%%%%")).string();
+}
+}
+
+/* ************************************************************************* */
+TEST(GnssSimulator, binaryRoundTrip) {
+  using namespace example;
+  const string file = tempFile();
+  GnssSimulator writer(params());
+  const size_t n = writeGnssSim(writer, file, GNSS_BINARY);
+  const vector<faultyRnxData> data = readGNSSBinary(file);
+  boost::filesystem::remove(file);
+
+  // the observations, in order, and a copy of the last one
+  GnssSimulator sim(params());
+  vector<GnssSimObservation> obs, all;
+  vector<GnssSimTruth> truth;
+  while (sim.next(100, obs, truth))
+    all.insert(all.end(), obs.begin(), obs.end());
+
+  LONGS_EQUAL(all.size(), n);
+  LONGS_EQUAL(n + 1, data.size());
+  size_t faults = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const GnssSimObservation& o = all[i];
+    const faultyRnxData& d = data[i];
+    EXPECT_DOUBLES_EQUAL(o.sow, d.get<0>(), 0.0);
+    LONGS_EQUAL(o.epoch, d.get<1>());
+    LONGS_EQUAL(o.svn, d.get<2>());
+    EXPECT(assert_equal(Point3(o.satXYZ[0], o.satXYZ[1], o.satXYZ[2]), d.get<3>(), 1e-9));
+    EXPECT_DOUBLES_EQUAL(o.rho, d.get<4>(), 0.0);
+    EXPECT_DOUBLES_EQUAL(o.range, d.get<5>(), 0.0);
+    EXPECT_DOUBLES_EQUAL(o.phase, d.get<6>(), 0.0);
+    LONGS_EQUAL(o.arc, d.get<7>());
+    LONGS_EQUAL(o.fault, d.get<8>());
+    faults += o.fault;
+  }
+  CHECK(faults > 0);
+  LONGS_EQUAL(data[n - 1].get<1>(), data[n].get<1>());
+  LONGS_EQUAL(data[n - 1].get<2>(), data[n].get<2>());
+  EXPECT_DOUBLES_EQUAL(data[n - 1].get<5>(), data[n].get<5>(), 0.0);
+}
+
+/* ************************************************************************* */
+TEST(GnssSimulator, textMatchesBinary) {
+  using namespace example;
+  const string textFile = tempFile(), binaryFile = tempFile();
+  GnssSimulator textSim(params()), binarySim(params());
+  writeGnssSim(textSim, textFile, GNSS_TEXT);
+  writeGnssSim(binarySim, binaryFile, GNSS_BINARY);
+  const vector<rnxData> text = readGNSS(textFile);
+  const vector<faultyRnxData> binary = readGNSSBinary(binaryFile);
+  boost::filesystem::remove(textFile);
+  boost::filesystem::remove(binaryFile);
+
+  // both end with the copy of the last observation
+  LONGS_EQUAL(text.size(), binary.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    LONGS_EQUAL(text[i].get<1>(), binary[i].get<1>());
+    LONGS_EQUAL(text[i].get<2>(), binary[i].get<2>());
+    EXPECT(assert_equal(text[i].get<3>(), binary[i].get<3>(), 1e-4));
+    EXPECT_DOUBLES_EQUAL(text[i].get<4>(), binary[i].get<4>(), 1e-4);
+    EXPECT_DOUBLES_EQUAL(text[i].get<5>(), binary[i].get<5>(), 1e-4);
+    EXPECT_DOUBLES_EQUAL(text[i].get<6>(), binary[i].get<6>(), 1e-4);
+    LONGS_EQUAL(text[i].get<7>(), binary[i].get<7>());
+  }
+}
+
+/* ************************************************************************* */
+TEST(GnssSimulator, svnCount) {
+  using namespace example;
+  const string file = tempFile();
+  GnssSimulator sim(params());
+  writeGnssSim(sim, file, GNSS_BINARY);
+  const vector<faultyRnxData> data = readGNSSBinary(file);
+  boost::filesystem::remove(file);
+
+  int maxSvn = 0;
+  for (size_t i = 0; i < data.size(); ++i)
+    maxSvn = max(maxSvn, data[i].get<2>());
+  CHECK(maxSvn > 300);
+  LONGS_EQUAL(maxSvn + 1, svnCount(data));
+  LONGS_EQUAL(34, svnCount(vector<faultyRnxData>()));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -27,11 +27,293 @@
 //
 //============================================================================
 
+#include <algorithm>
+#include <cmath>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
 #include "ARLambda.hpp"
+#include "SpecialFunctions.hpp"
 
 
 namespace gpstk
 {
+   namespace
+   {
+         // Pointers into the SearchSpace of one thread
+      struct Space
+      {
+         double *S, *dist, *zb, *z, *step;
+         long nodes;             // nodes not yet added to the shared count
+      };
+
+         // State shared by the threads of one search: the problem, the
+         // candidate list and its bound, the node count and the prefixes
+         // (values of the upper levels) left to search.
+      struct SearchShared
+      {
+         int n, lo, m;
+         const double *L, *D, *zs;
+
+         std::vector<double> cand;     // m rows of n values
+         std::vector<double> cdist;    // distance of each candidate
+         int nn, imax;
+         double maxdist;
+
+         long nodes, maxNodes;
+         bool truncated;
+         bool threaded;
+
+         int split;                    // prefixes fix levels split..n-1
+         std::vector<double> prefix;   // n-split values per prefix
+         std::vector<double> pdist;    // partial distance of each prefix
+         std::vector<size_t> porder;   // prefixes by increasing pdist
+         size_t next;                  // next entry of porder to search
+
+#ifndef _WIN32
+         pthread_mutex_t lock;
+#endif
+      };
+
+      inline void lockShared(SearchShared& sh)
+      {
+#ifndef _WIN32
+         if(sh.threaded) pthread_mutex_lock(&sh.lock);
+#endif
+      }
+
+      inline void unlockShared(SearchShared& sh)
+      {
+#ifndef _WIN32
+         if(sh.threaded) pthread_mutex_unlock(&sh.lock);
+#endif
+      }
+
+      inline double roundInt(double x)
+      { return double(std::floor(x+0.5)); }
+
+      inline double signOf(double x)
+      { return (x<=0.0)?-1.0:1.0; }
+
+         // Count a node; false once the node limit is reached. Threads add
+         // their count to the shared one in batches, and pick up the current
+         // bound when they do.
+      bool countNode(SearchShared& sh, Space& w, double& maxdist)
+      {
+         if(!sh.threaded)
+         {
+            sh.nodes++;
+            if(sh.maxNodes > 0 && sh.nodes > sh.maxNodes)
+            {
+               sh.truncated = true;
+               return false;
+            }
+            return true;
+         }
+
+         if(++w.nodes < 64) return true;
+
+         lockShared(sh);
+         sh.nodes += w.nodes;
+         if(sh.maxNodes > 0 && sh.nodes > sh.maxNodes) sh.truncated = true;
+         bool go(!sh.truncated);
+         maxdist = sh.maxdist;
+         unlockShared(sh);
+         w.nodes = 0;
+         return go;
+      }
+
+         // Add a leaf to the candidates, unless it is already there (a
+         // leaf of the first descent is found again below its prefix).
+         // Returns the bound for the search.
+      double addCandidate(SearchShared& sh, const double *z, double newdist)
+      {
+         lockShared(sh);
+         int slot(-1);
+         if(sh.nn < sh.m) slot = sh.nn;
+         else if(newdist < sh.cdist[sh.imax]) slot = sh.imax;
+
+         bool known(false);
+         for(int c=0; slot>=0 && c<sh.nn && !known; c++)
+         {
+            known = std::equal(z+sh.lo, z+sh.n, &sh.cand[c*sh.n+sh.lo]);
+         }
+
+         if(slot >= 0 && !known)
+         {
+            std::copy(z+sh.lo, z+sh.n, &sh.cand[slot*sh.n+sh.lo]);
+            sh.cdist[slot] = newdist;
+            if(slot == sh.nn) sh.nn++;
+            sh.imax = 0;
+            for(int i=1; i<sh.nn; i++) if(sh.cdist[sh.imax]<sh.cdist[i]) sh.imax=i;
+            if(sh.nn == sh.m) sh.maxdist = sh.cdist[sh.imax];
+         }
+
+         double maxdist(sh.maxdist);
+         unlockShared(sh);
+         return maxdist;
+      }
+
+         // mlambda depth first search of the levels bottom..top. The levels
+         // above top are fixed in w, and zb[top] and dist[top] are set.
+         // If record is true, each node reached at level bottom is stored
+         // as a prefix instead of a candidate; if stopWhenFull is true,
+         // the search stops as soon as there are m candidates.
+      void searchTree( SearchShared& sh, Space& w, int top, int bottom,
+                       bool record, bool stopWhenFull )
+      {
+         const int n(sh.n), lo(sh.lo);
+         const double *L(sh.L), *D(sh.D), *zs(sh.zs);
+         double *S(w.S), *dist(w.dist), *zb(w.zb), *z(w.z), *step(w.step);
+
+         double maxdist;
+         lockShared(sh);
+         maxdist = sh.maxdist;
+         unlockShared(sh);
+
+         int k(top);
+         z[k] = roundInt(zb[k]);
+         double y = zb[k]-z[k];
+         step[k] = signOf(y);
+
+         while(countNode(sh,w,maxdist))
+         {
+            double newdist = dist[k]+y*y/D[k];
+            if(newdist < maxdist)
+            {
+               if(k != bottom)
+               {
+                  dist[--k] = newdist;
+                  const double dz = z[k+1]-zb[k+1];
+                  const double *Lk(L+(k+1)*n), *Sk(S+(k+1)*n);
+                  double *Sn(S+k*n);
+                  for(int i=lo; i<=k; i++) Sn[i] = Sk[i]+dz*Lk[i];
+                  zb[k] = zs[k]+Sn[k];
+                  z[k] = roundInt(zb[k]); y = zb[k]-z[k]; step[k] = signOf(y);
+               }
+               else
+               {
+                  if(record)
+                  {
+                     sh.prefix.insert(sh.prefix.end(), z+bottom, z+n);
+                     sh.pdist.push_back(newdist);
+                  }
+                  else
+                  {
+                     maxdist = addCandidate(sh, z, newdist);
+                     if(stopWhenFull && sh.nn == sh.m) break;
+                  }
+                  z[k] += step[k]; y = zb[k]-z[k];
+                  step[k] = -step[k]-signOf(step[k]);
+               }
+            }
+            else
+            {
+               if(k == top) break;
+               k++;
+               z[k] += step[k]; y = zb[k]-z[k];
+               step[k] = -step[k]-signOf(step[k]);
+            }
+         }
+      }
+
+         // Set the top of the tree in w: nothing fixed yet.
+      void startTop(SearchShared& sh, Space& w)
+      {
+         const int n(sh.n);
+         std::fill(w.S+(n-1)*n, w.S+n*n, 0.0);
+         w.zb[n-1] = sh.zs[n-1];
+         w.dist[n-1] = 0.0;
+      }
+
+         // Fix the levels of prefix p in w, and set zb and dist of the
+         // level below it, as the search would have on reaching it.
+      void startPrefix(SearchShared& sh, Space& w, size_t p)
+      {
+         const int n(sh.n), lo(sh.lo), split(sh.split);
+         const double *L(sh.L), *D(sh.D), *zs(sh.zs);
+         const double *pz(&sh.prefix[p*(n-split)]);
+         startTop(sh, w);
+         for(int k=n-1; k>=split; k--)
+         {
+            w.z[k] = pz[k-split];
+            const double y = w.zb[k]-w.z[k];
+            w.dist[k-1] = w.dist[k]+y*y/D[k];
+            const double dz = w.z[k]-w.zb[k];
+            const double *Lk(L+k*n), *Sk(w.S+k*n);
+            double *Sn(w.S+(k-1)*n);
+            for(int i=lo; i<=k-1; i++) Sn[i] = Sk[i]+dz*Lk[i];
+            w.zb[k-1] = zs[k-1]+Sn[k-1];
+         }
+      }
+
+         // Search the subtrees below the prefixes, taking them in order of
+         // increasing partial distance until none is left or the node
+         // limit is reached.
+      void searchPrefixes(SearchShared& sh, Space& w)
+      {
+         for(;;)
+         {
+            lockShared(sh);
+            bool go(!sh.truncated && sh.next < sh.porder.size());
+            size_t p(go ? sh.porder[sh.next++] : 0);
+            double maxdist(sh.maxdist);
+            unlockShared(sh);
+
+               // the bound only shrinks, and later prefixes are no closer
+            if(!go || sh.pdist[p] >= maxdist) break;
+
+            startPrefix(sh, w, p);
+            searchTree(sh, w, sh.split-1, sh.lo, false, false);
+         }
+
+         lockShared(sh);
+         sh.nodes += w.nodes;
+         if(sh.maxNodes > 0 && sh.nodes > sh.maxNodes) sh.truncated = true;
+         unlockShared(sh);
+         w.nodes = 0;
+      }
+
+#ifndef _WIN32
+      struct PrefixTask
+      {
+         SearchShared *sh;
+         Space w;
+      };
+
+      void *prefixWorker(void *arg)
+      {
+         PrefixTask *task = static_cast<PrefixTask*>(arg);
+         searchPrefixes(*task->sh, task->w);
+         return 0;
+      }
+#endif
+
+         // Order prefixes by their partial distance
+      struct PrefixLess
+      {
+         PrefixLess(const std::vector<double>& d) : pdist(d) {}
+         bool operator()(size_t a, size_t b) const
+         { return pdist[a] < pdist[b]; }
+         const std::vector<double>& pdist;
+      };
+
+   }  // End of anonymous namespace
+
+
+   void ARLambda::SearchSpace::reserve(int n)
+   {
+      if(static_cast<int>(dist.size()) >= n) return;
+      S.resize(n*n, 0.0);
+      dist.resize(n, 0.0);
+      zb.resize(n, 0.0);
+      z.resize(n, 0.0);
+      step.resize(n, 0.0);
+   }
+
+
    Vector<double> ARLambda::resolveIntegerAmbiguity( 
                                                const Vector<double>& ambFloat, 
                                                const Matrix<double>& ambCov )
@@ -47,7 +329,8 @@ namespace gpstk
       try
       {
          Matrix<double> F; Vector<double> S;
-         if( lambda(ambFloat,ambCov,F,S,2)==0 )
+         int status = lambda(ambFloat,ambCov,F,S,2);
+         if( status==0 )
          {
             Vector<double> ambFixed( ambFloat.size(), 0.0 );
             for(size_t i=0; i<ambFloat.size(); i++) 
@@ -59,6 +342,12 @@ namespace gpstk
             
             return ambFixed;
          }
+         else if( status==1 )
+         {
+               // no subset reaches the success rate: nothing is fixed
+            squaredRatio = 0.0;
+            return ambFloat;
+         }
          else
          {
             ARException e("Failed to resolve the integer ambiguities.");
@@ -77,7 +366,7 @@ namespace gpstk
          // it should never go here, but we sill return the float ambiguities
       return ambFloat;
 
-   }  // End of method 'ARMLambda::resolveIntegerAmbiguity()'
+   }  // End of method 'ARLambda::resolveIntegerAmbiguity()'
 
    
    int ARLambda::factorize( const Matrix<double>& Q, 
@@ -200,11 +489,6 @@ namespace gpstk
                          Vector<double>& s, 
                           const int& m )
    {
-
-      ARException e("The LAMBDA search method have not been implemented.");
-      GPSTK_THROW(e);
-
-      // TODO: CHECK UNEXPECTED INPUT
       // n - number of float parameters
       // m - number of fixed solutions
       // L - nxn
@@ -212,87 +496,146 @@ namespace gpstk
       // zs - nxn
       // zn - nxm
       // s  - m
-      const int LOOPMAX = 10000;
+      if( searchLevels(L,D,zs,0,zn,s,m) < 1 ) return -1;
+
+      return 0;
+
+   }  // End of method 'ARLambda::search()'
+
+
+   int ARLambda::searchLevels( const Matrix<double>& L,
+                               const Vector<double>& D,
+                               const Vector<double>& zs,
+                               int lo,
+                               Matrix<double>& zn,
+                               Vector<double>& s,
+                               const int& m )
+   {
       const int n = L.rows();
 
       zn.resize(n,m,0.0);
       s.resize(m,0.0);
+      searchTruncated = false;
 
-      Matrix<double> S(n,n,0.0);
-      Vector<double> dist(n,0.0),zb(n,0.0),z(n,0.0),step(n,0.0);
+      if( m<1 || lo<0 || lo>=n ) return 0;
 
-      int k=n-1; dist[k]=0.0;
-      zb(k)=zs(k);
-      z(k)=round(zb(k)); 
-      double y=zb(k)-z(k); 
-      step(k)=sign(y);
+         // the problem, in flat storage the threads can share
+      flatL.resize(n*n);
+      for(int i=0; i<n; i++)
+      {
+         for(int j=0; j<n; j++) flatL[i*n+j] = L(i,j);
+      }
+      std::vector<double> vD(n), vzs(n);
+      for(int i=0; i<n; i++) { vD[i] = D(i); vzs[i] = zs(i); }
+
+      SearchShared sh;
+      sh.n = n; sh.lo = lo; sh.m = m;
+      sh.L = &flatL[0]; sh.D = &vD[0]; sh.zs = &vzs[0];
+      sh.cand.assign(m*n, 0.0);
+      sh.cdist.assign(m, 0.0);
+      sh.nn = 0; sh.imax = 0;
+      sh.maxdist = 1E99;
+      sh.nodes = 0; sh.maxNodes = maxNodes;
+      sh.truncated = false;
+      sh.threaded = false;
+      sh.split = n;
+      sh.next = 0;
+
+         // threads only pay off when the tree is deep enough to split
+      int nthreads(numThreads);
+#ifdef _WIN32
+      nthreads = 1;
+#endif
+      if( n-lo < 8 ) nthreads = 1;
+
+      if( static_cast<int>(spaces.size()) < nthreads ) spaces.resize(nthreads);
+      std::vector<Space> w(nthreads);
+      for(int t=0; t<nthreads; t++)
+      {
+         spaces[t].reserve(n);
+         w[t].S = &spaces[t].S[0];
+         w[t].dist = &spaces[t].dist[0];
+         w[t].zb = &spaces[t].zb[0];
+         w[t].z = &spaces[t].z[0];
+         w[t].step = &spaces[t].step[0];
+         w[t].nodes = 0;
+      }
 
-      int c(0),nn(0),imax(0);
-      double maxdist=1E99;
-      for(int c=0;c<LOOPMAX;c++)
+      startTop(sh, w[0]);
+      if( nthreads == 1 )
+      {
+         searchTree(sh, w[0], n-1, lo, false, false);
+      }
+      else
       {
-         double newdist=dist(k)+y*y/D(k);
-         if(newdist<maxdist) 
+            // first descent, to find m candidates and so a finite bound
+         searchTree(sh, w[0], n-1, lo, false, true);
+
+            // expand the upper levels until there is work for all threads
+         for(int split=n-1; !sh.truncated && sh.nn==m && split>lo; split--)
          {
-            if(k!=0) 
-            {
-               dist(--k)=newdist;
-               for(int i=0;i<=k;i++)
-               {
-                  S(k,i)=S(k+1,i)+(z(k+1)-zb(k+1))*L(k+1,i);
-               }
-               zb(k)=zs(k)+S(k,k);
-               z(k)=round(zb(k)); y=zb(k)-z(k); step(k)=sign(y);
-            }
-            else 
-            {
-               if(nn<m) 
-               {
-                  if(nn==0||newdist>s(imax)) imax=nn;
-                  for(int i=0;i<n;i++) zn(i,nn)=z(i);
-                  s(nn++)=newdist;
-               }
-               else 
-               {
-                  if(newdist<s(imax)) 
-                  {
-                     for(int i=0;i<n;i++) zn(i,imax)=z(i);
-                     s(imax)=newdist;
-                     for(int i=imax=0;i<m;i++) if (s(imax)<s(i)) imax=i;
-                  }
-                  maxdist=s(imax);
-               }
-               z(0)+=step(0); y=zb(0)-z(0); step(0)=-step(0)-sign(step(0));
-            }
+            sh.prefix.clear();
+            sh.pdist.clear();
+            sh.split = split;
+            startTop(sh, w[0]);
+            searchTree(sh, w[0], n-1, split, true, false);
+            if( static_cast<int>(sh.pdist.size()) >= 4*nthreads ) break;
          }
-         else 
+
+         if( !sh.truncated && sh.nn==m && sh.split>lo )
          {
-            if(k==n-1) break;
-            else 
+            sh.porder.resize(sh.pdist.size());
+            for(size_t p=0; p<sh.porder.size(); p++) sh.porder[p] = p;
+            std::sort(sh.porder.begin(), sh.porder.end(), PrefixLess(sh.pdist));
+
+#ifndef _WIN32
+            pthread_mutex_init(&sh.lock, 0);
+            sh.threaded = true;
+
+            std::vector<PrefixTask> tasks(nthreads);
+            std::vector<pthread_t> threads(nthreads);
+            std::vector<bool> started(nthreads,false);
+            for(int t=1; t<nthreads; t++)
             {
-               k++;
-               z(k)+=step(k); y=zb(k)-z(k); step(k)=-step(k)-sign(step(k));
+               tasks[t].sh = &sh;
+               tasks[t].w = w[t];
+               started[t] = (pthread_create(&threads[t], 0, prefixWorker,
+                                            &tasks[t]) == 0);
+            }
+            searchPrefixes(sh, w[0]);
+            for(int t=1; t<nthreads; t++)
+            {
+               if(started[t]) pthread_join(threads[t], 0);
             }
+
+            sh.threaded = false;
+            pthread_mutex_destroy(&sh.lock);
+#endif
          }
       }
-      for(int i=0;i<m-1;i++) 
+
+         // candidates in order of increasing distance
+      const int nn(sh.nn);
+      for(int i=0; i<nn; i++)
+      {
+         for(int k=lo; k<n; k++) zn(k,i) = sh.cand[i*n+k];
+         s(i) = sh.cdist[i];
+      }
+      for(int i=0;i<nn-1;i++) 
       { 
-         for(int j=i+1;j<m;j++) 
+         for(int j=i+1;j<nn;j++) 
          {
             if(s(i)<s(j)) continue;
             swap(s(i),s(j));
-            for(k=0;k<n;k++) swap(zn(k,i),zn(k,j));
+            for(int k=lo;k<n;k++) swap(zn(k,i),zn(k,j));
          }
       }
 
-      if (c>=LOOPMAX) 
-      {
-         return -1;
-      }
+      searchTruncated = sh.truncated;
 
-      return 0;
+      return nn;
 
-   }  // End of method 'ARLambda::search()'
+   }  // End of method 'ARLambda::searchLevels()'
 
 
    int ARLambda::lambda( const Vector<double>& a, 
@@ -301,6 +644,10 @@ namespace gpstk
                          Vector<double>& s,
                          const int& m )
    {
+      numFixed = 0;
+      successRate = 1.0;
+      searchTruncated = false;
+
       if( (a.size()!=Q.rows()) || (Q.rows()!=Q.cols()) ) return -1;
       if( m < 1) return -1;
 
@@ -310,21 +657,55 @@ namespace gpstk
       Vector<double> D(n,0.0),z(n,0.0);
       Matrix<double> Z = ident<double>(n);
 
-      if (factorize(Q,L,D)==0) 
-      {      
-         reduction(L,D,Z);
-         z = transpose(Z)*a;
+      if (factorize(Q,L,D)!=0) return -1;
+
+      reduction(L,D,Z);
+      z = transpose(Z)*a;
 
-         if (search(L,D,z,E,s,m)==0) 
+         // After reduction the conditional variances D decrease toward
+         // the end, where the search starts. Fix levels lo..n-1: all of
+         // them, or the most the bootstrapped success rate allows,
+         // P = prod( 2*Phi(1/(2*sqrt(D(i)))) - 1 ) = prod( erf(1/sqrt(8*D(i))) ).
+      int lo(0);
+      for(int i=n-1; i>=0; i--)
+      {
+         const double p = successRate * gpstk::erf(1.0/std::sqrt(8.0*D(i)));
+         if( minSuccessRate>0.0 && p<minSuccessRate ) { lo = i+1; break; }
+         successRate = p;
+      }
+      if( lo == n ) return 1;
+
+      if( lo == 0 )
+      {
+         if( search(L,D,z,E,s,m) != 0 ) return -1;
+      }
+      else
+      {
+         const int nn = searchLevels(L,D,z,lo,E,s,m);
+         if( nn < 1 ) return -1;
+
+            // the levels not fixed keep their float values, conditioned on
+            // the fixed ones as in the search: acc(i) holds S(k,i)
+         for(int c=0; c<nn; c++)
          {
-            try
-            {  // F=Z'\E - Z nxn  E nxm F nxm
-               F = transpose( inverseLUD(Z) ) * E;
+            Vector<double> acc(n,0.0);
+            for(int k=n-1; k>=0; k--)
+            {
+               const double zb = z(k)+acc(k);
+               const double zc = (k>=lo) ? E(k,c) : zb;
+               E(k,c) = zc;
+               for(int i=0; i<k; i++) acc(i) += (zc-zb)*L(k,i);
             }
-            catch(...) 
-            { return -1; }
          }
       }
+      numFixed = n-lo;
+
+      try
+      {  // F=Z'\E - Z nxn  E nxm F nxm
+         F = transpose( inverseLUD(Z) ) * E;
+      }
+      catch(...) 
+      { return -1; }
 
       return 0;
 
@@ -332,4 +713,3 @@ namespace gpstk
 
 
 }   // End of namespace gpstk
-
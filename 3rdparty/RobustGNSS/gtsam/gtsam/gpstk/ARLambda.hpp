@@ -30,6 +30,7 @@
 //
 //============================================================================
 
+#include <vector>
 #include "ARBase.hpp"
 
 namespace gpstk
@@ -41,13 +42,35 @@ namespace gpstk
        *   P.J.G.Teunissen, The least-square ambiguity decorrelation adjustment:
        *   a method for fast GPS ambiguity estimation, J.Geodesy, Vol.70, 65-82,
        *   1995
+       *
+       * The search is the mlambda search of ARMLambda, with three
+       * additions for large problems (multi-GNSS, several frequencies):
+       *
+       * - Partial ambiguity resolution: with setMinSuccessRate(), only
+       *   the largest subset of the decorrelated ambiguities whose
+       *   bootstrapped success rate reaches the given value is fixed.
+       *   The other ambiguities are returned as float values, conditioned
+       *   on the fixed ones.
+       * - Bounded search: setMaxNodes() limits the number of nodes the
+       *   search may visit. When the limit is hit, the best candidates
+       *   found so far are used and isSearchTruncated() returns true.
+       * - Parallel search: with setNumThreads(), the upper levels of the
+       *   search tree are expanded first. The subtrees below them are then
+       *   searched by a pool of threads that share the candidate list
+       *   and its bound.
+       *
+       * The working storage of the search is kept between calls and only
+       * grows, so a filter calling this every epoch does not allocate
+       * once the largest problem has been seen.
        */
    class ARLambda : public ARBase
    {
    public:
       
          /// Default constructor
-      ARLambda() : squaredRatio(0.0) {}      
+      ARLambda() : squaredRatio(0.0), minSuccessRate(0.0), maxNodes(10000),
+                   numThreads(1), numFixed(0), successRate(1.0),
+                   searchTruncated(false) {}
       
 
          /// Integer Ambiguity Resolution method
@@ -63,6 +86,50 @@ namespace gpstk
 
       bool isFixedSuccessfully(double threshhold = 3.0)
       { return (squaredRatio>threshhold)?true:false; }
+
+
+         /** Set the smallest bootstrapped success rate accepted for the
+          * fixed subset, in [0,1). Zero (the default) fixes all ambiguities.
+          */
+      virtual ARLambda& setMinSuccessRate(double rate)
+      { minSuccessRate = (rate < 0.0) ? 0.0 : rate; return (*this); }
+
+         /// Get the smallest success rate accepted for the fixed subset
+      virtual double getMinSuccessRate(void) const
+      { return minSuccessRate; }
+
+
+         /** Set the largest number of nodes the search may visit; zero or
+          * less means no limit. The default is 10000.
+          */
+      virtual ARLambda& setMaxNodes(long nodes)
+      { maxNodes = nodes; return (*this); }
+
+         /// Get the largest number of nodes the search may visit
+      virtual long getMaxNodes(void) const
+      { return maxNodes; }
+
+
+         /// Set the number of threads used by the search (default 1)
+      virtual ARLambda& setNumThreads(int n)
+      { numThreads = (n < 1) ? 1 : n; return (*this); }
+
+         /// Get the number of threads used by the search
+      virtual int getNumThreads(void) const
+      { return numThreads; }
+
+
+         /// Number of decorrelated ambiguities fixed by the last call
+      int getNumFixed(void) const
+      { return numFixed; }
+
+         /// Bootstrapped success rate of the subset fixed by the last call
+      double getSuccessRate(void) const
+      { return successRate; }
+
+         /// True if the last search stopped at the node limit
+      bool isSearchTruncated(void) const
+      { return searchTruncated; }
       
 
       double squaredRatio;
@@ -113,6 +180,18 @@ namespace gpstk
                           Vector<double>& s, 
                           const int& m = 2 );
 
+         /** mlambda search of the levels lo..n-1 of zs, i.e. of the
+          * last n-lo decorrelated ambiguities. Returns the number of
+          * candidates found (at most m), with zn and s as in search();
+          * rows below lo of zn are not set. */
+      int searchLevels( const Matrix<double>& L,
+                        const Vector<double>& D,
+                        const Vector<double>& zs,
+                        int lo,
+                        Matrix<double>& zn,
+                        Vector<double>& s,
+                        const int& m );
+
          // lambda/mlambda integer least-square estimation
          // a     Float parameters (n x 1)
          // Q     Covariance matrix of float parameters (n x n)
@@ -125,15 +204,36 @@ namespace gpstk
                   Matrix<double>& F, 
                   Vector<double>& s, 
                   const int& m = 2 );
-      
-   protected:
 
+
+         /// Working storage of one search thread
+      struct SearchSpace
+      {
+         void reserve(int n);
+         std::vector<double> S, dist, zb, z, step;
+      };
+
+         /// Smallest success rate of the fixed subset (0: fix all)
+      double minSuccessRate;
+
+         /// Largest number of search nodes (<=0: no limit)
+      long maxNodes;
+
+         /// Number of search threads
+      int numThreads;
+
+         /// Results of the last call
+      int numFixed;
+      double successRate;
+      bool searchTruncated;
+
+         /// L of the last search, row by row, and one space per thread
+      std::vector<double> flatL;
+      std::vector<SearchSpace> spaces;
       
-         
    };   // End of class 'ARLambda'
    
 }   // End of namespace gpstk
 
 
 #endif  //GPSTK_ARLAMBDA_HPP
-
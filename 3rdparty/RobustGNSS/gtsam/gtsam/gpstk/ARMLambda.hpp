@@ -41,6 +41,8 @@ namespace gpstk
        *   X.-W.Chang, X.Yang, T.Zhou, MLAMBDA: A modified LAMBDA method for
        *   integer least-squares estimation, J.Geodesy, Vol.79, 552-565, 2005
        *
+       * The search is inherited from ARLambda::search(), an mlambda
+       * search with partial fixing, a node limit and threads.
        */
    class ARMLambda : public ARLambda  
    {
@@ -53,16 +55,6 @@ namespace gpstk
          /// Destractor
       virtual ~ARMLambda(){}
       
-   protected:
-
-         /// modified lambda (mlambda) search
-      virtual int search( const Matrix<double>& L, 
-                          const Vector<double>& D, 
-                          const Vector<double>& zs, 
-                          Matrix<double>& zn, 
-                          Vector<double>& s, 
-                          const int& m = 2 );
-         
    };   // End of class 'ARMLambda'
    
 
@@ -0,0 +1,168 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testARLambda.cpp
+ * @brief   Unit tests for the LAMBDA integer ambiguity search
+ */
+
+#include <gtsam/gpstk/ARLambda.hpp>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <cmath>
+
+using namespace std;
+using namespace gpstk;
+
+namespace example {
+// weighted squared distance of the fixed solution from the float one
+double distance(const Vector<double>& a, const Matrix<double>& Q, const Vector<double>& f) {
+  const Vector<double> d = a - f;
+  return dot(d, inverse(Q) * d);
+}
+
+bool isInteger(double x) {
+  return fabs(x - floor(x + 0.5)) < 1e-9;
+}
+
+// Band covariance of 20 ambiguities with float values far from integers,
+// which takes the search well past 30 nodes
+void largeProblem(Vector<double>& a, Matrix<double>& Q) {
+  const int n = 20;
+  a.resize(n);
+  Q.resize(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++)
+      Q(i, j) = 0.5 * exp(-abs(i - j) / 3.0);
+    Q(i, i) += 0.5;
+    a(i) = 0.37 * i + 0.5 * sin(1.7 * i);
+  }
+}
+}
+
+/* ************************************************************************* */
+TEST(ARLambda, fixFloatSolution) {
+  // a correlated float solution near known integers
+  const int n = 4;
+  const double Qdata[] = { 0.0865, 0.0190, 0.0647, 0.0105,
+                           0.0190, 0.0398, 0.0170, 0.0191,
+                           0.0647, 0.0170, 0.0590, 0.0092,
+                           0.0105, 0.0191, 0.0092, 0.0382 };
+  const double truth[] = { 3.0, -2.0, 5.0, 1.0 };
+  const double noise[] = { 0.12, -0.08, 0.10, 0.05 };
+  Matrix<double> Q(n, n);
+  Vector<double> a(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++)
+      Q(i, j) = Qdata[i * n + j];
+    a(i) = truth[i] + noise[i];
+  }
+
+  ARLambda lambda;
+  const Vector<double> fixed = lambda.resolveIntegerAmbiguity(a, Q);
+  for (int i = 0; i < n; i++)
+    DOUBLES_EQUAL(truth[i], fixed(i), 1e-9);
+  LONGS_EQUAL(n, lambda.getNumFixed());
+  CHECK(lambda.isFixedSuccessfully());
+  CHECK(!lambda.isSearchTruncated());
+
+  // the parallel search finds the same solution
+  ARLambda parallel;
+  parallel.setNumThreads(4);
+  const Vector<double> same = parallel.resolveIntegerAmbiguity(a, Q);
+  for (int i = 0; i < n; i++)
+    DOUBLES_EQUAL(fixed(i), same(i), 0.0);
+  DOUBLES_EQUAL(lambda.squaredRatio, parallel.squaredRatio, 1e-12);
+}
+
+/* ************************************************************************* */
+TEST(ARLambda, partialFixing) {
+  // three precise ambiguities and one the data cannot fix
+  const int n = 4;
+  const double variance[] = { 0.001, 0.002, 4.0, 0.0015 };
+  const double truth[] = { 7.0, -4.0, 2.0, 11.0 };
+  const double noise[] = { 0.02, -0.03, 0.37, 0.01 };
+  Matrix<double> Q(n, n, 0.0);
+  Vector<double> a(n);
+  for (int i = 0; i < n; i++) {
+    Q(i, i) = variance[i];
+    a(i) = truth[i] + noise[i];
+  }
+
+  // fixing all of them has a poor success rate
+  ARLambda all;
+  all.resolveIntegerAmbiguity(a, Q);
+  LONGS_EQUAL(n, all.getNumFixed());
+  CHECK(all.getSuccessRate() < 0.5);
+
+  // with a required success rate only the precise three are fixed, and the
+  // other keeps its float value, as it is not correlated with them
+  ARLambda partial;
+  partial.setMinSuccessRate(0.99);
+  const Vector<double> fixed = partial.resolveIntegerAmbiguity(a, Q);
+  LONGS_EQUAL(n - 1, partial.getNumFixed());
+  CHECK(partial.getSuccessRate() >= 0.99);
+  DOUBLES_EQUAL(7.0, fixed(0), 1e-9);
+  DOUBLES_EQUAL(-4.0, fixed(1), 1e-9);
+  DOUBLES_EQUAL(a(2), fixed(2), 1e-9);
+  DOUBLES_EQUAL(11.0, fixed(3), 1e-9);
+
+  // when no subset reaches the success rate the float solution is returned
+  Matrix<double> Qpoor(n, n, 0.0);
+  for (int i = 0; i < n; i++)
+    Qpoor(i, i) = 1.0;
+  ARLambda none;
+  none.setMinSuccessRate(0.99);
+  const Vector<double> unfixed = none.resolveIntegerAmbiguity(a, Qpoor);
+  LONGS_EQUAL(0, none.getNumFixed());
+  DOUBLES_EQUAL(0.0, none.squaredRatio, 0.0);
+  for (int i = 0; i < n; i++)
+    DOUBLES_EQUAL(a(i), unfixed(i), 0.0);
+}
+
+/* ************************************************************************* */
+TEST(ARLambda, nodeLimit) {
+  using namespace example;
+  Vector<double> a;
+  Matrix<double> Q;
+  largeProblem(a, Q);
+
+  ARLambda full;
+  full.setMaxNodes(0);
+  const Vector<double> best = full.resolveIntegerAmbiguity(a, Q);
+  CHECK(!full.isSearchTruncated());
+
+  // at the limit the best candidate found so far is returned: an integer
+  // vector, no closer to the float solution than the full search's
+  ARLambda limited;
+  limited.setMaxNodes(30);
+  const Vector<double> fixed = limited.resolveIntegerAmbiguity(a, Q);
+  CHECK(limited.isSearchTruncated());
+  LONGS_EQUAL(a.size(), fixed.size());
+  for (size_t i = 0; i < fixed.size(); i++)
+    CHECK(isInteger(fixed(i)));
+  CHECK(distance(a, Q, fixed) >= distance(a, Q, best) - 1e-9);
+
+  // without a limit the parallel search finds the same solution
+  ARLambda parallel;
+  parallel.setMaxNodes(0).setNumThreads(4);
+  const Vector<double> same = parallel.resolveIntegerAmbiguity(a, Q);
+  for (size_t i = 0; i < best.size(); i++)
+    DOUBLES_EQUAL(best(i), same(i), 0.0);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -179,7 +179,6 @@ Ordering Ordering::ColamdConstrained(const VariableIndex& variableIndex,
     const FastMap<Key, int>& groups) {
   gttic(Ordering_COLAMDConstrained);
   size_t n = variableIndex.size();
-  std::vector<int> cmember(n, 0);
 
   // Build a mapping to look up sorted Key indices by Key
   FastMap<Key, size_t> keyIndices;
@@ -187,11 +186,22 @@ Ordering Ordering::ColamdConstrained(const VariableIndex& variableIndex,
   for (auto key_factors: variableIndex)
     keyIndices.insert(keyIndices.end(), make_pair(key_factors.first, j++));
 
-  // Assign groups
+  // Number the groups consecutively, as CCOLAMD rejects a group index larger than the number
+  // of variables.  This happens when callers constrain only a few of the variables to
+  // late groups.
   typedef FastMap<Key, int>::value_type key_group;
+  FastMap<int, int> groupIndices;
+  groupIndices.insert(make_pair(0, 0));
+  for(const key_group& p: groups)
+    groupIndices.insert(make_pair(p.second, 0));
+  int g = 0;
+  for(FastMap<int, int>::value_type& group: groupIndices)
+    group.second = g++;
+
+  // Assign groups
+  std::vector<int> cmember(n, groupIndices.at(0));
   for(const key_group& p: groups) {
-    // FIXME: check that no groups are skipped
-    cmember[keyIndices.at(p.first)] = p.second;
+    cmember[keyIndices.at(p.first)] = groupIndices.at(p.second);
   }
 
   return Ordering::ColamdConstrained(variableIndex, cmember);
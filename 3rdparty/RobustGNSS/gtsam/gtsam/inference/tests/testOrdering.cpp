@@ -109,6 +109,30 @@ TEST(Ordering, grouped_constrained_ordering) {
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(Ordering, grouped_constrained_ordering_sparse_groups) {
+
+  // the groups of grouped_constrained_ordering, numbered with gaps and past
+  // the number of variables, give the same ordering
+  SymbolicFactorGraph symbolicGraph = example::symbolicChain();
+
+  FastMap<Key, int> constraints;
+  constraints[2] = 7;
+  constraints[4] = 7;
+  constraints[5] = 20;
+
+  Ordering actual = Ordering::ColamdConstrained(symbolicGraph, constraints);
+  Ordering expected = list_of(0)(1)(3)(2)(4)(5);
+  EXPECT(assert_equal(expected, actual));
+
+  // a single late group is the last group, as ISAM2 gets when an update
+  // constrains only the newest variable
+  FastMap<Key, int> single;
+  single[2] = 2;
+  EXPECT(assert_equal(Ordering::ColamdConstrainedLast(symbolicGraph, list_of(2)),
+                      Ordering::ColamdConstrained(symbolicGraph, single)));
+}
+
 /* ************************************************************************* */
 TEST(Ordering, csr_format) {
   // Example in METIS manual
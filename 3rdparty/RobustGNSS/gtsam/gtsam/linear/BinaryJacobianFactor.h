@@ -72,11 +72,13 @@ struct BinaryJacobianFactor: JacobianFactor {
       Eigen::Block<const Matrix, M, N2> A2(Ab, 0, N1);
       Eigen::Block<const Matrix, M, 1> b(Ab, 0, N1 + N2);
 
-      // We perform I += A'*A to the upper triangle
-      info->diagonalBlock(slot1).rankUpdate(A1.transpose());
+      // We perform I += A'*A to the upper triangle. Not with rankUpdate: for
+      // a one column block A' is a row vector at compile time, which Eigen
+      // takes as a rank one update with that vector.
+      info->updateDiagonalBlock(slot1, (A1.transpose() * A1).eval());
       info->updateOffDiagonalBlock(slot1, slot2, A1.transpose() * A2);
       info->updateOffDiagonalBlock(slot1, slotB, A1.transpose() * b);
-      info->diagonalBlock(slot2).rankUpdate(A2.transpose());
+      info->updateDiagonalBlock(slot2, (A2.transpose() * A2).eval());
       info->updateOffDiagonalBlock(slot2, slotB, A2.transpose() * b);
       info->updateDiagonalBlock(slotB, b.transpose() * b);
     }
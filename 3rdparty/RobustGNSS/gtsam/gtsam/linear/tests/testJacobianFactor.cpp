@@ -21,6 +21,8 @@
 
 #include <gtsam/inference/VariableSlots.h>
 #include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/BinaryJacobianFactor.h>
+#include <gtsam/linear/HessianFactor.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam/linear/GaussianConditional.h>
 #include <gtsam/linear/VectorValues.h>
@@ -636,6 +638,21 @@ TEST(JacobianFactor, OverdeterminedEliminate) {
   EXPECT(actual.second->empty());
 }
 
+/* ************************************************************************* */
+TEST(JacobianFactor, BinaryJacobianFactorOneColumnHessian) {
+  // Second block has one column, as for the GNSS phase bias
+  Matrix25 A1;
+  A1 << 1, 2, 3, 4, 5,  //
+      6, 7, 8, 9, 10;
+  const Vector2 A2(0.5, -1.5), b(1, 2);
+
+  GaussianFactorGraph binary, generic;
+  binary += BinaryJacobianFactor<2, 5, 1>(3, A1, 7, A2, b);
+  generic += JacobianFactor(3, A1, 7, A2, b);
+
+  EXPECT(assert_equal(HessianFactor(generic), HessianFactor(binary), 1e-9));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
@@ -37,6 +37,8 @@ namespace br { using namespace boost::range; using namespace boost::adaptors; }
 #include <gtsam/nonlinear/nonlinearExceptions.h>
 #include <gtsam/nonlinear/LinearContainerFactor.h>
 
+#include <chrono>
+
 using namespace std;
 
 namespace gtsam {
@@ -61,6 +63,37 @@ public:
   ISAM2BayesTree() {}
 };
 
+/* ************************************************************************* */
+// Adds the wall time from construction to stop() to one of the ISAM2Result::stageTimes, when
+// they are enabled.  Used like gttic_/gttoc_.
+namespace {
+class StageTimer {
+  double* stage_;
+  std::chrono::steady_clock::time_point start_;
+public:
+  StageTimer(boost::optional<ISAM2Result::StageTimes>& times, double ISAM2Result::StageTimes::* stage) :
+    stage_(times ? &(*times.*stage) : 0) {
+    if(stage_) start_ = std::chrono::steady_clock::now(); }
+  ~StageTimer() { stop(); }
+  void stop() {
+    if(stage_) {
+      *stage_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+      stage_ = 0; } }
+};
+}
+
+/* ************************************************************************* */
+// Number of cliques created by reelimination.  The nodes index of a freshly eliminated tree
+// holds only its own cliques, not the orphans reattached to it, and each clique is counted
+// once through its first frontal variable.
+static size_t countCliques(const ISAM2BayesTree& bayesTree) {
+  size_t count = 0;
+  for(const ISAM2BayesTree::Nodes::value_type& node: bayesTree.nodes())
+    if(node.second->conditional()->front() == node.first)
+      ++ count;
+  return count;
+}
+
 /* ************************************************************************* */
 // Special JunctionTree class that produces ISAM2 BayesTree cliques, used for reeliminating ISAM2
 // subtrees.
@@ -360,9 +393,11 @@ boost::shared_ptr<KeySet > ISAM2::recalculate(const KeySet& markedKeys, const Ke
     gttoc(ordering);
 
     gttic(linearize);
+    StageTimer linearizeTimer(result.stageTimes, &ISAM2Result::StageTimes::relinearize);
     GaussianFactorGraph linearized = *nonlinearFactors_.linearize(theta_);
     if(params_.cacheLinearizedFactors)
       linearFactors_ = linearized;
+    linearizeTimer.stop();
     gttoc(linearize);
 
     gttic(eliminate);
@@ -378,6 +413,7 @@ boost::shared_ptr<KeySet > ISAM2::recalculate(const KeySet& markedKeys, const Ke
 
     result.variablesReeliminated = affectedKeysSet->size();
     result.factorsRecalculated = nonlinearFactors_.size();
+    result.cliquesReeliminated = countCliques(*bayesTree);
 
     lastAffectedMarkedCount = markedKeys.size();
     lastAffectedVariableCount = affectedKeysSet->size();
@@ -401,7 +437,9 @@ boost::shared_ptr<KeySet > ISAM2::recalculate(const KeySet& markedKeys, const Ke
     affectedAndNewKeys.insert(affectedAndNewKeys.end(), affectedKeys.begin(), affectedKeys.end());
     affectedAndNewKeys.insert(affectedAndNewKeys.end(), observedKeys.begin(), observedKeys.end());
     gttic(relinearizeAffected);
+    StageTimer linearizeTimer(result.stageTimes, &ISAM2Result::StageTimes::relinearize);
     GaussianFactorGraph factors(*relinearizeAffectedFactors(affectedAndNewKeys, relinKeys));
+    linearizeTimer.stop();
     if(debug) factors.print("Relinearized factors: ");
     gttoc(relinearizeAffected);
 
@@ -487,6 +525,8 @@ boost::shared_ptr<KeySet > ISAM2::recalculate(const KeySet& markedKeys, const Ke
 
     gttoc(reorder_and_eliminate);
 
+    result.cliquesReeliminated = countCliques(*bayesTree);
+
     gttic(reassemble);
     this->roots_.insert(this->roots_.end(), bayesTree->roots().begin(), bayesTree->roots().end());
     this->nodes_.insert(bayesTree->nodes().begin(), bayesTree->nodes().end());
@@ -528,8 +568,11 @@ ISAM2Result ISAM2::update(
   lastBacksubVariableCount = 0;
   lastNnzTop = 0;
   ISAM2Result result;
+  result.cliquesReeliminated = 0;
   if(params_.enableDetailedResults)
     result.detail = ISAM2Result::DetailedResults();
+  if(params_.enableStageTimes)
+    result.stageTimes = ISAM2Result::StageTimes();
   const bool relinearizeThisStep = force_relinearize
       || (params_.enableRelinearization && update_count_ % params_.relinearizeSkip == 0);
 
@@ -541,6 +584,7 @@ ISAM2Result ISAM2::update(
   // Update delta if we need it to check relinearization later
   if(relinearizeThisStep) {
     gttic(updateDelta);
+    StageTimer backSubstituteTimer(result.stageTimes, &ISAM2Result::StageTimes::backSubstitute);
     updateDelta(disableReordering);
     gttoc(updateDelta);
   }
@@ -632,6 +676,7 @@ ISAM2Result ISAM2::update(
   // Check relinearization if we're at the nth step, or we are using a looser loop relin threshold
   KeySet relinKeys;
   if (relinearizeThisStep) {
+    StageTimer relinearizeTimer(result.stageTimes, &ISAM2Result::StageTimes::relinearize);
     gttic(gather_relinearize_keys);
     // 4. Mark keys in \Delta above threshold \beta: J=\{\Delta_{j}\in\Delta|\Delta_{j}\geq\beta\}.
     if(params_.enablePartialRelinearizationCheck)
@@ -698,6 +743,7 @@ ISAM2Result ISAM2::update(
   // 7. Linearize new factors
   if(params_.cacheLinearizedFactors) {
     gttic(linearize);
+    StageTimer linearizeTimer(result.stageTimes, &ISAM2Result::StageTimes::relinearize);
     GaussianFactorGraph::shared_ptr linearFactors = newFactors.linearize(theta_);
     if(params_.findUnusedFactorSlots)
     {
@@ -725,8 +771,15 @@ ISAM2Result ISAM2::update(
   gttic(recalculate);
   // 8. Redo top of Bayes tree
   boost::shared_ptr<KeySet > replacedKeys;
-  if(!markedKeys.empty() || !observedKeys.empty())
+  if(!markedKeys.empty() || !observedKeys.empty()) {
+    // recalculate also linearizes the affected factors, which is not part of elimination
+    const double relinearizeBefore = result.stageTimes ? result.stageTimes->relinearize : 0.0;
+    StageTimer eliminateTimer(result.stageTimes, &ISAM2Result::StageTimes::eliminate);
     replacedKeys = recalculate(markedKeys, relinKeys, observedKeys, unusedIndices, constrainedKeys, result);
+    eliminateTimer.stop();
+    if(result.stageTimes)
+      result.stageTimes->eliminate -= result.stageTimes->relinearize - relinearizeBefore;
+  }
 
   // Update replaced keys mask (accumulates until back-substitution takes place)
   if(replacedKeys)
@@ -741,6 +794,7 @@ ISAM2Result ISAM2::update(
     gttoc(remove_variables);
   }
   result.cliques = this->nodes().size();
+  lastAffectedCliqueCount = result.cliquesReeliminated;
 
   gttic(evaluate_error_after);
   if(params_.evaluateNonlinearError)
@@ -1033,6 +1087,33 @@ Values ISAM2::calculateBestEstimate() const {
 
 /* ************************************************************************* */
 Matrix ISAM2::marginalCovariance(Key key) const {
+  gttic(ISAM2_marginalCovariance);
+  const sharedClique& clique = this->clique(key);
+  const GaussianConditional& conditional = *clique->conditional();
+
+  // A root conditional is already the marginal density of its frontal
+  // variables, so no shortcut or separator marginal has to be computed.
+  if(clique->isRoot() && !(conditional.get_model() && conditional.get_model()->isConstrained())) {
+    DenseIndex offset = 0;
+    GaussianConditional::const_iterator it = conditional.begin();
+    for(; *it != key; ++it)
+      offset += conditional.getDim(it);
+    const DenseIndex dim = conditional.getDim(it);
+
+    // With R the square root information of the variables from key on, the
+    // covariance of key is the top left block of R^-1 R^-T, i.e. X'X where
+    // R'X holds the first dim columns of the identity.
+    Matrix R = conditional.get_R();
+    if(conditional.get_model())
+      R = conditional.get_model()->Whiten(R);
+    const DenseIndex n = R.cols() - offset;
+    const Matrix X = R.bottomRightCorner(n, n).transpose().triangularView<Eigen::Lower>()
+      .solve(Matrix::Identity(n, dim));
+    return X.transpose() * X;
+  }
+
+  // Otherwise recover it through the separator marginals, which the cliques
+  // cache until an update replaces them
   return marginalFactor(key, params_.getEliminationFunction())->information().inverse();
 }
 
@@ -157,6 +157,8 @@ struct GTSAM_EXPORT ISAM2Params {
 
   bool enableDetailedResults; ///< Whether to compute and return ISAM2Result::detailedResults, this can increase running time (default: false)
 
+  bool enableStageTimes; ///< Whether to measure and return ISAM2Result::stageTimes, the wall time of the stages of each update (default: false)
+
   /** Check variables for relinearization in tree-order, stopping the check once a variable does not need to be relinearized (default: false).
    * This can improve speed by only checking a small part of the top of the tree. However, variables below the check cut-off can accumulate
    * significant deltas without triggering relinearization. This is particularly useful in exploration scenarios where real-time performance
@@ -183,7 +185,7 @@ struct GTSAM_EXPORT ISAM2Params {
       relinearizeSkip(_relinearizeSkip), enableRelinearization(_enableRelinearization),
       evaluateNonlinearError(_evaluateNonlinearError), factorization(_factorization),
       cacheLinearizedFactors(_cacheLinearizedFactors), keyFormatter(_keyFormatter),
-      enableDetailedResults(false), enablePartialRelinearizationCheck(false),
+      enableDetailedResults(false), enableStageTimes(false), enablePartialRelinearizationCheck(false),
       findUnusedFactorSlots(false) {}
 
   /// print iSAM2 parameters
@@ -210,6 +212,7 @@ struct GTSAM_EXPORT ISAM2Params {
     std::cout << "factorization:                     " << factorizationTranslator(factorization) << "\n";
     std::cout << "cacheLinearizedFactors:            " << cacheLinearizedFactors << "\n";
     std::cout << "enableDetailedResults:             " << enableDetailedResults << "\n";
+    std::cout << "enableStageTimes:                  " << enableStageTimes << "\n";
     std::cout << "enablePartialRelinearizationCheck: " << enablePartialRelinearizationCheck << "\n";
     std::cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots << "\n";
     std::cout.flush();
@@ -227,6 +230,7 @@ struct GTSAM_EXPORT ISAM2Params {
   bool isCacheLinearizedFactors() const { return cacheLinearizedFactors; }
   KeyFormatter getKeyFormatter() const { return keyFormatter; }
   bool isEnableDetailedResults() const { return enableDetailedResults; }
+  bool isEnableStageTimes() const { return enableStageTimes; }
   bool isEnablePartialRelinearizationCheck() const { return enablePartialRelinearizationCheck; }
 
   void setOptimizationParams(OptimizationParams optimizationParams) { this->optimizationParams = optimizationParams; }
@@ -238,6 +242,7 @@ struct GTSAM_EXPORT ISAM2Params {
   void setCacheLinearizedFactors(bool cacheLinearizedFactors) { this->cacheLinearizedFactors = cacheLinearizedFactors; }
   void setKeyFormatter(KeyFormatter keyFormatter) { this->keyFormatter = keyFormatter; }
   void setEnableDetailedResults(bool enableDetailedResults) { this->enableDetailedResults = enableDetailedResults; }
+  void setEnableStageTimes(bool enableStageTimes) { this->enableStageTimes = enableStageTimes; }
   void setEnablePartialRelinearizationCheck(bool enablePartialRelinearizationCheck) { this->enablePartialRelinearizationCheck = enablePartialRelinearizationCheck; }
 
   GaussianFactorGraph::Eliminate getEliminationFunction() const {
@@ -312,6 +317,12 @@ struct GTSAM_EXPORT ISAM2Result {
   /** The number of factors that were included in reelimination of the Bayes' tree. */
   size_t factorsRecalculated;
 
+  /** The number of cliques that were reeliminated, i.e. the cliques of the new top of the
+   * Bayes' tree.  Orphaned subtrees that were reattached are not counted.  A good ordering
+   * keeps this small and independent of the length of the graph.
+   */
+  size_t cliquesReeliminated;
+
   /** The number of cliques in the Bayes' Tree */
   size_t cliques;
 
@@ -351,14 +362,28 @@ struct GTSAM_EXPORT ISAM2Result {
    * Detail for information about the results data stored here. */
   boost::optional<DetailedResults> detail;
 
+  /** Wall time, in seconds, of the stages of an update.  Back-substitution done later by
+   * calculateEstimate() or getDelta() is not included. */
+  struct StageTimes {
+    double relinearize; ///< Relinearizing variables and linearizing new and affected factors
+    double eliminate; ///< Removing the top of the Bayes' tree, reordering and reeliminating it
+    double backSubstitute; ///< Updating the delta before checking for relinearization
+    StageTimes() : relinearize(0.0), eliminate(0.0), backSubstitute(0.0) {}
+  };
+
+  /** Stage times, if enabled by ISAM2Params::enableStageTimes. */
+  boost::optional<StageTimes> stageTimes;
+
 
   void print(const std::string str = "") const {
-    std::cout << str << "  Reelimintated: " << variablesReeliminated << "  Relinearized: " << variablesRelinearized << "  Cliques: " << cliques << std::endl;
+    std::cout << str << "  Reelimintated: " << variablesReeliminated << "  Relinearized: " << variablesRelinearized << "  Cliques: " << cliques
+              << "  Cliques reeliminated: " << cliquesReeliminated << std::endl;
   }
 
   /** Getters and Setters */
   size_t getVariablesRelinearized() const { return variablesRelinearized; };
   size_t getVariablesReeliminated() const { return variablesReeliminated; };
+  size_t getCliquesReeliminated() const { return cliquesReeliminated; };
   size_t getCliques() const { return cliques; };
 };
 
@@ -589,7 +614,9 @@ public:
    */
   const Value& calculateEstimate(Key key) const;
 
-  /** Return marginal on any variable as a covariance matrix */
+  /** Return marginal on any variable as a covariance matrix.  For a variable in a root clique,
+   * such as the newest variables after an update, this only inverts part of the root
+   * conditional, which is cheap enough to call after every update. */
   Matrix marginalCovariance(Key key) const;
 
   /// @name Public members for non-typical usage
@@ -0,0 +1,86 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGaussianISAM2.cpp
+ * @brief   Unit tests for ISAM2 marginal covariances
+ */
+
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/nonlinear/Marginals.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+namespace example {
+// Pose2 chain with loop closures, added one pose per update so that the
+// newest poses end up in the root clique
+ISAM2 poseChain(NonlinearFactorGraph& graph, size_t poses) {
+  const SharedNoiseModel odometryNoise = noiseModel::Diagonal::Sigmas(Vector3(0.2, 0.1, 0.05));
+  const SharedNoiseModel loopNoise = noiseModel::Diagonal::Sigmas(Vector3(0.5, 0.4, 0.1));
+  const Pose2 step(1.0, 0.0, M_PI / 6.0);
+
+  ISAM2 isam;
+  NonlinearFactorGraph newFactors;
+  Values newValues;
+  newFactors.add(PriorFactor<Pose2>(X(0), Pose2(),
+      noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.01))));
+  newValues.insert(X(0), Pose2());
+  Pose2 pose;
+  for (size_t k = 1; k < poses; ++k) {
+    pose = pose.compose(step);
+    newFactors.add(BetweenFactor<Pose2>(X(k - 1), X(k), step, odometryNoise));
+    if (k >= 12)  // once round the circle, close the loop
+      newFactors.add(BetweenFactor<Pose2>(X(k - 12), X(k), Pose2(), loopNoise));
+    newValues.insert(X(k), pose.retract(Vector3(0.05, -0.03, 0.01)));
+    isam.update(newFactors, newValues);
+    graph.push_back(newFactors);
+    newFactors.resize(0);
+    newValues.clear();
+  }
+  return isam;
+}
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, marginalCovariance) {
+  NonlinearFactorGraph graph;
+  const size_t poses = 30;
+  ISAM2 isam = example::poseChain(graph, poses);
+
+  // both at the linearization point of the Bayes tree
+  Marginals marginals(graph, isam.getLinearizationPoint());
+  size_t root = 0, nonRoot = 0;
+  for (size_t k = 0; k < poses; ++k) {
+    const bool isRoot = isam.clique(X(k))->isRoot();
+    (isRoot ? root : nonRoot)++;
+    EXPECT(assert_equal(marginals.marginalCovariance(X(k)), isam.marginalCovariance(X(k)), 1e-9));
+  }
+
+  // the root clique has several frontals, so the offset of the key matters
+  EXPECT(root > 1);
+  EXPECT(nonRoot > 0);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
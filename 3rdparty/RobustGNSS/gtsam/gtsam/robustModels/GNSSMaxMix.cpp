@@ -13,7 +13,7 @@ namespace gtsam {
 //***************************************************************************
 Vector GNSSMaxMix::evaluateError(const nonBiasStates& q, const phaseBias& g, boost::optional<Matrix&> H1, boost::optional<Matrix&> H2) const {
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
 
         double res_range = (h.transpose() * q) - measured_[0];
         double res_phase = (h.transpose() * q) + g[0] - measured_[1];
@@ -58,4 +58,18 @@ Vector GNSSMaxMix::evaluateError(const nonBiasStates& q, const phaseBias& g, boo
 
         return (Vector(2) << error).finished();
 }
+
+//***************************************************************************
+boost::shared_ptr<GaussianFactor> GNSSMaxMix::linearize(const Values& x) const {
+
+        noiseModel::Diagonal::shared_ptr diagonal =
+                boost::dynamic_pointer_cast<noiseModel::Diagonal>(noiseModel_);
+        if (!diagonal || diagonal->isConstrained())
+                return Base::linearize(x);
+
+        Matrix H1, H2;
+        Vector e = evaluateError(x.at<nonBiasStates>(key1()), x.at<phaseBias>(key2()), H1, H2);
+        return gnssJacobianFactor(key1(), H1, key2(), H2, e, diagonal->sigmas());
+}
+
 } // namespace
@@ -13,16 +13,16 @@ using namespace vertigo;
 namespace gtsam {
 Vector GNSSSwitch::evaluateError(const nonBiasStates& q, const phaseBias& g, const vertigo::SwitchPairLinear& s, boost::optional<Matrix&> H1, boost::optional<Matrix&> H2, boost::optional<Matrix&> H3) const {
 
-        Vector5 h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
 
-        double res_range = ( (h.transpose() * q) - measured_[0] ) * s.value()[0];
-        double res_phase = ( (h.transpose() * q) + g[0] - measured_[1] ) * s.value()[1];
+        double range = (h.transpose() * q) - measured_[0];
+        double phase = (h.transpose() * q) + g[0] - measured_[1];
 
-        Vector error = (Vector(2) << res_range, res_phase).finished();
+        Vector error = (Vector(2) << range * s.value()[0], phase * s.value()[1]).finished();
 
-        if (H1) { (*H1) = (Matrix(2,5) << h*s.value()[0], h*s.value()[1]).finished(); }
+        if (H1) { (*H1) = (Matrix(2,5) << h.transpose()*s.value()[0], h.transpose()*s.value()[1]).finished(); }
         if (H2) { (*H2) = (Matrix(2,1) << 0.0, s.value()[1]).finished(); }
-        if (H3) { (*H3) = (Vector(2) << error).finished(); }
+        if (H3) { (*H3) = (Matrix(2,2) << range, 0.0, 0.0, phase).finished(); }
         return error;
 }
 
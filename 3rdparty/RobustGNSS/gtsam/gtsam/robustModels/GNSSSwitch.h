@@ -27,6 +27,7 @@ private:
 
 Vector2 measured_;
 Point3 satXYZ_, nomXYZ_;
+nonBiasStates h_;
 typedef NoiseModelFactor3<nonBiasStates, phaseBias, vertigo::SwitchPairLinear> Base;
 
 public:
@@ -43,6 +44,7 @@ virtual ~GNSSSwitch() {
 GNSSSwitch(Key a, Key b, Key c, const Vector2 measurement,
            const Point3 satXYZ, const Point3 nomXYZ, const SharedNoiseModel &model) :
         Base(model, a,b,c), measured_(measurement), satXYZ_(satXYZ), nomXYZ_(nomXYZ) {
+        h_ = obsMap(satXYZ, nomXYZ, 1);
 }
 
 
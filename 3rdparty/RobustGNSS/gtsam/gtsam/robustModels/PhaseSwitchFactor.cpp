@@ -12,7 +12,7 @@ namespace gtsam {
 //***************************************************************************
 Vector PhaseSwitchFactor::evaluateError(const nonBiasStates& q, const phaseBias& g, const SwitchVariableLinear& s, boost::optional<Matrix&> H1, boost::optional<Matrix&> H2, boost::optional<Matrix&> H3) const {
 
-        Vector h = obsMap(satXYZ_, nomXYZ_, 1);
+        const Vector5& h = h_;
         double est = (h.transpose() * q) + g[0];
         Vector error = (Vector(1) << est - measured_ ).finished();
         error *= s.value();
@@ -43,6 +43,7 @@ virtual ~PhaseSwitchFactor() {
 PhaseSwitchFactor(Key a, Key b, Key c, const double deltaObs, const Point3 satXYZ, const Point3 nomXYZ, const SharedNoiseModel& model) :
         Base(model,a,b,c), measured_(deltaObs), satXYZ_(satXYZ) {
         nomXYZ_=nomXYZ;
+        h_ = obsMap(satXYZ, nomXYZ, 1);
 }
 virtual gtsam::NonlinearFactor::shared_ptr clone() const {
         return boost::static_pointer_cast<gtsam::NonlinearFactor>(
@@ -17,7 +17,6 @@ Vector PseudorangeSwitchFactor::evaluateError(const nonBiasStates& q,
                                               boost::optional<Matrix&> H1,
                                               boost::optional<Matrix&> H2) const {
 
-        Vector h_ = obsMap(satXYZ_, nomXYZ_, 1);
         double error = (h_.transpose()*q)-measured_;
         error *= s.value();
         if (H1) { (*H1) = (Matrix(1,5) << h_.transpose() * s.value() ).finished(); }
@@ -43,6 +43,7 @@ virtual ~PseudorangeSwitchFactor() {
 PseudorangeSwitchFactor(Key j, Key k, const double deltaObs, const Point3 satXYZ, const Point3 nomXYZ, const SharedNoiseModel& model) :
         Base(model, j,k), measured_(deltaObs), satXYZ_(satXYZ) {
         nomXYZ_=nomXYZ;
+        h_ = obsMap(satXYZ, nomXYZ, 1);
 }
 virtual gtsam::NonlinearFactor::shared_ptr clone() const {
         return boost::static_pointer_cast<gtsam::NonlinearFactor>(
@@ -0,0 +1,94 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testGNSSSwitch.cpp
+ * @brief   Unit test for the switchable GNSS factor
+ */
+
+#include <gtsam/robustModels/GNSSSwitch.h>
+#include <gtsam/gnssNavigation/GNSSFactor.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using namespace gtsam::symbol_shorthand;
+
+namespace example {
+const Point3 nomXYZ(856215.0, -4843097.0, 4047924.0);
+const Point3 satXYZ(-1692628.3735, -22516194.4719, 13984765.2746);
+const Vector2 measured(1.2, 10.4);
+const SharedNoiseModel model = noiseModel::Diagonal::Sigmas(Vector2(2.5, 0.25));
+const nonBiasStates q((Vector(5) << 0.7, -1.1, 0.4, 2.0, 0.05).finished());
+const phaseBias g(Vector1(8.9));
+
+// Central differences of the unwhitened error in one variable, the others
+// held at their values
+Matrix numericalJacobian(const NoiseModelFactor& factor, const Values& values,
+                         Key key, double delta = 1e-5) {
+  VectorValues dX = values.zeroVectors();
+  const size_t cols = dX.dim(key);
+  Matrix J(factor.dim(), cols);
+  for (size_t col = 0; col < cols; ++col) {
+    Vector dx = Vector::Zero(cols);
+    dx(col) = delta;
+    dX[key] = dx;
+    const Vector left = factor.unwhitenedError(values.retract(dX));
+    dX[key] = -dx;
+    const Vector right = factor.unwhitenedError(values.retract(dX));
+    J.col(col) = (left - right) / (2.0 * delta);
+  }
+  return J;
+}
+}
+
+/* ************************************************************************* */
+TEST(GNSSSwitch, error) {
+  using namespace example;
+  GNSSSwitch factor(X(0), G(0), S(0), measured, satXYZ, nomXYZ, model);
+  GNSSFactor plain(X(0), G(0), measured, satXYZ, nomXYZ, model);
+
+  // switched on, the factor is the plain GNSS factor
+  const Vector on = factor.evaluateError(q, g, SwitchPairLinear(1.0, 1.0));
+  EXPECT(assert_equal(plain.evaluateError(q, g), on, 1e-9));
+
+  // each switch scales its own residual
+  const Vector scaled = factor.evaluateError(q, g, SwitchPairLinear(0.5, 0.0));
+  EXPECT(assert_equal(Vector2(0.5 * on(0), 0.0), scaled, 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(GNSSSwitch, Jacobians) {
+  using namespace example;
+  GNSSSwitch factor(X(0), G(0), S(0), measured, satXYZ, nomXYZ, model);
+
+  Values values;
+  values.insert(X(0), q);
+  values.insert(G(0), g);
+  values.insert(S(0), SwitchPairLinear(0.8, 0.3));
+
+  Matrix H1, H2, H3;
+  factor.evaluateError(q, g, SwitchPairLinear(0.8, 0.3), H1, H2, H3);
+  EXPECT(assert_equal(numericalJacobian(factor, values, X(0)), H1, 1e-7));
+  EXPECT(assert_equal(numericalJacobian(factor, values, G(0)), H2, 1e-7));
+  EXPECT(assert_equal(numericalJacobian(factor, values, S(0)), H3, 1e-7));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -0,0 +1,417 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeGnssIce.cpp
+ * @brief   Times the GNSS estimators (L2, DCS, max-mix, switchable and ICE)
+ *          on a synthetic multi-hour dataset, so no data files are needed
+ *
+ * Usage: timeGnssIce [--hours h] [--rate hz] [--faults fraction] [--nlos rate]
+ *                    [--seed n] [--config l2|dcs|maxmix|switch|ice]
+ *
+ * The dataset is generated by GnssSimulator from the seed, with --nlos NLOS
+ * episodes per satellite and hour, written in the readGNSS format and read
+ * back with readGNSS, or with readGNSSFaulty when --faults is given, so runs
+ * with the same arguments see the same observations. Each configuration
+ * runs in its own process. Its peak RSS is reported above the RSS it starts
+ * with, so the dataset the parent loaded is not counted.
+ */
+
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/gnssNavigation/GnssData.h>
+#include <gtsam/gnssNavigation/GnssSimulator.h>
+#include <gtsam/gnssNavigation/GNSSFactor.h>
+#include <gtsam/gnssNavigation/GNSSDCSFactor.h>
+#include <gtsam/gnssNavigation/GNSSMultiModalFactor.h>
+#include <gtsam/gnssNavigation/ThreadBudget.h>
+#include <gtsam/gnssNavigation/nonBiasStates.h>
+#include <gtsam/robustModels/GNSSSwitch.h>
+
+#include <libcluster/merge.h>
+#include <libcluster/libcluster.h>
+
+#include <boost/filesystem.hpp>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+using namespace std;
+using namespace gtsam;
+using namespace gtsam::symbol_shorthand;
+using namespace vertigo;
+
+enum Estimator { L2_ESTIMATOR, DCS_ESTIMATOR, MAXMIX_ESTIMATOR, SWITCH_ESTIMATOR, ICE_ESTIMATOR, NUM_ESTIMATORS };
+const char* estimatorNames[NUM_ESTIMATORS] = { "l2", "dcs", "maxmix", "switch", "ice" };
+
+// Receiver at a fixed site, displaced from the nominal position by an error
+// the estimators have to find [ENU, m]
+const Point3 nomXYZ(856215.0, -4843097.0, 4047924.0);
+const Vector3 truthOffset(-1.5, 2.0, 1.0);
+
+// Inlier measurement model of the examples [m]
+const double rangeWeight = 2.5;
+const double phaseWeight = 0.25;
+
+// Magnitude of the faults readGNSSFaulty adds to the computed range [m]
+const double faultMean = 25.0;
+const double faultStdDev = 5.0;
+
+struct Observation {
+  int svn;
+  Point3 satXYZ;
+  double rho, range, phase;
+  int arc;
+};
+typedef vector<Observation> Epoch;
+
+// Write the dataset in the readGNSS format with GnssSimulator: the 24
+// satellites of a GPS constellation, a static receiver and white noise, so
+// any faults come from readGNSSFaulty or the simulated NLOS. Returns the
+// number of lines written.
+size_t writeDataset(const string& file, double hours, double rate, double nlosRate,
+                    unsigned int seed) {
+  GnssSimParams params;
+  params.nomXYZ = nomXYZ;
+  params.offset = truthOffset;
+  params.hours = hours;
+  params.rate = rate;
+  params.satellites[GNSS_GPS] = 24;
+  params.satellites[GNSS_GLONASS] = 0;
+  params.satellites[GNSS_GALILEO] = 0;
+  params.satellites[GNSS_BEIDOU] = 0;
+  params.nlosRate = nlosRate;
+  params.seed = seed;
+  GnssSimulator sim(params);
+  return writeGnssSim(sim, file, GNSS_TEXT);
+}
+
+// Group the observations by epoch. The readers add a copy of the last line
+// at the end of the file, so only the first `lines` records are used.
+template<class DATA>
+vector<Epoch> toEpochs(const vector<DATA>& data, size_t lines) {
+  vector<Epoch> epochs;
+  int last = -1;
+  for (size_t i = 0; i < lines && i < data.size(); ++i) {
+    if (data[i].template get<1>() != last) {
+      epochs.push_back(Epoch());
+      last = data[i].template get<1>();
+    }
+    Observation obs = { data[i].template get<2>(), data[i].template get<3>(),
+                        data[i].template get<4>(), data[i].template get<5>(),
+                        data[i].template get<6>(),
+                        static_cast<int>(data[i].template get<7>()) };
+    epochs.back().push_back(obs);
+  }
+  return epochs;
+}
+
+struct Result {
+  size_t epochs;
+  double seconds, p50, p99, rms;
+  long peakRSS;
+};
+
+// A field of /proc/self/status in kB, or -1 where there is none
+long statusKB(const char* field) {
+  ifstream status("/proc/self/status");
+  string line;
+  const size_t length = strlen(field);
+  while (getline(status, line))
+    if (!line.compare(0, length, field))
+      return atol(line.c_str() + length);
+  return -1;
+}
+
+// Reset the peak RSS (VmHWM) to the current RSS and return the current RSS in
+// kB. Without /proc the peak cannot be reset, and 0 is returned, so the peak
+// includes the parent's pages.
+long resetPeakRSS() {
+  ofstream("/proc/self/clear_refs") << "5";
+  const long rss = statusKB("VmRSS:");
+  return rss < 0 ? 0 : rss;
+}
+
+// Peak RSS in kB, VmHWM where there is one
+long peakRSS() {
+  const long hwm = statusKB("VmHWM:");
+  if (hwm >= 0) return hwm;
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// nearest rank percentile of sorted values
+double percentile(const vector<double>& sorted, double p) {
+  size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.5);
+  rank = min(max(rank, static_cast<size_t>(1)), sorted.size());
+  return sorted[rank - 1];
+}
+
+// Component of the model that best explains a residual, counted in numObs,
+// or gmm.size() when the residual is more than 3 sigma from it
+size_t classify(const vector<merge::mixtureComponents>& gmm, const Vector& res,
+                vector<int>& numObs) {
+  size_t best = 0;
+  double probMax = 0.0;
+  for (size_t k = 0; k < gmm.size(); ++k) {
+    const Eigen::MatrixXd& cov = gmm[k].get<4>();
+    const double quadform = res.transpose() * cov.inverse() * res;
+    const double prob = pow(sqrt(2 * M_PI), -1) * pow(cov.determinant(), -0.5)
+        * exp(-0.5 * quadform);
+    if (prob >= probMax) {
+      best = k;
+      probMax = prob;
+    }
+  }
+  const Eigen::MatrixXd& cov = gmm[best].get<4>();
+  if (fabs(res(0)) / sqrt(cov(0, 0)) > 3.0 || fabs(res(1)) / sqrt(cov(1, 1)) > 3.0)
+    return gmm.size();
+  numObs[best]++;
+  return best;
+}
+
+// Run one estimator over the epochs, the way the test_gnss_* examples do,
+// except that only the estimates the epoch needs are computed rather than
+// the whole Values, whose copy would otherwise dominate long runs
+Result run(Estimator estimator, const vector<Epoch>& epochs, const Vector3& truthDelta) {
+
+  const long baseRSS = resetPeakRSS();
+  ThreadBudget threadBudget;
+
+  noiseModel::Diagonal::shared_ptr initNoise = noiseModel::Diagonal::Variances(
+      (Vector(5) << 0.2, 0.2, 0.2, 3e6, 1e-1).finished());
+  noiseModel::Diagonal::shared_ptr resetNoise = noiseModel::Diagonal::Variances(
+      (Vector(5) << 3e4, 3e4, 3e4, 3e6, 1e-1).finished());
+  noiseModel::Diagonal::shared_ptr biasNoise = noiseModel::Diagonal::Variances(
+      (Vector(1) << 3e6).finished());
+  noiseModel::Diagonal::shared_ptr measNoise = noiseModel::Diagonal::Sigmas(
+      (Vector(2) << rangeWeight, phaseWeight).finished());
+  noiseModel::Diagonal::shared_ptr switchNoise = noiseModel::Diagonal::Sigmas(
+      (Vector(2) << 0.5, 0.5).finished());
+
+  Eigen::MatrixXd dcsModel(2, 2);
+  dcsModel << pow(rangeWeight, 2), 0.0, 0.0, pow(phaseWeight, 2);
+  const Vector2 kernelWidth(rangeWeight * 3.0, phaseWeight * 3.0);
+
+  // max-mix: inlier and outlier components; ICE: the inlier component,
+  // grown from the residuals that fit none
+  vector<merge::mixtureComponents> gmm;
+  gmm.push_back(boost::make_tuple(0, 0, 0.0, Eigen::RowVectorXd::Zero(2), dcsModel));
+  if (estimator == MAXMIX_ESTIMATOR)
+    gmm.push_back(boost::make_tuple(0, 0, 0.0, Eigen::RowVectorXd::Zero(2),
+                                    Eigen::MatrixXd(dcsModel * 1e1)));
+  vector<int> numObs(1000, 0);
+  vector<Vector> outliers;
+
+  ISAM2Params parameters;
+  parameters.relinearizeThreshold = 0.01;
+  parameters.relinearizeSkip = 1000;
+  ISAM2 isam(parameters);
+
+  map<int, int> arcs;
+  map<int, Key> biases;
+  size_t nBiases = 0, nSwitches = 0;
+  nonBiasStates state(Z_5x1);
+  vector<double> latency;
+  double squaredError = 0.0;
+
+  for (size_t k = 0; k < epochs.size(); ++k) {
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    NonlinearFactorGraph graph;
+    Values values;
+    graph.add(PriorFactor<nonBiasStates>(X(k), state, k == 0 ? initNoise : resetNoise));
+    values.insert(X(k), state);
+
+    vector<size_t> gnssSlots;
+    for (size_t i = 0; i < epochs[k].size(); ++i) {
+      const Observation& obs = epochs[k][i];
+      if (!arcs.count(obs.svn) || arcs[obs.svn] != obs.arc) {
+        arcs[obs.svn] = obs.arc;
+        biases[obs.svn] = G(nBiases++);
+        const phaseBias bias(obs.phase - obs.range);
+        graph.add(PriorFactor<phaseBias>(biases[obs.svn], bias, biasNoise));
+        values.insert(biases[obs.svn], bias);
+      }
+
+      const Vector2 z(obs.range - obs.rho, obs.phase - obs.rho);
+      gnssSlots.push_back(graph.size());
+      switch (estimator) {
+      case L2_ESTIMATOR:
+        graph.add(GNSSFactor(X(k), biases[obs.svn], z, obs.satXYZ, nomXYZ, measNoise));
+        break;
+      case DCS_ESTIMATOR:
+        graph.add(GNSSDCSFactor(X(k), biases[obs.svn], z, obs.satXYZ, nomXYZ, dcsModel, kernelWidth));
+        break;
+      case MAXMIX_ESTIMATOR:
+      case ICE_ESTIMATOR:
+        graph.add(GNSSMultiModalFactor(X(k), biases[obs.svn], z, obs.satXYZ, nomXYZ, gmm));
+        break;
+      case SWITCH_ESTIMATOR:
+        graph.add(GNSSSwitch(X(k), biases[obs.svn], S(nSwitches), z, obs.satXYZ, nomXYZ, measNoise));
+        graph.add(PriorFactor<SwitchPairLinear>(S(nSwitches), SwitchPairLinear(1.0, 1.0), switchNoise));
+        values.insert(S(nSwitches), SwitchPairLinear(1.0, 1.0));
+        ++nSwitches;
+        break;
+      default:
+        break;
+      }
+    }
+
+    ISAM2Result result = isam.update(graph, values);
+
+    if (estimator == ICE_ESTIMATOR) {
+      // drop the observations no component explains, keeping their
+      // residuals to learn new components from
+      Values estimate;
+      estimate.insert(X(k), isam.calculateEstimate<nonBiasStates>(X(k)));
+      for (size_t i = 0; i < epochs[k].size(); ++i) {
+        const Key bias = biases[epochs[k][i].svn];
+        estimate.insert(bias, isam.calculateEstimate<phaseBias>(bias));
+      }
+      FactorIndices removed;
+      for (size_t i = 0; i < gnssSlots.size(); ++i) {
+        const Vector res = graph.at(gnssSlots[i])->residual(estimate);
+        if (classify(gmm, res, numObs) == gmm.size()) {
+          outliers.push_back(res);
+          removed.push_back(result.newFactorsIndices[gnssSlots[i]]);
+        }
+      }
+      isam.update(NonlinearFactorGraph(), Values(), removed);
+
+      if (outliers.size() > 1000) {
+        Eigen::MatrixXd residuals(outliers.size(), 2);
+        for (size_t i = 0; i < outliers.size(); ++i)
+          residuals.row(i) = outliers[i].transpose();
+
+        distributions::StickBreak weights;
+        vector<distributions::GaussWish> clusters;
+        Eigen::MatrixXd qZ;
+        libcluster::learnVDP(residuals, qZ, weights, clusters, PRIORVAL, -1, false,
+                             threadBudget.threads());
+        gmm = merge::updateObs(gmm, numObs);
+        fill(numObs.begin(), numObs.end(), 0);
+        gmm = merge::mergeMixtureModel(residuals, qZ, gmm, clusters, weights, 0.05, 20,
+                                       threadBudget.threads());
+        outliers.clear();
+      }
+    }
+    else {
+      isam.update();
+    }
+    isam.update();
+
+    state = isam.calculateEstimate<nonBiasStates>(X(k));
+
+    latency.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    squaredError += (Vector3(state.x(), state.y(), state.z()) - truthDelta).squaredNorm();
+  }
+
+  Result r;
+  r.epochs = latency.size();
+  r.seconds = 0.0;
+  for (size_t i = 0; i < latency.size(); ++i)
+    r.seconds += latency[i];
+  sort(latency.begin(), latency.end());
+  r.p50 = latency.empty() ? 0.0 : percentile(latency, 50.0);
+  r.p99 = latency.empty() ? 0.0 : percentile(latency, 99.0);
+  r.rms = latency.empty() ? 0.0 : sqrt(squaredError / latency.size());
+
+  r.peakRSS = peakRSS() - baseRSS;  // kB
+  return r;
+}
+
+void printRow(Estimator estimator, const Result& r) {
+  printf("%-8s %8zu %10.1f %10.3f %10.3f %12.1f %9.3f\n", estimatorNames[estimator],
+         r.epochs, r.epochs / r.seconds, r.p50 * 1e3, r.p99 * 1e3, r.peakRSS / 1024.0, r.rms);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+
+  double hours = 2.0, rate = 1.0, faults = 0.0, nlos = 0.0;
+  unsigned int seed = 42;
+  int only = -1;
+
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--hours") && hasValue) hours = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--rate") && hasValue) rate = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--faults") && hasValue) faults = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--nlos") && hasValue) nlos = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && hasValue) seed = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--config") && hasValue) {
+      const char* name = argv[++i];
+      for (int e = 0; e < NUM_ESTIMATORS; ++e)
+        if (!strcmp(name, estimatorNames[e])) only = e;
+      if (only < 0) {
+        cerr << "unknown configuration " << name << endl;
+        return 1;
+      }
+    }
+    else {
+      cerr << "usage: " << argv[0] << " [--hours h] [--rate hz] [--faults fraction]"
+           << " [--nlos rate] [--seed n] [--config l2|dcs|maxmix|switch|ice]" << endl;
+      return 1;
+    }
+  }
+
+  const string file = (boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path("timeGnssIce-%%%%-%%%%.txt")).string();
+  const size_t lines = writeDataset(file, hours, rate, nlos, seed);
+  const vector<Epoch> epochs = faults > 0.0
+      ? toEpochs(readGNSSFaulty(file, faultMean, faultStdDev, faults, seed), lines)
+      : toEpochs(readGNSS(file), lines);
+  boost::filesystem::remove(file);
+
+  // the estimators solve for the nominal position minus the true one
+  const Point3 truthXYZ = GnssReceiver(nomXYZ).toECEF(Point3(truthOffset));
+  const Vector3 truthDelta(nomXYZ.x() - truthXYZ.x(), nomXYZ.y() - truthXYZ.y(),
+                           nomXYZ.z() - truthXYZ.z());
+
+  cout << "Synthetic dataset: " << hours << " h at " << rate << " Hz, " << epochs.size()
+       << " epochs, " << lines << " observations, seed " << seed
+       << ", faulty fraction " << faults << ", NLOS rate " << nlos << endl;
+  printf("%-8s %8s %10s %10s %10s %12s %9s\n", "config", "epochs", "epochs/s",
+         "p50[ms]", "p99[ms]", "peakRSS[MB]", "rms[m]");
+  fflush(stdout);
+
+  if (only >= 0) {
+    printRow(Estimator(only), run(Estimator(only), epochs, truthDelta));
+    return 0;
+  }
+
+  // one process per configuration, so the peak RSS is the configuration's.
+  // The child starts with the parent's pages, which resetPeakRSS discounts.
+  for (int e = 0; e < NUM_ESTIMATORS; ++e) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      printRow(Estimator(e), run(Estimator(e), epochs, truthDelta));
+      _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      cerr << estimatorNames[e] << " failed" << endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,136 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeGnssLinearize.cpp
+ * @brief   Times iSAM2 updates on a GNSS chain, with the GNSS factors linearized
+ *          to fixed size BinaryJacobianFactors and to generic JacobianFactors
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/ISAM2.h>
+#include <gtsam/slam/PriorFactor.h>
+#include <gtsam/gnssNavigation/GNSSFactor.h>
+#include <gtsam/gnssNavigation/nonBiasStates.h>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+
+using namespace std;
+using namespace gtsam;
+using namespace gtsam::symbol_shorthand;
+
+// The GNSS factor as it was linearized before: a JacobianFactor of
+// dynamic size, whitened through the noise model.
+class GenericGNSSFactor : public GNSSFactor {
+public:
+  GenericGNSSFactor(Key deltaStates, Key bias, const Vector2 measurement,
+      const Point3 satXYZ, const Point3 nomXYZ, const SharedNoiseModel &model) :
+      GNSSFactor(deltaStates, bias, measurement, satXYZ, nomXYZ, model) {
+  }
+
+  virtual boost::shared_ptr<GaussianFactor> linearize(const Values& x) const {
+    return NoiseModelFactor::linearize(x);
+  }
+};
+
+const size_t steps = 2000;
+const size_t nSats = 10;
+
+// Receiver at a fixed site and satellites on the GPS orbit radius
+const Point3 nomXYZ(856215.0, -4843097.0, 4047924.0);
+
+vector<Point3> satellites() {
+  boost::mt19937 rng(42);
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<> >
+      randn(rng, boost::normal_distribution<>());
+  const Vector3 up = Vector3(nomXYZ.x(), nomXYZ.y(), nomXYZ.z()).normalized();
+  vector<Point3> sats;
+  while (sats.size() < nSats) {
+    Vector3 dir(randn(), randn(), randn());
+    dir.normalize();
+    if (dir.dot(up) < 0.3) continue;
+    sats.push_back(Point3(26560000.0 * dir));
+  }
+  return sats;
+}
+
+// Run the chain and return the total time spent in iSAM2 updates
+template<class FACTOR>
+double run(const string& name) {
+
+  cout << "Playing forward " << steps << " epochs of " << nSats
+       << " satellites with " << name << " linearization..." << endl;
+
+  tictoc_reset_();
+
+  const vector<Point3> sats = satellites();
+  boost::mt19937 rng(7);
+  boost::variate_generator<boost::mt19937&, boost::normal_distribution<> >
+      randn(rng, boost::normal_distribution<>());
+
+  noiseModel::Diagonal::shared_ptr measNoise =
+      noiseModel::Diagonal::Sigmas((Vector(2) << 3.0, 0.03).finished());
+  noiseModel::Diagonal::shared_ptr stateNoise =
+      noiseModel::Diagonal::Sigmas((Vector(5) << 10.0, 10.0, 10.0, 100.0, 1.0).finished());
+  noiseModel::Diagonal::shared_ptr biasNoise =
+      noiseModel::Diagonal::Sigmas((Vector(1) << 100.0).finished());
+
+  vector<phaseBias> biases(nSats);
+  for (size_t s = 0; s < nSats; ++s)
+    biases[s] = phaseBias(10.0 * randn());
+
+  ISAM2 isam2;
+
+  for (size_t step = 0; step < steps; ++step) {
+
+    Values newVariables;
+    NonlinearFactorGraph newFactors;
+
+    gttic_(Create_measurements);
+    newFactors.add(PriorFactor<nonBiasStates>(X(step), nonBiasStates(), stateNoise));
+    newVariables.insert(X(step), nonBiasStates());
+
+    for (size_t s = 0; s < nSats; ++s) {
+      if (step == 0) {
+        newFactors.add(PriorFactor<phaseBias>(G(s), biases[s], biasNoise));
+        newVariables.insert(G(s), biases[s]);
+      }
+      Vector2 obs(3.0 * randn(), biases[s](0) + 0.03 * randn());
+      newFactors.add(FACTOR(X(step), G(s), obs, sats[s], nomXYZ, measNoise));
+    }
+    gttoc_(Create_measurements);
+
+    gttic_(Update_ISAM2);
+    isam2.update(newFactors, newVariables);
+    gttoc_(Update_ISAM2);
+
+    tictoc_finishedIteration_();
+  }
+
+  tictoc_print_();
+
+  tictoc_getNode(node, Update_ISAM2);
+  return node->secs();
+}
+
+int main(int argc, char *argv[]) {
+
+  const double generic = run<GenericGNSSFactor>("generic JacobianFactor");
+  const double fixed = run<GNSSFactor>("BinaryJacobianFactor<2,5,1>");
+
+  cout << "iSAM2 update time, generic JacobianFactor:      " << generic << " s" << endl;
+  cout << "iSAM2 update time, BinaryJacobianFactor<2,5,1>: " << fixed << " s" << endl;
+  cout << "speedup: " << generic / fixed << endl;
+
+  return 0;
+}
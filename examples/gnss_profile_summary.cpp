@@ -0,0 +1,58 @@
+/*
+ *  @file   gnss_profile_summary.cpp
+ *  @brief  Print per stage percentiles of a trace written by the estimators
+ *          (profileFile in the conf file).
+ */
+
+// GTSAM
+#include <gtsam/gnssNavigation/GnssProfiler.h>
+
+// BOOST
+#include <boost/program_options.hpp>
+
+// STD
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+using namespace gtsam;
+
+namespace po = boost::program_options;
+
+int main(int argc, char *argv[])
+{
+        vector<string> traceFiles;
+
+        po::options_description desc("Available options");
+        desc.add_options()
+                ("help,h", "Print help message")
+                ("trace,t", po::value<vector<string> >(&traceFiles),
+                "Profiler trace file(s)" );
+
+        po::positional_options_description pos;
+        pos.add("trace", -1);
+
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), vm);
+        po::notify(vm);
+
+        if (vm.count("help") || traceFiles.empty()) {
+                cout << "usage: gnss_profile_summary trace [trace ...]\n\n" << desc << endl;
+                return traceFiles.empty() ? 1 : 0;
+        }
+
+        for (size_t i = 0; i < traceFiles.size(); i++) {
+                try {
+                        vector<GnssProfiler::Span> spans = GnssProfiler::read(traceFiles[i]);
+                        cout << traceFiles[i] << "\n";
+                        GnssProfiler::summarize(spans, cout);
+                        cout << endl;
+                }
+                catch (std::exception& e) {
+                        cerr << e.what() << endl;
+                        return 1;
+                }
+        }
+
+        return 0;
+}
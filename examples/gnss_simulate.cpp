@@ -0,0 +1,147 @@
+/*
+ *  @file   gnss_simulate.cpp
+ *  @brief  Write a synthetic multi-constellation dataset in the estimator
+ *          input format (readGNSS, readGNSS_SingleFreq) or the binary
+ *          format of readGNSSBinary.
+ */
+
+// GTSAM
+#include <gtsam/gnssNavigation/GnssSimulator.h>
+
+// BOOST
+#include <boost/program_options.hpp>
+
+// STD
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+using namespace gtsam;
+
+namespace po = boost::program_options;
+
+int main(int argc, char *argv[])
+{
+        GnssSimParams params;
+        string outputFile, truthFile, format, trajectory;
+        vector<double> nominal, offset;
+        double mask, heading;
+
+        po::options_description desc("Available options");
+        desc.add_options()
+                ("help,h", "Print help message")
+                ("out,o", po::value<string>(&outputFile),
+                "Output file" )
+                ("format,f", po::value<string>(&format)->default_value("text"),
+                "text (readGNSS), single (readGNSS_SingleFreq) or binary (readGNSSBinary)" )
+                ("truth", po::value<string>(&truthFile)->default_value(""),
+                "Write the true states of each epoch to this file" )
+                ("hours", po::value<double>(&params.hours)->default_value(params.hours),
+                "Length of the dataset [hours]" )
+                ("rate", po::value<double>(&params.rate)->default_value(params.rate),
+                "Epochs per second" )
+                ("gps", po::value<int>(&params.satellites[GNSS_GPS])->default_value(params.satellites[GNSS_GPS]),
+                "GPS satellites" )
+                ("glonass", po::value<int>(&params.satellites[GNSS_GLONASS])->default_value(params.satellites[GNSS_GLONASS]),
+                "GLONASS satellites" )
+                ("galileo", po::value<int>(&params.satellites[GNSS_GALILEO])->default_value(params.satellites[GNSS_GALILEO]),
+                "Galileo satellites" )
+                ("beidou", po::value<int>(&params.satellites[GNSS_BEIDOU])->default_value(params.satellites[GNSS_BEIDOU]),
+                "BeiDou MEO satellites" )
+                ("mask", po::value<double>(&mask)->default_value(10.0),
+                "Elevation mask [deg]" )
+                ("nominal", po::value<vector<double> >(&nominal)->multitoken(),
+                "Nominal receiver position x y z [ECEF, meter]" )
+                ("offset", po::value<vector<double> >(&offset)->multitoken(),
+                "Start of the trajectory from the nominal position e n u [meter]" )
+                ("trajectory", po::value<string>(&trajectory)->default_value("static"),
+                "static, circle or line" )
+                ("speed", po::value<double>(&params.speed)->default_value(params.speed),
+                "Receiver speed [meter/sec]" )
+                ("radius", po::value<double>(&params.radius)->default_value(params.radius),
+                "Radius of the circle [meter]" )
+                ("heading", po::value<double>(&heading)->default_value(0.0),
+                "Heading of the line, clockwise from north [deg]" )
+                ("range-sigma", po::value<double>(&params.rangeSigma)->default_value(params.rangeSigma),
+                "Range noise [meter]" )
+                ("phase-sigma", po::value<double>(&params.phaseSigma)->default_value(params.phaseSigma),
+                "Phase noise [meter]" )
+                ("multipath", po::value<double>(&params.multipathSigma)->default_value(params.multipathSigma),
+                "Range multipath sigma [meter]" )
+                ("multipath-tau", po::value<double>(&params.multipathTau)->default_value(params.multipathTau),
+                "Multipath correlation time [sec]" )
+                ("nlos-rate", po::value<double>(&params.nlosRate)->default_value(params.nlosRate),
+                "NLOS episodes per satellite and hour" )
+                ("nlos-duration", po::value<double>(&params.nlosDuration)->default_value(params.nlosDuration),
+                "Mean length of an NLOS episode [sec]" )
+                ("nlos-mean", po::value<double>(&params.nlosMean)->default_value(params.nlosMean),
+                "Mean NLOS extra path [meter]" )
+                ("nlos-std", po::value<double>(&params.nlosStdDev)->default_value(params.nlosStdDev),
+                "Sigma of the NLOS extra path [meter]" )
+                ("slip-rate", po::value<double>(&params.slipRate)->default_value(params.slipRate),
+                "Cycle slips per satellite and hour" )
+                ("seed", po::value<unsigned int>(&params.seed)->default_value(params.seed),
+                "Random seed" )
+                ("threads", po::value<unsigned int>(&params.threads)->default_value(params.threads),
+                "Worker threads, 0 for all processors" );
+
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+
+        if (vm.count("help") || outputFile.empty()) {
+                cout << "usage: gnss_simulate --out file [options]\n\n" << desc << endl;
+                return outputFile.empty() ? 1 : 0;
+        }
+
+        GnssSimFormat fileFormat;
+        if (format == "text") fileFormat = GNSS_TEXT;
+        else if (format == "single") fileFormat = GNSS_TEXT_SINGLE_FREQ;
+        else if (format == "binary") fileFormat = GNSS_BINARY;
+        else {
+                cerr << "unknown format " << format << endl;
+                return 1;
+        }
+
+        if (trajectory == "static") params.trajectory = GNSS_STATIC;
+        else if (trajectory == "circle") params.trajectory = GNSS_CIRCLE;
+        else if (trajectory == "line") params.trajectory = GNSS_LINE;
+        else {
+                cerr << "unknown trajectory " << trajectory << endl;
+                return 1;
+        }
+
+        if (vm.count("nominal")) {
+                if (nominal.size() != 3) {
+                        cerr << "--nominal takes x y z" << endl;
+                        return 1;
+                }
+                params.nomXYZ = Point3(nominal[0], nominal[1], nominal[2]);
+        }
+        if (vm.count("offset")) {
+                if (offset.size() != 3) {
+                        cerr << "--offset takes e n u" << endl;
+                        return 1;
+                }
+                params.offset = Vector3(offset[0], offset[1], offset[2]);
+        }
+        params.elevationMask = mask*M_PI/180.0;
+        params.heading = heading*M_PI/180.0;
+
+        try {
+                GnssSimulator sim(params);
+                const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                const size_t n = writeGnssSim(sim, outputFile, fileFormat, truthFile);
+                const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                cout << sim.numEpochs() << " epochs, " << sim.numSatellites() << " satellites, "
+                     << n << " observations written to " << outputFile << " in " << seconds
+                     << " s (" << n/seconds << " observations/s)" << endl;
+        }
+        catch (std::exception& e) {
+                cerr << e.what() << endl;
+                return 1;
+        }
+
+        return 0;
+}
@@ -58,12 +58,14 @@
 #include <gtsam/inference/FactorGraph.h>
 #include <gtsam/gnssNavigation/GnssData.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
 #include <gtsam/nonlinear/DoglegOptimizer.h>
 #include <gtsam/gnssNavigation/GNSSFactor.h>
 #include <gtsam/nonlinear/NonlinearFactor.h>
 #include <gtsam/gnssNavigation/FolderUtils.h>
 #include <gtsam/gnssNavigation/GnssPostfit.h>
 #include <gtsam/gnssNavigation/gnssStateVec.h>
+#include <gtsam/gnssNavigation/ThreadBudget.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/GaussNewtonOptimizer.h>
 #include <gtsam/nonlinear/NonlinearOptimizer.h>
@@ -205,22 +207,12 @@ int main(int argc, char** argv) {
 
         if ( noTrop ) { trop = 0; }
 
-        #ifdef GTSAM_USE_TBB
-        std::auto_ptr<tbb::task_scheduler_init> init;
-        if(nThreads > 0) {
+        // One thread budget for ISAM2 (TBB) and the mixture model learning
+        ThreadBudget threadBudget(nThreads);
+        if(nThreads > 0)
                 cout << "\n\n Using " << nThreads << " threads " << endl;
-                init.reset(new tbb::task_scheduler_init(nThreads));
-        }
         else
                 cout << green << " \n\n Using threads for all processors" << endl;
-        #else
-        if(nThreads > 0) {
-                cout << red <<" \n\n GTSAM is not compiled with TBB, so threading is"
-                     << " disabled and the --threads option cannot be used."
-                     << endl;
-                exit(1);
-        }
-        #endif
 
         // set up directory to store all generated data
         if ( dir.empty() ) { dir = getTimestamp(); }
@@ -234,6 +226,7 @@ int main(int argc, char** argv) {
         Point3 nomXYZ(856514.1467,-4843013.0689, 4047939.8237);
         // Nom. pos. for the dec12 dataset.
         // Point3 nomXYZ(856295.3346, -4843033.4111, 4048017.6649);
+        GnssReceiver nomRec(nomXYZ);
         Point3 nomNED(0.0, 0.0, 0.0);
 
         double output_time = 0.0;
@@ -241,9 +234,6 @@ int main(int argc, char** argv) {
         double phaseWeight = pow(rangeWeight*(1/phaseScale), 2);
 
         phaseBias bias_state(Z_1x1);
-        gnssStateVector phase_arc(Z_34x1);
-        gnssStateVector bias_counter(Z_34x1);
-        for (int i=1; i<34; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
         nonBiasStates initEst((gtsam::Vector(5) << 0,0,0,0,0).finished());
 
         using symbol_shorthand::X; // nonBiasStates ( dx, dy, dz, trop, cb )
@@ -263,6 +253,12 @@ int main(int argc, char** argv) {
                 exit(1);
         }
 
+        // indexed by svn, which goes past 34 in multi-constellation data
+        const int numSvn = svnCount(data);
+        Eigen::VectorXd phase_arc = Eigen::VectorXd::Zero(numSvn);
+        Eigen::VectorXd bias_counter = Eigen::VectorXd::Zero(numSvn);
+        for (int i=1; i<numSvn; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
+
         strategy = "GNSS Only using VDP in conjuction with max-mixtures";
         cout << green << "\n\n" << lineBreak << " GNSS Data File :: "
              << gnssFile << endl;
@@ -311,8 +307,9 @@ int main(int argc, char** argv) {
                         ambFactors.push_back(make_pair(i, ++factorCount));
                 }
 
-                double rw = elDepWeight(satXYZ, nomXYZ, rangeWeight);
-                double pw = elDepWeight(satXYZ, nomXYZ, phaseWeight);
+                double elWeight = nomRec.elDepWeight(satXYZ, 1.0);
+                double rw = elWeight*rangeWeight;
+                double pw = elWeight*phaseWeight;
 
                 // Generate phase factor
                 graph.add(boost::make_shared<GNSSFactor>(X(currKey), G(bias_counter[svn]), obs, satXYZ, nomXYZ, diagNoise::Variances( (gtsam::Vector(2) << rw, pw).finished() )));
@@ -371,7 +368,8 @@ int main(int argc, char** argv) {
 
                 // variational dirichlet process.
                 // Eigen::MatrixXd whitened_residuals = whitenData(residuals);
-                learnVDP(residuals, qZ, weights, clusters);
+                learnVDP(residuals, qZ, weights, clusters, PRIORVAL, -1, false,
+                         threadBudget.threads());
                 // learnVDP(whitened_residuals, qZ, weights, clusters);
                 // Tw_inv = Eigen::MatrixXd::Identity(2,2);
                 // whitened_residuals.resize(0,0);
@@ -12,8 +12,10 @@
 #include <gtsam/slam/BetweenFactor.h>
 #include <gtsam/gnssNavigation/GnssData.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
 #include <gtsam/gnssNavigation/GNSSDCSFactor.h>
 #include <gtsam/gnssNavigation/nonBiasStates.h>
+#include <gtsam/gnssNavigation/ThreadBudget.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 
@@ -108,6 +110,7 @@ int main(int argc, char* argv[])
         }
 
         Point3 nomXYZ(xn, yn, zn);
+        GnssReceiver nomRec(nomXYZ);
         Point3 prop_xyz = nomXYZ;
 
         try {data = readGNSS_SingleFreq(gnssFile); }
@@ -118,11 +121,9 @@ int main(int argc, char* argv[])
         }
 
 
-        std::auto_ptr<tbb::task_scheduler_init> init;
-        if(nThreads > 0) {
-                init.reset(new tbb::task_scheduler_init(nThreads));
-        }
-        else
+        // One thread budget for ISAM2 (TBB) and the mixture model learning
+        ThreadBudget threadBudget(nThreads);
+        if(nThreads <= 0)
                 cout << green << " \n\n Using threads for all processors" << endl;
 
         ISAM2DoglegParams doglegParams;
@@ -141,9 +142,11 @@ int main(int argc, char* argv[])
         nonBiasStates prior_nonBias = (gtsam::Vector(5) << 0.0, 0.0, 0.0, 0.0, 0.0).finished();
 
         phaseBias bias_state(Z_1x1);
-        gnssStateVector phase_arc(Z_34x1);
-        gnssStateVector bias_counter(Z_34x1);
-        for (int i=1; i<34; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
+        // indexed by svn, which goes past 34 in multi-constellation data
+        const int numSvn = svnCount(data);
+        Eigen::VectorXd phase_arc = Eigen::VectorXd::Zero(numSvn);
+        Eigen::VectorXd bias_counter = Eigen::VectorXd::Zero(numSvn);
+        for (int i=1; i<numSvn; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
 
         nonBiasStates initEst(Z_5x1);
         nonBiasStates between_nonBias_State(Z_5x1);
@@ -249,7 +252,7 @@ int main(int argc, char* argv[])
                         }
 
                         if (printENU) {
-                                Point3 enu = xyz2enu(prop_xyz, nomXYZ);
+                                Point3 enu = nomRec.toENU(prop_xyz);
                                 cout << "enu " << gnssTime << " " << enu.x() << " " << enu.y() << " " << enu.z() << endl;
                         }
 
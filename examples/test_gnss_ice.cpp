@@ -12,9 +12,13 @@
 #include <gtsam/slam/BetweenFactor.h>
 #include <gtsam/gnssNavigation/GnssData.h>
 #include <gtsam/gnssNavigation/GnssTools.h>
+#include <gtsam/gnssNavigation/GnssGeometry.h>
+#include <gtsam/gnssNavigation/GnssOrdering.h>
+#include <gtsam/gnssNavigation/GnssProfiler.h>
 #include <gtsam/gnssNavigation/nonBiasStates.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/gnssNavigation/GNSSMultiModalFactor.h>
+#include <gtsam/gnssNavigation/ThreadBudget.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 
 
@@ -79,10 +83,11 @@ int main(int argc, char* argv[])
         int ob_count(0), state_skip(0), tmp(0);
         int startKey(0), currKey, startEpoch(0), svn, numBatch(0), state_count(0), update_count(0);
         int nThreads(-1), phase_break, break_count(0), nextKey, factor_count(-1), res_count(-1);
-        bool printECEF, printENU, printAmb, first_ob(true);
+        bool printECEF, printENU, printAmb, printCov, printCliques, constrainOrdering, first_ob(true);
         Eigen::MatrixXd residuals, all_residuals;
         vector<mixtureComponents> globalMixtureModel;
 
+        string profileFile;
         string res_str = "all.residuals";
         ofstream res_os(res_str);
 
@@ -118,10 +123,20 @@ int main(int argc, char* argv[])
                 printENU = confReader.getValueAsBoolean("printENU", station);
                 printAmb = confReader.getValueAsBoolean("printAmb", station);
                 printECEF = confReader.getValueAsBoolean("printECEF", station);
+                printCov = confReader.ifExist("printCov", station) &&
+                           confReader.getValueAsBoolean("printCov", station);
+                printCliques = confReader.ifExist("printCliques", station) &&
+                               confReader.getValueAsBoolean("printCliques", station);
+                constrainOrdering = !confReader.ifExist("constrainOrdering", station) ||
+                                    confReader.getValueAsBoolean("constrainOrdering", station);
                 gnssFile = confReader("dataFile", station);
+                if (confReader.ifExist("profileFile", station)) {
+                        profileFile = confReader("profileFile", station);
+                }
         }
 
         Point3 nomXYZ(xn, yn, zn);
+        GnssReceiver nomRec(nomXYZ);
         Point3 prop_xyz = nomXYZ;
 
         try {data = readGNSS_SingleFreq(gnssFile); }
@@ -132,17 +147,16 @@ int main(int argc, char* argv[])
         }
 
 
-        std::auto_ptr<tbb::task_scheduler_init> init;
-        if(nThreads > 0) {
-                init.reset(new tbb::task_scheduler_init(nThreads));
-        }
-        else
+        // One thread budget for ISAM2 (TBB) and the mixture model learning
+        ThreadBudget threadBudget(nThreads);
+        if(nThreads <= 0)
                 cout << green << " \n\n Using threads for all processors" << endl;
 
         ISAM2DoglegParams doglegParams;
         ISAM2Params parameters;
         parameters.relinearizeThreshold = 0.01;
         parameters.relinearizeSkip = 1000;
+        parameters.enableStageTimes = !profileFile.empty();
         ISAM2 isam(parameters);
 
         double output_time = 0.0;
@@ -155,9 +169,11 @@ int main(int argc, char* argv[])
         nonBiasStates prior_nonBias = (gtsam::Vector(5) << 0.0, 0.0, 0.0, 0.0, 0.0).finished();
 
         phaseBias bias_state(Z_1x1);
-        gnssStateVector phase_arc(Z_34x1);
-        gnssStateVector bias_counter(Z_34x1);
-        for (int i=1; i<34; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
+        // indexed by svn, which goes past 34 in multi-constellation data
+        const int numSvn = svnCount(data);
+        Eigen::VectorXd phase_arc = Eigen::VectorXd::Zero(numSvn);
+        Eigen::VectorXd bias_counter = Eigen::VectorXd::Zero(numSvn);
+        for (int i=1; i<numSvn; i++) {bias_counter(i) = bias_counter(i-1) + 10000; }
 
         nonBiasStates initEst(Z_5x1);
         nonBiasStates between_nonBias_State(Z_5x1);
@@ -190,10 +206,14 @@ int main(int argc, char* argv[])
 
         std::vector<int> num_obs (1000, 0);
 
+        // Per epoch stage times, written to profileFile at the end
+        GnssProfiler profiler(!profileFile.empty());
+
         for(unsigned int i = startEpoch; i < data.size(); i++ ) {
 
 
                 auto start = high_resolution_clock::now();
+                GnssProfiler::Scope buildScope(profiler, GNSS_GRAPH_BUILD);
 
                 double gnssTime = get<0>(data[i]);
                 int currKey = get<1>(data[i]);
@@ -252,8 +272,27 @@ int main(int argc, char* argv[])
 
                         }
 
-                        isam.update(*graph, initial_values);
-                        result = isam.calculateEstimate();
+                        // Keep the newest state and the biases in view at the root
+                        boost::optional<FastMap<Key,int> > constraints;
+                        if (constrainOrdering) {
+                                vector<Key> activeBiases;
+                                for (int k=0; k<prn_vec.size(); k++) {
+                                        activeBiases.push_back(G(bias_counter[prn_vec[k]]));
+                                }
+                                constraints = gnssOrderingConstraints(X(currKey), activeBiases);
+                        }
+
+                        buildScope.stop();
+
+                        ISAM2Result updateResult = isam.update(*graph, initial_values, FactorIndices(), constraints);
+                        size_t cliquesReeliminated = updateResult.getCliquesReeliminated();
+                        profiler.add(updateResult);
+                        {
+                                GnssProfiler::Scope scope(profiler, GNSS_BACK_SUBSTITUTE);
+                                result = isam.calculateEstimate();
+                        }
+
+                        GnssProfiler::Scope classifyScope(profiler, GNSS_CLASSIFY);
 
 
                         // Only learn from residuals which don't agree with the model
@@ -328,6 +367,8 @@ int main(int argc, char* argv[])
                         }
 
 
+                        classifyScope.stop();
+
                         initial_values.clear();
                         if (ob_count >= 5) {
 
@@ -335,9 +376,22 @@ int main(int argc, char* argv[])
                                 ++tmp;
                                 ++state_count;
 
-                                isam.update(*graph);
-                                isam.update();
-                                result = isam.calculateEstimate();
+                                updateResult = isam.update(*graph, Values(), FactorIndices(), constraints);
+                                cliquesReeliminated += updateResult.getCliquesReeliminated();
+                                profiler.add(updateResult);
+                                updateResult = isam.update(NonlinearFactorGraph(), Values(), FactorIndices(), constraints);
+                                cliquesReeliminated += updateResult.getCliquesReeliminated();
+                                profiler.add(updateResult);
+                                {
+                                        GnssProfiler::Scope scope(profiler, GNSS_BACK_SUBSTITUTE);
+                                        result = isam.calculateEstimate();
+                                }
+
+                                GnssProfiler::Scope outputScope(profiler, GNSS_OUTPUT);
+
+                                if (printCliques) {
+                                        cout << "cliques " << gnssTime << " " << cliquesReeliminated << endl;
+                                }
 
                                 prior_nonBias = result.at<nonBiasStates>(X(currKey));
                                 Point3 delta_xyz = (gtsam::Vector(3) << prior_nonBias.x(), prior_nonBias.y(), prior_nonBias.z()).finished();
@@ -348,10 +402,23 @@ int main(int argc, char* argv[])
                                 }
 
                                 if (printENU) {
-                                        Point3 enu = xyz2enu(prop_xyz, nomXYZ);
+                                        Point3 enu = nomRec.toENU(prop_xyz);
                                         cout << "enu " << gnssTime << " " << enu.x() << " " << enu.y() << " " << enu.z() << endl;
                                 }
 
+                                // The newest state is kept in the root clique, so its
+                                // marginal comes straight from the root conditional
+                                if (printCov) {
+                                        gtsam::Matrix cov = isam.marginalCovariance(X(currKey));
+                                        cout << "cov " << gnssTime;
+                                        for (int r=0; r<cov.rows(); r++) {
+                                                for (int c=0; c<cov.cols(); c++) {
+                                                        cout << " " << cov(r,c);
+                                                }
+                                        }
+                                        cout << endl;
+                                }
+
                                 if (printAmb) {
                                         cout << "gps " << " " << gnssTime << " ";
                                         for (int k=0; k<prn_vec.size(); k++) {
@@ -378,14 +445,21 @@ int main(int argc, char* argv[])
                                 vector<GaussWish> clusters;
                                 Eigen::MatrixXd qZ;
 
-                                learnVDP(residuals, qZ, weights, clusters);
+                                GnssProfiler::Scope vdpScope(profiler, GNSS_VDP);
+                                learnVDP(residuals, qZ, weights, clusters, PRIORVAL, -1, false,
+                                         threadBudget.threads());
+                                vdpScope.stop();
+
+                                GnssProfiler::Scope mergeScope(profiler, GNSS_MERGE);
 
                                 // update the number of obs in each component
                                 globalMixtureModel = updateObs(globalMixtureModel, num_obs);
                                 std::fill(num_obs.begin(), num_obs.end(), 0);
 
                                 // merge the curr and prior mixture models.
-                                globalMixtureModel = mergeMixtureModel(residuals, qZ, globalMixtureModel, clusters, weights, 0.05, 20);
+                                globalMixtureModel = mergeMixtureModel(residuals, qZ, globalMixtureModel, clusters, weights, 0.05, 20,
+                                                                       threadBudget.threads());
+                                mergeScope.stop();
 
                                 cout << "\n\n\n\n\n\n" << endl;
                                 cout << "----------------- Merged MODEL ----------------" << endl;
@@ -410,6 +484,8 @@ int main(int argc, char* argv[])
                         cout << "Delta time: "
                              << duration.count() << " microseconds" << endl;
 
+                        profiler.nextEpoch();
+
                         initial_values.insert(X(nextKey), prior_nonBias);
                         ob_count = 0;
                 }
@@ -425,5 +501,9 @@ int main(int argc, char* argv[])
                 cout << mc.get<0>() << " " << mc.get<1>() << " "  <<  mc.get<2>() << "    " << mc.get<3>() <<"     "<< cov(0,0) << " " << cov(0,1) << " " << cov(1,1) <<"     "<<"\n\n" << endl;
         }
 
+        if (!profileFile.empty()) {
+                profiler.write(profileFile);
+        }
+
         return 0;
 }